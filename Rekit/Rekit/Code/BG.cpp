@@ -195,10 +195,26 @@ void BG::Update ( float elapsedTime )
 
 void BG::Draw () const
 {
+	float texW = 0.0f, texH = 0.0f;
+	if (!Donya::Sprite::GetTextureSize ( gear, &texW, &texH )) { return; }
+	// else
+
+	std::array<Donya::Sprite::Batch::ReserveDesc, GEAR_NUM> descs{};
 	for (int i = 0; i < GEAR_NUM; i++)
 	{
-		Donya::Sprite::Draw ( gear, pos[i].x, pos[i].y, degree[i], 0.8f );
+		auto &desc = descs[i];
+		desc.screenX	= pos[i].x;
+		desc.screenY	= pos[i].y;
+		desc.screenW	= texW;
+		desc.screenH	= texH;
+		desc.textureW	= texW;
+		desc.textureH	= texH;
+		desc.centerX	= texW * 0.5f;
+		desc.centerY	= texH * 0.5f;
+		desc.alpha		= 0.8f;
+		desc.degree		= degree[i];
 	}
+	Donya::Sprite::DrawBulk ( gear, descs.data (), descs.size () );
 }
 
 #if USE_IMGUI
@@ -0,0 +1,73 @@
+#include "ContactCache.h"
+
+#include <cmath>		// Use roundf().
+#include <functional>	// Use std::hash.
+
+namespace
+{
+	// The positions and sizes are quantized by this scale, so the precision of key is 0.01.
+	constexpr float QUANTIZE_SCALE = 100.0f;
+
+	int Quantize( float value )
+	{
+		return static_cast<int>( roundf( value * QUANTIZE_SCALE ) );
+	}
+
+	void CombineHash( size_t *pSeed, int value )
+	{
+		// I referred to boost::hash_combine().
+		*pSeed ^= std::hash<int>()( value ) + 0x9e3779b9 + ( *pSeed << 6 ) + ( *pSeed >> 2 );
+	}
+}
+
+void ContactCache::Begin()
+{
+	// Reuse the both buffers, so this does not allocate at the steady state.
+	previous.swap( current );
+	current.clear();
+}
+void ContactCache::Clear()
+{
+	previous.clear();
+	current.clear();
+}
+
+void ContactCache::Register( size_t key, size_t hintIndex, const Donya::Vector2 &pushDirection )
+{
+	for ( auto &it : current )
+	{
+		if ( it.key != key ) { continue; }
+		// else
+
+		// The same pair was resolved again in this frame. Keep the latest push.
+		it.hintIndex = hintIndex;
+		if ( !pushDirection.IsZero() )
+		{
+			it.pushDirection = pushDirection;
+		}
+		return;
+	}
+
+	current.emplace_back( Contact{ key, hintIndex, pushDirection } );
+}
+
+size_t ContactCache::Validate( const Contact &prev, const BoxEx &owner, const BoxEx *pBoxes, size_t boxCount ) const
+{
+	if ( !pBoxes || boxCount <= prev.hintIndex ) { return NOT_FOUND; }
+	// else
+
+	const size_t key = MakeKey( owner, pBoxes[prev.hintIndex] );
+	return ( key == prev.key ) ? prev.hintIndex : NOT_FOUND;
+}
+
+size_t ContactCache::MakeKey( const BoxEx &owner, const BoxEx &other )
+{
+	size_t seed = 0;
+	CombineHash( &seed, other.attr );
+	CombineHash( &seed, other.mass );
+	CombineHash( &seed, Quantize( other.size.x ) );
+	CombineHash( &seed, Quantize( other.size.y ) );
+	CombineHash( &seed, Quantize( other.pos.x - owner.pos.x ) );
+	CombineHash( &seed, Quantize( other.pos.y - owner.pos.y ) );
+	return seed;
+}
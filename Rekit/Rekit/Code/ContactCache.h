@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+
+#include "Donya/Vector.h"
+
+#include "DerivedCollision.h"
+
+/// <summary>
+/// Remember the contacts that resolved at previous frame, per owner(usually a gimmick).<para></para>
+/// A contact is keyed by the pair of [owner - other], the key is built from other's attribute, mass, size and relative position to the owner.<para></para>
+/// So a stack that moves together(e.g. pushed by the hook) keeps the same keys between frames.
+/// </summary>
+class ContactCache
+{
+public:
+	static constexpr size_t NOT_FOUND = static_cast<size_t>( -1 );
+public:
+	struct Contact
+	{
+		size_t			key{};
+		size_t			hintIndex{ NOT_FOUND };	// The index of the other's box in the list that was passed at the frame.
+		Donya::Vector2	pushDirection{};		// Normalized-vector of [other->owner]. Zero if the contact did not push the owner at the frame.
+	};
+private:
+	std::vector<Contact> previous;
+	std::vector<Contact> current;
+public:
+	ContactCache() : previous(), current() {}
+public:
+	/// <summary>
+	/// Please call at first of each resolution. The contacts of last frame will become the warm-start candidates.
+	/// </summary>
+	void Begin();
+	/// <summary>
+	/// Forget all contacts.
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Register the resolved contact at the current frame.
+	/// </summary>
+	void Register( size_t key, size_t hintIndex, const Donya::Vector2 &pushDirection );
+
+	/// <summary>
+	/// Returns the contacts that resolved at last frame.
+	/// </summary>
+	const std::vector<Contact> &Previous() const { return previous; }
+
+	/// <summary>
+	/// Returns the index of "pBoxes" that is matched to the key of previous contact, or NOT_FOUND if the hint is no longer valid.
+	/// </summary>
+	size_t Validate( const Contact &previousContact, const BoxEx &owner, const BoxEx *pBoxes, size_t boxCount ) const;
+public:
+	/// <summary>
+	/// Make a key of pair of [owner - other]. The positions are quantized, so a small floating error is ignored.
+	/// </summary>
+	static size_t MakeKey( const BoxEx &owner, const BoxEx &other );
+};
@@ -0,0 +1,277 @@
+#include "AllocationTracker.h"
+
+#include <array>
+#include <atomic>
+#include <cstdio>		// Use snprintf().
+#include <cstring>		// Use strcmp().
+#include <mutex>
+#include <Windows.h>	// Use OutputDebugStringA().
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace AllocationTracker
+	{
+		constexpr size_t MAX_ZONE_COUNT	= 32U;
+		constexpr size_t UNTRACKED		= 0U;
+
+		struct Counter
+		{
+			std::atomic<unsigned int>		allocCount{ 0U };
+			std::atomic<unsigned long long>	allocBytes{ 0U };
+			std::atomic<unsigned int>		freeCount{ 0U };
+		public:
+			Stats Exchange()
+			{
+				Stats stats{};
+				stats.allocCount = allocCount.exchange( 0U );
+				stats.allocBytes = allocBytes.exchange( 0U );
+				stats.freeCount  = freeCount.exchange( 0U );
+				return stats;
+			}
+		};
+
+		// These are fixed size, because the hook must not allocate.
+		static std::array<const char *, MAX_ZONE_COUNT>	zoneNames{ "Untracked" };
+		static std::array<Counter, MAX_ZONE_COUNT>		currentCounters{};
+		static std::array<Stats, MAX_ZONE_COUNT>		lastFrameStats{};
+		static Stats									lastFrameWhole{};
+		static std::atomic<size_t>						zoneCount{ 1U };
+		static std::mutex								zoneMutex;
+
+		static thread_local size_t						currentZone = UNTRACKED;
+
+		static thread_local int							forbidDepth = 0;	// Per thread, so the other threads(e.g. the loaders) are not flagged.
+		static std::atomic<unsigned int>				violationCount{ 0U };
+		static std::atomic<size_t>						lastViolationZone{ UNTRACKED };
+		static unsigned int								reportedViolationCount = 0U;
+		static bool										enableForbid = false;
+		static bool										breakOnViolation = false;
+		static int										warmUpTimer = 0;
+		static bool										wasInstalled = false;
+
+		size_t FindOrRegisterZone( const char *zoneName )
+		{
+			std::lock_guard<std::mutex> enterCS( zoneMutex );
+
+			const size_t count = zoneCount.load();
+			for ( size_t i = 0; i < count; ++i )
+			{
+				if ( zoneNames[i] == zoneName || !strcmp( zoneNames[i], zoneName ) )
+				{
+					return i;
+				}
+			}
+
+			if ( MAX_ZONE_COUNT <= count ) { return UNTRACKED; }
+			// else
+
+			zoneNames[count] = zoneName;
+			zoneCount.store( count + 1 );
+			return count;
+		}
+
+	#if DEBUG_MODE
+
+		static _CRT_ALLOC_HOOK prevHook = nullptr;
+
+		// Do not call any CRT function from here, it may recurse into the hook.
+		int __cdecl AllocHook( int allocType, void *pUserData, size_t size, int blockType, long requestNumber, const unsigned char *fileName, int lineNumber )
+		{
+			if ( blockType == _CRT_BLOCK ) { return TRUE; } // The CRT's internal.
+			// else
+
+			Counter &counter = currentCounters[currentZone];
+			if ( allocType == _HOOK_FREE )
+			{
+				counter.freeCount.fetch_add( 1U, std::memory_order_relaxed );
+				return TRUE;
+			}
+			// else
+
+			counter.allocCount.fetch_add( 1U, std::memory_order_relaxed );
+			counter.allocBytes.fetch_add( size, std::memory_order_relaxed );
+
+			if ( 0 < forbidDepth )
+			{
+				violationCount.fetch_add( 1U );
+				lastViolationZone.store( currentZone );
+			}
+
+			return TRUE;
+		}
+
+	#endif // DEBUG_MODE
+
+		void Init()
+		{
+		#if DEBUG_MODE
+			if ( wasInstalled ) { return; }
+			// else
+
+			prevHook = _CrtSetAllocHook( AllocHook );
+			wasInstalled = true;
+		#endif // DEBUG_MODE
+		}
+		void Uninit()
+		{
+		#if DEBUG_MODE
+			if ( !wasInstalled ) { return; }
+			// else
+
+			_CrtSetAllocHook( prevHook );
+			prevHook = nullptr;
+			wasInstalled = false;
+		#endif // DEBUG_MODE
+		}
+
+		void ReportViolations()
+		{
+			const unsigned int totalCount = violationCount.load();
+			if ( totalCount == reportedViolationCount ) { return; }
+			// else
+
+			const size_t zone = lastViolationZone.load();
+
+			// Use a stack buffer, because the std::string allocates.
+			char message[256]{};
+			snprintf
+			(
+				message, sizeof( message ),
+				"[AllocationTracker] %u allocation(s) in the forbidden scope. The last one is at the zone[%s].\n",
+				totalCount - reportedViolationCount,
+				zoneNames[zone]
+			);
+			OutputDebugStringA( message );
+
+			reportedViolationCount = totalCount;
+
+		#if DEBUG_MODE
+			// Break here instead of the hook, so the allocation itself is not stopped.
+			if ( breakOnViolation ) { _CrtDbgBreak(); }
+		#endif // DEBUG_MODE
+		}
+
+		void BeginFrame()
+		{
+			lastFrameWhole = Stats{};
+
+			const size_t count = zoneCount.load();
+			for ( size_t i = 0; i < count; ++i )
+			{
+				Stats &stats = lastFrameStats[i];
+				stats = currentCounters[i].Exchange();
+
+				lastFrameWhole.allocCount += stats.allocCount;
+				lastFrameWhole.allocBytes += stats.allocBytes;
+				lastFrameWhole.freeCount  += stats.freeCount;
+			}
+
+			if ( 0 < warmUpTimer ) { warmUpTimer--; }
+
+			ReportViolations();
+		}
+
+		Stats GetLastFrameStats()
+		{
+			return lastFrameWhole;
+		}
+		size_t GetZoneCount()
+		{
+			return zoneCount.load();
+		}
+		const char *GetZoneName( size_t zoneIndex )
+		{
+			return ( zoneIndex < zoneCount.load() ) ? zoneNames[zoneIndex] : nullptr;
+		}
+		Stats GetLastFrameStats( size_t zoneIndex )
+		{
+			return ( zoneIndex < zoneCount.load() ) ? lastFrameStats[zoneIndex] : Stats{};
+		}
+		size_t GetCurrentZoneIndex()
+		{
+			return currentZone;
+		}
+
+		void SetForbidEnable( bool enable )
+		{
+			enableForbid = enable;
+		}
+		void ResetWarmUp( int warmUpFrameCount )
+		{
+			warmUpTimer = warmUpFrameCount;
+		}
+		void SetBreakOnViolation( bool enable )
+		{
+			breakOnViolation = enable;
+		}
+		unsigned int GetViolationCount()
+		{
+			return violationCount.load();
+		}
+
+		Zone::Zone( const char *zoneName ) : parentIndex( currentZone )
+		{
+		#if DEBUG_MODE
+			currentZone = FindOrRegisterZone( zoneName );
+		#endif // DEBUG_MODE
+		}
+		Zone::Zone( size_t zoneIndex ) : parentIndex( currentZone )
+		{
+		#if DEBUG_MODE
+			currentZone = ( zoneIndex < zoneCount.load() ) ? zoneIndex : UNTRACKED;
+		#endif // DEBUG_MODE
+		}
+		Zone::~Zone()
+		{
+			currentZone = parentIndex;
+		}
+
+		ForbidScope::ForbidScope() : isActive( false )
+		{
+		#if DEBUG_MODE
+			if ( enableForbid && warmUpTimer <= 0 )
+			{
+				isActive = true;
+				forbidDepth++;
+			}
+		#endif // DEBUG_MODE
+		}
+		ForbidScope::~ForbidScope()
+		{
+			if ( isActive )
+			{
+				forbidDepth--;
+			}
+		}
+
+	#if USE_IMGUI
+
+		void ShowImGuiNode( const char *nodeCaption )
+		{
+			if ( !ImGui::TreeNode( nodeCaption ) ) { return; }
+			// else
+
+			const Stats whole = GetLastFrameStats();
+			ImGui::Text( u8"Alloc[%u] Bytes[%llu] Free[%u]", whole.allocCount, whole.allocBytes, whole.freeCount );
+			ImGui::Text( u8"Violation[%u]", GetViolationCount() );
+			ImGui::Checkbox( u8"Forbid in the zero-alloc scopes", &enableForbid );
+			ImGui::Checkbox( u8"Break on violation", &breakOnViolation );
+
+			ImGui::Separator();
+
+			const size_t count = GetZoneCount();
+			for ( size_t i = 0; i < count; ++i )
+			{
+				const Stats stats = GetLastFrameStats( i );
+				ImGui::Text( u8"[%s] Alloc[%u] Bytes[%llu] Free[%u]", zoneNames[i], stats.allocCount, stats.allocBytes, stats.freeCount );
+			}
+
+			ImGui::TreePop();
+		}
+
+	#endif // USE_IMGUI
+	}
+}
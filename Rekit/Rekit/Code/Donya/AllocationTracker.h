@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Constant.h"	// Use DEBUG_MODE, DELETE_COPY_AND_ASSIGN macro.
+#include "UseImgui.h"	// Use USE_IMGUI macro.
+
+namespace Donya
+{
+	/// <summary>
+	/// Count the heap allocations per frame, by the hook of CRT's debug heap.<para></para>
+	/// The allocations are attributed to the zone that is opened by Zone class at the allocating thread.<para></para>
+	/// In release build, all functions are no-op and all stats are zero.
+	/// </summary>
+	namespace AllocationTracker
+	{
+		struct Stats
+		{
+			unsigned int		allocCount{};	// Contain the realloc.
+			unsigned long long	allocBytes{};
+			unsigned int		freeCount{};
+		};
+
+		/// <summary>
+		/// Install the hook. Donya::Init() calls this.
+		/// </summary>
+		void Init();
+		/// <summary>
+		/// Uninstall the hook. Donya::Uninit() calls this.
+		/// </summary>
+		void Uninit();
+
+		/// <summary>
+		/// Please call at first of each frame. Donya::SystemUpdate() calls this.<para></para>
+		/// The counts of current frame will become the last frame's stats.
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Returns the whole stats of last frame.
+		/// </summary>
+		Stats GetLastFrameStats();
+		/// <summary>
+		/// Returns the count of zones that were opened once at least. The zone of zero is "Untracked".
+		/// </summary>
+		size_t GetZoneCount();
+		/// <summary>
+		/// Returns nullptr if the index is out of range.
+		/// </summary>
+		const char *GetZoneName( size_t zoneIndex );
+		/// <summary>
+		/// Returns the stats of last frame at the zone.
+		/// </summary>
+		Stats GetLastFrameStats( size_t zoneIndex );
+		/// <summary>
+		/// Returns the index of the zone that is opened at this thread now. Pass it to the Zone of another thread for attributing the work to the same zone.
+		/// </summary>
+		size_t GetCurrentZoneIndex();
+
+		/// <summary>
+		/// The ForbidScope works only while this is enabled. Default is false.
+		/// </summary>
+		void SetForbidEnable( bool enable );
+		/// <summary>
+		/// The ForbidScope is ignored until the frames of "warmUpFrameCount" passed from this call.
+		/// </summary>
+		void ResetWarmUp( int warmUpFrameCount );
+		/// <summary>
+		/// If set true, break into the debugger when the violations are reported at BeginFrame(). Default is false.
+		/// </summary>
+		void SetBreakOnViolation( bool enable );
+		/// <summary>
+		/// Returns the total count of the allocations that occurred inside the ForbidScope.
+		/// </summary>
+		unsigned int GetViolationCount();
+
+		/// <summary>
+		/// Attribute the allocations of this thread to the "zoneName" while this is alive. The zones are nestable.<para></para>
+		/// Please pass a string literal, the pointer is stored. The count of zones is limited to 32, the overflowed zone is counted as "Untracked".
+		/// </summary>
+		class Zone
+		{
+		private:
+			size_t parentIndex;
+		public:
+			Zone( const char *zoneName );
+			/// <summary>
+			/// Open the zone of GetCurrentZoneIndex(). If the index is invalid, use the "Untracked".
+			/// </summary>
+			explicit Zone( size_t zoneIndex );
+			~Zone();
+			DELETE_COPY_AND_ASSIGN( Zone )
+		};
+
+		/// <summary>
+		/// Flag any allocation of this thread as the violation while this is alive, if enabled and after the warm-up.<para></para>
+		/// The allocations of other threads(e.g. the workers of a ThreadPool) are not flagged.<para></para>
+		/// The violations are reported to the debug output at next BeginFrame().
+		/// </summary>
+		class ForbidScope
+		{
+		private:
+			bool isActive;
+		public:
+			ForbidScope();
+			~ForbidScope();
+			DELETE_COPY_AND_ASSIGN( ForbidScope )
+		};
+
+	#if USE_IMGUI
+		/// <summary>
+		/// Show the stats of last frame by ImGui::TreeNode(). Please call between ImGui::Begin() and ImGui::End().
+		/// </summary>
+		void ShowImGuiNode( const char *nodeCaption );
+	#endif // USE_IMGUI
+	}
+}
@@ -0,0 +1,553 @@
+#include "AssetPipeline.h"
+
+#include <algorithm>
+#include <cctype>		// Use tolower().
+#include <mutex>
+#include <unordered_map>
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include "Benchmark.h"
+#include "Constant.h"	// Use scast macro.
+#include "Loader.h"
+#include "ObjParser.h"	// Use MappedFile.
+#include "Serializer.h"
+#include "ThreadPool.h"
+#include "Useful.h"		// Use IsExistFile().
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace AssetPipeline
+	{
+		namespace
+		{
+			struct FileStamp
+			{
+				unsigned long long size{};
+				unsigned long long writeTime{};
+			};
+
+		#if defined( _WIN32 )
+
+			bool FetchFileStamp( const std::string &filePath, FileStamp *pOutput )
+			{
+				WIN32_FILE_ATTRIBUTE_DATA attributes{};
+				if ( !GetFileAttributesExA( filePath.c_str(), GetFileExInfoStandard, &attributes ) ) { return false; }
+				// else
+				if ( attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY ) { return false; }
+				// else
+
+				pOutput->size		= ( scast<unsigned long long>( attributes.nFileSizeHigh ) << 32 ) | attributes.nFileSizeLow;
+				pOutput->writeTime	= ( scast<unsigned long long>( attributes.ftLastWriteTime.dwHighDateTime ) << 32 ) | attributes.ftLastWriteTime.dwLowDateTime;
+				return true;
+			}
+
+			void EnumerateRecursively( const std::string &directory, std::vector<std::string> *pOutput )
+			{
+				WIN32_FIND_DATAA data{};
+				HANDLE hFind = FindFirstFileA( ( directory + "/*" ).c_str(), &data );
+				if ( hFind == INVALID_HANDLE_VALUE ) { return; }
+				// else
+
+				do
+				{
+					const std::string name{ data.cFileName };
+					if ( name == "." || name == ".." ) { continue; }
+					// else
+
+					const std::string path = directory + "/" + name;
+					if ( data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY )
+					{
+						EnumerateRecursively( path, pOutput );
+					}
+					else if ( IsSourceAsset( path ) )
+					{
+						pOutput->emplace_back( path );
+					}
+				}
+				while ( FindNextFileA( hFind, &data ) );
+
+				FindClose( hFind );
+			}
+
+		#else
+
+			bool FetchFileStamp( const std::string &filePath, FileStamp *pOutput )
+			{
+				struct stat status{};
+				if ( stat( filePath.c_str(), &status ) != 0 ) { return false; }
+				// else
+				if ( !S_ISREG( status.st_mode ) ) { return false; }
+				// else
+
+				pOutput->size		= scast<unsigned long long>( status.st_size );
+				pOutput->writeTime	= scast<unsigned long long>( status.st_mtime );
+				return true;
+			}
+
+			void EnumerateRecursively( const std::string &directory, std::vector<std::string> *pOutput )
+			{
+				DIR *pDir = opendir( directory.c_str() );
+				if ( !pDir ) { return; }
+				// else
+
+				while ( const dirent *pEntry = readdir( pDir ) )
+				{
+					const std::string name{ pEntry->d_name };
+					if ( name == "." || name == ".." ) { continue; }
+					// else
+
+					const std::string path = directory + "/" + name;
+
+					struct stat status{};
+					if ( stat( path.c_str(), &status ) != 0 ) { continue; }
+					// else
+
+					if ( S_ISDIR( status.st_mode ) )
+					{
+						EnumerateRecursively( path, pOutput );
+					}
+					else if ( IsSourceAsset( path ) )
+					{
+						pOutput->emplace_back( path );
+					}
+				}
+
+				closedir( pDir );
+			}
+
+		#endif // _WIN32
+
+			std::string ReplaceSeparators( std::string path )
+			{
+				std::replace( path.begin(), path.end(), '\\', '/' );
+				return path;
+			}
+
+			/// <summary>
+			/// Returns true if the source and the settings are same as the "entry", and the binary exists.
+			/// If the content is same but the stamp is not, the stamp of "pEntry" is updated.<para></para>
+			/// The "pHashed" is set to true if the "pHash" is set by hashing the source.
+			/// </summary>
+			bool IsUpToDate( const std::string &sourcePath, const FileStamp &stamp, bool compressMotions, Entry *pEntry, unsigned long long *pHash, bool *pHashed )
+			{
+				*pHashed = false;
+
+				if ( pEntry->pipelineVersion   != PIPELINE_VERSION ) { return false; }
+				if ( pEntry->compressedMotions != compressMotions  ) { return false; }
+				if ( !Donya::IsExistFile( pEntry->binaryPath )     ) { return false; }
+				// else
+
+				if ( pEntry->sourceSize == stamp.size && pEntry->sourceWriteTime == stamp.writeTime ) { return true; }
+				// else
+				if ( pEntry->sourceSize != stamp.size ) { return false; }
+				// else
+
+				// The write time is changed but the content may be same(e.g. checked out again).
+				if ( !HashFile( sourcePath, pHash ) ) { return false; }
+				// else
+				*pHashed = true;
+				if ( *pHash != pEntry->sourceHash ) { return false; }
+				// else
+
+				pEntry->sourceWriteTime = stamp.writeTime;
+				return true;
+			}
+
+			static std::string	manifestPath{ "./Data/AssetManifest.bin" };
+			static Manifest		runtimeManifest{};
+			static bool			runtimeManifestWasRead = false;
+			static CacheStats	cacheStats{};
+			static std::mutex	runtimeMutex{};
+		}
+
+		bool Manifest::LoadFile( const std::string &filePath )
+		{
+			entries.clear();
+			if ( !Donya::IsExistFile( filePath ) ) { return false; }
+			// else
+
+			Donya::Serializer seria;
+			if ( !seria.Load( Donya::Serializer::Extension::BINARY, filePath.c_str(), SERIAL_ID, *this ) )
+			{
+				entries.clear();
+				return false;
+			}
+			// else
+
+			auto Less = []( const Entry &lhs, const Entry &rhs ) { return lhs.sourcePath < rhs.sourcePath; };
+			if ( !std::is_sorted( entries.begin(), entries.end(), Less ) )
+			{
+				std::sort( entries.begin(), entries.end(), Less );
+			}
+			return true;
+		}
+		void Manifest::SaveFile( const std::string &filePath ) const
+		{
+			Donya::Serializer seria;
+			seria.Save( Donya::Serializer::Extension::BINARY, filePath.c_str(), SERIAL_ID, *this );
+		}
+
+		const Entry *Manifest::Find( const std::string &sourcePath ) const
+		{
+			const std::string key = MakeManifestKey( sourcePath );
+			auto found = std::lower_bound
+			(
+				entries.begin(), entries.end(), key,
+				[]( const Entry &element, const std::string &value ) { return element.sourcePath < value; }
+			);
+			return ( found != entries.end() && found->sourcePath == key ) ? &( *found ) : nullptr;
+		}
+		void Manifest::Register( const Entry &entry )
+		{
+			Entry normalized = entry;
+			normalized.sourcePath = MakeManifestKey( entry.sourcePath );
+
+			auto found = std::lower_bound
+			(
+				entries.begin(), entries.end(), normalized.sourcePath,
+				[]( const Entry &element, const std::string &value ) { return element.sourcePath < value; }
+			);
+			if ( found != entries.end() && found->sourcePath == normalized.sourcePath )
+			{
+				*found = std::move( normalized );
+				return;
+			}
+			// else
+
+			entries.insert( found, std::move( normalized ) );
+		}
+		void Manifest::Unregister( const std::string &sourcePath )
+		{
+			const Entry *pFound = Find( sourcePath );
+			if ( !pFound ) { return; }
+			// else
+
+			entries.erase( entries.begin() + ( pFound - entries.data() ) );
+		}
+
+		std::string MakeManifestKey( const std::string &sourcePath )
+		{
+			std::string key = ReplaceSeparators( sourcePath );
+			while ( key.compare( 0, 2, "./" ) == 0 )
+			{
+				key.erase( 0, 2 );
+			}
+			for ( auto &c : key )
+			{
+				c = scast<char>( tolower( scast<unsigned char>( c ) ) );
+			}
+			return key;
+		}
+		std::string MakeBinaryPath( const std::string &sourcePath )
+		{
+			std::string path = ReplaceSeparators( sourcePath );
+
+			const size_t extPos   = path.find_last_of( '.' );
+			const size_t slashPos = path.find_last_of( '/' );
+			if ( extPos == std::string::npos || ( slashPos != std::string::npos && extPos < slashPos ) )
+			{
+				return path + ".bin";
+			}
+			// else
+
+			return path.substr( 0, extPos ) + ".bin";
+		}
+		bool IsSourceAsset( const std::string &filePath )
+		{
+			if ( filePath.size() < 4 ) { return false; }
+			// else
+
+			std::string ext = filePath.substr( filePath.size() - 4 );
+			for ( auto &c : ext )
+			{
+				c = scast<char>( tolower( scast<unsigned char>( c ) ) );
+			}
+			return ( ext == ".fbx" || ext == ".obj" );
+		}
+
+		bool HashFile( const std::string &filePath, unsigned long long *pOutput )
+		{
+			ObjParser::MappedFile file{};
+			if ( !file.Open( filePath ) ) { return false; }
+			// else
+
+			// FNV-1a.
+			unsigned long long hash = 14695981039346656037ULL;
+			const unsigned char *pBytes = reinterpret_cast<const unsigned char *>( file.GetData() );
+			const size_t byteSize = file.GetSize();
+			for ( size_t i = 0; i < byteSize; ++i )
+			{
+				hash ^= pBytes[i];
+				hash *= 1099511628211ULL;
+			}
+
+			*pOutput = hash;
+			return true;
+		}
+
+		std::vector<std::string> EnumerateSourceAssets( const std::string &directory )
+		{
+			std::vector<std::string> paths{};
+			EnumerateRecursively( ReplaceSeparators( directory ), &paths );
+
+			// The order of the file system is not specified.
+			std::sort( paths.begin(), paths.end() );
+			return paths;
+		}
+
+		ConvertReport ConvertChangedAssets( const std::vector<std::string> &sourcePaths, bool compressMotions )
+		{
+			ConvertReport report{};
+
+			std::string currentManifestPath{};
+			{
+				std::lock_guard<std::mutex> lock( runtimeMutex );
+				currentManifestPath = manifestPath;
+			}
+
+			Manifest manifest{};
+			manifest.LoadFile( currentManifestPath );
+
+			enum class State { UpToDate, Changed, Failed };
+			struct Work
+			{
+				State				state = State::Changed;
+				Entry				entry{};
+				std::string			error{};
+			};
+			std::vector<Work> works( sourcePaths.size() );
+			for ( size_t i = 0; i < works.size(); ++i )
+			{
+				const Entry *pRegistered = manifest.Find( sourcePaths[i] );
+				if ( pRegistered ) { works[i].entry = *pRegistered; }
+			}
+
+			// The sources that differ only by the extension(e.g. foo.fbx and foo.obj) make the same binary.
+			// These can not be converted concurrently, and the result depends on which finished last, so report these as the errors.
+			{
+				std::unordered_map<std::string, std::vector<size_t>> sourcesPerBinary{};
+				for ( size_t i = 0; i < sourcePaths.size(); ++i )
+				{
+					sourcesPerBinary[MakeManifestKey( MakeBinaryPath( sourcePaths[i] ) )].emplace_back( i );
+				}
+				for ( const auto &it : sourcesPerBinary )
+				{
+					const auto &indices = it.second;
+					if ( indices.size() < 2U ) { continue; }
+					// else
+
+					std::string sharingSources{};
+					for ( const size_t index : indices )
+					{
+						sharingSources += ( sharingSources.empty() ) ? sourcePaths[index] : ", " + sourcePaths[index];
+					}
+					for ( const size_t index : indices )
+					{
+						works[index].state = State::Failed;
+						works[index].error = "The binary [" + MakeBinaryPath( sourcePaths[index] ) + "] is shared by [" + sharingSources + "], please rename these.";
+					}
+				}
+			}
+
+			Donya::ThreadPool pool{};
+			Benchmark timer{};
+
+			// Find the changed sources. Only the jobs of these are hashed.
+			timer.Begin();
+			pool.ParallelFor
+			(
+				works.size(),
+				[&]( size_t i )
+				{
+					const std::string &sourcePath = sourcePaths[i];
+					Work &work = works[i];
+					if ( work.state == State::Failed ) { return; }
+					// else
+
+					FileStamp stamp{};
+					if ( !FetchFileStamp( sourcePath, &stamp ) )
+					{
+						work.state = State::Failed;
+						work.error = "The source is not found.";
+						return;
+					}
+					// else
+
+					unsigned long long hash = 0;
+					bool hashed = false;
+					if ( !work.entry.sourcePath.empty() )
+					{
+						if ( IsUpToDate( sourcePath, stamp, compressMotions, &work.entry, &hash, &hashed ) )
+						{
+							work.state = State::UpToDate;
+							return;
+						}
+					}
+					// else
+
+					if ( !hashed && !HashFile( sourcePath, &hash ) )
+					{
+						work.state = State::Failed;
+						work.error = "The source can not be read.";
+						return;
+					}
+					// else
+
+					work.entry.sourcePath			= sourcePath;
+					work.entry.binaryPath			= MakeBinaryPath( sourcePath );
+					work.entry.sourceHash			= hash;
+					work.entry.sourceSize			= stamp.size;
+					work.entry.sourceWriteTime		= stamp.writeTime;
+					work.entry.pipelineVersion		= PIPELINE_VERSION;
+					work.entry.compressedMotions	= compressMotions;
+				}
+			);
+			report.hashSeconds = timer.End();
+
+			// Convert the changed sources.
+			timer.Begin();
+			pool.ParallelFor
+			(
+				works.size(),
+				[&]( size_t i )
+				{
+					Work &work = works[i];
+					if ( work.state != State::Changed ) { return; }
+					// else
+
+					Donya::Loader loader{};
+					std::string loadError{};
+					if ( !loader.Load( sourcePaths[i], &loadError, /* outputDebugProgress = */ false, /* allowCachedBinary = */ false ) )
+					{
+						work.state = State::Failed;
+						work.error = ( loadError.empty() ) ? "The source can not be loaded, is the FBX-SDK enabled?" : loadError;
+						return;
+					}
+					// else
+
+					if ( compressMotions )
+					{
+						// The source motions are kept, because nothing samples the compressed motions at runtime yet.
+						loader.CompressMotions( Loader::CompressedMotion::Tolerance{}, /* discardSourceMotions = */ false );
+					}
+
+					loader.SaveByCereal( work.entry.binaryPath );
+					if ( !Donya::IsExistFile( work.entry.binaryPath ) )
+					{
+						work.state = State::Failed;
+						work.error = "The binary can not be saved.";
+						return;
+					}
+				}
+			);
+			report.convertSeconds = timer.End();
+
+			for ( size_t i = 0; i < works.size(); ++i )
+			{
+				const Work &work = works[i];
+				switch ( work.state )
+				{
+				case State::UpToDate:
+					report.upToDateCount++;
+					manifest.Register( work.entry );	// The stamp may be updated.
+					break;
+				case State::Changed:
+					report.convertedCount++;
+					manifest.Register( work.entry );
+					break;
+				case State::Failed:
+					report.failedCount++;
+					report.errors.emplace_back( "[" + sourcePaths[i] + "] : " + work.error );
+					manifest.Unregister( sourcePaths[i] );
+					break;
+				default: break;
+				}
+			}
+
+			manifest.SaveFile( currentManifestPath );
+
+			std::lock_guard<std::mutex> lock( runtimeMutex );
+			if ( currentManifestPath == manifestPath )
+			{
+				runtimeManifest			= std::move( manifest );
+				runtimeManifestWasRead	= true;
+			}
+
+			return report;
+		}
+
+		void SetManifestPath( const std::string &filePath )
+		{
+			std::lock_guard<std::mutex> lock( runtimeMutex );
+			manifestPath			= filePath;
+			runtimeManifestWasRead	= false;
+		}
+		bool FindCachedBinary( const std::string &sourcePath, std::string *pBinaryPath )
+		{
+			// Copy the entry, because the checking may hash the source, so it is done out of the lock.
+			Entry entry{};
+			{
+				std::lock_guard<std::mutex> lock( runtimeMutex );
+
+				if ( !runtimeManifestWasRead )
+				{
+					runtimeManifest.LoadFile( manifestPath );
+					runtimeManifestWasRead = true;
+				}
+
+				const Entry *pFound = runtimeManifest.Find( sourcePath );
+				if ( !pFound )
+				{
+					cacheStats.missCount++;
+					return false;
+				}
+				// else
+				entry = *pFound;
+			}
+
+			bool isUpToDate = ( entry.pipelineVersion == PIPELINE_VERSION && Donya::IsExistFile( entry.binaryPath ) );
+			bool isStampUpdated = false;
+
+			FileStamp stamp{};
+			if ( isUpToDate && FetchFileStamp( sourcePath, &stamp ) )
+			{
+				const unsigned long long previousWriteTime = entry.sourceWriteTime;
+				unsigned long long hash = 0;
+				bool hashed = false;
+				isUpToDate		= IsUpToDate( sourcePath, stamp, entry.compressedMotions, &entry, &hash, &hashed );
+				isStampUpdated	= ( isUpToDate && entry.sourceWriteTime != previousWriteTime );
+			}
+			// else the source is not shipped, so trust the binary.
+
+			std::lock_guard<std::mutex> lock( runtimeMutex );
+			if ( !isUpToDate )
+			{
+				cacheStats.missCount++;
+				return false;
+			}
+			// else
+
+			// Remember the new stamp for skipping the hashing at next time, it is saved by the next conversion.
+			if ( isStampUpdated ) { runtimeManifest.Register( entry ); }
+
+			*pBinaryPath = entry.binaryPath;
+			cacheStats.hitCount++;
+			return true;
+		}
+
+		CacheStats GetCacheStats()
+		{
+			std::lock_guard<std::mutex> lock( runtimeMutex );
+			return cacheStats;
+		}
+	}
+}
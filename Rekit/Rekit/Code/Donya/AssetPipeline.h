@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>	// Use size_t.
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#undef max
+#undef min
+
+#include "cereal/cereal.hpp"
+#include "cereal/types/string.hpp"
+#include "cereal/types/vector.hpp"
+
+namespace Donya
+{
+	/// <summary>
+	/// Convert the source assets(.fbx, .obj) to the binary of Loader(.bin), only when the content of the source is changed.<para></para>
+	/// The manifest remembers the hash of each source, so the Loader can serve the converted binary instead of parsing the source.
+	/// </summary>
+	namespace AssetPipeline
+	{
+		/// <summary>
+		/// Increase when the conversion produces the different binary, then all sources are converted again.
+		/// </summary>
+		constexpr unsigned int PIPELINE_VERSION = 2U;	// 2 : The source motions are kept with the compressed motions.
+
+		/// <summary>
+		/// A converted source. The paths are relative to the working directory, and the "sourcePath" is normalized by MakeManifestKey().
+		/// </summary>
+		struct Entry
+		{
+			std::string			sourcePath{};
+			std::string			binaryPath{};
+			unsigned long long	sourceHash{};		// FNV-1a of the content.
+			unsigned long long	sourceSize{};
+			unsigned long long	sourceWriteTime{};	// Use for skipping the hashing. The unit depends on the platform.
+			unsigned int		pipelineVersion{};
+			bool				compressedMotions{};
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( sourcePath ),
+					CEREAL_NVP( binaryPath ),
+					CEREAL_NVP( sourceHash ),
+					CEREAL_NVP( sourceSize ),
+					CEREAL_NVP( sourceWriteTime ),
+					CEREAL_NVP( pipelineVersion ),
+					CEREAL_NVP( compressedMotions )
+				);
+				if ( 1 <= version )
+				{
+					// archive( CEREAL_NVP( x ) );
+				}
+			}
+		};
+
+		/// <summary>
+		/// The entries are sorted by the source path.
+		/// </summary>
+		class Manifest
+		{
+		private:
+			static constexpr const char *SERIAL_ID = "AssetManifest";
+		private:
+			std::vector<Entry> entries;
+		public:
+			Manifest() : entries() {}
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive( CEREAL_NVP( entries ) );
+				if ( 1 <= version )
+				{
+					// archive( CEREAL_NVP( x ) );
+				}
+			}
+		public:
+			/// <summary>
+			/// Returns false if the file is not found, then the entries are cleared.
+			/// </summary>
+			bool LoadFile( const std::string &manifestPath );
+			void SaveFile( const std::string &manifestPath ) const;
+
+			/// <summary>
+			/// Returns nullptr if the source is not registered. The "sourcePath" is normalized in here.
+			/// </summary>
+			const Entry *Find( const std::string &sourcePath ) const;
+			/// <summary>
+			/// Add or overwrite the entry of the "entry.sourcePath".
+			/// </summary>
+			void Register( const Entry &entry );
+			void Unregister( const std::string &sourcePath );
+
+			const std::vector<Entry> &GetEntries() const { return entries; }
+		};
+
+		/// <summary>
+		/// Returns the path that is used as the key of the manifest:
+		/// the separators are "/", the leading "./" is removed, and the letters are lower case.
+		/// </summary>
+		std::string MakeManifestKey( const std::string &sourcePath );
+		/// <summary>
+		/// Returns the "sourcePath" that the extension is replaced to ".bin".
+		/// </summary>
+		std::string MakeBinaryPath( const std::string &sourcePath );
+		/// <summary>
+		/// Returns true if the extension is .fbx or .obj(the case is ignored).
+		/// </summary>
+		bool IsSourceAsset( const std::string &filePath );
+
+		/// <summary>
+		/// Hash the content of the file by FNV-1a(64 bits). Returns false if the file can not be opened.
+		/// </summary>
+		bool HashFile( const std::string &filePath, unsigned long long *pOutput );
+
+		/// <summary>
+		/// Collect the source assets in the "directory" and its sub-directories. The paths start with the "directory".
+		/// </summary>
+		std::vector<std::string> EnumerateSourceAssets( const std::string &directory );
+
+		struct ConvertReport
+		{
+			size_t						upToDateCount{};
+			size_t						convertedCount{};
+			size_t						failedCount{};
+			double						hashSeconds{};
+			double						convertSeconds{};
+			std::vector<std::string>	errors{};		// "[source path] : message".
+		};
+		/// <summary>
+		/// Convert the sources that are changed from the manifest, or that the binary is missing, and save the manifest.<para></para>
+		/// The hashing and the conversion are run in parallel. The parsing by the FBX-SDK is serialized in the Loader, so it is not accelerated.<para></para>
+		/// The sources that make the same binary path(e.g. foo.fbx and foo.obj) are not converted, and reported as failed.<para></para>
+		/// If "compressMotions" is true, the motions are saved also as Loader::CompressedMotion. The source motions are kept, because nothing samples the compressed motions at runtime yet.
+		/// </summary>
+		ConvertReport ConvertChangedAssets( const std::vector<std::string> &sourcePaths, bool compressMotions = true );
+
+		/// <summary>
+		/// Set the path of manifest file. The default is "./Data/AssetManifest.bin".
+		/// </summary>
+		void SetManifestPath( const std::string &filePath );
+		/// <summary>
+		/// Returns true and set the binary path if the converted binary of the "sourcePath" is up to date.<para></para>
+		/// The source is compared by the size and the write time first, then by the hash only if these differ.
+		/// If the source does not exist(e.g. it is not shipped), the registered binary is trusted.<para></para>
+		/// The manifest is read at first call. This is thread-safe.
+		/// </summary>
+		bool FindCachedBinary( const std::string &sourcePath, std::string *pBinaryPath );
+
+		struct CacheStats
+		{
+			unsigned int hitCount{};
+			unsigned int missCount{};
+		};
+		/// <summary>
+		/// Returns the total count of FindCachedBinary() results.
+		/// </summary>
+		CacheStats GetCacheStats();
+	}
+}
+
+CEREAL_CLASS_VERSION( Donya::AssetPipeline::Entry,		0 )
+CEREAL_CLASS_VERSION( Donya::AssetPipeline::Manifest,	0 )
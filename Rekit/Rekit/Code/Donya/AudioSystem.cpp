@@ -566,29 +566,64 @@ namespace Donya
 		// else
 	}
 
-	size_t AudioSystem::Load( std::string fileName, bool isEnableLoop )
+	size_t MakeSoundHandle( const std::string &fileName )
 	{
 		size_t hash = std::hash<std::string>()( fileName );
 		if ( hash == NULL )	// NULL using error code.
 		{
 			hash = 1;
 		}
+		return hash;
+	}
+
+	size_t AudioSystem::Load( std::string fileName, bool isEnableLoop, bool isStreaming )
+	{
+		const size_t hash = MakeSoundHandle( fileName );
 
 		decltype( sounds )::iterator it = sounds.find( hash );
 		if ( it != sounds.end() ) { return it->first; } // it->first == hash
 		// else
 
+		return Register( Prepare( fileName, isEnableLoop, isStreaming ) );
+	}
+	AudioSystem::PreparedSound AudioSystem::Prepare( const std::string &fileName, bool isEnableLoop, bool isStreaming ) const
+	{
+		PreparedSound prepared{};
+		prepared.fileName = fileName;
+
 		FMOD_RESULT fr = FMOD_OK;
 		FMOD_MODE mode = FMOD_DEFAULT;
 		mode |= ( isEnableLoop ) ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF;
+		if ( isStreaming ) { mode |= FMOD_CREATESTREAM; }
 
+		// The FMOD's API is thread-safe, so this can be called from the loading threads.
 		FMOD::Sound *pSound = nullptr;
 		fr = pLowSystem->createSound( fileName.c_str(), mode, nullptr, &pSound );
-		if ( OutputDebugErrorStringIfFMODFailed( fr ) ) { return NULL; }
+		if ( OutputDebugErrorStringIfFMODFailed( fr ) ) { return prepared; }
+		// else
+
+		prepared.pSound = pSound;
+		return prepared;
+	}
+	size_t AudioSystem::Register( PreparedSound &&prepared )
+	{
+		if ( !prepared.pSound ) { return NULL; }
+		// else
+
+		const size_t hash = MakeSoundHandle( prepared.fileName );
+
+		decltype( sounds )::iterator it = sounds.find( hash );
+		if ( it != sounds.end() )
+		{
+			prepared.pSound->release();
+			prepared.pSound = nullptr;
+			return it->first;
+		}
 		// else
 
-		sounds.insert( std::make_pair( hash, pSound ) );
+		sounds.insert( std::make_pair( hash, prepared.pSound ) );
 		channels.insert( std::make_pair( hash, std::make_unique<Channels>() ) );
+		prepared.pSound = nullptr;
 
 		return hash;
 	}
@@ -2,6 +2,7 @@
 #define INCLUDED_DONYA_AUDIO_SYSTEM_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 namespace FMOD
@@ -23,6 +24,15 @@ namespace Donya
 	/// </summary>
 	class AudioSystem
 	{
+	public:
+		/// <summary>
+		/// The sound that is created but not registered yet. Made by Prepare(), and consumed by Register().
+		/// </summary>
+		struct PreparedSound
+		{
+			std::string		fileName{};
+			FMOD::Sound		*pSound{ nullptr };	// Null if the creation failed.
+		};
 	private:
 		class Channels;
 	private:
@@ -49,9 +59,20 @@ namespace Donya
 		/// Please set relative-path or whole-path to fileName.<para></para>
 		/// If load successed, returns unique handle of sound.<para></para>
 		/// If load failed, returns NULL. <para></para>
-		/// If fileName is already loaded, returns that loaded handle.
+		/// If fileName is already loaded, returns that loaded handle.<para></para>
+		/// If "isStreaming" is true, the sound is decoded from the file while playing(FMOD_CREATESTREAM), so the loading is fast and the memory is small.
+		/// A streaming sound can be played by one channel at once.
+		/// </summary>
+		size_t Load( std::string fileName, bool isEnableLoop, bool isStreaming = false );
+		/// <summary>
+		/// The first half of Load(). This opens and decodes the file, and can be called from any thread.
+		/// </summary>
+		PreparedSound Prepare( const std::string &fileName, bool isEnableLoop, bool isStreaming = false ) const;
+		/// <summary>
+		/// The second half of Load(). Please call from the thread that uses this.<para></para>
+		/// If the preparation failed, returns NULL. If the file name is already loaded, the prepared one is released and returns that loaded handle.
 		/// </summary>
-		size_t Load( std::string fileName, bool isEnableLoop );
+		size_t Register( PreparedSound &&prepared );
 
 		/// <summary>
 		/// Play the sound identified by handle.<para></para>
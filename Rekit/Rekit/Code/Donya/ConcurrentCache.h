@@ -0,0 +1,343 @@
+#pragma once
+
+#include <array>
+#include <cstddef>	// Use size_t.
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Constant.h"	// Use scast macro.
+
+namespace Donya
+{
+	/// <summary>
+	/// The map of loaded resources that can be shared by the loading threads.<para></para>
+	/// The keys are distributed to some shards by the hash, and each shard has own lock, so the threads that request the different keys rarely wait each other.
+	/// The lock is held only while finding or registering, the creation is done out of the lock.<para></para>
+	/// If a key is requested while another thread is creating it, the requester waits for that result instead of creating it twice.<para></para>
+	/// The returned value(ValuePtr) is a handle, the value is alive while a handle is held even if the key is erased from the cache.
+	/// </summary>
+	template<typename Key, typename Value, typename Hasher = std::hash<Key>, size_t SHARD_COUNT = 16U>
+	class ConcurrentCache
+	{
+		static_assert( 0 < SHARD_COUNT, "The SHARD_COUNT must be greater than zero." );
+	public:
+		using ValuePtr = std::shared_ptr<const Value>;
+
+		/// <summary>
+		/// Use for the accounting of the values. All members are optional.
+		/// </summary>
+		struct Tracker
+		{
+			std::function<size_t( const Value & )>				measure;	// Returns the byte size of a value.
+			std::function<unsigned long long()>					now;		// Returns the current time for the "lastUsed" of entries.
+			std::function<unsigned long long( const Value & )>	touched;	// Returns the time that the value was used out of the cache(e.g. drawn). The later one of this and "lastUsed" is reported.
+			std::function<void( long long bytes, int count )>	onChanged;	// Called with the difference when a value is registered or erased.
+		};
+	private:
+		struct Entry
+		{
+			std::shared_future<ValuePtr>	future{};
+			unsigned long long				serial{};	// Use for identifying the entry that was registered by a creator.
+			unsigned long long				lastUsed{};
+			size_t							byteSize{};
+			bool							isCounted{};	// True if the value was reported to the Tracker::onChanged.
+			bool							isPinned{};		// True if the value was handed out without a handle.
+		};
+		struct Shard
+		{
+			std::mutex								mutex{};
+			std::unordered_map<Key, Entry, Hasher>	entries{};
+			unsigned long long						nextSerial = 0;
+		};
+	private:
+		std::array<Shard, SHARD_COUNT>	shards;
+		Hasher							hasher;
+		Tracker							tracker;
+	public:
+		ConcurrentCache() : shards(), hasher(), tracker() {}
+		explicit ConcurrentCache( const Tracker &tracker ) : shards(), hasher(), tracker( tracker ) {}
+		ConcurrentCache( const ConcurrentCache & ) = delete;
+		ConcurrentCache &operator = ( const ConcurrentCache & ) = delete;
+	public:
+		/// <summary>
+		/// Returns the cached value, or the value that is created by "create" if the key is not registered.<para></para>
+		/// The "create" is called as bool( Value *pOutput ), and returns false if failed. The failed key is not registered, so the next request tries again.<para></para>
+		/// Returns nullptr if the creation is failed, also to the waiting requesters.
+		/// Please do not request the same key in the "create", it waits for itself.
+		/// </summary>
+		template<typename Creator>
+		ValuePtr FindOrCreate( const Key &key, Creator &&create )
+		{
+			Shard &shard = GetShard( key );
+
+			std::promise<ValuePtr>			promise{};
+			std::shared_future<ValuePtr>	future{};
+			unsigned long long				serial = 0;
+			{
+				std::lock_guard<std::mutex> lock( shard.mutex );
+
+				auto found = shard.entries.find( key );
+				if ( found != shard.entries.end() )
+				{
+					future = found->second.future;
+					found->second.lastUsed = Now();
+				}
+				else
+				{
+					serial = ++shard.nextSerial;
+					future = promise.get_future().share();
+
+					Entry entry{};
+					entry.future	= future;
+					entry.serial	= serial;
+					entry.lastUsed	= Now();
+					shard.entries.emplace( key, std::move( entry ) );
+				}
+			}
+
+			// Wait out of the lock, the other keys of this shard are not blocked.
+			if ( !serial ) { return future.get(); }
+			// else
+
+			ValuePtr pCreated{};
+			try
+			{
+				auto pValue = std::make_shared<Value>();
+				if ( create( pValue.get() ) )
+				{
+					pCreated = std::move( pValue );
+				}
+			}
+			catch ( ... )
+			{
+				EraseIfSame( &shard, key, serial );
+				promise.set_value( nullptr );
+				throw;
+			}
+
+			if ( pCreated )
+			{
+				Count( &shard, key, serial, *pCreated );
+			}
+			else
+			{
+				// Remove before the notification, so the requester that is woken up does not find the failed entry.
+				EraseIfSame( &shard, key, serial );
+			}
+			promise.set_value( pCreated );
+			return pCreated;
+		}
+
+		/// <summary>
+		/// Returns nullptr if the key is not registered. If the key is in creating, wait for it.
+		/// </summary>
+		ValuePtr Find( const Key &key )
+		{
+			Shard &shard = GetShard( key );
+
+			std::shared_future<ValuePtr> future{};
+			{
+				std::lock_guard<std::mutex> lock( shard.mutex );
+
+				auto found = shard.entries.find( key );
+				if ( found == shard.entries.end() ) { return nullptr; }
+				// else
+				future = found->second.future;
+				found->second.lastUsed = Now();
+			}
+
+			return future.get();
+		}
+
+		/// <summary>
+		/// The value is released when the last user releases it. The creation in progress is not canceled, but the result is not registered.
+		/// </summary>
+		void Erase( const Key &key )
+		{
+			Shard &shard = GetShard( key );
+
+			std::lock_guard<std::mutex> lock( shard.mutex );
+
+			auto found = shard.entries.find( key );
+			if ( found == shard.entries.end() ) { return; }
+			// else
+
+			Uncount( found->second );
+			shard.entries.erase( found );
+		}
+		void Clear()
+		{
+			for ( auto &shard : shards )
+			{
+				std::lock_guard<std::mutex> lock( shard.mutex );
+				for ( const auto &it : shard.entries )
+				{
+					Uncount( it.second );
+				}
+				shard.entries.clear();
+			}
+		}
+
+		/// <summary>
+		/// Exclude the entry from ForEachUnused() and EraseIfUnused(), for the value that is handed out as a raw pointer that the use count can not see.<para></para>
+		/// The pinned entry is still removed by Erase() and Clear(). Does nothing if the key is not registered.
+		/// </summary>
+		void Pin( const Key &key )
+		{
+			Shard &shard = GetShard( key );
+
+			std::lock_guard<std::mutex> lock( shard.mutex );
+
+			auto found = shard.entries.find( key );
+			if ( found == shard.entries.end() ) { return; }
+			// else
+			found->second.isPinned = true;
+		}
+
+		/// <summary>
+		/// Call the "visit" as void( unsigned long long id, unsigned long long lastUsed, size_t byteSize ) for each created value that is not held by the others.<para></para>
+		/// The shard is locked while visiting, so please do not call the other methods in the "visit".
+		/// </summary>
+		template<typename Visitor>
+		void ForEachUnused( Visitor &&visit )
+		{
+			for ( size_t i = 0; i < SHARD_COUNT; ++i )
+			{
+				Shard &shard = shards[i];
+				std::lock_guard<std::mutex> lock( shard.mutex );
+				for ( const auto &it : shard.entries )
+				{
+					const Entry &entry = it.second;
+					if ( !IsUnused( entry ) ) { continue; }
+					// else
+
+					visit( MakeId( i, entry.serial ), CalcLastUsed( entry ), entry.byteSize );
+				}
+			}
+		}
+		/// <summary>
+		/// Erase the entry of the "id" that is passed by ForEachUnused(), if it is still not held by the others.<para></para>
+		/// Returns the byte size of the erased value, or zero if not erased.
+		/// </summary>
+		size_t EraseIfUnused( unsigned long long id )
+		{
+			const size_t				shardIndex	= scast<size_t>( id % SHARD_COUNT );
+			const unsigned long long	serial		= id / SHARD_COUNT;
+
+			Shard &shard = shards[shardIndex];
+			std::lock_guard<std::mutex> lock( shard.mutex );
+			for ( auto it = shard.entries.begin(); it != shard.entries.end(); ++it )
+			{
+				if ( it->second.serial != serial ) { continue; }
+				// else
+				if ( !IsUnused( it->second ) ) { return 0; }
+				// else
+
+				const size_t byteSize = it->second.byteSize;
+				Uncount( it->second );
+				shard.entries.erase( it );
+				return byteSize;
+			}
+
+			return 0;
+		}
+
+		/// <summary>
+		/// Returns the count of registered keys, the keys in creating are also contained.
+		/// </summary>
+		size_t Size()
+		{
+			size_t sum = 0;
+			for ( auto &shard : shards )
+			{
+				std::lock_guard<std::mutex> lock( shard.mutex );
+				sum += shard.entries.size();
+			}
+			return sum;
+		}
+	private:
+		unsigned long long Now() const
+		{
+			return ( tracker.now ) ? tracker.now() : 0;
+		}
+		unsigned long long CalcLastUsed( const Entry &entry ) const
+		{
+			if ( !tracker.touched || !entry.isCounted ) { return entry.lastUsed; }
+			// else
+
+			const unsigned long long touched = tracker.touched( *entry.future.get() );
+			return ( entry.lastUsed < touched ) ? touched : entry.lastUsed;
+		}
+		static unsigned long long MakeId( size_t shardIndex, unsigned long long serial )
+		{
+			return serial * SHARD_COUNT + shardIndex;
+		}
+		/// <summary>
+		/// Returns true if the value is created, and only the cache holds it.
+		/// </summary>
+		static bool IsUnused( const Entry &entry )
+		{
+			if ( !entry.isCounted || entry.isPinned ) { return false; }
+			// else
+
+			// The counted entry is ready, so the get() does not wait.
+			return ( entry.future.get().use_count() == 1 );
+		}
+
+		/// <summary>
+		/// Measure the created value, and report it if the entry of "serial" is still registered.
+		/// </summary>
+		void Count( Shard *pShard, const Key &key, unsigned long long serial, const Value &created )
+		{
+			const size_t byteSize = ( tracker.measure ) ? tracker.measure( created ) : 0;
+
+			std::lock_guard<std::mutex> lock( pShard->mutex );
+
+			auto found = pShard->entries.find( key );
+			if ( found == pShard->entries.end() || found->second.serial != serial ) { return; }
+			// else
+
+			found->second.byteSize	= byteSize;
+			found->second.isCounted	= true;
+			if ( tracker.onChanged ) { tracker.onChanged( scast<long long>( byteSize ), 1 ); }
+		}
+		void Uncount( const Entry &entry )
+		{
+			if ( !entry.isCounted ) { return; }
+			// else
+			if ( tracker.onChanged ) { tracker.onChanged( -scast<long long>( entry.byteSize ), -1 ); }
+		}
+
+		Shard &GetShard( const Key &key )
+		{
+			return shards[GetShardIndex( key )];
+		}
+		size_t GetShardIndex( const Key &key ) const
+		{
+			// The upper bits are mixed, because the std::hash of integer may be the identity.
+			size_t hash = hasher( key );
+			hash ^= hash >> 17;
+			hash *= 0x9E3779B1U;
+			hash ^= hash >> 15;
+			return hash % SHARD_COUNT;
+		}
+
+		/// <summary>
+		/// Erase the entry only if it is registered by the creator of "serial", because it may be erased and registered again by the others.
+		/// </summary>
+		void EraseIfSame( Shard *pShard, const Key &key, unsigned long long serial )
+		{
+			std::lock_guard<std::mutex> lock( pShard->mutex );
+
+			auto found = pShard->entries.find( key );
+			if ( found != pShard->entries.end() && found->second.serial == serial )
+			{
+				Uncount( found->second );
+				pShard->entries.erase( found );
+			}
+		}
+	};
+}
@@ -0,0 +1,483 @@
+#include "DebugDraw.h"
+
+#include <algorithm>	// Use std::min().
+#include <array>
+#include <climits>		// Use INT_MAX.
+#include <cstring>		// Use memcpy().
+#include <d3d11.h>
+#include <DirectXMath.h>
+#include <memory>
+#include <vector>
+#include <wrl.h>
+
+#include "CBuffer.h"
+#include "Constant.h"	// Use scast macro.
+#include "Direct3DUtil.h"
+#include "Donya.h"
+#include "RenderCommand.h"
+#include "RenderingStates.h"
+#include "Shader.h"
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace DebugDraw
+	{
+		/// <summary>
+		/// 16 bytes. The color is packed to R8G8B8A8.
+		/// </summary>
+		struct Vertex
+		{
+			DirectX::XMFLOAT3	pos{};
+			unsigned int		color{};
+		};
+		struct Constants
+		{
+			DirectX::XMFLOAT4X4	matVP{};
+		};
+
+		constexpr const char				*ShaderSourceCode()
+		{
+			return
+			"cbuffer CBuffer : register( b0 )\n"
+			"{\n"
+			"	row_major\n"
+			"	float4x4	cbVP;\n"
+			"};\n"
+			"struct VS_IN\n"
+			"{\n"
+			"	float3		pos			: POSITION;\n"
+			"	float4		color		: COLOR;\n"
+			"};\n"
+			"struct VS_OUT\n"
+			"{\n"
+			"	float4		pos			: SV_POSITION;\n"
+			"	float4		color		: COLOR;\n"
+			"};\n"
+			"VS_OUT VSMain( VS_IN vin )\n"
+			"{\n"
+			"	VS_OUT vout = ( VS_OUT )( 0 );\n"
+			"	vout.pos				=  mul( float4( vin.pos, 1.0f ), cbVP );\n"
+			"	vout.color				=  vin.color;\n"
+			"	return vout;\n"
+			"}\n"
+			"float4 PSMain( VS_OUT pin ) : SV_TARGET\n"
+			"{\n"
+			"	return pin.color;\n"
+			"}\n"
+			;
+		}
+		constexpr const char				*ShaderNameVS()
+		{
+			return "DebugDrawVS";
+		}
+		constexpr const char				*ShaderNamePS()
+		{
+			return "DebugDrawPS";
+		}
+		constexpr D3D11_DEPTH_STENCIL_DESC	DepthStencilDesc()
+		{
+			D3D11_DEPTH_STENCIL_DESC standard{};
+			standard.DepthEnable    = TRUE;
+			standard.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ALL;
+			standard.DepthFunc      = D3D11_COMPARISON_LESS_EQUAL;
+			standard.StencilEnable  = FALSE;
+			return standard;
+		}
+		constexpr D3D11_RASTERIZER_DESC		RasterizerDesc()
+		{
+			D3D11_RASTERIZER_DESC standard{};
+			standard.FillMode				= D3D11_FILL_WIREFRAME;
+			standard.CullMode				= D3D11_CULL_NONE;
+			standard.FrontCounterClockwise	= FALSE;
+			standard.DepthClipEnable		= TRUE;
+			standard.AntialiasedLineEnable	= TRUE;
+			return standard;
+		}
+
+		template<typename T> using ComPtr = Microsoft::WRL::ComPtr<T>;
+
+		/// <summary>
+		/// The resources of the drawing. These are made at Init().
+		/// </summary>
+		struct Renderer
+		{
+			Donya::VertexShader		VS;
+			Donya::PixelShader		PS;
+			Donya::CBuffer<Constants>	cbuffer;
+			ComPtr<ID3D11Buffer>	pVertexBuffer;
+			int						idDepthStencil{};
+			int						idRasterizer{};
+		};
+		static std::unique_ptr<Renderer>	pRenderer{};
+
+		static size_t				capacity = 0;	// Count of lines.
+		static size_t				budget = 0;		// Count of lines.
+		static std::vector<Vertex>	vertices{};		// Two vertices per line. Kept over the frames.
+		static size_t				recordedVertexCount = 0;	// The vertices before this are referred by the recorded commands, so these are kept until BeginFrame().
+		static Stats				currentStats{};
+		static Stats				lastStats{};
+
+		unsigned int PackColor( const Donya::Vector4 &color )
+		{
+			auto ToByte = []( float normalized )->unsigned int
+			{
+				const float clamped = std::max( 0.0f, std::min( 1.0f, normalized ) );
+				return scast<unsigned int>( clamped * 255.0f + 0.5f );
+			};
+			return	( ToByte( color.x )			)
+				|	( ToByte( color.y ) << 8	)
+				|	( ToByte( color.z ) << 16	)
+				|	( ToByte( color.w ) << 24	);
+		}
+
+		/// <summary>
+		/// Returns false if the "lineCount" lines can not be added. The overflow is counted at there.
+		/// </summary>
+		bool CanReserve( size_t lineCount )
+		{
+			const size_t reservedLineCount = vertices.size() / 2U;
+			if ( budget < reservedLineCount + lineCount )
+			{
+				currentStats.overflowCount += lineCount;
+				return false;
+			}
+			// else
+			return true;
+		}
+		void PushLine( const Donya::Vector3 &start, const Donya::Vector3 &end, unsigned int packedColor )
+		{
+			vertices.emplace_back( Vertex{ start.XMFloat(), packedColor } );
+			vertices.emplace_back( Vertex{ end.XMFloat(),   packedColor } );
+		}
+
+		int FindUsableDepthStencilIdentifier()
+		{
+			// The internal object use minus value to identifier.
+			for ( int i = -1; -INT_MAX < i; --i )
+			{
+				if ( Donya::DepthStencil::IsUsableIdentifier( i ) ) { return i; }
+			}
+			return 0;
+		}
+		int FindUsableRasterizerIdentifier()
+		{
+			// The internal object use minus value to identifier.
+			for ( int i = -1; -INT_MAX < i; --i )
+			{
+				if ( Donya::Rasterizer::IsUsableIdentifier( i ) ) { return i; }
+			}
+			return 0;
+		}
+
+		bool Init( size_t maxLineCount )
+		{
+			if ( pRenderer ) { return true; }
+			// else
+
+			if ( !maxLineCount ) { return false; }
+			// else
+
+			std::unique_ptr<Renderer> pNew = std::make_unique<Renderer>();
+
+			HRESULT hr = S_OK;
+			ID3D11Device *pDevice = Donya::GetDevice();
+
+			// Create the dynamic vertex buffer.
+			{
+				const std::vector<Vertex> initialVertices( maxLineCount * 2U );
+				hr = Donya::CreateVertexBuffer<Vertex>
+				(
+					pDevice, initialVertices,
+					D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE,
+					pNew->pVertexBuffer.GetAddressOf()
+				);
+				if ( FAILED( hr ) )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Create Vertex-Buffer of DebugDraw." );
+					return false;
+				}
+				// else
+			}
+
+			// Create Shaders.
+			{
+				constexpr std::array<D3D11_INPUT_ELEMENT_DESC, 2> inputElements
+				{
+					D3D11_INPUT_ELEMENT_DESC{ "POSITION",	0, DXGI_FORMAT_R32G32B32_FLOAT,	0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA,	0 },
+					D3D11_INPUT_ELEMENT_DESC{ "COLOR",		0, DXGI_FORMAT_R8G8B8A8_UNORM,	0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA,	0 },
+				};
+				bool succeeded = pNew->VS.CreateByEmbededSourceCode
+				(
+					ShaderNameVS(), ShaderSourceCode(), "VSMain",
+					std::vector<D3D11_INPUT_ELEMENT_DESC>{ inputElements.begin(), inputElements.end() }
+				);
+				if ( !succeeded )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Create vertex-shader of DebugDraw." );
+					return false;
+				}
+				// else
+
+				succeeded = pNew->PS.CreateByEmbededSourceCode
+				(
+					ShaderNamePS(), ShaderSourceCode(), "PSMain"
+				);
+				if ( !succeeded )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Create pixel-shader of DebugDraw." );
+					return false;
+				}
+				// else
+
+				if ( !pNew->cbuffer.Create() )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Create constant-buffer of DebugDraw." );
+					return false;
+				}
+				// else
+			}
+
+			// Create Rendering States.
+			{
+				constexpr int DEFAULT_ID = 0;
+
+				pNew->idDepthStencil = FindUsableDepthStencilIdentifier();
+				if ( pNew->idDepthStencil == DEFAULT_ID || !Donya::DepthStencil::CreateState( pNew->idDepthStencil, DepthStencilDesc() ) )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Create DepthStencil State of DebugDraw." );
+					return false;
+				}
+				// else
+
+				pNew->idRasterizer = FindUsableRasterizerIdentifier();
+				if ( pNew->idRasterizer == DEFAULT_ID || !Donya::Rasterizer::CreateState( pNew->idRasterizer, RasterizerDesc() ) )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Create Rasterizer State of DebugDraw." );
+					return false;
+				}
+				// else
+			}
+
+			pRenderer	= std::move( pNew );
+			capacity	= maxLineCount;
+			budget		= maxLineCount;
+			vertices.clear();
+			vertices.reserve( maxLineCount * 2U ); // The budget does not exceed this, so the recorded vertices are not reallocated.
+			recordedVertexCount = 0;
+			return true;
+		}
+		void Uninit()
+		{
+			pRenderer.reset();
+			capacity	= 0;
+			budget		= 0;
+			vertices.clear();
+			vertices.shrink_to_fit();
+			recordedVertexCount = 0;
+		}
+
+		void SetBudget( size_t lineCount )
+		{
+			budget = std::min( capacity, lineCount );
+		}
+		size_t GetBudget()
+		{
+			return budget;
+		}
+
+		bool ReserveLine( const Donya::Vector3 &wsStart, const Donya::Vector3 &wsEnd, const Donya::Vector4 &color )
+		{
+			if ( !CanReserve( 1U ) ) { return false; }
+			// else
+
+			PushLine( wsStart, wsEnd, PackColor( color ) );
+			return true;
+		}
+		bool ReserveAABB( const Donya::AABB &wsBox, const Donya::Vector4 &color )
+		{
+			constexpr size_t EDGE_COUNT = 12U;
+			if ( !CanReserve( EDGE_COUNT ) ) { return false; }
+			// else
+
+			const Donya::Vector3 &c = wsBox.pos;
+			const Donya::Vector3 &s = wsBox.size;
+			// The bit 0, 1, 2 represents the sign of X, Y, Z.
+			auto Corner = [&c, &s]( int bits )
+			{
+				return Donya::Vector3
+				{
+					c.x + ( ( bits & 1 ) ? s.x : -s.x ),
+					c.y + ( ( bits & 2 ) ? s.y : -s.y ),
+					c.z + ( ( bits & 4 ) ? s.z : -s.z )
+				};
+			};
+			const std::array<Donya::Vector3, 8> corners
+			{
+				Corner( 0 ), Corner( 1 ), Corner( 2 ), Corner( 3 ),
+				Corner( 4 ), Corner( 5 ), Corner( 6 ), Corner( 7 ),
+			};
+
+			const unsigned int packedColor = PackColor( color );
+			for ( int i = 0; i < 8; ++i )
+			{
+				// Connect to the corners that differ by one bit, each edge is made once.
+				for ( int bit = 1; bit < 8; bit <<= 1 )
+				{
+					if ( i & bit ) { continue; }
+					// else
+					PushLine( corners[i], corners[i | bit], packedColor );
+				}
+			}
+			return true;
+		}
+		bool ReserveBox( const Donya::Box &wsBox, float wsPlaneZ, const Donya::Vector4 &color )
+		{
+			constexpr size_t EDGE_COUNT = 4U;
+			if ( !CanReserve( EDGE_COUNT ) ) { return false; }
+			// else
+
+			const float left	= wsBox.pos.x - wsBox.size.x;
+			const float right	= wsBox.pos.x + wsBox.size.x;
+			const float bottom	= wsBox.pos.y - wsBox.size.y;
+			const float top		= wsBox.pos.y + wsBox.size.y;
+			const Donya::Vector3 LB{ left,  bottom, wsPlaneZ };
+			const Donya::Vector3 RB{ right, bottom, wsPlaneZ };
+			const Donya::Vector3 RT{ right, top,    wsPlaneZ };
+			const Donya::Vector3 LT{ left,  top,    wsPlaneZ };
+
+			const unsigned int packedColor = PackColor( color );
+			PushLine( LB, RB, packedColor );
+			PushLine( RB, RT, packedColor );
+			PushLine( RT, LT, packedColor );
+			PushLine( LT, LB, packedColor );
+			return true;
+		}
+		bool ReserveRay( const Donya::Vector3 &wsOrigin, const Donya::Vector3 &direction, float length, const Donya::Vector4 &color )
+		{
+			return ReserveLine( wsOrigin, wsOrigin + direction * length, color );
+		}
+		bool ReservePath( const Donya::Vector3 *pPoints, size_t pointCount, const Donya::Vector4 &color )
+		{
+			if ( !pPoints || pointCount < 2U ) { return true; }
+			// else
+
+			const size_t lineCount = pointCount - 1U;
+			if ( !CanReserve( lineCount ) ) { return false; }
+			// else
+
+			const unsigned int packedColor = PackColor( color );
+			for ( size_t i = 0; i < lineCount; ++i )
+			{
+				PushLine( pPoints[i], pPoints[i + 1], packedColor );
+			}
+			return true;
+		}
+
+		/// <summary>
+		/// Draw the "vertexCount" vertices as the line list by one draw call.
+		/// </summary>
+		void DrawLines( const Vertex *pFirst, size_t vertexCount, const Donya::Vector4x4 &matVP )
+		{
+			ID3D11DeviceContext *pImmediateContext = Donya::GetImmediateContext();
+
+			// Upload the all lines at once.
+			{
+				D3D11_MAPPED_SUBRESOURCE msrVertex{};
+				const HRESULT hr = pImmediateContext->Map( pRenderer->pVertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &msrVertex );
+				if ( FAILED( hr ) )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Mapping at DebugDraw." );
+					return;
+				}
+				// else
+
+				memcpy( msrVertex.pData, pFirst, sizeof( Vertex ) * vertexCount );
+				pImmediateContext->Unmap( pRenderer->pVertexBuffer.Get(), 0 );
+			}
+
+			pRenderer->cbuffer.data.matVP = matVP.XMFloat();
+			pRenderer->cbuffer.Activate( 0, /* setVS = */ true, /* setPS = */ false );
+			pRenderer->VS.Activate();
+			pRenderer->PS.Activate();
+			Donya::DepthStencil::Activate( pRenderer->idDepthStencil );
+			Donya::Rasterizer::Activate( pRenderer->idRasterizer );
+
+			const UINT stride = sizeof( Vertex );
+			const UINT offset = 0;
+			pImmediateContext->IASetVertexBuffers( 0, 1, pRenderer->pVertexBuffer.GetAddressOf(), &stride, &offset );
+			pImmediateContext->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_LINELIST );
+
+			pImmediateContext->Draw( scast<UINT>( vertexCount ), 0 );
+
+			ID3D11Buffer *pNullBuffer = nullptr;
+			const UINT nullStride = 0;
+			pImmediateContext->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_UNDEFINED ); // Reset
+			pImmediateContext->IASetVertexBuffers( 0, 1, &pNullBuffer, &nullStride, &offset );
+
+			Donya::Rasterizer::Deactivate();
+			Donya::DepthStencil::Deactivate();
+			pRenderer->PS.Deactivate();
+			pRenderer->VS.Deactivate();
+			pRenderer->cbuffer.Deactivate();
+		}
+		void ReplayLines( const Donya::RenderCommand::Command &command )
+		{
+			if ( !pRenderer ) { return; }
+			// else
+
+			// The source is the first vertex of the lines, two vertices per line.
+			DrawLines( scast<const Vertex *>( command.pSource ), command.instanceCount * 2U, command.transform );
+		}
+
+		void Flush( const Donya::Vector4x4 &matVP )
+		{
+			if ( vertices.size() <= recordedVertexCount || !pRenderer ) { return; }
+			// else
+
+			const Vertex *pFirst		= vertices.data() + recordedVertexCount;
+			const size_t vertexCount	= vertices.size() - recordedVertexCount;
+			const size_t lineCount		= vertexCount / 2U;
+			currentStats.lineCount += lineCount;
+			currentStats.drawCalls++;
+
+			if ( Donya::RenderCommand::IsRecording() )
+			{
+				// The lines write the depth, so only the alpha makes these order-dependent.
+				constexpr unsigned int OPAQUE_ALPHA = 0xFFU << 24;
+				unsigned char drawFlags = Donya::RenderCommand::DRAW_OPAQUE;
+				for ( size_t i = 0; i < vertexCount; ++i )
+				{
+					if ( ( pFirst[i].color & OPAQUE_ALPHA ) != OPAQUE_ALPHA )
+					{
+						drawFlags = Donya::RenderCommand::DRAW_TRANSLUCENT;
+						break;
+					}
+				}
+
+				// The backend reads the vertices at the RenderCommand::Submit(), so keep these until BeginFrame(). The reserve() at Init() prevents the reallocation.
+				Donya::RenderCommand::Record( Donya::RenderCommand::Make( Donya::RenderCommand::Type::Line, pFirst, 0U, scast<unsigned int>( lineCount ), matVP, Donya::Vector4{ 1.0f, 1.0f, 1.0f, 1.0f }, drawFlags, &ReplayLines, nullptr ) );
+				recordedVertexCount = vertices.size();
+				return;
+			}
+			// else
+
+			DrawLines( pFirst, vertexCount, matVP );
+			vertices.resize( recordedVertexCount );
+		}
+
+		Stats GetLastStats()
+		{
+			return lastStats;
+		}
+		void BeginFrame()
+		{
+			lastStats		= currentStats;
+			currentStats	= Stats{};
+			vertices.clear();
+			recordedVertexCount = 0;
+		}
+	}
+}
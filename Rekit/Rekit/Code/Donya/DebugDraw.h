@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>		// Use size_t.
+
+#include "Collision.h"
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The batched drawer of the debug lines(collision wireframes, normals, paths, rays).<para></para>
+	/// The Reserve methods only store the lines to one buffer, then Flush() draws these by one dynamic vertex buffer and one draw call.<para></para>
+	/// The count of lines per frame is capped by the budget, the lines over the budget are not drawn, but counted as the overflow.<para></para>
+	/// Please use from the main thread only.
+	/// </summary>
+	namespace DebugDraw
+	{
+		constexpr size_t DEFAULT_MAX_LINE_COUNT = 16384U;
+
+		/// <summary>
+		/// Create the vertex buffer that can store the "maxLineCount" lines, and the shaders.<para></para>
+		/// Donya::Init() calls this with the default count. Returns true if succeeded or already initialized.
+		/// </summary>
+		bool Init( size_t maxLineCount = DEFAULT_MAX_LINE_COUNT );
+		void Uninit();
+
+		/// <summary>
+		/// Set the max count of lines per frame. It is clamped by the capacity of Init(). Default is the capacity.
+		/// </summary>
+		void SetBudget( size_t lineCount );
+		size_t GetBudget();
+
+		/// <summary>
+		/// Returns false if the line over the budget.
+		/// </summary>
+		bool ReserveLine( const Donya::Vector3 &wsStart, const Donya::Vector3 &wsEnd, const Donya::Vector4 &color );
+		/// <summary>
+		/// Reserve the 12 edges of the box. The exist flag is ignored.<para></para>
+		/// Returns false if the lines over the budget, then nothing is reserved.
+		/// </summary>
+		bool ReserveAABB( const Donya::AABB &wsBox, const Donya::Vector4 &color );
+		/// <summary>
+		/// Reserve the 4 edges of the box, on the plane of "wsPlaneZ". The exist flag is ignored.<para></para>
+		/// Returns false if the lines over the budget, then nothing is reserved.
+		/// </summary>
+		bool ReserveBox( const Donya::Box &wsBox, float wsPlaneZ, const Donya::Vector4 &color );
+		/// <summary>
+		/// Reserve a line from the "wsOrigin" to [wsOrigin + direction * length]. Use for the normals or the rays.<para></para>
+		/// Returns false if the line over the budget.
+		/// </summary>
+		bool ReserveRay( const Donya::Vector3 &wsOrigin, const Donya::Vector3 &direction, float length, const Donya::Vector4 &color );
+		/// <summary>
+		/// Reserve the lines that connect the points in order. Use for the moved path.<para></para>
+		/// Returns false if the lines over the budget, then nothing is reserved.
+		/// </summary>
+		bool ReservePath( const Donya::Vector3 *pPoints, size_t pointCount, const Donya::Vector4 &color );
+
+		/// <summary>
+		/// Draw the reserved lines by one draw call, then clear these. Please call once per frame, after the other drawing.<para></para>
+		/// While the Donya::RenderCommand is recording, this records a Line command instead. Its source points the first vertex of the lines(float3 position, packed RGBA8 color),
+		/// and the lines are kept until the next BeginFrame(), so they count toward the budget of the frame.
+		/// </summary>
+		void Flush( const Donya::Vector4x4 &matViewProjection );
+
+		struct Stats
+		{
+			size_t lineCount{};		// The count of the drawn lines.
+			size_t overflowCount{};	// The count of the lines that were rejected by the budget.
+			size_t drawCalls{};
+		};
+		/// <summary>
+		/// Returns the stats of last frame.
+		/// </summary>
+		Stats GetLastStats();
+		/// <summary>
+		/// The stats of current frame will become the last frame's, and the reserved lines that were not flushed are discarded.<para></para>
+		/// Donya::SystemUpdate() calls this.
+		/// </summary>
+		void BeginFrame();
+	}
+}
@@ -9,16 +9,23 @@
 #include <Windows.Foundation.h> // Use Windows::Foundation::Initialize(), Windows::Foundation::Uninitialize().
 #include <wrl.h>
 
+#include "AllocationTracker.h"
 #include "Blend.h"
 #include "Constant.h"
+#include "DebugDraw.h"
+#include "FrameArena.h"
 #include "GamepadXInput.h"
 #include "HighResolutionTimer.h"
+#include "Input.h"
 #include "Keyboard.h"
 #include "Mouse.h"
+#include "RenderCommand.h"
 #include "Resource.h"
+#include "ResourceBudget.h"
 #include "ScreenShake.h"
 #include "Sound.h"
 #include "Sprite.h"
+#include "StaticMesh.h"
 #include "Useful.h"
 #include "UseImgui.h"
 #include "WindowsUtil.h"
@@ -622,6 +629,9 @@ namespace Donya
 	
 	LRESULT CALLBACK WndProc( HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam )
 	{
+		// Store before the ImGui consumes. The Donya::Keyboard is also made from these.
+		Donya::Input::ProcessMessage( hwnd, msg, wParam, lParam );
+
 	#if USE_IMGUI
 
 		if ( ImGui_ImplWin32_WndProcHandler( hwnd, msg, wParam, lParam ) )
@@ -965,8 +975,10 @@ namespace Donya
 		Windows::Foundation::Uninitialize();
 	}
 
-	bool Init( int nCmdShow, int screenWidth, int screenHeight, const char *windowCaption, bool fullScreenMode, bool isAppendFPS, bool isEnableMultiThreaded )
+	bool Init( int nCmdShow, int screenWidth, int screenHeight, const char *windowCaption, bool fullScreenMode, bool isAppendFPS, bool isEnableMultiThreaded, bool isNullAudio )
 	{
+		Donya::AllocationTracker::Init();
+
 		HRESULT hr = ThreadInitialize( isEnableMultiThreaded );
 		if ( FAILED( hr ) )
 		{
@@ -996,8 +1008,16 @@ namespace Donya
 	#endif // USE_IMGUI
 
 		Donya::Blend::Init();
-		Donya::Sound::Init();
+		if ( isNullAudio )
+		{
+			Donya::Sound::InitWithSoftwareMixer();
+		}
+		else
+		{
+			Donya::Sound::Init();
+		}
 		Donya::Sprite::Init();
+		Donya::DebugDraw::Init();
 
 		Donya::ScreenShake::SetEnableState( true );
 
@@ -1103,6 +1123,12 @@ namespace Donya
 
 	void SystemUpdate()
 	{
+		Donya::AllocationTracker::BeginFrame();
+		Donya::FrameArena::ResetAll();
+		Donya::StaticMesh::FlushRenderStats();
+		Donya::DebugDraw::BeginFrame();
+		Donya::ResourceBudget::Update();
+
 		ResetPipelineStages();
 
 	#if USE_IMGUI
@@ -1113,7 +1139,8 @@ namespace Donya
 
 	#endif
 
-		Donya::Keyboard::Update();
+		Donya::Input::Update();
+		Donya::Keyboard::Update();	// Made from the snapshot of Donya::Input.
 
 		Donya::ScreenShake::Update( GetElapsedTime() );
 		Donya::Sound::Update();
@@ -1159,6 +1186,7 @@ namespace Donya
 	bool Present( UINT syncInterval, UINT flags )
 	{
 		Donya::Sprite::PostDraw();
+		Donya::RenderCommand::Submit();
 
 	#if USE_IMGUI
 
@@ -1194,6 +1222,8 @@ namespace Donya
 
 		Donya::Resource::ReleaseAllCachedResources();
 
+		Donya::DebugDraw::Uninit();
+
 	#if USE_IMGUI
 
 		ImGui_ImplDX11_Shutdown();
@@ -1213,6 +1243,8 @@ namespace Donya
 
 		ThreadUninitialize();
 
+		Donya::AllocationTracker::Uninit();
+
 		return exitCode;
 	}
 
@@ -18,9 +18,10 @@ namespace Donya
 	/// Initialize Donya's engine, if not initialized yet.<para></para>
 	/// Use Windows::Foundation::Initialize( RO_INIT_MULTITHREADED ).<para></para>
 	/// If initialize failed, returns false.<para></para>
-	/// In release mode, the isAppendFPS flag fixed to false.
+	/// In release mode, the isAppendFPS flag fixed to false.<para></para>
+	/// If "isNullAudio" is true, the sounds are mixed by Donya::SoftwareMixer and discarded, the audio device(FMOD) is not initialized.
 	/// </summary>
-	bool Init( int nCmdShow, int screenWidth, int screenHeight, const char *windowCaption, bool fullScreenMode, bool isAppendFPS = true, bool isEnableMultiThreaded = true );
+	bool Init( int nCmdShow, int screenWidth, int screenHeight, const char *windowCaption, bool fullScreenMode, bool isAppendFPS = true, bool isEnableMultiThreaded = true, bool isNullAudio = false );
 
 	/// <summary>
 	/// Returns false if failed.
@@ -36,6 +37,10 @@ namespace Donya
 	/// <summary>
 	/// Please call after MessageLoop().<para></para>
 	/// This function doing:<para></para>
+	/// AllocationTracker::BeginFrame(),<para></para>
+	/// FrameArena::ResetAll(),<para></para>
+	/// StaticMesh::FlushRenderStats(),<para></para>
+	/// DebugDraw::BeginFrame(),<para></para>
 	/// Keyboard::Update(),<para></para>
 	/// ScreenShake::Update(),<para></para>
 	/// Sound::Update().
@@ -67,6 +72,7 @@ namespace Donya
 
 	/// <summary>
 	/// Doing IDXGISwapChain::Present(), check and assertion return value.<para></para>
+	/// The recorded render commands are submitted before that, if the RenderCommand has a backend.<para></para>
 	/// returns false when failed.
 	/// </summary>
 	bool Present( UINT syncInterval = 0, UINT flags = 0 );
@@ -0,0 +1,99 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <mutex>
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace
+	{
+		// The arenas of all threads. Use for ResetAll().
+		static std::vector<FrameArena *>	arenas{};
+		static std::mutex					arenasMutex{};
+
+		size_t AlignUp( size_t value, size_t alignment )
+		{
+			return ( value + ( alignment - 1 ) ) & ~( alignment - 1 );
+		}
+	}
+
+	FrameArena &FrameArena::Get()
+	{
+		static thread_local FrameArena instance{};
+		return instance;
+	}
+	void FrameArena::ResetAll()
+	{
+		std::lock_guard<std::mutex> enterCS( arenasMutex );
+		for ( auto &it : arenas )
+		{
+			it->Reset();
+		}
+	}
+
+	FrameArena::FrameArena( size_t blockSize ) :
+		blocks(), currentBlock( 0 ), offset( 0 ), usedBytes( 0 ), peakBytes( 0 )
+	{
+		AppendBlock( blockSize );
+
+		std::lock_guard<std::mutex> enterCS( arenasMutex );
+		arenas.emplace_back( this );
+	}
+	FrameArena::~FrameArena()
+	{
+		std::lock_guard<std::mutex> enterCS( arenasMutex );
+		arenas.erase( std::remove( arenas.begin(), arenas.end(), this ), arenas.end() );
+	}
+
+	void *FrameArena::Allocate( size_t bytes, size_t alignment )
+	{
+		size_t begin = AlignUp( offset, alignment );
+		if ( blocks[currentBlock].capacity < begin + bytes )
+		{
+			// The remaining of the current block is wasted until the Reset().
+			AppendBlock( std::max( bytes, blocks[currentBlock].capacity ) );
+			currentBlock = blocks.size() - 1;
+
+			offset = 0;
+			begin  = 0;
+		}
+
+		usedBytes += ( begin - offset ) + bytes;
+		peakBytes  = std::max( peakBytes, usedBytes );
+
+		offset = begin + bytes;
+		return blocks[currentBlock].buffer.get() + begin;
+	}
+
+	void FrameArena::Reset()
+	{
+		if ( 1U < blocks.size() )
+		{
+			const size_t wholeCapacity = GetCapacity();
+			blocks.clear();
+			AppendBlock( wholeCapacity );
+		}
+
+		currentBlock	= 0;
+		offset			= 0;
+		usedBytes		= 0;
+	}
+
+	size_t FrameArena::GetCapacity() const
+	{
+		size_t sum = 0;
+		for ( const auto &it : blocks )
+		{
+			sum += it.capacity;
+		}
+		return sum;
+	}
+
+	void FrameArena::AppendBlock( size_t capacity )
+	{
+		blocks.emplace_back( Block{ std::make_unique<unsigned char[]>( capacity ), capacity } );
+	}
+}
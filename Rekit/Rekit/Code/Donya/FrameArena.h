@@ -0,0 +1,98 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Constant.h"	// Use DELETE_COPY_AND_ASSIGN macro.
+
+namespace Donya
+{
+	/// <summary>
+	/// Linear(bump) allocator for the temporary buffers that live within a frame.<para></para>
+	/// Each thread has an own arena, that is rewound by FrameArena::ResetAll() at first of each frame.<para></para>
+	/// The deallocation is no-op, so please reserve the container's capacity if you know it.
+	/// </summary>
+	class FrameArena
+	{
+	public:
+		static constexpr size_t DEFAULT_BLOCK_SIZE = 512U * 1024U;
+	public:
+		/// <summary>
+		/// Returns the arena of the calling thread. It is created at first call.
+		/// </summary>
+		static FrameArena &Get();
+		/// <summary>
+		/// Rewind the arenas of all threads. Donya::SystemUpdate() calls this.<para></para>
+		/// Please call when the other threads are not using their arenas.
+		/// </summary>
+		static void ResetAll();
+	private:
+		struct Block
+		{
+			std::unique_ptr<unsigned char[]>	buffer;
+			size_t								capacity;
+		};
+	private:
+		std::vector<Block>	blocks;
+		size_t				currentBlock;
+		size_t				offset;			// In the current block.
+		size_t				usedBytes;		// In this frame.
+		size_t				peakBytes;
+	public:
+		FrameArena( size_t blockSize = DEFAULT_BLOCK_SIZE );
+		~FrameArena();
+		DELETE_COPY_AND_ASSIGN( FrameArena )
+	public:
+		/// <summary>
+		/// The "alignment" must be a power of two, and not greater than the alignment of operator new. If the current block is not enough, a new block is appended.
+		/// </summary>
+		void *Allocate( size_t bytes, size_t alignment );
+		/// <summary>
+		/// Rewind to the first block. If some blocks were appended in this frame, these are merged into one block, so the next frame fits in the one.
+		/// </summary>
+		void Reset();
+
+		size_t GetUsedBytes()	const { return usedBytes; }
+		size_t GetPeakBytes()	const { return peakBytes; }
+		size_t GetCapacity()	const;
+	private:
+		void AppendBlock( size_t capacity );
+	};
+
+	/// <summary>
+	/// The allocator for std containers, that allocates from a FrameArena.<para></para>
+	/// The default constructed one uses the arena of the constructing thread.
+	/// </summary>
+	template<typename T>
+	class FrameAllocator
+	{
+	public:
+		using value_type = T;
+	public:
+		FrameArena *pArena;
+	public:
+		FrameAllocator() : pArena( &FrameArena::Get() ) {}
+		FrameAllocator( FrameArena *pArena ) : pArena( pArena ) {}
+		template<typename U>
+		FrameAllocator( const FrameAllocator<U> &other ) : pArena( other.pArena ) {}
+	public:
+		T *allocate( size_t count )
+		{
+			return static_cast<T *>( pArena->Allocate( sizeof( T ) * count, alignof( T ) ) );
+		}
+		void deallocate( T *, size_t )
+		{
+			// No op. The memory is released by FrameArena::Reset().
+		}
+	};
+	template<typename T, typename U>
+	bool operator == ( const FrameAllocator<T> &L, const FrameAllocator<U> &R ) { return L.pArena == R.pArena; }
+	template<typename T, typename U>
+	bool operator != ( const FrameAllocator<T> &L, const FrameAllocator<U> &R ) { return !( L == R ); }
+
+	/// <summary>
+	/// The vector that allocates from the FrameArena. Do not keep it over the frame.
+	/// </summary>
+	template<typename T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+}
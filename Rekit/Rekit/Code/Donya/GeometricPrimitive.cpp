@@ -7,6 +7,7 @@
 #include "Constant.h"
 #include "Direct3DUtil.h"
 #include "Donya.h"
+#include "RenderCommand.h"
 #include "RenderingStates.h"
 #include "Resource.h"
 #include "Useful.h"
@@ -20,6 +21,43 @@ namespace Donya
 	{
 		// TODO : User can specify some a slot.
 
+		/// <summary>
+		/// The arguments of the default shading Render() that the recorded command replays with.
+		/// </summary>
+		struct RecordedDraw
+		{
+			XMFLOAT4X4		matW{};
+			XMFLOAT4		lightDir{};
+			Donya::Vector2	texPartPosLT{};		// Only the TextureBoard uses.
+			Donya::Vector2	texPartWholeSize{};	// Only the TextureBoard uses.
+			bool			isEnableFill{};
+		};
+
+		template<typename Primitive>
+		void ReplayRender( const Donya::RenderCommand::Command &command )
+		{
+			const RecordedDraw *pDraw = scast<const RecordedDraw *>( command.pPayload );
+			scast<const Primitive *>( command.pSource )->Render( nullptr, /* useDefaultShading = */ true, pDraw->isEnableFill, command.transform, pDraw->matW, pDraw->lightDir, command.color );
+		}
+		void ReplayRenderPart( const Donya::RenderCommand::Command &command )
+		{
+			const RecordedDraw *pDraw = scast<const RecordedDraw *>( command.pPayload );
+			scast<const TextureBoard *>( command.pSource )->RenderPart( pDraw->texPartPosLT, pDraw->texPartWholeSize, nullptr, /* useDefaultShading = */ true, pDraw->isEnableFill, command.transform, pDraw->matW, pDraw->lightDir, command.color );
+		}
+
+		/// <summary>
+		/// The primitives write the depth, so only the material makes these order-dependent. The "isTranslucentMaterial" is for the textured one, the alpha of the "color" is checked at here.
+		/// </summary>
+		void RecordPrimitive( const void *pSource, Donya::RenderCommand::Replayer replay, const RecordedDraw &draw, const XMFLOAT4X4 &matWVP, const XMFLOAT4 &color, bool isTranslucentMaterial )
+		{
+			const unsigned char drawFlags
+				= ( isTranslucentMaterial || color.w < 1.0f )
+				? Donya::RenderCommand::DRAW_TRANSLUCENT
+				: Donya::RenderCommand::DRAW_OPAQUE;
+
+			Donya::RenderCommand::Record( Donya::RenderCommand::Make( Donya::RenderCommand::Type::Primitive, pSource, 0U, 1U, matWVP, color, drawFlags, replay, Donya::RenderCommand::MakePayload( &draw ) ) );
+		}
+
 		Base::Base() :
 			iVertexBuffer(), iIndexBuffer(), iConstantBuffer(),
 			iInputLayout(), iVertexShader(), iPixelShader(),
@@ -387,6 +425,18 @@ namespace Donya
 			}
 			// else
 
+			// The replay uses the default shading, so the own shading is drawn immediately.
+			if ( Donya::RenderCommand::IsRecording() && useDefaultShading )
+			{
+				RecordedDraw draw{};
+				draw.matW			= defMatW;
+				draw.lightDir		= defLightDir;
+				draw.isEnableFill	= isEnableFill;
+				RecordPrimitive( this, &ReplayRender<Cube>, draw, defMatWVP, defMtlColor, /* isTranslucentMaterial = */ false );
+				return;
+			}
+			// else
+
 			HRESULT hr = S_OK;
 
 			// Use default context.
@@ -718,6 +768,18 @@ namespace Donya
 			}
 			// else
 
+			// The replay uses the default shading, so the own shading is drawn immediately.
+			if ( Donya::RenderCommand::IsRecording() && useDefaultShading )
+			{
+				RecordedDraw draw{};
+				draw.matW			= defMatW;
+				draw.lightDir		= defLightDir;
+				draw.isEnableFill	= isEnableFill;
+				RecordPrimitive( this, &ReplayRender<Sphere>, draw, defMatWVP, defMtlColor, /* isTranslucentMaterial = */ false );
+				return;
+			}
+			// else
+
 			HRESULT hr = S_OK;
 			
 			// Use default context.
@@ -898,7 +960,7 @@ namespace Donya
 
 		TextureBoard::TextureBoard( std::wstring filePath ) : Base(),
 			FILE_PATH( filePath ),
-			vertices(), textureDesc(), iSRV(), iSampler()
+			vertices(), textureDesc(), iSRV(), iSampler(), pTexture()
 		{}
 		TextureBoard::~TextureBoard() = default;
 
@@ -1072,13 +1134,12 @@ namespace Donya
 					desc
 				);
 
-				Resource::CreateTexture2DFromFile
-				(
-					pDevice,
-					FILE_PATH,
-					iSRV.GetAddressOf(),
-					&textureDesc
-				);
+				pTexture = Resource::AcquireTexture2D( pDevice, FILE_PATH );
+				if ( pTexture )
+				{
+					iSRV		= pTexture->d3dShaderResourceView;
+					textureDesc	= pTexture->d3dTexture2DDesc;
+				}
 			}
 
 			wasCreated = true;
@@ -1121,6 +1182,21 @@ namespace Donya
 			}
 			// else
 
+			// The replay uses the default shading, so the own shading is drawn immediately.
+			if ( Donya::RenderCommand::IsRecording() && useDefaultShading )
+			{
+				RecordedDraw draw{};
+				draw.matW				= defMatW;
+				draw.lightDir			= defLightDir;
+				draw.texPartPosLT		= texPartPosLT;
+				draw.texPartWholeSize	= texPartWholeSize;
+				draw.isEnableFill		= isEnableFill;
+				// The texture may have the alpha, same as the sprites.
+				RecordPrimitive( this, &ReplayRenderPart, draw, defMatWVP, defMtlColor, /* isTranslucentMaterial = */ true );
+				return;
+			}
+			// else
+
 			constexpr unsigned int VERTEX_COUNT = 4 * 2; // Front-face and back-face.
 
 			HRESULT hr = S_OK;
@@ -1222,6 +1298,7 @@ namespace Donya
 				pImmediateContext->OMSetDepthStencilState( iDepthStencilState.Get(), 0xffffffff );
 			}
 
+			if ( pTexture ) { pTexture->usage.Touch(); }
 			pImmediateContext->Draw( VERTEX_COUNT, 0 );
 
 			// PostProcessing.
@@ -1513,6 +1590,38 @@ namespace Donya
 			if ( !reserveCount ) { return; }
 			// else
 
+			if ( Donya::RenderCommand::IsRecording() )
+			{
+				// The lines write the depth, so only the alpha makes these order-dependent.
+				unsigned char drawFlags = Donya::RenderCommand::DRAW_OPAQUE;
+				for ( size_t i = 0; i < reserveCount; ++i )
+				{
+					if ( instances[i].color.w < 1.0f )
+					{
+						drawFlags = Donya::RenderCommand::DRAW_TRANSLUCENT;
+						break;
+					}
+				}
+
+				const Instance *pPayload = Donya::RenderCommand::MakePayload( instances.data(), reserveCount );
+				Donya::RenderCommand::Record( Donya::RenderCommand::Make( Donya::RenderCommand::Type::Line, this, 0U, scast<unsigned int>( reserveCount ), matVP, Donya::Vector4{ 1.0f, 1.0f, 1.0f, 1.0f }, drawFlags, &Line::Replay, pPayload ) );
+			}
+			else
+			{
+				Draw( instances.data(), reserveCount, matVP );
+			}
+
+			reserveCount = 0U;
+			instances.clear();
+			instances.resize( MAX_INSTANCES );
+		}
+		void Line::Replay( const Donya::RenderCommand::Command &command )
+		{
+			const Line *pLine = scast<const Line *>( command.pSource );
+			pLine->Draw( scast<const Instance *>( command.pPayload ), command.instanceCount, command.transform );
+		}
+		void Line::Draw( const Instance *pInstances, size_t instanceCount, const Donya::Vector4x4 &matVP ) const
+		{
 			HRESULT hr = S_OK;
 			ID3D11DeviceContext *pImmediateContext = Donya::GetImmediateContext();
 
@@ -1550,8 +1659,7 @@ namespace Donya
 					}
 					// else
 
-					// Should change to this -> memcpy_s( msrInstance.pData, sizeof( Line::Instance ) * reserveCount, instances.data(), msrInstance.RowPitch );
-					memcpy( msrInstance.pData, instances.data(), msrInstance.RowPitch );
+					memcpy_s( msrInstance.pData, msrInstance.RowPitch, pInstances, sizeof( Line::Instance ) * instanceCount );
 
 					pImmediateContext->Unmap( pInstanceBuffer.Get(), 0 );
 				}
@@ -1569,7 +1677,7 @@ namespace Donya
 			pImmediateContext->IASetVertexBuffers( 0, BUFFER_COUNT, pBuffers, strides, offsets );
 			pImmediateContext->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_LINELIST );
 
-			pImmediateContext->DrawInstanced( 2U, reserveCount, 0, 0 );
+			pImmediateContext->DrawInstanced( 2U, scast<UINT>( instanceCount ), 0, 0 );
 
 			UINT disStrides[BUFFER_COUNT]{ 0, 0 };
 			UINT disOffsets[BUFFER_COUNT]{ 0, 0 };
@@ -1581,10 +1689,6 @@ namespace Donya
 			Donya::DepthStencil::Deactivate();
 			linePS.Deactivate();
 			lineVS.Deactivate();
-
-			reserveCount = 0U;
-			instances.clear();
-			instances.resize( MAX_INSTANCES );
 		}
 
 	// region Line
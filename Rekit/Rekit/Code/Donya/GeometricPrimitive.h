@@ -10,10 +10,16 @@
 #include "Color.h"		// Use for Line.
 #include "Shader.h"		// Use for Line.
 #include "Quaternion.h"	// Use for Billboard's freeze axis.
+#include "Resource.h"		// Use for TextureBoard's texture.
 #include "Vector.h"
 
 namespace Donya
 {
+	namespace RenderCommand
+	{
+		struct Command;
+	}
+
 	namespace Geometric
 	{
 		/// <summary>
@@ -142,6 +148,7 @@ namespace Donya
 			mutable D3D11_TEXTURE2D_DESC								textureDesc;
 			mutable Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	iSRV;
 			mutable Microsoft::WRL::ComPtr<ID3D11SamplerState>			iSampler;
+			mutable Resource::Handle<Resource::Texture2DResource>		pTexture;	// Keeps the cached texture from the eviction.
 		public:
 			TextureBoard( std::wstring filePath );
 			~TextureBoard();
@@ -254,9 +261,13 @@ namespace Donya
 			bool Reserve( const Donya::Vector3 &wsStartPoint, const Donya::Vector3 &wsEndPoint, float alpha, Donya::Color::Code color = Donya::Color::Code::BLACK ) const;
 
 			/// <summary>
-			/// Draw current reserving instances.
+			/// Draw current reserving instances.<para></para>
+			/// While the Donya::RenderCommand is recording, this records a command with the copy of the instances instead.
 			/// </summary>
 			void Flush( const Donya::Vector4x4 &matViewProjection ) const;
+		private:
+			void Draw( const Instance *pInstances, size_t instanceCount, const Donya::Vector4x4 &matViewProjection ) const;
+			static void Replay( const Donya::RenderCommand::Command &command );
 		};
 
 		Cube			CreateCube();
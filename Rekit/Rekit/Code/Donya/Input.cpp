@@ -0,0 +1,508 @@
+#include "Input.h"
+
+#include <algorithm>
+#include <Xinput.h>
+
+#include "cereal/types/vector.hpp"
+
+#include "Constant.h"	// Use scast macro.
+#include "Serializer.h"
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace Input
+	{
+		constexpr size_t EVENT_CAPACITY = 256U; // The events of several ticks.
+
+		// The events are stored by ProcessMessage(), and consumed by Update().
+		static std::array<Event, EVENT_CAPACITY>	events{};
+		static size_t								eventHead	= 0;	// The index of the oldest one.
+		static size_t								eventCount	= 0;
+
+		static Snapshot								deviceState{};	// Made from the devices. This is tracked even while the source is used.
+		static Snapshot								current{};
+		static Snapshot								previous{};
+		static std::shared_ptr<Source>				pSource{ nullptr };
+
+		static bool									isRecording	= false;
+		static std::vector<Snapshot>				recorded{};
+
+		static LatencyStats							latency{};
+
+		static std::chrono::steady_clock::time_point lastPadPoll{};
+
+	#pragma region Snapshot
+
+		bool GetBit( const std::array<std::uint32_t, Snapshot::KEY_WORD_COUNT> &bits, int index )
+		{
+			if ( index < 0 || 256 <= index ) { return false; }
+			// else
+			return ( bits[index / 32] >> ( index % 32 ) ) & 1U;
+		}
+		void SetBit( std::array<std::uint32_t, Snapshot::KEY_WORD_COUNT> *pBits, int index, bool value )
+		{
+			if ( index < 0 || 256 <= index ) { return; }
+			// else
+
+			const std::uint32_t mask = 1U << ( index % 32 );
+			std::uint32_t &word = ( *pBits )[index / 32];
+			word = ( value ) ? word | mask : word & ~mask;
+		}
+		bool GetButtonBit( std::uint32_t bits, Gamepad::Button kind )
+		{
+			if ( kind < 0 || Gamepad::Button::TERMINATION_OF_BUTTON_TYPES <= kind ) { return false; }
+			// else
+			return ( bits >> kind ) & 1U;
+		}
+
+		bool Snapshot::IsPressed( int vKey )				const { return GetBit( keys,		vKey ); }
+		bool Snapshot::IsDown( int vKey )					const { return GetBit( keyDowns,	vKey ); }
+		bool Snapshot::IsUp( int vKey )						const { return GetBit( keyUps,		vKey ); }
+		bool Snapshot::IsPressed( Gamepad::Button kind )	const { return GetButtonBit( buttons,		kind ); }
+		bool Snapshot::IsDown( Gamepad::Button kind )		const { return GetButtonBit( buttonDowns,	kind ); }
+		bool Snapshot::IsUp( Gamepad::Button kind )			const { return GetButtonBit( buttonUps,		kind ); }
+
+		// The normalization is same as the Donya::XInput.
+		constexpr float THUMB_MAX = 32768.0f;
+		Vector2 Snapshot::LeftStick() const
+		{
+			return Vector2{ scast<float>( thumbs[0] ) / THUMB_MAX, scast<float>( thumbs[1] ) / THUMB_MAX };
+		}
+		Vector2 Snapshot::RightStick() const
+		{
+			return Vector2{ scast<float>( thumbs[2] ) / THUMB_MAX, scast<float>( thumbs[3] ) / THUMB_MAX };
+		}
+
+	#pragma endregion
+
+	#pragma region Source
+
+		bool ReplaySource::Next( Snapshot *pOutput )
+		{
+			if ( snapshots.size() <= index ) { return false; }
+			// else
+
+			*pOutput = snapshots[index];
+			index++;
+			return true;
+		}
+
+		void SetSource( std::shared_ptr<Source> pNewSource )
+		{
+			pSource = std::move( pNewSource );
+		}
+		bool IsUsingSource()
+		{
+			return ( pSource != nullptr );
+		}
+
+	#pragma endregion
+
+	#pragma region Events
+
+		void PushEvent( const Event &event )
+		{
+			if ( EVENT_CAPACITY <= eventCount )
+			{
+				// Discard the oldest one.
+				eventHead = ( eventHead + 1U ) % EVENT_CAPACITY;
+				eventCount--;
+				latency.droppedCount++;
+			}
+
+			events[( eventHead + eventCount ) % EVENT_CAPACITY] = event;
+			eventCount++;
+		}
+		void PushKeyEvent( int vKey, bool isDown )
+		{
+			Event event{};
+			event.timestamp	= std::chrono::steady_clock::now();
+			event.device	= Device::Keyboard;
+			event.code		= scast<unsigned char>( vKey );
+			event.isDown	= isDown;
+			PushEvent( event );
+		}
+
+		/// <summary>
+		/// The messages have VK_SHIFT, VK_CONTROL, VK_MENU, so convert these to the left or right one.
+		/// </summary>
+		int ToSidedKey( WPARAM vKey, LPARAM lParam )
+		{
+			const UINT scanCode		= scast<UINT>( ( lParam >> 16 ) & 0xFF );
+			const bool isExtended	= ( lParam & ( 1 << 24 ) ) != 0;
+			switch ( vKey )
+			{
+			case VK_SHIFT:		return scast<int>( MapVirtualKey( scanCode, MAPVK_VSC_TO_VK_EX ) );
+			case VK_CONTROL:	return ( isExtended ) ? VK_RCONTROL	: VK_LCONTROL;
+			case VK_MENU:		return ( isExtended ) ? VK_RMENU	: VK_LMENU;
+			default: break;
+			}
+			return scast<int>( vKey );
+		}
+
+		/// <summary>
+		/// Capture the mouse while some button is pressed. The "wParam" is of the button message, it has the buttons that are pressed after the message.
+		/// </summary>
+		void UpdateMouseCapture( HWND hWnd, WPARAM wParam )
+		{
+			constexpr WPARAM BUTTON_FLAGS = MK_LBUTTON | MK_RBUTTON | MK_MBUTTON | MK_XBUTTON1 | MK_XBUTTON2;
+			const bool isPressing = ( GET_KEYSTATE_WPARAM( wParam ) & BUTTON_FLAGS ) != 0;
+			if ( isPressing )
+			{
+				if ( GetCapture() != hWnd ) { SetCapture( hWnd ); }
+			}
+			else
+			{
+				if ( GetCapture() == hWnd ) { ReleaseCapture(); }
+			}
+		}
+
+		void ProcessMessage( HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam )
+		{
+			switch ( msg )
+			{
+			case WM_KEYDOWN:
+			case WM_SYSKEYDOWN:
+				{
+					const int vKey = ToSidedKey( wParam, lParam );
+					// Ignore the auto-repeat. But the key that is held while the focus returns is only sent as the repeat, so accept it if not pressed.
+					if ( ( lParam & ( 1 << 30 ) ) && GetBit( deviceState.keys, vKey ) ) { break; }
+					// else
+					PushKeyEvent( vKey, true );
+				}
+				break;
+			case WM_KEYUP:
+			case WM_SYSKEYUP:
+				PushKeyEvent( ToSidedKey( wParam, lParam ), false );
+				break;
+			case WM_LBUTTONDOWN:	PushKeyEvent( VK_LBUTTON, true  );	UpdateMouseCapture( hWnd, wParam );	break;
+			case WM_LBUTTONUP:		PushKeyEvent( VK_LBUTTON, false );	UpdateMouseCapture( hWnd, wParam );	break;
+			case WM_RBUTTONDOWN:	PushKeyEvent( VK_RBUTTON, true  );	UpdateMouseCapture( hWnd, wParam );	break;
+			case WM_RBUTTONUP:		PushKeyEvent( VK_RBUTTON, false );	UpdateMouseCapture( hWnd, wParam );	break;
+			case WM_MBUTTONDOWN:	PushKeyEvent( VK_MBUTTON, true  );	UpdateMouseCapture( hWnd, wParam );	break;
+			case WM_MBUTTONUP:		PushKeyEvent( VK_MBUTTON, false );	UpdateMouseCapture( hWnd, wParam );	break;
+			case WM_XBUTTONDOWN:
+			case WM_XBUTTONUP:
+				PushKeyEvent( ( GET_XBUTTON_WPARAM( wParam ) == XBUTTON1 ) ? VK_XBUTTON1 : VK_XBUTTON2, ( msg == WM_XBUTTONDOWN ) );
+				UpdateMouseCapture( hWnd, wParam );
+				break;
+			case WM_CAPTURECHANGED:
+				{
+					// The button up is not sent to the window that lost the capture, so release the mouse buttons.
+					// If this window released it at the last button up, the buttons are already released.
+					Event event{};
+					event.timestamp	= std::chrono::steady_clock::now();
+					event.device	= Device::Capture;
+					PushEvent( event );
+				}
+				break;
+			case WM_KILLFOCUS:
+				{
+					// The key up is not sent to the window that lost the focus, so release all.
+					// The keys pressed after the last Update() are still in the events, so release these at the consuming.
+					Event event{};
+					event.timestamp	= std::chrono::steady_clock::now();
+					event.device	= Device::Focus;
+					PushEvent( event );
+				}
+				break;
+			default: break;
+			}
+		}
+
+		void ApplyKey( Snapshot *pState, int vKey, bool isDown )
+		{
+			if ( GetBit( pState->keys, vKey ) == isDown ) { return; }
+			// else
+
+			SetBit( &pState->keys, vKey, isDown );
+			SetBit( ( isDown ) ? &pState->keyDowns : &pState->keyUps, vKey, true );
+
+			// Also set the key that is not distinguished the left and right, as GetKeyboardState().
+			auto UpdateGeneric = [&pState]( int generic, int left, int right )
+			{
+				const bool pressed = GetBit( pState->keys, left ) || GetBit( pState->keys, right );
+				if ( GetBit( pState->keys, generic ) == pressed ) { return; }
+				// else
+
+				SetBit( &pState->keys, generic, pressed );
+				SetBit( ( pressed ) ? &pState->keyDowns : &pState->keyUps, generic, true );
+			};
+			switch ( vKey )
+			{
+			case VK_LSHIFT:		case VK_RSHIFT:		UpdateGeneric( VK_SHIFT,	VK_LSHIFT,		VK_RSHIFT	);	break;
+			case VK_LCONTROL:	case VK_RCONTROL:	UpdateGeneric( VK_CONTROL,	VK_LCONTROL,	VK_RCONTROL	);	break;
+			case VK_LMENU:		case VK_RMENU:		UpdateGeneric( VK_MENU,		VK_LMENU,		VK_RMENU	);	break;
+			default: break;
+			}
+		}
+		void ApplyButton( Snapshot *pState, int kind, bool isDown )
+		{
+			const std::uint32_t mask = 1U << kind;
+			if ( ( ( pState->buttons & mask ) != 0 ) == isDown ) { return; }
+			// else
+
+			pState->buttons = ( isDown ) ? pState->buttons | mask : pState->buttons & ~mask;
+			if ( isDown )	{ pState->buttonDowns	|= mask; }
+			else			{ pState->buttonUps		|= mask; }
+		}
+
+		/// <summary>
+		/// Apply the stored events in the order.
+		/// </summary>
+		void ConsumeEvents( Snapshot *pState, std::chrono::steady_clock::time_point now )
+		{
+			for ( ; eventCount; --eventCount )
+			{
+				const Event &event = events[eventHead];
+				eventHead = ( eventHead + 1U ) % EVENT_CAPACITY;
+
+				if ( event.device == Device::Gamepad )
+				{
+					ApplyButton( pState, event.code, event.isDown );
+					continue;
+				}
+				if ( event.device == Device::Focus )
+				{
+					for ( int vKey = 0; vKey < 256; ++vKey )
+					{
+						if ( GetBit( pState->keys, vKey ) ) { ApplyKey( pState, vKey, false ); }
+					}
+					continue;
+				}
+				if ( event.device == Device::Capture )
+				{
+					constexpr std::array<int, 5> MOUSE_BUTTONS{ VK_LBUTTON, VK_RBUTTON, VK_MBUTTON, VK_XBUTTON1, VK_XBUTTON2 };
+					for ( const int vKey : MOUSE_BUTTONS )
+					{
+						ApplyKey( pState, vKey, false );
+					}
+					continue;
+				}
+				// else
+
+				ApplyKey( pState, event.code, event.isDown );
+
+				// The gamepad is polled in Update(), so only the events of the messages are measured.
+				const double seconds = std::chrono::duration<double>( now - event.timestamp ).count();
+				latency.eventCount++;
+				latency.totalSeconds	+= seconds;
+				latency.maxSeconds		=  std::max( latency.maxSeconds, seconds );
+			}
+		}
+
+	#pragma endregion
+
+	#pragma region Gamepad
+
+		// Same order as Gamepad::Button::UP ~ Gamepad::Button::Y.
+		constexpr std::array<WORD, Gamepad::Button::LT> XINPUT_BUTTONS
+		{
+			XINPUT_GAMEPAD_DPAD_UP,
+			XINPUT_GAMEPAD_DPAD_DOWN,
+			XINPUT_GAMEPAD_DPAD_LEFT,
+			XINPUT_GAMEPAD_DPAD_RIGHT,
+			XINPUT_GAMEPAD_START,
+			XINPUT_GAMEPAD_BACK,
+			XINPUT_GAMEPAD_LEFT_THUMB,
+			XINPUT_GAMEPAD_RIGHT_THUMB,
+			XINPUT_GAMEPAD_LEFT_SHOULDER,
+			XINPUT_GAMEPAD_RIGHT_SHOULDER,
+			XINPUT_GAMEPAD_A,
+			XINPUT_GAMEPAD_B,
+			XINPUT_GAMEPAD_X,
+			XINPUT_GAMEPAD_Y
+		};
+
+		/// <summary>
+		/// Poll the PAD_1, and store the changes of buttons as the events. The thumbs are written to the "pState" directly.
+		/// </summary>
+		void PollGamepad( Snapshot *pState, std::chrono::steady_clock::time_point now )
+		{
+			// XInputGetState() to the disconnected pad is slow, so it is retried at intervals.
+			constexpr auto RETRY_INTERVAL = std::chrono::seconds( 1 );
+			if ( !pState->isPadConnected && now - lastPadPoll < RETRY_INTERVAL ) { return; }
+			// else
+			lastPadPoll = now;
+
+			XINPUT_STATE state{};
+			const bool isConnected = ( XInputGetState( Gamepad::PAD_1, &state ) == ERROR_SUCCESS );
+
+			std::uint32_t buttons = 0;
+			if ( isConnected )
+			{
+				const XINPUT_GAMEPAD &pad = state.Gamepad;
+				for ( size_t i = 0; i < XINPUT_BUTTONS.size(); ++i )
+				{
+					if ( pad.wButtons & XINPUT_BUTTONS[i] ) { buttons |= 1U << i; }
+				}
+				if ( XINPUT_GAMEPAD_TRIGGER_THRESHOLD < pad.bLeftTrigger  ) { buttons |= 1U << Gamepad::Button::LT; }
+				if ( XINPUT_GAMEPAD_TRIGGER_THRESHOLD < pad.bRightTrigger ) { buttons |= 1U << Gamepad::Button::RT; }
+
+				auto IsInDeadZone = []( long long x, long long y, long long deadZone )
+				{
+					return ( x * x + y * y < deadZone * deadZone );
+				};
+				const bool deadL = IsInDeadZone( pad.sThumbLX, pad.sThumbLY, XINPUT_GAMEPAD_LEFT_THUMB_DEADZONE  );
+				const bool deadR = IsInDeadZone( pad.sThumbRX, pad.sThumbRY, XINPUT_GAMEPAD_RIGHT_THUMB_DEADZONE );
+				pState->thumbs[0] = ( deadL ) ? 0 : pad.sThumbLX;
+				pState->thumbs[1] = ( deadL ) ? 0 : pad.sThumbLY;
+				pState->thumbs[2] = ( deadR ) ? 0 : pad.sThumbRX;
+				pState->thumbs[3] = ( deadR ) ? 0 : pad.sThumbRY;
+			}
+			else
+			{
+				pState->thumbs.fill( 0 );
+			}
+			pState->isPadConnected = isConnected;
+
+			const std::uint32_t changed = buttons ^ pState->buttons;
+			for ( int kind = 0; kind < Gamepad::Button::TERMINATION_OF_BUTTON_TYPES; ++kind )
+			{
+				if ( !( ( changed >> kind ) & 1U ) ) { continue; }
+				// else
+
+				Event event{};
+				event.timestamp	= now;
+				event.device	= Device::Gamepad;
+				event.code		= scast<unsigned char>( kind );
+				event.isDown	= ( ( buttons >> kind ) & 1U ) != 0;
+				PushEvent( event );
+			}
+		}
+
+	#pragma endregion
+
+		void Update()
+		{
+			const auto now = std::chrono::steady_clock::now();
+
+			Snapshot next = deviceState;
+			next.tick = current.tick + 1U;
+			next.keyDowns.fill( 0U );
+			next.keyUps.fill( 0U );
+			next.buttonDowns	= 0U;
+			next.buttonUps		= 0U;
+
+			PollGamepad( &next, now );
+			ConsumeEvents( &next, now );
+			deviceState = next;
+
+			previous = current;
+			current  = next;
+
+			if ( pSource )
+			{
+				Snapshot supplied{};
+				if ( pSource->Next( &supplied ) )
+				{
+					supplied.tick = next.tick;
+					current = supplied;
+				}
+				else
+				{
+					pSource.reset();
+				}
+			}
+
+			if ( isRecording )
+			{
+				recorded.emplace_back( current );
+			}
+		}
+
+		const Snapshot &Current()	{ return current;	}
+		const Snapshot &Previous()	{ return previous;	}
+
+		bool Press( int vKey )					{ return current.IsPressed( vKey );	}
+		bool Trigger( int vKey )				{ return current.IsDown( vKey );	}
+		bool Release( int vKey )				{ return current.IsUp( vKey );		}
+		bool Press( Gamepad::Button kind )		{ return current.IsPressed( kind );	}
+		bool Trigger( Gamepad::Button kind )	{ return current.IsDown( kind );	}
+		bool Release( Gamepad::Button kind )	{ return current.IsUp( kind );		}
+
+		void StartRecording()
+		{
+			recorded.clear();
+			isRecording = true;
+		}
+		std::vector<Snapshot> StopRecording()
+		{
+			isRecording = false;
+
+			std::vector<Snapshot> result{};
+			result.swap( recorded );
+			return result;
+		}
+		bool IsRecording()
+		{
+			return isRecording;
+		}
+
+		constexpr const char *SERIAL_ID = "InputSnapshots";
+		bool SaveSnapshots( const std::vector<Snapshot> &snapshots, const std::string &filePath )
+		{
+			std::vector<Snapshot> instance = snapshots;
+			return Donya::Serializer::Save( instance, filePath.c_str(), SERIAL_ID, /* toBinary = */ true );
+		}
+		bool LoadSnapshots( std::vector<Snapshot> *pOutput, const std::string &filePath )
+		{
+			return Donya::Serializer::Load( *pOutput, filePath.c_str(), SERIAL_ID, /* fromBinary = */ true );
+		}
+
+		LatencyStats GetLatencyStats()
+		{
+			return latency;
+		}
+		void ResetLatencyStats()
+		{
+			latency = LatencyStats{};
+		}
+
+	#if USE_IMGUI
+
+		void ShowImGuiNode( const char *nodeCaption )
+		{
+			if ( !ImGui::TreeNode( nodeCaption ) ) { return; }
+			// else
+
+			constexpr double TO_MS = 1000.0;
+			ImGui::Text( u8"Tick[%llu], Pad[%s]", current.tick, ( current.isPadConnected ) ? "Connected" : "None" );
+			ImGui::Text
+			(
+				u8"Latency : Average[%.3f ms], Max[%.3f ms], Events[%llu], Dropped[%llu]",
+				latency.AverageSeconds() * TO_MS, latency.maxSeconds * TO_MS,
+				latency.eventCount, latency.droppedCount
+			);
+			if ( ImGui::Button( u8"Reset latency" ) ) { ResetLatencyStats(); }
+
+			ImGui::Separator();
+
+			static std::vector<Snapshot> lastRecorded{};
+			if ( isRecording )
+			{
+				ImGui::Text( u8"Recording[%d ticks]", scast<int>( recorded.size() ) );
+				if ( ImGui::Button( u8"Stop recording" ) ) { lastRecorded = StopRecording(); }
+			}
+			else
+			{
+				if ( ImGui::Button( u8"Start recording" ) ) { StartRecording(); }
+			}
+
+			if ( !lastRecorded.empty() && !IsUsingSource() )
+			{
+				if ( ImGui::Button( u8"Replay the recorded" ) )
+				{
+					SetSource( std::make_shared<ReplaySource>( lastRecorded ) );
+				}
+			}
+
+			ImGui::TreePop();
+		}
+
+	#endif // USE_IMGUI
+	}
+}
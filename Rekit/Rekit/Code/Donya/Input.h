@@ -0,0 +1,200 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>		// Use std::uint32_t, std::int16_t.
+#include <memory>
+#include <string>
+#include <vector>
+
+#define NOMINMAX
+#include <Windows.h>	// Use HWND, UINT, WPARAM, LPARAM.
+
+#include "cereal/cereal.hpp"
+#include "cereal/types/array.hpp"
+
+#include "GamepadXInput.h"	// Use Gamepad::Button.
+#include "UseImgui.h"		// Use USE_IMGUI macro.
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The input that is collected by events, and read by per-tick snapshot.<para></para>
+	/// The window messages of the keyboard and the mouse buttons are stored into a ring buffer with the timestamp, and the gamepad(PAD_1) is polled once per tick.
+	/// Update() applies the stored events to the snapshot, so the queries do not touch the devices.<para></para>
+	/// The snapshot can be supplied by a Source instead of the devices, for the replay or the benchmark.<para></para>
+	/// Please use from the main thread only.
+	/// </summary>
+	namespace Input
+	{
+		enum class Device : unsigned char
+		{
+			Keyboard = 0,	// The code is a virtual key code. The mouse buttons are included as VK_LBUTTON, VK_RBUTTON, etc.
+			Gamepad,		// The code is a Gamepad::Button.
+			Focus,			// The window lost the focus, releases all keys after the earlier events. The code is not used.
+			Capture,		// The window lost the mouse capture, releases the mouse buttons after the earlier events. The code is not used.
+		};
+		struct Event
+		{
+			std::chrono::steady_clock::time_point	timestamp{};
+			Device									device{};
+			unsigned char							code{};
+			bool									isDown{};
+		};
+
+		/// <summary>
+		/// The state of a tick. The "Down" and "Up" bits are set if the event happened in the tick, so the press that is shorter than a tick is not lost.
+		/// </summary>
+		struct Snapshot
+		{
+			static constexpr size_t KEY_WORD_COUNT = 256U / 32U;
+		public:
+			unsigned long long							tick{};
+			std::array<std::uint32_t, KEY_WORD_COUNT>	keys{};			// Pressing at the end of the tick.
+			std::array<std::uint32_t, KEY_WORD_COUNT>	keyDowns{};
+			std::array<std::uint32_t, KEY_WORD_COUNT>	keyUps{};
+			std::uint32_t								buttons{};		// The bits of Gamepad::Button.
+			std::uint32_t								buttonDowns{};
+			std::uint32_t								buttonUps{};
+			std::array<std::int16_t, 4>					thumbs{};		// LX, LY, RX, RY. The values in the dead zone are zero.
+			bool										isPadConnected{};
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( tick ),
+					CEREAL_NVP( keys ),
+					CEREAL_NVP( keyDowns ),
+					CEREAL_NVP( keyUps ),
+					CEREAL_NVP( buttons ),
+					CEREAL_NVP( buttonDowns ),
+					CEREAL_NVP( buttonUps ),
+					CEREAL_NVP( thumbs ),
+					CEREAL_NVP( isPadConnected )
+				);
+			}
+		public:
+			bool IsPressed( int vKey )				const;
+			bool IsDown( int vKey )					const;
+			bool IsUp( int vKey )					const;
+			bool IsPressed( Gamepad::Button kind )	const;
+			bool IsDown( Gamepad::Button kind )		const;
+			bool IsUp( Gamepad::Button kind )		const;
+			/// <summary>
+			/// Returns (x, y) is [-1.0f ~ 1.0f]. Same as Gamepad::LeftStick().
+			/// </summary>
+			Vector2 LeftStick()						const;
+			/// <summary>
+			/// Returns (x, y) is [-1.0f ~ 1.0f]. Same as Gamepad::RightStick().
+			/// </summary>
+			Vector2 RightStick()					const;
+		};
+
+		/// <summary>
+		/// Supply the snapshots instead of the devices.
+		/// </summary>
+		class Source
+		{
+		public:
+			virtual ~Source() = default;
+		public:
+			/// <summary>
+			/// Write the snapshot of the next tick. Returns false if the source is finished, then the devices are used again.
+			/// </summary>
+			virtual bool Next( Snapshot *pOutput ) = 0;
+		};
+		/// <summary>
+		/// Supply the recorded snapshots in the order.
+		/// </summary>
+		class ReplaySource : public Source
+		{
+		private:
+			std::vector<Snapshot>	snapshots;
+			size_t					index;
+		public:
+			ReplaySource( std::vector<Snapshot> snapshots ) : snapshots( std::move( snapshots ) ), index( 0 ) {}
+		public:
+			bool Next( Snapshot *pOutput ) override;
+		public:
+			size_t GetIndex() const { return index; }
+			size_t GetCount() const { return snapshots.size(); }
+		};
+
+		/// <summary>
+		/// Please call at the top of the window procedure. This stores the events of the keyboard and the mouse buttons.<para></para>
+		/// The mouse is captured to the "hWnd" while a button is pressed, so the release outside of the window is also received.<para></para>
+		/// This does not consume the message.
+		/// </summary>
+		void ProcessMessage( HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam );
+		/// <summary>
+		/// Store an event. If the buffer is full, the oldest one is discarded.
+		/// </summary>
+		void PushEvent( const Event &event );
+
+		/// <summary>
+		/// Please call once per tick on the main thread. Donya::SystemUpdate() calls this.<para></para>
+		/// Make the snapshot of this tick from the stored events and the gamepad, or from the Source if it is set.
+		/// </summary>
+		void Update();
+
+		const Snapshot &Current();
+		const Snapshot &Previous();
+
+		// These are shortcuts to the Current().
+
+		bool Press( int vKey );
+		bool Trigger( int vKey );
+		bool Release( int vKey );
+		bool Press( Gamepad::Button kind );
+		bool Trigger( Gamepad::Button kind );
+		bool Release( Gamepad::Button kind );
+
+		/// <summary>
+		/// Use the "pSource" instead of the devices from the next Update(). The nullptr restores the devices.<para></para>
+		/// The devices are still tracked while the source is used, but these are not reported.
+		/// </summary>
+		void SetSource( std::shared_ptr<Source> pSource );
+		bool IsUsingSource();
+
+		/// <summary>
+		/// Store the snapshots of following Update() until StopRecording().
+		/// </summary>
+		void StartRecording();
+		std::vector<Snapshot> StopRecording();
+		bool IsRecording();
+
+		bool SaveSnapshots( const std::vector<Snapshot> &snapshots, const std::string &filePath );
+		/// <summary>
+		/// Returns false if the file is not found.
+		/// </summary>
+		bool LoadSnapshots( std::vector<Snapshot> *pOutput, const std::string &filePath );
+
+		/// <summary>
+		/// The time from an event is stored until the Update() applies it.
+		/// </summary>
+		struct LatencyStats
+		{
+			unsigned long long	eventCount{};
+			unsigned long long	droppedCount{};	// The count of events that were discarded by the full buffer.
+			double				totalSeconds{};
+			double				maxSeconds{};
+		public:
+			double AverageSeconds() const { return ( eventCount ) ? totalSeconds / eventCount : 0.0; }
+		};
+		LatencyStats GetLatencyStats();
+		void ResetLatencyStats();
+
+	#if USE_IMGUI
+		/// <summary>
+		/// Show the latency and the recording by ImGui::TreeNode(). Please call between ImGui::Begin() and ImGui::End().
+		/// </summary>
+		void ShowImGuiNode( const char *nodeCaption );
+	#endif // USE_IMGUI
+	}
+}
+
+CEREAL_CLASS_VERSION( Donya::Input::Snapshot, 0 )
@@ -2,6 +2,8 @@
 
 #include <Windows.h>
 
+#include "Input.h"
+
 namespace Donya
 {
 
@@ -21,15 +23,12 @@ namespace Donya
 				// NOP, I should be error process.
 			}
 
-			BYTE temporary[KEYBOARD_SIZE] = { 0 };
-			if ( GetKeyboardState( temporary ) == FALSE )
-			{
-				// NOP, I should be error process.
-			}
+			// Read the snapshot instead of the device, so the replay of Donya::Input also drives this.
+			const auto &snapshot = Donya::Input::Current();
 
 			for ( size_t i = 0; i < KEYBOARD_SIZE; ++i )
 			{
-				if ( temporary[i] & 0x80 )
+				if ( snapshot.IsPressed( static_cast<int>( i ) ) )
 				{
 					if ( UINT_MAX <= current[i] ) { continue; }
 					// else
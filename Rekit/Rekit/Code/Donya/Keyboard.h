@@ -12,12 +12,12 @@ namespace Donya
 #if USE_STATIC_ARRAY_FOR_KEYBOARD_UPDATE
 
 	/// <summary>
-	/// Using GetKeyboardState().
+	/// Using the snapshot of Donya::Input, so the replay of Donya::Input also drives this.
 	/// </summary>
 	namespace Keyboard
 	{
 		/// <summary>
-		/// Please call every frame.
+		/// Please call every frame, after Donya::Input::Update(). Donya::SystemUpdate() calls this.
 		/// </summary>
 		void Update();
 
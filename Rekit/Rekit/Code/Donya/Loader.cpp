@@ -1,5 +1,6 @@
 #include "Loader.h"
 
+#include <algorithm>
 #include <crtdbg.h>
 #include <Windows.h>
 
@@ -7,7 +8,9 @@
 #include <fbxsdk.h>
 #endif // USE_FBX_SDK
 
+#include "AssetPipeline.h"
 #include "Constant.h"	// Use scast macro.
+#include "MotionCompression.h"
 #include "Useful.h"		// Use OutputDebugStr().
 
 #undef min
@@ -31,16 +34,18 @@ namespace Donya
 {
 	Loader::Loader() :
 		absFilePath(), fileName(), fileDirectory(),
-		meshes(), motions(), collisionFaces()
+		meshes(), motions(), collisionFaces(), compressedMotions()
 	{}
 	Loader::~Loader()
 	{
 		meshes.clear();
 		motions.clear();
 		collisionFaces.clear();
+		compressedMotions.clear();
 		meshes.shrink_to_fit();
 		motions.shrink_to_fit();
 		collisionFaces.shrink_to_fit();
+		compressedMotions.shrink_to_fit();
 	}
 
 	std::mutex Loader::cerealMutex{};
@@ -298,10 +303,24 @@ namespace Donya
 
 #endif // USE_FBX_SDK
 
-	bool Loader::Load( const std::string &filePath, std::string *outputErrorString, bool outputProgress )
+	bool Loader::Load( const std::string &filePath, std::string *outputErrorString, bool outputProgress, bool allowCachedBinary )
 	{
 		std::string fullPath = ToFullPath( filePath );
 
+		std::string cachedPath{};
+		if ( allowCachedBinary && AssetPipeline::IsSourceAsset( filePath ) && AssetPipeline::FindCachedBinary( filePath, &cachedPath ) )
+		{
+			OutputDebugProgress( std::string{ "Start By Cached Binary:" + cachedPath }, outputProgress );
+
+			bool succeeded = LoadByCereal( ToFullPath( cachedPath ), outputErrorString, outputProgress );
+
+			const std::string resultString = ( succeeded ) ? "Load By Cached Binary Successful:" : "Load By Cached Binary Failed:";
+			OutputDebugProgress( resultString + filePath, outputProgress );
+
+			if ( succeeded ) { return true; }
+			// else the binary is broken, so fall back to the source.
+		}
+
 	#if USE_FBX_SDK
 
 		auto ShouldUseFBXSDK = []( const std::string &filePath )
@@ -382,6 +401,33 @@ namespace Donya
 		seria.Save( bin, filePath.c_str(),  SERIAL_ID, *this );
 	}
 	
+	bool Loader::CompressMotions( const CompressedMotion::Tolerance &tolerance, bool discardSourceMotions )
+	{
+		bool succeeded = true;
+
+		std::vector<Motion> remainMotions{};
+		for ( auto &motion : motions )
+		{
+			CompressedMotion compressed{};
+			if ( !MotionCompression::Compress( motion, tolerance, &compressed ) )
+			{
+				succeeded = false;
+				remainMotions.emplace_back( std::move( motion ) );
+				continue;
+			}
+			// else
+
+			compressedMotions.emplace_back( std::move( compressed ) );
+			if ( !discardSourceMotions )
+			{
+				remainMotions.emplace_back( std::move( motion ) );
+			}
+		}
+
+		motions.swap( remainMotions );
+		return succeeded;
+	}
+	
 	bool Loader::LoadByCereal( const std::string &filePath, std::string *outputErrorString, bool outputProgress )
 	{
 		Donya::Serializer::Extension ext = Donya::Serializer::Extension::BINARY;
@@ -1147,6 +1193,41 @@ namespace Donya
 				ImGui::TreePop();
 			}
 		}
+
+		const size_t compressedMotionCount = compressedMotions.size();
+		for ( size_t i = 0; i < compressedMotionCount; ++i )
+		{
+			const auto &motion = compressedMotions[i];
+			const std::string motionCaption = "CompressedMotion[" + std::to_string( i ) + "]";
+			if ( ImGui::TreeNode( motionCaption.c_str() ) )
+			{
+				ImGui::Text( "Mesh.No:%d", motion.meshNo );
+				ImGui::Text( "Mesh.SamplingRate:%5.3f", motion.samplingRate );
+				ImGui::Text( "FrameCount:%d", motion.frameCount );
+				ImGui::Text( "TransformByteSize:%d", MotionCompression::CalcTransformByteSize( motion ) );
+
+				if ( ImGui::TreeNode( "Tracks" ) )
+				{
+					const size_t trackCount = std::min( motion.tracks.size(), motion.boneNames.size() );
+					for ( size_t t = 0; t < trackCount; ++t )
+					{
+						const auto &track = motion.tracks[t];
+						ImGui::Text
+						(
+							"[%d].Name:[%s], Keys:[T:%d][R:%d][S:%d]",
+							t, motion.boneNames[t].c_str(),
+							track.translationFrames.size(),
+							track.rotationFrames.size(),
+							track.scaleFrames.size()
+						);
+					}
+
+					ImGui::TreePop();
+				}
+
+				ImGui::TreePop();
+			}
+		}
 	}
 #endif // USE_IMGUI
 }
\ No newline at end of file
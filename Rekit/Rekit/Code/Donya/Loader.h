@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -179,6 +180,78 @@ namespace Donya
 			}
 		};
 
+		/// <summary>
+		/// The compressed form of a Motion. Each bone has own tracks of translation, rotation and scale,
+		/// and each track stores only the keyframes that are necessary for the tolerance.<para></para>
+		/// The rotations are quantized to 48 bits. Please sample it by Donya::MotionCompression::Sampler.
+		/// </summary>
+		struct CompressedMotion
+		{
+			/// <summary>
+			/// The max error of a track between the source and the interpolated keyframes.
+			/// </summary>
+			struct Tolerance
+			{
+				float translation	= 0.001f;	// The distance.
+				float rotation		= 0.0005f;	// The angle, radian.
+				float scale			= 0.0001f;	// Per axis.
+			};
+			/// <summary>
+			/// The keyframes of a bone. The frame numbers are ascending, the first is 0 and the last is the last frame of motion.
+			/// </summary>
+			struct Track
+			{
+				std::vector<std::uint16_t>					translationFrames{};
+				std::vector<Donya::Vector3>					translations{};
+				std::vector<std::uint16_t>					rotationFrames{};
+				std::vector<std::array<std::uint16_t, 3>>	rotations{};	// Quantized by "smallest three".
+				std::vector<std::uint16_t>					scaleFrames{};
+				std::vector<Donya::Vector3>					scales{};
+			private:
+				friend class cereal::access;
+				template<class Archive>
+				void serialize( Archive &archive, std::uint32_t version )
+				{
+					archive
+					(
+						CEREAL_NVP( translationFrames ),	CEREAL_NVP( translations ),
+						CEREAL_NVP( rotationFrames ),		CEREAL_NVP( rotations ),
+						CEREAL_NVP( scaleFrames ),			CEREAL_NVP( scales )
+					);
+					if ( 1 <= version )
+					{
+						// archive();
+					}
+				}
+			};
+		public:
+			int							meshNo{};	// 0-based.
+			float						samplingRate{ Motion::DEFAULT_SAMPLING_RATE };
+			size_t						frameCount{};
+			std::vector<std::string>	names{};
+			std::vector<std::string>	boneNames{};
+			std::vector<Track>			tracks{};	// Per bone.
+		private:
+			friend class cereal::access;
+			template<class Archive>
+			void serialize( Archive &archive, std::uint32_t version )
+			{
+				archive
+				(
+					CEREAL_NVP( meshNo ),
+					CEREAL_NVP( samplingRate ),
+					CEREAL_NVP( frameCount ),
+					CEREAL_NVP( names ),
+					CEREAL_NVP( boneNames ),
+					CEREAL_NVP( tracks )
+				);
+				if ( 1 <= version )
+				{
+					// archive();
+				}
+			}
+		};
+
 		struct BoneInfluence
 		{
 			int		index{};
@@ -288,6 +361,7 @@ namespace Donya
 		std::vector<Mesh>	meshes;
 		std::vector<Motion> motions;
 		std::vector<Face>	collisionFaces;
+		std::vector<CompressedMotion> compressedMotions;
 	public:
 		Loader();
 		~Loader();
@@ -312,6 +386,10 @@ namespace Donya
 				archive( CEREAL_NVP( collisionFaces ) );
 			}
 			if ( 3 <= version )
+			{
+				archive( CEREAL_NVP( compressedMotions ) );
+			}
+			if ( 4 <= version )
 			{
 				// archive( CEREAL_NVP( x ) );
 			}
@@ -322,14 +400,23 @@ namespace Donya
 		/// .fbx, .FBX(If the flag of use fbx-sdk is on),<para></para>
 		/// .obj, .OBJ(If the flag of use fbx-sdk is on),<para></para>
 		/// .bin, .json(Expect, only file of saved by this Loader class).<para></para>
+		/// If "allowCachedBinary" is true and the .fbx or .obj is converted by the AssetPipeline, the converted binary is loaded instead.
+		/// So we can load these even if the flag of use fbx-sdk is off.<para></para>
 		/// The "outputErrorString" can set nullptr.
 		/// </summary>
-		bool Load( const std::string &filePath, std::string *outputErrorString, bool outputDebugProgress = true );
+		bool Load( const std::string &filePath, std::string *outputErrorString, bool outputDebugProgress = true, bool allowCachedBinary = true );
 
 		/// <summary>
 		/// We expect the "filePath" contain extension also.
 		/// </summary>
 		void SaveByCereal( const std::string &filePath ) const;
+
+		/// <summary>
+		/// Compress all motions to the "compressedMotions", it is far smaller than the sampled matrices.<para></para>
+		/// If "discardSourceMotions" is true, the compressed motions are removed from the "motions", so the saved file also becomes small.<para></para>
+		/// Returns false if some motion can not be compressed(e.g. the bone count is changed in the motion), then that motion is kept.
+		/// </summary>
+		bool CompressMotions( const CompressedMotion::Tolerance &tolerance = CompressedMotion::Tolerance{}, bool discardSourceMotions = true );
 	public:
 		std::string GetAbsoluteFilePath()					const { return absFilePath;		}
 		std::string GetOnlyFileName()						const { return fileName;		}
@@ -337,6 +424,7 @@ namespace Donya
 		const std::vector<Mesh>		*GetMeshes()			const { return &meshes;			}
 		const std::vector<Motion>	*GetMotions()			const { return &motions;		}
 		const std::vector<Face>		*GetCollisionFaces()	const { return &collisionFaces;	}
+		const std::vector<CompressedMotion>	*GetCompressedMotions()	const { return &compressedMotions; }
 	private:
 		bool LoadByCereal( const std::string &filePath, std::string *outputErrorString, bool outputDebugProgress );
 		
@@ -369,12 +457,14 @@ namespace Donya
 
 }
 
-CEREAL_CLASS_VERSION( Donya::Loader,				2 )
+CEREAL_CLASS_VERSION( Donya::Loader,				3 )
 CEREAL_CLASS_VERSION( Donya::Loader::Material,		0 )
 CEREAL_CLASS_VERSION( Donya::Loader::Subset,		0 )
 CEREAL_CLASS_VERSION( Donya::Loader::Bone,			0 )
 CEREAL_CLASS_VERSION( Donya::Loader::Skeletal,		0 )
 CEREAL_CLASS_VERSION( Donya::Loader::Motion,		0 )
+CEREAL_CLASS_VERSION( Donya::Loader::CompressedMotion,			0 )
+CEREAL_CLASS_VERSION( Donya::Loader::CompressedMotion::Track,	0 )
 CEREAL_CLASS_VERSION( Donya::Loader::BoneInfluence, 0 )
 CEREAL_CLASS_VERSION( Donya::Loader::BoneInfluencesPerControlPoint, 0 )
 CEREAL_CLASS_VERSION( Donya::Loader::Mesh,			1 )
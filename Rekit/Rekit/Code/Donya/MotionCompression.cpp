@@ -0,0 +1,453 @@
+#include "MotionCompression.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include "Constant.h"	// Use scast macro.
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace MotionCompression
+	{
+		namespace
+		{
+			constexpr float	SQRT_HALF		= 0.70710678f;	// The max absolute value of the components except the largest one.
+			constexpr float	QUANTIZE_SCALE	= 32767.0f;		// 15 bits.
+
+			Donya::Vector3 Lerp( const Donya::Vector3 &begin, const Donya::Vector3 &end, float t )
+			{
+				return begin + ( end - begin ) * t;
+			}
+			/// <summary>
+			/// Normalized linear interpolation. It is enough for the near keyframes, and faster than the slerp.
+			/// </summary>
+			Donya::Quaternion Nlerp( const Donya::Quaternion &begin, const Donya::Quaternion &end, float t )
+			{
+				// Take the shortest path.
+				const float sign = ( Donya::Quaternion::Dot( begin, end ) < 0.0f ) ? -1.0f : 1.0f;
+				const Donya::Quaternion blended
+				{
+					begin.x + ( end.x * sign - begin.x ) * t,
+					begin.y + ( end.y * sign - begin.y ) * t,
+					begin.z + ( end.z * sign - begin.z ) * t,
+					begin.w + ( end.w * sign - begin.w ) * t
+				};
+				return blended.Normalized();
+			}
+
+			/// <summary>
+			/// Returns the distance between the quaternions, in the same hemisphere.
+			/// </summary>
+			float CalcChord( const Donya::Quaternion &L, const Donya::Quaternion &R )
+			{
+				const float sign = ( Donya::Quaternion::Dot( L, R ) < 0.0f ) ? -1.0f : 1.0f;
+				const float dx = L.x - R.x * sign;
+				const float dy = L.y - R.y * sign;
+				const float dz = L.z - R.z * sign;
+				const float dw = L.w - R.w * sign;
+				return sqrtf( dx * dx + dy * dy + dz * dz + dw * dw );
+			}
+
+			/// <summary>
+			/// Keep the first and the last frame, and the frames that the interpolation between the kept frames can not reproduce.<para></para>
+			/// The "IsReproducible( i, keyBegin, keyEnd )" returns true if the frame "i" is reproduced by the interpolation between the keys.
+			/// If the all frames are reproduced by the first key only, keeps the first key only.
+			/// </summary>
+			template<typename Function>
+			std::vector<std::uint16_t> ReduceKeyframes( size_t frameCount, Function IsReproducible )
+			{
+				auto IsReproducibleAll = [&]( size_t keyBegin, size_t keyEnd )
+				{
+					for ( size_t i = keyBegin + 1; i < keyEnd; ++i )
+					{
+						if ( !IsReproducible( i, keyBegin, keyEnd ) ) { return false; }
+					}
+					return true;
+				};
+
+				// Check the constant track.
+				{
+					bool isConstant = true;
+					for ( size_t i = 1; i < frameCount && isConstant; ++i )
+					{
+						isConstant = IsReproducible( i, 0U, 0U );
+					}
+					if ( isConstant ) { return std::vector<std::uint16_t>{ 0U }; }
+				}
+				// else
+
+				// Extend the segment greedily, then the last reachable frame becomes the next key.
+				std::vector<std::uint16_t> keys{ 0U };
+				size_t keyBegin = 0;
+				for ( size_t keyEnd = 2; keyEnd < frameCount; ++keyEnd )
+				{
+					if ( IsReproducibleAll( keyBegin, keyEnd ) ) { continue; }
+					// else
+
+					keyBegin = keyEnd - 1;
+					keys.emplace_back( scast<std::uint16_t>( keyBegin ) );
+				}
+				keys.emplace_back( scast<std::uint16_t>( frameCount - 1 ) );
+				return keys;
+			}
+
+			float CalcRatio( size_t frame, size_t keyBegin, size_t keyEnd )
+			{
+				if ( keyEnd <= keyBegin ) { return 0.0f; }
+				// else
+				return scast<float>( frame - keyBegin ) / scast<float>( keyEnd - keyBegin );
+			}
+
+			/// <summary>
+			/// Returns the index of key that is the last key of [key.frame <= frame]. The "pCursor" is the hint and updated.
+			/// </summary>
+			size_t FindKey( const std::vector<std::uint16_t> &frames, float frame, size_t *pCursor )
+			{
+				constexpr size_t MAX_WALK_COUNT = 4U;
+
+				const size_t keyCount = frames.size();
+				size_t key = *pCursor;
+				if ( key < keyCount && scast<float>( frames[key] ) <= frame )
+				{
+					// The next key is usually near if playing forward.
+					for ( size_t i = 0; i < MAX_WALK_COUNT; ++i )
+					{
+						if ( keyCount <= key + 1U || frame < scast<float>( frames[key + 1U] ) )
+						{
+							*pCursor = key;
+							return key;
+						}
+						// else
+						++key;
+					}
+				}
+
+				// Rewound or jumped, so search by binary.
+				auto found = std::upper_bound
+				(
+					frames.begin(), frames.end(), frame,
+					[]( float lhs, std::uint16_t rhs ) { return lhs < scast<float>( rhs ); }
+				);
+				key = ( found == frames.begin() ) ? 0U : scast<size_t>( found - frames.begin() ) - 1U;
+				*pCursor = key;
+				return key;
+			}
+
+			Donya::Vector3 SampleVector( const std::vector<std::uint16_t> &frames, const std::vector<Donya::Vector3> &values, float frame, size_t *pCursor )
+			{
+				const size_t key = FindKey( frames, frame, pCursor );
+				if ( frames.size() <= key + 1U ) { return values[key]; }
+				// else
+
+				const float begin	= scast<float>( frames[key] );
+				const float end		= scast<float>( frames[key + 1U] );
+				return Lerp( values[key], values[key + 1U], ( frame - begin ) / ( end - begin ) );
+			}
+			Donya::Quaternion SampleRotation( const std::vector<std::uint16_t> &frames, const std::vector<std::array<std::uint16_t, 3>> &values, float frame, size_t *pCursor )
+			{
+				const size_t key = FindKey( frames, frame, pCursor );
+				if ( frames.size() <= key + 1U ) { return DequantizeRotation( values[key] ); }
+				// else
+
+				const float begin	= scast<float>( frames[key] );
+				const float end		= scast<float>( frames[key + 1U] );
+				return Nlerp
+				(
+					DequantizeRotation( values[key] ),
+					DequantizeRotation( values[key + 1U] ),
+					( frame - begin ) / ( end - begin )
+				);
+			}
+		}
+
+		Transform Transform::Decompose( const Donya::Vector4x4 &M )
+		{
+			Transform rv{};
+			rv.translation = Donya::Vector3{ M._41, M._42, M._43 };
+
+			Donya::Vector3 rows[3]
+			{
+				Donya::Vector3{ M._11, M._12, M._13 },
+				Donya::Vector3{ M._21, M._22, M._23 },
+				Donya::Vector3{ M._31, M._32, M._33 },
+			};
+			rv.scale = Donya::Vector3{ rows[0].Length(), rows[1].Length(), rows[2].Length() };
+
+			const float determinant = Donya::Vector3::Dot( Donya::Vector3::Cross( rows[0], rows[1] ), rows[2] );
+			if ( determinant < 0.0f ) { rv.scale.x *= -1.0f; }
+
+			const float scales[3]{ rv.scale.x, rv.scale.y, rv.scale.z };
+			for ( int i = 0; i < 3; ++i )
+			{
+				// The degenerated axis can not be decomposed.
+				if ( fabsf( scales[i] ) < FLT_EPSILON ) { return rv; }
+				// else
+				rows[i] *= 1.0f / scales[i];
+			}
+
+			Donya::Vector4x4 rotation{};
+			rotation._11 = rows[0].x; rotation._12 = rows[0].y; rotation._13 = rows[0].z;
+			rotation._21 = rows[1].x; rotation._22 = rows[1].y; rotation._23 = rows[1].z;
+			rotation._31 = rows[2].x; rotation._32 = rows[2].y; rotation._33 = rows[2].z;
+			rv.rotation = Donya::Quaternion::Make( rotation ).Normalized();
+
+			return rv;
+		}
+		Donya::Vector4x4 Transform::ToMatrix() const
+		{
+			const DirectX::XMFLOAT4X4 R = rotation.RequireRotationMatrix();
+
+			Donya::Vector4x4 M{};
+			M._11 = R._11 * scale.x;	M._12 = R._12 * scale.x;	M._13 = R._13 * scale.x;
+			M._21 = R._21 * scale.y;	M._22 = R._22 * scale.y;	M._23 = R._23 * scale.y;
+			M._31 = R._31 * scale.z;	M._32 = R._32 * scale.z;	M._33 = R._33 * scale.z;
+			M._41 = translation.x;		M._42 = translation.y;		M._43 = translation.z;
+			return M;
+		}
+
+		std::array<std::uint16_t, 3> QuantizeRotation( const Donya::Quaternion &Q )
+		{
+			const float components[4]{ Q.x, Q.y, Q.z, Q.w };
+
+			std::uint16_t largestIndex = 0;
+			for ( std::uint16_t i = 1; i < 4; ++i )
+			{
+				if ( fabsf( components[largestIndex] ) < fabsf( components[i] ) )
+				{
+					largestIndex = i;
+				}
+			}
+
+			// The Q and -Q are same rotation, so make the largest one positive, then it can be restored from the others.
+			const float sign = ( components[largestIndex] < 0.0f ) ? -1.0f : 1.0f;
+
+			std::array<std::uint16_t, 3> rv{};
+			for ( std::uint16_t i = 0, out = 0; i < 4; ++i )
+			{
+				if ( i == largestIndex ) { continue; }
+				// else
+
+				const float normalized = std::max( -1.0f, std::min( 1.0f, components[i] * sign / SQRT_HALF ) );	// -1 ~ +1
+				rv[out++] = scast<std::uint16_t>( lroundf( ( normalized * 0.5f + 0.5f ) * QUANTIZE_SCALE ) );
+			}
+
+			// Store the index at the highest bits.
+			rv[0] |= scast<std::uint16_t>( ( largestIndex & 1U ) << 15 );
+			rv[1] |= scast<std::uint16_t>( ( largestIndex & 2U ) << 14 );
+			return rv;
+		}
+		Donya::Quaternion DequantizeRotation( const std::array<std::uint16_t, 3> &quantized )
+		{
+			const std::uint16_t largestIndex = scast<std::uint16_t>( ( quantized[0] >> 15 ) | ( ( quantized[1] >> 15 ) << 1 ) );
+
+			float components[4]{};
+			float lengthSq = 0.0f;
+			for ( std::uint16_t i = 0, in = 0; i < 4; ++i )
+			{
+				if ( i == largestIndex ) { continue; }
+				// else
+
+				constexpr float DEQUANTIZE_SCALE = 2.0f / QUANTIZE_SCALE;
+				const float normalized = scast<float>( quantized[in++] & 0x7FFFU ) * DEQUANTIZE_SCALE - 1.0f;
+				components[i] = normalized * SQRT_HALF;
+				lengthSq += components[i] * components[i];
+			}
+			// The restored quaternion is already normalized.
+			components[largestIndex] = sqrtf( std::max( 0.0f, 1.0f - lengthSq ) );
+
+			return Donya::Quaternion{ components[0], components[1], components[2], components[3] };
+		}
+
+		bool Compress( const Loader::Motion &source, const Loader::CompressedMotion::Tolerance &tolerance, Loader::CompressedMotion *pOutput )
+		{
+			if ( !pOutput ) { return false; }
+			// else
+
+			const size_t frameCount = source.motion.size();
+			if ( !frameCount || MAX_FRAME_COUNT < frameCount ) { return false; }
+			// else
+
+			const size_t boneCount = source.motion.front().skeletal.size();
+			for ( const auto &skeletal : source.motion )
+			{
+				if ( skeletal.skeletal.size() != boneCount ) { return false; }
+			}
+			// else
+
+			Loader::CompressedMotion &output = *pOutput;
+			output = Loader::CompressedMotion{};
+			output.meshNo		= source.meshNo;
+			output.samplingRate	= source.samplingRate;
+			output.frameCount	= frameCount;
+			output.names		= source.names;
+			output.tracks.resize( boneCount );
+			for ( const auto &bone : source.motion.front().skeletal )
+			{
+				output.boneNames.emplace_back( bone.name );
+			}
+
+			// Compare the rotations by the chord length of quaternions( 2 * sin( angle / 4 ) ).
+			// The cosine of a small angle is too close to 1 for the float.
+			const float maxRotationChord = 2.0f * sinf( std::max( 0.0f, tolerance.rotation ) * 0.25f );
+
+			std::vector<Transform>			transforms( frameCount );
+			std::vector<Donya::Quaternion>	quantizedRotations( frameCount );	// The rotation that the runtime will restore.
+			for ( size_t b = 0; b < boneCount; ++b )
+			{
+				for ( size_t f = 0; f < frameCount; ++f )
+				{
+					transforms[f]			= Transform::Decompose( source.motion[f].skeletal[b].transform );
+					quantizedRotations[f]	= DequantizeRotation( QuantizeRotation( transforms[f].rotation ) );
+				}
+
+				auto &track = output.tracks[b];
+
+				track.translationFrames = ReduceKeyframes
+				(
+					frameCount,
+					[&]( size_t i, size_t keyBegin, size_t keyEnd )
+					{
+						const Donya::Vector3 interpolated = Lerp( transforms[keyBegin].translation, transforms[keyEnd].translation, CalcRatio( i, keyBegin, keyEnd ) );
+						return ( ( interpolated - transforms[i].translation ).Length() <= tolerance.translation );
+					}
+				);
+				track.rotationFrames = ReduceKeyframes
+				(
+					frameCount,
+					[&]( size_t i, size_t keyBegin, size_t keyEnd )
+					{
+						const Donya::Quaternion interpolated = Nlerp( quantizedRotations[keyBegin], quantizedRotations[keyEnd], CalcRatio( i, keyBegin, keyEnd ) );
+						return ( CalcChord( interpolated, transforms[i].rotation ) <= maxRotationChord );
+					}
+				);
+				track.scaleFrames = ReduceKeyframes
+				(
+					frameCount,
+					[&]( size_t i, size_t keyBegin, size_t keyEnd )
+					{
+						const Donya::Vector3 diff = Lerp( transforms[keyBegin].scale, transforms[keyEnd].scale, CalcRatio( i, keyBegin, keyEnd ) ) - transforms[i].scale;
+						return ( std::max( fabsf( diff.x ), std::max( fabsf( diff.y ), fabsf( diff.z ) ) ) <= tolerance.scale );
+					}
+				);
+
+				for ( const auto &f : track.translationFrames )
+				{
+					track.translations.emplace_back( transforms[f].translation );
+				}
+				for ( const auto &f : track.rotationFrames )
+				{
+					track.rotations.emplace_back( QuantizeRotation( transforms[f].rotation ) );
+				}
+				for ( const auto &f : track.scaleFrames )
+				{
+					track.scales.emplace_back( transforms[f].scale );
+				}
+			}
+
+			return true;
+		}
+
+		size_t CalcTransformByteSize( const Loader::CompressedMotion &motion )
+		{
+			size_t byteSize = 0;
+			for ( const auto &track : motion.tracks )
+			{
+				byteSize += track.translationFrames.size()	* ( sizeof( std::uint16_t ) + sizeof( Donya::Vector3 ) );
+				byteSize += track.rotationFrames.size()		* ( sizeof( std::uint16_t ) + sizeof( std::array<std::uint16_t, 3> ) );
+				byteSize += track.scaleFrames.size()		* ( sizeof( std::uint16_t ) + sizeof( Donya::Vector3 ) );
+			}
+			return byteSize;
+		}
+		size_t CalcTransformByteSize( const Loader::Motion &motion )
+		{
+			size_t byteSize = 0;
+			for ( const auto &skeletal : motion.motion )
+			{
+				byteSize += skeletal.skeletal.size() * sizeof( Donya::Vector4x4 );
+			}
+			return byteSize;
+		}
+
+		Sampler::Sampler() : pMotion( nullptr ), cursors() {}
+		Sampler::Sampler( const Loader::CompressedMotion *pMotion ) : pMotion( nullptr ), cursors()
+		{
+			Assign( pMotion );
+		}
+
+		void Sampler::Assign( const Loader::CompressedMotion *pCompressedMotion )
+		{
+			pMotion = pCompressedMotion;
+			cursors.assign( ( pMotion ) ? pMotion->tracks.size() : 0U, Cursor{} );
+		}
+
+		float Sampler::CalcFrame( float seconds, bool isLoop ) const
+		{
+			if ( !pMotion || !pMotion->frameCount || pMotion->samplingRate <= 0.0f ) { return 0.0f; }
+			// else
+
+			const float lastFrame	= scast<float>( pMotion->frameCount - 1U );
+			const float frame		= seconds / pMotion->samplingRate;
+			if ( !isLoop ) { return std::max( 0.0f, std::min( lastFrame, frame ) ); }
+			// else
+
+			// The last frame and the first frame are regarded as the same posture.
+			if ( lastFrame <= 0.0f ) { return 0.0f; }
+			// else
+			const float wrapped = fmodf( frame, lastFrame );
+			return ( wrapped < 0.0f ) ? wrapped + lastFrame : wrapped;
+		}
+
+		void Sampler::Sample( float frame, std::vector<Transform> *pOutput )
+		{
+			if ( !pOutput ) { return; }
+			// else
+
+			const size_t trackCount = ( pMotion && pMotion->frameCount ) ? pMotion->tracks.size() : 0U;
+			pOutput->resize( trackCount );
+			if ( !trackCount ) { return; }
+			// else
+
+			frame = ClampFrame( frame );
+			for ( size_t i = 0; i < trackCount; ++i )
+			{
+				( *pOutput )[i] = SampleTrack( i, frame );
+			}
+		}
+		void Sampler::Sample( float frame, std::vector<Donya::Vector4x4> *pOutput )
+		{
+			if ( !pOutput ) { return; }
+			// else
+
+			const size_t trackCount = ( pMotion && pMotion->frameCount ) ? pMotion->tracks.size() : 0U;
+			pOutput->resize( trackCount );
+			if ( !trackCount ) { return; }
+			// else
+
+			frame = ClampFrame( frame );
+			for ( size_t i = 0; i < trackCount; ++i )
+			{
+				( *pOutput )[i] = SampleTrack( i, frame ).ToMatrix();
+			}
+		}
+
+		float Sampler::ClampFrame( float frame ) const
+		{
+			return std::max( 0.0f, std::min( scast<float>( pMotion->frameCount - 1U ), frame ) );
+		}
+		Transform Sampler::SampleTrack( size_t trackIndex, float frame )
+		{
+			const auto	&track	= pMotion->tracks[trackIndex];
+			auto		&cursor	= cursors[trackIndex];
+
+			Transform rv{};
+			rv.translation	= SampleVector	( track.translationFrames,	track.translations,	frame, &cursor.translation	);
+			rv.rotation		= SampleRotation( track.rotationFrames,		track.rotations,	frame, &cursor.rotation		);
+			rv.scale		= SampleVector	( track.scaleFrames,		track.scales,		frame, &cursor.scale		);
+			return rv;
+		}
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <cstddef>	// Use size_t.
+#include <cstdint>
+#include <vector>
+
+#include "Loader.h"
+#include "Quaternion.h"
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// Compress the sampled matrices of Loader::Motion to the keyframes of translation, rotation and scale(Loader::CompressedMotion),
+	/// and interpolate these at runtime.<para></para>
+	/// This is a library only yet : no motion playback exists in this project, so nothing samples the compressed motions at runtime.
+	/// Please keep the source motions(Loader::CompressMotions( tolerance, false )) until a playback uses the Sampler.
+	/// </summary>
+	namespace MotionCompression
+	{
+		/// <summary>
+		/// The max frame count of a compressed motion, because the frame numbers are stored as 16 bits.
+		/// </summary>
+		constexpr size_t MAX_FRAME_COUNT = 65536U;
+
+		/// <summary>
+		/// The decomposed transform of a bone.
+		/// </summary>
+		struct Transform
+		{
+			Donya::Vector3		translation{};
+			Donya::Quaternion	rotation{};
+			Donya::Vector3		scale{ 1.0f, 1.0f, 1.0f };
+		public:
+			/// <summary>
+			/// Decompose the affine matrix. The shear is not supported. A reflection is stored as the negative "scale.x".
+			/// </summary>
+			static Transform Decompose( const Donya::Vector4x4 &matrix );
+		public:
+			/// <summary>
+			/// Returns S * R * T.
+			/// </summary>
+			Donya::Vector4x4 ToMatrix() const;
+		};
+
+		/// <summary>
+		/// Quantize a normalized quaternion to 48 bits by "smallest three":
+		/// the largest component is dropped, and the other three are stored as 15 bits, then the 2 bits index of the dropped component.
+		/// The max error is about 0.0001 radian.
+		/// </summary>
+		std::array<std::uint16_t, 3> QuantizeRotation( const Donya::Quaternion &normalized );
+		Donya::Quaternion DequantizeRotation( const std::array<std::uint16_t, 3> &quantized );
+
+		/// <summary>
+		/// Decompose the bones of each frame, then keep only the keyframes that the linear interpolation can not reproduce within the "tolerance".<para></para>
+		/// Returns false if the bone count is changed in the motion, or the frame count is over the MAX_FRAME_COUNT.
+		/// </summary>
+		bool Compress( const Loader::Motion &source, const Loader::CompressedMotion::Tolerance &tolerance, Loader::CompressedMotion *pOutput );
+
+		/// <summary>
+		/// Returns the byte size of the transforms, the names are not contained. Use for comparing with the source.
+		/// </summary>
+		size_t CalcTransformByteSize( const Loader::CompressedMotion &motion );
+		/// <summary>
+		/// Returns the byte size of the transforms, the names are not contained. Use for comparing with the compressed.
+		/// </summary>
+		size_t CalcTransformByteSize( const Loader::Motion &motion );
+
+		/// <summary>
+		/// Interpolate the keyframes of a compressed motion on demand.<para></para>
+		/// It remembers the last keyframe per track, so playing forward finds the next keyframes without searching.
+		/// Please use one instance per playing motion.
+		/// </summary>
+		class Sampler
+		{
+		private:
+			struct Cursor
+			{
+				size_t translation{};
+				size_t rotation{};
+				size_t scale{};
+			};
+		private:
+			const Loader::CompressedMotion	*pMotion;
+			std::vector<Cursor>				cursors;	// Per track.
+		public:
+			Sampler();
+			explicit Sampler( const Loader::CompressedMotion *pMotion );
+		public:
+			/// <summary>
+			/// The "pMotion" must be alive while sampling.
+			/// </summary>
+			void Assign( const Loader::CompressedMotion *pMotion );
+
+			/// <summary>
+			/// Convert the seconds to the frame. If "isLoop" is true, the frame is wrapped, otherwise clamped.
+			/// </summary>
+			float CalcFrame( float seconds, bool isLoop ) const;
+
+			/// <summary>
+			/// Interpolate the transforms of all bones at the "frame"(it is clamped to [0 ~ frameCount - 1]).<para></para>
+			/// The "pOutput" is resized to the bone count.
+			/// </summary>
+			void Sample( float frame, std::vector<Transform> *pOutput );
+			/// <summary>
+			/// Interpolate the matrices of all bones at the "frame"(it is clamped to [0 ~ frameCount - 1]).
+			/// It is same as Loader::Bone::transform.<para></para>
+			/// The "pOutput" is resized to the bone count.
+			/// </summary>
+			void Sample( float frame, std::vector<Donya::Vector4x4> *pOutput );
+		private:
+			float ClampFrame( float frame ) const;
+			Transform SampleTrack( size_t trackIndex, float frame );
+		};
+	}
+}
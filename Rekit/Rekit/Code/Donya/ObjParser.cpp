@@ -0,0 +1,837 @@
+#include "ObjParser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>		// Use SIZE_MAX.
+#include <cstdlib>		// Use strtof().
+#include <cstring>		// Use memchr(), memcmp(), memcpy(), strlen().
+#include <unordered_map>
+#include <utility>		// Use std::pair.
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Constant.h"	// Use scast macro.
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace ObjParser
+	{
+		namespace
+		{
+			bool IsSpace( char c )
+			{
+				return ( c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v' );
+			}
+			bool IsDigit( char c )
+			{
+				return ( '0' <= c && c <= '9' );
+			}
+
+			/// <summary>
+			/// Walk a text by line and by token. The line feed is not regarded as a space.
+			/// </summary>
+			class Reader
+			{
+			private:
+				const char *pCurrent;
+				const char *pLineEnd;	// The end of current line, except the comment.
+				const char *pNextLine;
+				const char *pEnd;
+			public:
+				Reader( const char *pBytes, size_t byteSize ) :
+					pCurrent( pBytes ), pLineEnd( pBytes ), pNextLine( pBytes ), pEnd( pBytes + byteSize )
+				{}
+			public:
+				/// <summary>
+				/// Move to the head of next line that is not empty and not a comment. Returns false if reached the end.
+				/// </summary>
+				bool NextLine()
+				{
+					while ( pNextLine < pEnd )
+					{
+						const char *pBegin		= pNextLine;
+						const void *pFound		= memchr( pBegin, '\n', scast<size_t>( pEnd - pBegin ) );
+						const char *pLineFeed	= ( pFound ) ? static_cast<const char *>( pFound ) : pEnd;
+						pNextLine = ( pFound ) ? pLineFeed + 1 : pEnd;
+
+						// The comment is valid until the end of line.
+						const void *pComment = memchr( pBegin, '#', scast<size_t>( pLineFeed - pBegin ) );
+						pLineEnd = ( pComment ) ? static_cast<const char *>( pComment ) : pLineFeed;
+						pCurrent = pBegin;
+
+						SkipSpaces();
+						if ( !IsLineEnd() ) { return true; }
+					}
+					return false;
+				}
+
+				void SkipSpaces()
+				{
+					while ( pCurrent < pLineEnd && IsSpace( *pCurrent ) ) { ++pCurrent; }
+				}
+				bool IsLineEnd() const
+				{
+					return ( pLineEnd <= pCurrent );
+				}
+
+				/// <summary>
+				/// Returns the token until next space, then skip the spaces after it.
+				/// </summary>
+				std::pair<const char *, const char *> Token()
+				{
+					const char *pBegin = pCurrent;
+					while ( pCurrent < pLineEnd && !IsSpace( *pCurrent ) ) { ++pCurrent; }
+					const char *pTokenEnd = pCurrent;
+					SkipSpaces();
+					return std::make_pair( pBegin, pTokenEnd );
+				}
+				/// <summary>
+				/// Returns the remain of current line, the spaces at the end are removed.
+				/// </summary>
+				std::string Rest()
+				{
+					const char *pBegin = pCurrent;
+					const char *pRestEnd = pLineEnd;
+					while ( pBegin < pRestEnd && IsSpace( *( pRestEnd - 1 ) ) ) { --pRestEnd; }
+					pCurrent = pLineEnd;
+					return std::string( pBegin, pRestEnd );
+				}
+
+				/// <summary>
+				/// Returns false if the number is not found, then the position is not moved.
+				/// </summary>
+				bool Float( float *pOutput )
+				{
+					const char *pNext = ParseFloat( pCurrent, pLineEnd, pOutput );
+					if ( pNext == pCurrent ) { return false; }
+					// else
+					pCurrent = pNext;
+					SkipSpaces();
+					return true;
+				}
+				/// <summary>
+				/// Returns false if the number is not found. The spaces after the number are not skipped.
+				/// </summary>
+				bool Int( int *pOutput )
+				{
+					const char *p = pCurrent;
+					bool negative = false;
+					if ( p < pLineEnd && ( *p == '-' || *p == '+' ) )
+					{
+						negative = ( *p == '-' );
+						++p;
+					}
+					if ( pLineEnd <= p || !IsDigit( *p ) ) { return false; }
+					// else
+
+					long long value = 0;
+					for ( ; p < pLineEnd && IsDigit( *p ); ++p )
+					{
+						value = std::min( value * 10 + ( *p - '0' ), 0x7FFFFFFFLL );
+					}
+					*pOutput = scast<int>( ( negative ) ? -value : value );
+					pCurrent = p;
+					return true;
+				}
+				bool Consume( char c )
+				{
+					if ( pCurrent < pLineEnd && *pCurrent == c )
+					{
+						++pCurrent;
+						return true;
+					}
+					// else
+					return false;
+				}
+			};
+
+			bool IsSame( const std::pair<const char *, const char *> &token, const char *keyword )
+			{
+				const size_t length = scast<size_t>( token.second - token.first );
+				return ( length == strlen( keyword ) && memcmp( token.first, keyword, length ) == 0 );
+			}
+
+			/// <summary>
+			/// The exact powers of ten in double.
+			/// </summary>
+			constexpr double POWERS_OF_TEN[] =
+			{
+				1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+				1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+			constexpr int MAX_EXACT_POWER = 22;
+			constexpr int MAX_MANTISSA_DIGITS = 19;	// unsigned long long can store 19 digits.
+
+			/// <summary>
+			/// Use the CRT's parser for the unusual text(e.g. "nan", "inf").
+			/// </summary>
+			const char *ParseFloatByCRT( const char *pBegin, const char *pEnd, float *pOutput )
+			{
+				char buffer[64]{};
+				const size_t length = std::min( sizeof( buffer ) - 1, scast<size_t>( pEnd - pBegin ) );
+				memcpy( buffer, pBegin, length );
+
+				char *pParsedEnd = nullptr;
+				const float value = strtof( buffer, &pParsedEnd );
+				if ( pParsedEnd == buffer ) { return pBegin; }
+				// else
+
+				*pOutput = value;
+				return pBegin + ( pParsedEnd - buffer );
+			}
+
+			/// <summary>
+			/// The count of lines per statement, for reserving the capacity before the parsing.<para></para>
+			/// Scanning the line heads is far cheaper than the re-allocations of large vectors.
+			/// </summary>
+			struct LineCounts
+			{
+				size_t position{};
+				size_t texCoord{};
+				size_t normal{};
+				size_t face{};
+			public:
+				LineCounts( const char *pBytes, size_t byteSize )
+				{
+					const char *p		= pBytes;
+					const char *pEnd	= pBytes + byteSize;
+					while ( p < pEnd )
+					{
+						while ( p < pEnd && IsSpace( *p ) ) { ++p; }
+						if ( p + 1 < pEnd )
+						{
+							const char next = p[1];
+							if ( *p == 'v' )
+							{
+								if ( IsSpace( next )	) { position++; }
+								else if ( next == 't'	) { texCoord++; }
+								else if ( next == 'n'	) { normal++;   }
+							}
+							else if ( *p == 'f' && IsSpace( next ) ) { face++; }
+						}
+
+						const void *pFound = memchr( p, '\n', scast<size_t>( pEnd - p ) );
+						p = ( pFound ) ? static_cast<const char *>( pFound ) + 1 : pEnd;
+					}
+				}
+			};
+
+			/// <summary>
+			/// The key of a vertex of the faces. The indices are zero-based, -1 means not specified.
+			/// </summary>
+			struct VertexKey
+			{
+				int position;
+				int texCoord;
+				int normal;
+			};
+
+			/// <summary>
+			/// The hash map from the VertexKey to the index of vertex. The bucket is the position index itself.<para></para>
+			/// The faces refer the near positions, so the buckets are accessed with good locality, unlike a general hash.
+			/// A position is shared by few combinations of texcoord and normal, so the chains are short.
+			/// </summary>
+			constexpr size_t EMPTY = ~size_t( 0 );
+			class VertexTable
+			{
+			private:
+				struct Node
+				{
+					int		texCoord;
+					int		normal;
+					size_t	index;
+					size_t	next;
+				};
+			private:
+				std::vector<size_t>	heads;	// The first node per position.
+				std::vector<Node>	nodes;
+			public:
+				VertexTable() : heads(), nodes() {}
+			public:
+				void Reserve( size_t positionCount, size_t vertexCount )
+				{
+					heads.reserve( positionCount );
+					nodes.reserve( vertexCount );
+				}
+				/// <summary>
+				/// Returns the registered index if the key is found. Otherwise register the "newIndex" and returns it.
+				/// </summary>
+				size_t FindOrInsert( const VertexKey &key, size_t newIndex )
+				{
+					const size_t bucket = scast<size_t>( key.position );
+					if ( heads.size() <= bucket ) { heads.resize( bucket + 1U, EMPTY ); }
+
+					for ( size_t i = heads[bucket]; i != EMPTY; i = nodes[i].next )
+					{
+						const Node &node = nodes[i];
+						if ( node.texCoord == key.texCoord && node.normal == key.normal )
+						{
+							return node.index;
+						}
+					}
+
+					nodes.emplace_back( Node{ key.texCoord, key.normal, newIndex, heads[bucket] } );
+					heads[bucket] = nodes.size() - 1U;
+					return newIndex;
+				}
+			};
+
+			/// <summary>
+			/// Convert the one-based or negative index to zero-based. Returns false if the index is out of range.
+			/// </summary>
+			bool ResolveIndex( int index, size_t definedCount, int *pOutput )
+			{
+				const long long resolved = ( index < 0 )
+				? scast<long long>( definedCount ) + index
+				: scast<long long>( index ) - 1;
+				if ( resolved < 0 || scast<long long>( definedCount ) <= resolved ) { return false; }
+				// else
+				*pOutput = scast<int>( resolved );
+				return true;
+			}
+
+			/// <summary>
+			/// Skip the options of a map statement(e.g. "-s 1 1 1 -clamp on"). The count of arguments depends on the option.
+			/// </summary>
+			void SkipMapOptions( Reader *pReader )
+			{
+				struct Option
+				{
+					const char	*name;
+					int			maxArgCount;
+					bool		isNumeric;	// The numeric option may omit some arguments.
+				};
+				constexpr Option OPTIONS[] =
+				{
+					{ "-blendu",	1, false },
+					{ "-blendv",	1, false },
+					{ "-cc",		1, false },
+					{ "-clamp",		1, false },
+					{ "-imfchan",	1, false },
+					{ "-type",		1, false },
+					{ "-boost",		1, true  },
+					{ "-bm",		1, true  },
+					{ "-texres",	1, true  },
+					{ "-mm",		2, true  },
+					{ "-o",			3, true  },
+					{ "-s",			3, true  },
+					{ "-t",			3, true  },
+				};
+
+				for ( ; !pReader->IsLineEnd(); )
+				{
+					Reader lookAhead = *pReader;
+					const auto token = lookAhead.Token();
+					if ( *token.first != '-' ) { return; }
+					// else
+					*pReader = lookAhead;
+
+					int  maxArgCount = 3;
+					bool isNumeric   = true;
+					for ( const auto &option : OPTIONS )
+					{
+						if ( IsSame( token, option.name ) )
+						{
+							maxArgCount	= option.maxArgCount;
+							isNumeric	= option.isNumeric;
+							break;
+						}
+					}
+
+					for ( int i = 0; i < maxArgCount && !pReader->IsLineEnd(); ++i )
+					{
+						if ( isNumeric )
+						{
+							float discard{};
+							if ( !pReader->Float( &discard ) ) { break; }
+						}
+						else
+						{
+							pReader->Token();
+						}
+					}
+				}
+			}
+		}
+
+		const char *ParseFloat( const char *pBegin, const char *pEnd, float *pOutput )
+		{
+			const char *p = pBegin;
+			bool negative = false;
+			if ( p < pEnd && ( *p == '-' || *p == '+' ) )
+			{
+				negative = ( *p == '-' );
+				++p;
+			}
+
+			unsigned long long mantissa = 0;
+			int  digitCount = 0;	// The significant digits in the mantissa.
+			int  exponent   = 0;
+			bool hasDigit   = false;
+			for ( ; p < pEnd && IsDigit( *p ); ++p )
+			{
+				hasDigit = true;
+				if ( digitCount < MAX_MANTISSA_DIGITS )
+				{
+					mantissa = mantissa * 10U + scast<unsigned int>( *p - '0' );
+					if ( mantissa ) { digitCount++; }
+				}
+				else
+				{
+					exponent++;
+				}
+			}
+			if ( p < pEnd && *p == '.' )
+			{
+				++p;
+				for ( ; p < pEnd && IsDigit( *p ); ++p )
+				{
+					hasDigit = true;
+					if ( digitCount < MAX_MANTISSA_DIGITS )
+					{
+						mantissa = mantissa * 10U + scast<unsigned int>( *p - '0' );
+						if ( mantissa ) { digitCount++; }
+						exponent--;
+					}
+				}
+			}
+			if ( !hasDigit )
+			{
+				const bool isSpecialValue = ( p < pEnd && ( *p == 'n' || *p == 'N' || *p == 'i' || *p == 'I' ) );
+				return ( isSpecialValue ) ? ParseFloatByCRT( pBegin, pEnd, pOutput ) : pBegin;
+			}
+			// else
+
+			if ( p < pEnd && ( *p == 'e' || *p == 'E' ) )
+			{
+				const char *pExponent = p + 1;
+				bool negativeExponent = false;
+				if ( pExponent < pEnd && ( *pExponent == '-' || *pExponent == '+' ) )
+				{
+					negativeExponent = ( *pExponent == '-' );
+					++pExponent;
+				}
+				// The "e" is not a part of number if the digits are not following.
+				if ( pExponent < pEnd && IsDigit( *pExponent ) )
+				{
+					int value = 0;
+					for ( ; pExponent < pEnd && IsDigit( *pExponent ); ++pExponent )
+					{
+						value = std::min( value * 10 + ( *pExponent - '0' ), 9999 );
+					}
+					exponent += ( negativeExponent ) ? -value : value;
+					p = pExponent;
+				}
+			}
+
+			double value = scast<double>( mantissa );
+			if ( mantissa && exponent )
+			{
+				if ( -MAX_EXACT_POWER <= exponent && exponent <= MAX_EXACT_POWER )
+				{
+					value = ( exponent < 0 )
+					? value / POWERS_OF_TEN[-exponent]
+					: value * POWERS_OF_TEN[ exponent];
+				}
+				else
+				{
+					value *= std::pow( 10.0, exponent );
+				}
+			}
+
+			*pOutput = scast<float>( ( negative ) ? -value : value );
+			return p;
+		}
+
+		bool ParseObj( const char *pBytes, size_t byteSize, Obj *pOutput, bool dedupeVertices, std::string *pErrorMessage )
+		{
+			if ( !pOutput ) { return false; }
+			// else
+			*pOutput = Obj{};
+			if ( !pBytes || !byteSize ) { return true; }
+			// else
+
+			auto Error = [&pErrorMessage]( const char *message )
+			{
+				if ( pErrorMessage ) { *pErrorMessage = message; }
+				return false;
+			};
+
+			const LineCounts lineCounts{ pBytes, byteSize };
+
+			std::vector<Float3> definedPositions{};
+			std::vector<Float3> definedNormals{};
+			std::vector<Float2> definedTexCoords{};
+			definedPositions.reserve( lineCounts.position );
+			definedNormals.reserve( lineCounts.normal );
+			definedTexCoords.reserve( lineCounts.texCoord );
+
+			// Regard the faces as triangles. The shared vertices are about the count of positions.
+			const size_t cornerCount = lineCounts.face * 3U;
+			const size_t vertexCount = ( dedupeVertices ) ? std::min( cornerCount, lineCounts.position + lineCounts.position / 2U ) : cornerCount;
+			pOutput->positions.reserve( vertexCount );
+			pOutput->normals.reserve( vertexCount );
+			pOutput->texCoords.reserve( vertexCount );
+
+			// The indices are stored per subset, then joined at the end. So a material becomes one range even if it is used many times.
+			std::vector<std::vector<size_t>>		subsetIndices{};
+			std::unordered_map<std::string, size_t>	subsetMap{};	// mtlName -> index of subsets.
+			size_t currentSubset = SIZE_MAX;
+			auto UseSubset = [&]( const std::string &mtlName )
+			{
+				auto found = subsetMap.find( mtlName );
+				if ( found != subsetMap.end() )
+				{
+					currentSubset = found->second;
+					return;
+				}
+				// else
+
+				currentSubset = pOutput->subsets.size();
+				subsetMap.insert( std::make_pair( mtlName, currentSubset ) );
+				pOutput->subsets.emplace_back();
+				pOutput->subsets.back().mtlName = mtlName;
+				subsetIndices.emplace_back();
+				if ( currentSubset == 0 ) { subsetIndices.back().reserve( cornerCount ); }
+			};
+
+			VertexTable vertexTable{};
+			if ( dedupeVertices ) { vertexTable.Reserve( lineCounts.position, vertexCount ); }
+			auto AddVertex = [&]( const VertexKey &key )->size_t
+			{
+				const size_t newIndex = pOutput->positions.size();
+				if ( dedupeVertices )
+				{
+					const size_t index = vertexTable.FindOrInsert( key, newIndex );
+					if ( index != newIndex ) { return index; }
+				}
+				// else
+
+				pOutput->positions.emplace_back( definedPositions[key.position] );
+				pOutput->texCoords.emplace_back( ( key.texCoord < 0 ) ? Float2{} : definedTexCoords[key.texCoord] );
+				pOutput->normals.emplace_back( ( key.normal < 0 ) ? Float3{} : definedNormals[key.normal] );
+				return newIndex;
+			};
+
+			std::vector<VertexKey> corners{};
+			Reader reader{ pBytes, byteSize };
+			while ( reader.NextLine() )
+			{
+				const auto keyword = reader.Token();
+
+				if ( IsSame( keyword, "v" ) )
+				{
+					Float3 v{};
+					reader.Float( &v.x );
+					reader.Float( &v.y );
+					reader.Float( &v.z );
+					definedPositions.emplace_back( v );
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "vt" ) )
+				{
+					Float2 v{};
+					reader.Float( &v.x );
+					reader.Float( &v.y );
+					// definedTexCoords.emplace_back( Float2{ v.x,  v.y } );	// If obj-file is LH
+					definedTexCoords.emplace_back( Float2{ v.x, -v.y } );		// If obj-file is RH
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "vn" ) )
+				{
+					Float3 v{};
+					reader.Float( &v.x );
+					reader.Float( &v.y );
+					reader.Float( &v.z );
+					definedNormals.emplace_back( v );
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "f" ) )
+				{
+					corners.clear();
+					while ( !reader.IsLineEnd() )
+					{
+						VertexKey key{ -1, -1, -1 };
+						int index = 0;
+
+						if ( !reader.Int( &index ) ) { return Error( "obj file error! : the face has an invalid token." ); }
+						if ( !ResolveIndex( index, definedPositions.size(), &key.position ) ) { return Error( "obj file error! : not found specified position-index until specify face." ); }
+						// else
+
+						if ( reader.Consume( '/' ) )
+						{
+							// The texcoord can be omitted as "1//1".
+							if ( reader.Int( &index ) )
+							{
+								if ( !ResolveIndex( index, definedTexCoords.size(), &key.texCoord ) ) { return Error( "obj file error! : not found specified texcoord-index until specify face." ); }
+							}
+							if ( reader.Consume( '/' ) )
+							{
+								if ( !reader.Int( &index ) ) { return Error( "obj file error! : the face has an invalid token." ); }
+								if ( !ResolveIndex( index, definedNormals.size(), &key.normal ) ) { return Error( "obj file error! : not found specified normal-index until specify face." ); }
+							}
+						}
+
+						corners.emplace_back( key );
+						reader.SkipSpaces();
+					}
+					if ( corners.size() < 3U ) { continue; }
+					// else
+
+					if ( currentSubset == SIZE_MAX ) { UseSubset( "" ); }
+					auto &indices = subsetIndices[currentSubset];
+
+					// Divide the polygon as a fan.
+					const size_t first = AddVertex( corners[0] );
+					size_t prev = AddVertex( corners[1] );
+					for ( size_t i = 2; i < corners.size(); ++i )
+					{
+						const size_t current = AddVertex( corners[i] );
+						indices.emplace_back( first   );
+						indices.emplace_back( prev    );
+						indices.emplace_back( current );
+						prev = current;
+					}
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "usemtl" ) )
+				{
+					UseSubset( reader.Rest() );
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "mtllib" ) )
+				{
+					while ( !reader.IsLineEnd() )
+					{
+						const auto name = reader.Token();
+						pOutput->mtllibNames.emplace_back( name.first, name.second );
+					}
+					continue;
+				}
+				// else
+
+				// The groups("g", "o"), the smoothing("s") and the others are not supported.
+			}
+
+			const size_t subsetCount = pOutput->subsets.size();
+			if ( subsetCount == 1U )
+			{
+				// Most files use one material, then the copy is unnecessary.
+				pOutput->subsets.front().indexCount = subsetIndices.front().size();
+				pOutput->indices.swap( subsetIndices.front() );
+			}
+			else
+			{
+				size_t indexCount = 0;
+				for ( const auto &it : subsetIndices ) { indexCount += it.size(); }
+				pOutput->indices.reserve( indexCount );
+
+				for ( size_t i = 0; i < subsetCount; ++i )
+				{
+					auto &subset = pOutput->subsets[i];
+					subset.indexStart = pOutput->indices.size();
+					subset.indexCount = subsetIndices[i].size();
+					pOutput->indices.insert( pOutput->indices.end(), subsetIndices[i].begin(), subsetIndices[i].end() );
+					std::vector<size_t>().swap( subsetIndices[i] );
+				}
+			}
+
+			pOutput->positions.shrink_to_fit();
+			pOutput->normals.shrink_to_fit();
+			pOutput->texCoords.shrink_to_fit();
+
+			return true;
+		}
+
+		bool ParseMtl( const char *pBytes, size_t byteSize, std::vector<Mtl> *pOutput )
+		{
+			if ( !pOutput ) { return false; }
+			if ( !pBytes || !byteSize ) { return true; }
+			// else
+
+			// The statements before "newmtl" are ignored.
+			Mtl *pCurrent = nullptr;
+
+			auto ReadColor = []( Reader *pReader, float( &color )[3] )
+			{
+				if ( !pReader->Float( &color[0] ) ) { return; }
+				// else
+
+				// The G and B are same as R if these are omitted.
+				if ( !pReader->Float( &color[1] ) ) { color[1] = color[0]; }
+				if ( !pReader->Float( &color[2] ) ) { color[2] = color[0]; }
+			};
+
+			Reader reader{ pBytes, byteSize };
+			while ( reader.NextLine() )
+			{
+				const auto keyword = reader.Token();
+
+				if ( IsSame( keyword, "newmtl" ) )
+				{
+					pOutput->emplace_back();
+					pCurrent = &pOutput->back();
+					pCurrent->name = reader.Rest();
+					continue;
+				}
+				// else
+				if ( !pCurrent ) { continue; }
+				// else
+
+				if ( IsSame( keyword, "Ka" ) )
+				{
+					ReadColor( &reader, pCurrent->ambient );
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "Kd" ) )
+				{
+					ReadColor( &reader, pCurrent->diffuse );
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "Ks" ) )
+				{
+					ReadColor( &reader, pCurrent->specular );
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "Ns" ) )
+				{
+					reader.Float( &pCurrent->shininess );
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "illum" ) )
+				{
+					int illuminate = 0;
+					if ( reader.Int( &illuminate ) ) { pCurrent->illuminate = illuminate; }
+					continue;
+				}
+				// else
+				if ( IsSame( keyword, "map_Kd" ) )
+				{
+					// TODO:Apply a options.
+					SkipMapOptions( &reader );
+					pCurrent->diffuseMapName = reader.Rest();
+					continue;
+				}
+				// else
+			}
+
+			return true;
+		}
+
+		MappedFile::MappedFile() : pData( nullptr ), byteSize( 0 ) {}
+		MappedFile::~MappedFile()
+		{
+			Close();
+		}
+
+	#if defined( _WIN32 )
+
+		bool MappedFile::Open( const std::string &filePath )
+		{
+			Close();
+
+			HANDLE hFile = CreateFileA( filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+			if ( hFile == INVALID_HANDLE_VALUE ) { return false; }
+			// else
+
+			LARGE_INTEGER fileSize{};
+			if ( !GetFileSizeEx( hFile, &fileSize ) )
+			{
+				CloseHandle( hFile );
+				return false;
+			}
+			// else
+			if ( fileSize.QuadPart == 0 )
+			{
+				// The empty file can not be mapped.
+				CloseHandle( hFile );
+				return true;
+			}
+			// else
+
+			HANDLE hMapping = CreateFileMappingA( hFile, NULL, PAGE_READONLY, 0, 0, NULL );
+			CloseHandle( hFile );	// The mapping holds the file.
+			if ( !hMapping ) { return false; }
+			// else
+
+			const void *pView = MapViewOfFile( hMapping, FILE_MAP_READ, 0, 0, 0 );
+			CloseHandle( hMapping );	// The view holds the mapping.
+			if ( !pView ) { return false; }
+			// else
+
+			pData		= static_cast<const char *>( pView );
+			byteSize	= scast<size_t>( fileSize.QuadPart );
+			return true;
+		}
+		void MappedFile::Close()
+		{
+			if ( pData ) { UnmapViewOfFile( pData ); }
+			pData		= nullptr;
+			byteSize	= 0;
+		}
+
+	#else
+
+		bool MappedFile::Open( const std::string &filePath )
+		{
+			Close();
+
+			const int fd = open( filePath.c_str(), O_RDONLY );
+			if ( fd < 0 ) { return false; }
+			// else
+
+			struct stat status{};
+			if ( fstat( fd, &status ) != 0 )
+			{
+				close( fd );
+				return false;
+			}
+			// else
+			if ( status.st_size == 0 )
+			{
+				// The empty file can not be mapped.
+				close( fd );
+				return true;
+			}
+			// else
+
+			void *pView = mmap( nullptr, scast<size_t>( status.st_size ), PROT_READ, MAP_PRIVATE, fd, 0 );
+			close( fd );	// The mapping holds the file.
+			if ( pView == MAP_FAILED ) { return false; }
+			// else
+
+			madvise( pView, scast<size_t>( status.st_size ), MADV_SEQUENTIAL );
+
+			pData		= static_cast<const char *>( pView );
+			byteSize	= scast<size_t>( status.st_size );
+			return true;
+		}
+		void MappedFile::Close()
+		{
+			if ( pData ) { munmap( const_cast<char *>( pData ), byteSize ); }
+			pData		= nullptr;
+			byteSize	= 0;
+		}
+
+	#endif
+	}
+}
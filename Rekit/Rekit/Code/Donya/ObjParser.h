@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>	// Use size_t.
+#include <string>
+#include <vector>
+
+namespace Donya
+{
+	/// <summary>
+	/// Parse the OBJ and MTL files from the bytes, without the streams and the per line strings.<para></para>
+	/// This is plain CPU code, it does not depend on the graphics API. The textures are not loaded here, only the names are stored.
+	/// </summary>
+	namespace ObjParser
+	{
+		struct Float2 { float x{}, y{}; };
+		struct Float3 { float x{}, y{}, z{}; };
+
+		/// <summary>
+		/// The range of indices that uses a material.
+		/// </summary>
+		struct Subset
+		{
+			std::string	mtlName{};		// Empty if the faces are placed before any "usemtl".
+			size_t		indexStart{};	// zero-based number.
+			size_t		indexCount{};
+		};
+
+		/// <summary>
+		/// The "positions", "normals" and "texCoords" are parallel arrays, so a vertex is [i] of each.<para></para>
+		/// A component that is not specified by the face is zero.
+		/// </summary>
+		struct Obj
+		{
+			std::vector<Float3>			positions{};
+			std::vector<Float3>			normals{};
+			std::vector<Float2>			texCoords{};	// The V is flipped, because the obj-file is RH.
+			std::vector<size_t>			indices{};		// Triangle list. The polygons are divided as a fan.
+			std::vector<Subset>			subsets{};		// A material has one subset, in order of first use.
+			std::vector<std::string>	mtllibNames{};	// As written in the file, relative to the obj-file.
+		};
+
+		struct Mtl
+		{
+			std::string	name{};
+			int			illuminate = 0;		// 0 ~ 10
+			float		shininess = 0;		// 0.0f ~ 1000.0f
+			float		ambient[3]{};		// RGB, 0.0f ~ 1.0f
+			float		diffuse[3]{};		// RGB, 0.0f ~ 1.0f
+			float		specular[3]{};		// RGB, 0.0f ~ 1.0f
+			std::string	diffuseMapName{};	// As written in the file, relative to the mtl-file. The options are removed.
+		};
+
+		/// <summary>
+		/// Parse the text of obj-file.<para></para>
+		/// If "dedupeVertices" is true, the same combination of position, texcoord and normal is stored once, and shared by the indices.
+		/// Otherwise each corner of the faces has own vertex.<para></para>
+		/// Returns false if a face refers the element that is not defined, then the "pErrorMessage" is set if it is not null.
+		/// </summary>
+		bool ParseObj( const char *pBytes, size_t byteSize, Obj *pOutput, bool dedupeVertices = true, std::string *pErrorMessage = nullptr );
+		/// <summary>
+		/// Parse the text of mtl-file. The materials are appended to "pOutput", in order of the file.
+		/// </summary>
+		bool ParseMtl( const char *pBytes, size_t byteSize, std::vector<Mtl> *pOutput );
+
+		/// <summary>
+		/// Parse a float from the [pBegin ~ pEnd). Returns the position after the number, or "pBegin" if the number is not found.<para></para>
+		/// The leading spaces are not skipped.
+		/// </summary>
+		const char *ParseFloat( const char *pBegin, const char *pEnd, float *pOutput );
+
+		/// <summary>
+		/// Map a file to the memory as read-only. The mapping is released by the destructor.<para></para>
+		/// The file is not read to a buffer, so the pages are loaded by the OS as the parser touches these.
+		/// </summary>
+		class MappedFile
+		{
+		private:
+			const char	*pData;
+			size_t		byteSize;
+		public:
+			MappedFile();
+			~MappedFile();
+			MappedFile( const MappedFile & ) = delete;
+			MappedFile &operator = ( const MappedFile & ) = delete;
+		public:
+			/// <summary>
+			/// Returns false if the file can not be opened. An empty file is succeeded with zero size.
+			/// </summary>
+			bool Open( const std::string &filePath );
+			void Close();
+
+			const char *GetData() const { return pData; }
+			size_t GetSize() const { return byteSize; }
+		};
+	}
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <vector>
+
+namespace Donya
+{
+	/// <summary>
+	/// Fixed-capacity pool. All instances are constructed by Reserve(), then recycled by a free-list.<para></para>
+	/// The active instances are kept densely in the order of acquisition. The release keeps the order of the others.<para></para>
+	/// This does not allocate after the Reserve().<para></para>
+	/// Requirement : T is default constructible and copy assignable.
+	/// </summary>
+	template<typename T>
+	class ObjectPool
+	{
+	public:
+		static constexpr size_t NIL = static_cast<size_t>( -1 );
+		/// <summary>
+		/// Identify an instance. The handle becomes invalid when the instance is released, even if the slot was reused.
+		/// </summary>
+		struct Handle
+		{
+			size_t			slot{ NIL };
+			unsigned int	generation{};
+		};
+	private:
+		std::vector<T>				instances;		// The size is the capacity.
+		std::vector<unsigned int>	generations;	// Per slot. Increase at the release.
+		std::vector<size_t>			denseIndices;	// Per slot. The index of "activeSlots", or NIL if the slot is free.
+		std::vector<size_t>			activeSlots;	// Dense.
+		std::vector<size_t>			freeSlots;		// Use as stack.
+	public:
+		ObjectPool() : instances(), generations(), denseIndices(), activeSlots(), freeSlots() {}
+	public:
+		/// <summary>
+		/// Construct the instances of "capacity" count. The current actives are released.
+		/// </summary>
+		void Reserve( size_t capacity )
+		{
+			instances.assign( capacity, T{} );
+			generations.assign( capacity, 0U );
+			denseIndices.assign( capacity, NIL );
+
+			activeSlots.clear();
+			activeSlots.reserve( capacity );
+
+			freeSlots.resize( capacity );
+			for ( size_t i = 0; i < capacity; ++i )
+			{
+				// Reverse order, so the first acquire returns the slot of zero.
+				freeSlots[i] = capacity - 1 - i;
+			}
+		}
+		/// <summary>
+		/// Release all actives. The capacity is kept.
+		/// </summary>
+		void ReleaseAll()
+		{
+			while ( !activeSlots.empty() )
+			{
+				ReleaseAt( activeSlots.size() - 1 );
+			}
+		}
+
+		/// <summary>
+		/// Returns an invalid handle if the pool is full. The returned instance keeps the state of last use, so please initialize it.
+		/// </summary>
+		Handle Acquire()
+		{
+			if ( freeSlots.empty() ) { return Handle{}; }
+			// else
+
+			const size_t slot = freeSlots.back();
+			freeSlots.pop_back();
+
+			denseIndices[slot] = activeSlots.size();
+			activeSlots.emplace_back( slot ); // Does not allocate, the capacity was reserved.
+
+			return Handle{ slot, generations[slot] };
+		}
+
+		void Release( const Handle &handle )
+		{
+			if ( !IsValid( handle ) ) { return; }
+			// else
+			ReleaseAt( denseIndices[handle.slot] );
+		}
+		/// <summary>
+		/// Release by the index of actives. The actives after the "activeIndex" are shifted to front.
+		/// </summary>
+		void ReleaseAt( size_t activeIndex )
+		{
+			if ( activeSlots.size() <= activeIndex ) { return; }
+			// else
+
+			FreeSlot( activeSlots[activeIndex] );
+
+			const size_t activeCount = activeSlots.size();
+			for ( size_t i = activeIndex + 1; i < activeCount; ++i )
+			{
+				activeSlots[i - 1] = activeSlots[i];
+				denseIndices[activeSlots[i - 1]] = i - 1;
+			}
+			activeSlots.pop_back();
+		}
+		/// <summary>
+		/// Release the actives that the "predicate( const T & )" returns true. The order of the remaining actives is kept.
+		/// </summary>
+		template<typename Predicate>
+		void ReleaseIf( Predicate predicate )
+		{
+			// Stable compaction, each remaining active is moved once.
+			size_t remainCount = 0;
+			const size_t activeCount = activeSlots.size();
+			for ( size_t i = 0; i < activeCount; ++i )
+			{
+				const size_t slot = activeSlots[i];
+				if ( predicate( instances[slot] ) )
+				{
+					FreeSlot( slot );
+					continue;
+				}
+				// else
+
+				activeSlots[remainCount] = slot;
+				denseIndices[slot] = remainCount;
+				++remainCount;
+			}
+			activeSlots.resize( remainCount ); // Shrinking does not allocate.
+		}
+	public:
+		bool IsValid( const Handle &handle ) const
+		{
+			if ( instances.size() <= handle.slot ) { return false; }
+			if ( denseIndices[handle.slot] == NIL ) { return false; }
+			// else
+			return ( generations[handle.slot] == handle.generation ) ? true : false;
+		}
+		/// <summary>
+		/// Returns nullptr if the handle is invalid.
+		/// </summary>
+		T *Find( const Handle &handle )
+		{
+			return ( IsValid( handle ) ) ? &instances[handle.slot] : nullptr;
+		}
+		/// <summary>
+		/// Returns nullptr if the handle is invalid.
+		/// </summary>
+		const T *Find( const Handle &handle ) const
+		{
+			return ( IsValid( handle ) ) ? &instances[handle.slot] : nullptr;
+		}
+
+		/// <summary>
+		/// Returns the count of actives.
+		/// </summary>
+		size_t Size()		const { return activeSlots.size();	}
+		size_t Capacity()	const { return instances.size();	}
+		bool   IsEmpty()	const { return activeSlots.empty();	}
+		bool   IsFull()		const { return freeSlots.empty();	}
+
+		/// <summary>
+		/// Access by the index of actives. Please use with Size().
+		/// </summary>
+		T		&At( size_t activeIndex )		{ return instances[activeSlots[activeIndex]]; }
+		/// <summary>
+		/// Access by the index of actives. Please use with Size().
+		/// </summary>
+		const T	&At( size_t activeIndex ) const	{ return instances[activeSlots[activeIndex]]; }
+	private:
+		/// <summary>
+		/// Invalidate the handles of the "slot", and return it to the free-list. The "activeSlots" is not changed.
+		/// </summary>
+		void FreeSlot( size_t slot )
+		{
+			denseIndices[slot] = NIL;
+			++generations[slot];
+			freeSlots.emplace_back( slot );
+		}
+	};
+	template<typename T>
+	constexpr size_t ObjectPool<T>::NIL;
+}
@@ -0,0 +1,170 @@
+#include "RectPacker.h"
+
+#include <algorithm>
+#include <climits>		// Use INT_MAX.
+
+#include "Constant.h"	// Use scast macro.
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	RectPacker::RectPacker( int areaWidth, int areaHeight, int padding ) :
+		areaWidth( std::max( 0, areaWidth ) ), areaHeight( std::max( 0, areaHeight ) ), padding( std::max( 0, padding ) ),
+		usedArea( 0 ), skyline()
+	{
+		Reset();
+	}
+
+	void RectPacker::Reset()
+	{
+		usedArea = 0;
+
+		skyline.clear();
+		skyline.emplace_back( Segment{ 0, 0, areaWidth } );
+	}
+
+	bool RectPacker::Insert( int rectWidth, int rectHeight, int *pOutX, int *pOutY )
+	{
+		if ( rectWidth <= 0 || rectHeight <= 0 ) { return false; }
+		// else
+
+		const int width  = rectWidth  + padding;
+		const int height = rectHeight + padding;
+
+		// Choose the lowest bottom, and the left one if the same.
+		size_t	bestIndex	= skyline.size();
+		int		bestY		= 0;
+		int		bestBottom	= INT_MAX;
+		for ( size_t i = 0; i < skyline.size(); ++i )
+		{
+			const int y = CalcPlacedY( i, width, height );
+			if ( y < 0 ) { continue; }
+			// else
+
+			if ( y + height < bestBottom )
+			{
+				bestIndex	= i;
+				bestY		= y;
+				bestBottom	= y + height;
+			}
+		}
+
+		if ( bestIndex == skyline.size() ) { return false; }
+		// else
+
+		const int x = skyline[bestIndex].x;
+		AddSkylineLevel( bestIndex, x, bestY, width, height );
+
+		usedArea += scast<long long>( width ) * height;
+
+		if ( pOutX ) { *pOutX = x;     }
+		if ( pOutY ) { *pOutY = bestY; }
+		return true;
+	}
+
+	size_t RectPacker::InsertAll( Rect *pRects, size_t rectCount )
+	{
+		if ( !pRects ) { return 0; }
+		// else
+
+		std::vector<size_t> order( rectCount );
+		for ( size_t i = 0; i < rectCount; ++i )
+		{
+			order[i] = i;
+		}
+		std::stable_sort
+		(
+			order.begin(), order.end(),
+			[&pRects]( size_t lhs, size_t rhs )
+			{
+				if ( pRects[lhs].height != pRects[rhs].height )
+				{
+					return ( pRects[rhs].height < pRects[lhs].height ) ? true : false;
+				}
+				// else
+				return ( pRects[rhs].width < pRects[lhs].width ) ? true : false;
+			}
+		);
+
+		size_t packedCount = 0;
+		for ( const auto &index : order )
+		{
+			Rect &rect = pRects[index];
+			rect.packed = Insert( rect.width, rect.height, &rect.x, &rect.y );
+			if ( rect.packed ) { packedCount++; }
+		}
+		return packedCount;
+	}
+
+	float RectPacker::GetOccupancy() const
+	{
+		const long long wholeArea = scast<long long>( areaWidth ) * areaHeight;
+		if ( wholeArea <= 0 ) { return 0.0f; }
+		// else
+		return scast<float>( usedArea ) / scast<float>( wholeArea );
+	}
+
+	int RectPacker::CalcPlacedY( size_t segmentIndex, int width, int height ) const
+	{
+		const int x = skyline[segmentIndex].x;
+		if ( areaWidth < x + width ) { return -1; }
+		// else
+
+		// The rect lies on the highest segment of the spanned segments.
+		int y = 0;
+		int remainingWidth = width;
+		for ( size_t i = segmentIndex; 0 < remainingWidth && i < skyline.size(); ++i )
+		{
+			y = std::max( y, skyline[i].y );
+			if ( areaHeight < y + height ) { return -1; }
+			// else
+
+			remainingWidth -= skyline[i].width;
+		}
+
+		return y;
+	}
+
+	void RectPacker::AddSkylineLevel( size_t segmentIndex, int x, int y, int width, int height )
+	{
+		skyline.insert( skyline.begin() + segmentIndex, Segment{ x, y + height, width } );
+
+		// Cut the segments that are covered by the new one.
+		const int right = x + width;
+		size_t i = segmentIndex + 1;
+		while ( i < skyline.size() )
+		{
+			Segment &segment = skyline[i];
+			if ( right <= segment.x ) { break; }
+			// else
+
+			const int overlap = right - segment.x;
+			if ( segment.width <= overlap )
+			{
+				skyline.erase( skyline.begin() + i );
+				continue;
+			}
+			// else
+
+			segment.x		+= overlap;
+			segment.width	-= overlap;
+			break;
+		}
+
+		// Merge the neighbors that have the same height.
+		i = 0;
+		while ( i + 1 < skyline.size() )
+		{
+			if ( skyline[i].y == skyline[i + 1].y )
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase( skyline.begin() + i + 1 );
+				continue;
+			}
+			// else
+			++i;
+		}
+	}
+}
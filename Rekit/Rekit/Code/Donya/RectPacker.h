@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>	// Use size_t.
+#include <vector>
+
+namespace Donya
+{
+	/// <summary>
+	/// Pack the rectangles into a fixed size area, by the skyline bottom-left algorithm.<para></para>
+	/// This is plain CPU code, it does not depend on the graphics API.
+	/// </summary>
+	class RectPacker
+	{
+	public:
+		struct Rect
+		{
+			int		x{};		// Output. Left.
+			int		y{};		// Output. Top.
+			int		width{};	// Input.
+			int		height{};	// Input.
+			bool	packed{};	// Output.
+		};
+	private:
+		/// <summary>
+		/// A segment of the skyline. The segments cover the whole width without gaps, in ascending order of "x".
+		/// </summary>
+		struct Segment
+		{
+			int x;
+			int y;
+			int width;
+		};
+	private:
+		int						areaWidth;
+		int						areaHeight;
+		int						padding;	// Applied at the right and bottom of each rect.
+		long long				usedArea;
+		std::vector<Segment>	skyline;
+	public:
+		RectPacker( int areaWidth, int areaHeight, int padding = 0 );
+	public:
+		/// <summary>
+		/// Remove all packed rects.
+		/// </summary>
+		void Reset();
+
+		/// <summary>
+		/// Returns false if the rect does not fit to the remaining space.
+		/// </summary>
+		bool Insert( int rectWidth, int rectHeight, int *pOutX, int *pOutY );
+		/// <summary>
+		/// Pack all rects, the taller ones first, because that packs tighter than the given order.<para></para>
+		/// The "width" and "height" of each rect are the input. The "x", "y" and "packed" are the output.<para></para>
+		/// Returns the count of the packed rects.
+		/// </summary>
+		size_t InsertAll( Rect *pRects, size_t rectCount );
+
+		int GetWidth()  const { return areaWidth;  }
+		int GetHeight() const { return areaHeight; }
+		/// <summary>
+		/// Returns the ratio of the used area(contains the padding) in the whole area. 0.0f ~ 1.0f.
+		/// </summary>
+		float GetOccupancy() const;
+	private:
+		/// <summary>
+		/// Returns the top of the rect that is placed at the left of the segment, or -1 if it does not fit.
+		/// </summary>
+		int  CalcPlacedY( size_t segmentIndex, int width, int height ) const;
+		void AddSkylineLevel( size_t segmentIndex, int x, int y, int width, int height );
+	};
+}
@@ -0,0 +1,339 @@
+#include "RenderCommand.h"
+
+#include <algorithm>	// Use std::min(), std::max().
+#include <cstdint>		// Use uintptr_t.
+#include <d3d11.h>
+#include <vector>
+#include <wrl.h>
+
+#include "Blend.h"
+#include "Donya.h"		// Use GetImmediateContext().
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace RenderCommand
+	{
+		struct KeyIndex
+		{
+			unsigned long long	key;
+			unsigned int		index;
+		};
+
+		static Backend				*pCurrentBackend = nullptr;
+		static std::vector<Command>	commands{};
+		static unsigned char		currentLayer = 0;
+		static bool					enableSort = true;
+		static bool					nowReplaying = false;
+		static FrameStats			lastFrameStats{};
+
+		// These are kept over the frames, for prevent the allocation at every Submit().
+		static std::vector<KeyIndex>	sortKeys{};
+		static std::vector<KeyIndex>	sortWork{};
+		static std::vector<Command>		sortedCommands{};
+
+		unsigned char CalcChangedStates( const Command &prev, const Command &next )
+		{
+			unsigned char changed = 0;
+			if ( prev.blendMode		!= next.blendMode	) { changed |= STATE_BLEND;		}
+			if ( prev.type			!= next.type		) { changed |= STATE_SHADER;	}
+			if ( prev.pSource		!= next.pSource		) { changed |= STATE_MESH;		}
+			if ( prev.material		!= next.material	) { changed |= STATE_MATERIAL;	}
+			if ( prev.pPayload		!= next.pPayload	) { changed |= STATE_INSTANCE;	}
+
+			// The material and the instance buffer belong to the mesh.
+			if ( changed & STATE_MESH ) { changed |= STATE_MATERIAL | STATE_INSTANCE; }
+
+			return changed;
+		}
+		void AddStateChanges( StateChanges *pChanges, unsigned char changedStates )
+		{
+			if ( changedStates & STATE_BLEND	) { pChanges->blend++;		}
+			if ( changedStates & STATE_SHADER	) { pChanges->shader++;		}
+			if ( changedStates & STATE_MESH		) { pChanges->mesh++;		}
+			if ( changedStates & STATE_MATERIAL	) { pChanges->material++;	}
+		}
+		StateChanges CountStateChanges( const std::vector<Command> &source )
+		{
+			StateChanges changes{};
+			for ( size_t i = 1; i < source.size(); ++i )
+			{
+				AddStateChanges( &changes, CalcChangedStates( source[i - 1], source[i] ) );
+			}
+			return changes;
+		}
+
+		/// <summary>
+		/// LSD radix sort by 8 bits. This is stable, so the commands of same key keep the recorded order.
+		/// </summary>
+		void RadixSort( std::vector<KeyIndex> *pKeys, std::vector<KeyIndex> *pWork )
+		{
+			constexpr unsigned int	RADIX_BITS	= 8U;
+			constexpr unsigned int	BUCKET_COUNT= 1U << RADIX_BITS;
+			constexpr unsigned int	PASS_COUNT	= ( sizeof( unsigned long long ) * 8U ) / RADIX_BITS;
+
+			const size_t count = pKeys->size();
+			pWork->resize( count );
+
+			std::vector<KeyIndex> *pSrc = pKeys;
+			std::vector<KeyIndex> *pDst = pWork;
+
+			for ( unsigned int pass = 0; pass < PASS_COUNT; ++pass )
+			{
+				const unsigned int shift = pass * RADIX_BITS;
+
+				size_t offsets[BUCKET_COUNT]{};
+				for ( const auto &it : *pSrc )
+				{
+					offsets[( it.key >> shift ) & ( BUCKET_COUNT - 1 )]++;
+				}
+
+				// All keys have the same digit, so this pass does not change the order.
+				const unsigned int firstDigit = scast<unsigned int>( ( pSrc->front().key >> shift ) & ( BUCKET_COUNT - 1 ) );
+				if ( offsets[firstDigit] == count ) { continue; }
+				// else
+
+				size_t sum = 0;
+				for ( auto &it : offsets )
+				{
+					const size_t bucketSize = it;
+					it  = sum;
+					sum += bucketSize;
+				}
+
+				for ( const auto &it : *pSrc )
+				{
+					( *pDst )[offsets[( it.key >> shift ) & ( BUCKET_COUNT - 1 )]++] = it;
+				}
+
+				std::swap( pSrc, pDst );
+			}
+
+			if ( pSrc != pKeys )
+			{
+				pKeys->swap( *pSrc );
+			}
+		}
+
+		void DeviceBackend::Submit( const Command *pCommands, size_t commandCount )
+		{
+			if ( !commandCount ) { return; }
+			// else
+
+			ID3D11DeviceContext *pImmediateContext = Donya::GetImmediateContext();
+
+			// For PostProcessing. The replay functions do not restore these.
+			Microsoft::WRL::ComPtr<ID3D11RasterizerState>	prevRasterizerState;
+			Microsoft::WRL::ComPtr<ID3D11InputLayout>		prevInputLayout;
+			Microsoft::WRL::ComPtr<ID3D11VertexShader>		prevVS;
+			Microsoft::WRL::ComPtr<ID3D11PixelShader>		prevPS;
+			Microsoft::WRL::ComPtr<ID3D11SamplerState>		prevSamplerState;
+			Microsoft::WRL::ComPtr<ID3D11DepthStencilState>	prevDepthStencilState;
+			D3D11_PRIMITIVE_TOPOLOGY						prevTopology{};
+			{
+				pImmediateContext->RSGetState( prevRasterizerState.ReleaseAndGetAddressOf() );
+				pImmediateContext->IAGetInputLayout( prevInputLayout.ReleaseAndGetAddressOf() );
+				pImmediateContext->IAGetPrimitiveTopology( &prevTopology );
+				pImmediateContext->VSGetShader( prevVS.ReleaseAndGetAddressOf(), 0, 0 );
+				pImmediateContext->PSGetShader( prevPS.ReleaseAndGetAddressOf(), 0, 0 );
+				pImmediateContext->PSGetSamplers( 0, 1, prevSamplerState.ReleaseAndGetAddressOf() );
+				pImmediateContext->OMGetDepthStencilState( prevDepthStencilState.ReleaseAndGetAddressOf(), 0 );
+			}
+			const Donya::Blend::Mode prevBlendMode = Donya::Blend::CurrentMode();
+
+			constexpr unsigned char EXTERNAL_BLEND = scast<unsigned char>( Donya::Blend::Mode::BLEND_MODE_COUNT );
+			for ( size_t i = 0; i < commandCount; ++i )
+			{
+				const Command &it = pCommands[i];
+
+				// The user definition blend state can not be re-activated by the mode, so it is drawn with the current one.
+				if ( ( it.changedStates & STATE_BLEND ) && it.blendMode != EXTERNAL_BLEND )
+				{
+					Donya::Blend::Activate( scast<Donya::Blend::Mode>( it.blendMode ), pImmediateContext );
+				}
+
+				if ( it.replay )
+				{
+					it.replay( it );
+				}
+			}
+
+			// PostProcessing
+			{
+				if ( prevBlendMode != Donya::Blend::Mode::BLEND_MODE_COUNT )
+				{
+					Donya::Blend::Activate( prevBlendMode, pImmediateContext );
+				}
+
+				pImmediateContext->RSSetState( prevRasterizerState.Get() );
+				pImmediateContext->IASetInputLayout( prevInputLayout.Get() );
+				pImmediateContext->IASetPrimitiveTopology( prevTopology );
+				pImmediateContext->VSSetShader( prevVS.Get(), nullptr, 0 );
+				pImmediateContext->PSSetShader( prevPS.Get(), nullptr, 0 );
+
+				ID3D11Buffer *pNullBuffers[2]{};
+				UINT zeros[2]{};
+				pImmediateContext->IASetVertexBuffers( 0, 2, pNullBuffers, zeros, zeros );
+				pImmediateContext->VSSetConstantBuffers( 0, 2, pNullBuffers );
+				pImmediateContext->PSSetConstantBuffers( 0, 2, pNullBuffers );
+
+				ID3D11ShaderResourceView *pNullSRV = nullptr;
+				pImmediateContext->PSSetShaderResources( 0, 1, &pNullSRV );
+				pImmediateContext->PSSetSamplers( 0, 1, prevSamplerState.GetAddressOf() );
+
+				pImmediateContext->OMSetDepthStencilState( prevDepthStencilState.Get(), 1 );
+			}
+		}
+
+		void SetBackend( Backend *pBackend )
+		{
+			pCurrentBackend = pBackend;
+			commands.clear();
+		}
+		Backend *GetBackend()
+		{
+			return pCurrentBackend;
+		}
+		bool IsRecording()
+		{
+			return ( pCurrentBackend && !nowReplaying ) ? true : false;
+		}
+
+		void SetLayer( unsigned char layer )
+		{
+			currentLayer = layer;
+		}
+		unsigned char GetLayer()
+		{
+			return currentLayer;
+		}
+
+		bool IsOrderDependent( unsigned char drawFlags )
+		{
+			return ( drawFlags & ( DRAW_TRANSLUCENT | DRAW_NO_DEPTH_WRITE ) ) ? true : false;
+		}
+
+		unsigned long long MakeSortKey( unsigned char layer, unsigned char drawFlags, Type type, const void *pSource, unsigned int material, float normalizedDepth, unsigned int sequence )
+		{
+			const float				clampedDepth= std::max( 0.0f, std::min( 1.0f, normalizedDepth ) );
+			const unsigned long long depth		= scast<unsigned long long>( clampedDepth * 65535.0f );
+
+			unsigned long long key = 0;
+			key |= scast<unsigned long long>( layer ) << 56;
+
+			if ( IsOrderDependent( drawFlags ) )
+			{
+				// Back to front. The grouping by the states would break the blended result.
+				key |= 1ULL										<< 55;
+				key |= ( 65535ULL - depth )						<< 39;
+				key |= scast<unsigned long long>( sequence )	<< 7;
+				return key;
+			}
+			// else
+
+			// The collision of the hash only worsen the grouping, the drawing result is not changed.
+			const uintptr_t			address		= reinterpret_cast<uintptr_t>( pSource );
+			const unsigned long long sourceHash	= scast<unsigned long long>( ( address >> 4 ) ^ ( address >> 31 ) ) & 0x7FFFFFFULL;
+
+			key |= ( scast<unsigned long long>( type )		& 0xFULL )		<< 51;
+			key |= sourceHash												<< 24;
+			key |= ( scast<unsigned long long>( material )	& 0xFFULL )		<< 16;
+			key |= depth;
+			return key;
+		}
+
+		Command Make( Type type, const void *pSource, unsigned int material, unsigned int instanceCount, const Donya::Vector4x4 &transform, const Donya::Vector4 &color, unsigned char drawFlags, Replayer replay, const void *pPayload )
+		{
+			// The clip-space depth of the origin. The transform is the row-major, so the origin is mapped to the fourth row.
+			const float depth = ( transform._44 != 0.0f ) ? transform._43 / transform._44 : 0.0f;
+
+			Command command{};
+			command.type			= type;
+			command.blendMode		= scast<unsigned char>( Donya::Blend::CurrentMode() );
+			command.drawFlags		= drawFlags;
+			command.layer			= currentLayer;
+			command.material		= scast<unsigned short>( material );
+			command.instanceCount	= instanceCount;
+			command.pSource			= pSource;
+			command.pPayload		= pPayload;
+			command.replay			= replay;
+			command.transform		= transform;
+			command.color			= color;
+			command.sortKey			= MakeSortKey( command.layer, drawFlags, type, pSource, material, depth, scast<unsigned int>( commands.size() ) );
+			return command;
+		}
+		void Record( const Command &command )
+		{
+			if ( !pCurrentBackend ) { return; }
+			// else
+			commands.emplace_back( command );
+		}
+
+		size_t GetRecordedCount()
+		{
+			return commands.size();
+		}
+
+		void SetSortEnable( bool enable )
+		{
+			enableSort = enable;
+		}
+
+		void Submit()
+		{
+			currentLayer = 0;
+
+			if ( !pCurrentBackend || commands.empty() ) { return; }
+			// else
+
+			lastFrameStats = FrameStats{};
+			lastFrameStats.commandCount  = commands.size();
+			lastFrameStats.recordedOrder = CountStateChanges( commands );
+
+			if ( enableSort )
+			{
+				sortKeys.resize( commands.size() );
+				for ( size_t i = 0; i < commands.size(); ++i )
+				{
+					sortKeys[i] = KeyIndex{ commands[i].sortKey, scast<unsigned int>( i ) };
+				}
+
+				RadixSort( &sortKeys, &sortWork );
+
+				sortedCommands.resize( commands.size() );
+				for ( size_t i = 0; i < sortKeys.size(); ++i )
+				{
+					sortedCommands[i] = commands[sortKeys[i].index];
+				}
+				commands.swap( sortedCommands );
+			}
+
+			for ( size_t i = 0; i < commands.size(); ++i )
+			{
+				commands[i].changedStates
+					= ( i == 0 )
+					? scast<unsigned char>( STATE_ALL )
+					: CalcChangedStates( commands[i - 1], commands[i] );
+
+				if ( 0 < i )
+				{
+					AddStateChanges( &lastFrameStats.submittedOrder, commands[i].changedStates );
+				}
+			}
+
+			// The replay functions call the immediate draw methods, these must not record the commands again.
+			nowReplaying = true;
+			pCurrentBackend->Submit( commands.data(), commands.size() );
+			nowReplaying = false;
+
+			commands.clear(); // Keep the capacity.
+		}
+
+		FrameStats GetLastFrameStats()
+		{
+			return lastFrameStats;
+		}
+	}
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <memory>		// Use std::uninitialized_copy().
+#include <type_traits>
+
+#include "Constant.h"	// Use scast macro.
+#include "FrameArena.h"
+#include "Vector.h"
+
+namespace Donya
+{
+	/// <summary>
+	/// The layer between the draw methods and the graphics API.<para></para>
+	/// By default(no backend is set), the draw methods call the Direct3D 11 immediately, and nothing is recorded.<para></para>
+	/// If a backend is set, the draw methods(StaticMesh, Sprite::Batch, Geometric::Cube/Sphere/TextureBoard, Geometric::Line) only record the compact commands without touching the Direct3D 11,
+	/// then Submit() sorts the recorded commands by these sort-key, and passes these to the backend.<para></para>
+	/// The DeviceBackend replays the sorted commands by the Direct3D 11, each command is drawn by its "replay" function with the arguments that were copied to its payload.<para></para>
+	/// The immediate drawing keeps the order of the draw calls.<para></para>
+	/// Please use from the main thread only.
+	/// </summary>
+	namespace RenderCommand
+	{
+		enum class Type : unsigned char
+		{
+			StaticMesh,				// Per subset.
+			StaticMeshInstanced,	// Per subset.
+			SpriteBatch,
+			Primitive,				// Geometric::Cube, Sphere, TextureBoard.
+			Line,
+
+			TypeCount
+		};
+
+		/// <summary>
+		/// The bits of the states that a command should bind. The backend can skip the binds of the states that are not set.
+		/// </summary>
+		enum StateBit : unsigned char
+		{
+			STATE_BLEND		= 1 << 0,
+			STATE_SHADER	= 1 << 1,	// Each type uses an own shader.
+			STATE_MESH		= 1 << 2,	// The source resource.
+			STATE_MATERIAL	= 1 << 3,
+			STATE_INSTANCE	= 1 << 4,	// The per-draw data of the payload, e.g. the instances. The instanced ones upload it only when this is set.
+
+			STATE_ALL		= STATE_BLEND | STATE_SHADER | STATE_MESH | STATE_MATERIAL | STATE_INSTANCE
+		};
+
+		/// <summary>
+		/// The properties of a draw that decide whether the draw can be reordered.
+		/// </summary>
+		enum DrawFlag : unsigned char
+		{
+			DRAW_OPAQUE			= 0,
+			DRAW_TRANSLUCENT	= 1 << 0,	// The material or the color is not opaque, e.g. the alpha is less than 1 or the texture is blended.
+			DRAW_NO_DEPTH_WRITE	= 1 << 1,	// The draw does not write the depth, so the later draws can not hide it.
+		};
+
+		struct Command;
+		/// <summary>
+		/// Draw the command by the Direct3D 11. The "pSource" and the "pPayload" of the command are the ones that the recorder set.
+		/// </summary>
+		using Replayer = void( * )( const Command &command );
+
+		/// <summary>
+		/// The compact representation of a draw call.
+		/// </summary>
+		struct Command
+		{
+			unsigned long long	sortKey{};		// Made by MakeSortKey() at the recording.
+			Type				type{};
+			unsigned char		blendMode{};	// The Donya::Blend::Mode at the recording.
+			unsigned char		drawFlags{};	// The combination of DrawFlag.
+			unsigned char		layer{};
+			unsigned char		changedStates{};// The combination of StateBit. Set by Submit(), the states that are same as the previous command are not set.
+			unsigned short		material{};		// The index of subset, or zero if the source does not have the materials.
+			unsigned int		instanceCount{};
+			const void			*pSource{};		// Identify the drawing resource, like a mesh or a sprite.
+			const void			*pPayload{};	// The arguments of the draw, that were made by MakePayload(). Some commands of one draw call share it.
+			Replayer			replay{};
+			Donya::Vector4x4	transform{};	// The World-View-Projection, or the View-Projection if the instances have the world.
+			Donya::Vector4		color{};
+		};
+
+		/// <summary>
+		/// The interface of the command consumer.
+		/// </summary>
+		class Backend
+		{
+		public:
+			virtual ~Backend() = default;
+		public:
+			virtual void Submit( const Command *pCommands, size_t commandCount ) = 0;
+		};
+
+		/// <summary>
+		/// The backend that draws the commands by the Direct3D 11 immediate context.<para></para>
+		/// It binds the blend state only if the "changedStates" has the STATE_BLEND, and the replay functions skip the binds of the other states that are not set.
+		/// The states of the context are restored after the drawing.
+		/// </summary>
+		class DeviceBackend : public Backend
+		{
+		public:
+			void Submit( const Command *pCommands, size_t commandCount ) override;
+		};
+
+		/// <summary>
+		/// Set the backend. The draw methods record the commands while a backend is set.<para></para>
+		/// Set nullptr for back to the immediate Direct3D 11 drawing(default). The recorded but not submitted commands are discarded at the change.<para></para>
+		/// The backend is not owned, please keep it alive while it is set.
+		/// </summary>
+		void SetBackend( Backend *pBackend );
+		/// <summary>
+		/// Returns nullptr if the backend is not set.
+		/// </summary>
+		Backend *GetBackend();
+		/// <summary>
+		/// Returns true if a backend is set. The draw methods check this.<para></para>
+		/// Returns false while the backend is drawing the commands at Submit(), so the replay functions can call the immediate draw methods.
+		/// </summary>
+		bool IsRecording();
+
+		/// <summary>
+		/// Set the layer of the commands that will be recorded. The layer is the most significant order, so please separate the order-dependent draws(e.g. translucent ones) by the layer. Default is zero.<para></para>
+		/// The layer is reset to zero at Submit().
+		/// </summary>
+		void SetLayer( unsigned char layer );
+		unsigned char GetLayer();
+
+		/// <summary>
+		/// Returns true if the command must keep the drawing order, it is the translucent one or the one that does not write the depth.<para></para>
+		/// The blend mode is not considered, because the ALPHA mode draws an opaque one same as the NO_BLEND.
+		/// </summary>
+		bool IsOrderDependent( unsigned char drawFlags );
+		/// <summary>
+		/// The "normalizedDepth" is clamped in [0.0f ~ 1.0f]. The order-dependent ones are drawn after the opaque ones in the same layer.<para></para>
+		/// Opaque(MSB to LSB) : layer[8], 0[1], shader(type)[4], mesh(source)[27], material[8], depth[16]. The near one is drawn first.<para></para>
+		/// Order-dependent : layer[8], 1[1], inverted depth[16], sequence[32], 0[7]. The far one is drawn first, and the same depth keeps the recorded order.
+		/// The sprites are at the depth zero, so these keep the recorded order(painter's order).
+		/// </summary>
+		unsigned long long MakeSortKey( unsigned char layer, unsigned char drawFlags, Type type, const void *pSource, unsigned int material, float normalizedDepth, unsigned int sequence );
+
+		/// <summary>
+		/// Make a command, the blend mode and the layer are the current ones. The depth of the sort-key is the origin of the "transform".<para></para>
+		/// The sequence of the sort-key is the count of recorded commands, so please Record() the made command before making the next one.
+		/// </summary>
+		Command Make( Type type, const void *pSource, unsigned int material, unsigned int instanceCount, const Donya::Vector4x4 &transform, const Donya::Vector4 &color, unsigned char drawFlags, Replayer replay, const void *pPayload );
+
+		/// <summary>
+		/// Copy the "count" elements to the memory that lives until the end of the frame(the FrameArena of the calling thread), and returns the copy.<para></para>
+		/// The destructor of the copy is not called, so the "T" must be trivially destructible.
+		/// </summary>
+		template<typename T>
+		const T *MakePayload( const T *pSource, size_t count = 1U )
+		{
+			static_assert( std::is_trivially_destructible<T>::value, "The payload must be trivially destructible." );
+
+			T *pDest = static_cast<T *>( Donya::FrameArena::Get().Allocate( sizeof( T ) * count, alignof( T ) ) );
+			std::uninitialized_copy( pSource, pSource + count, pDest );
+			return pDest;
+		}
+		/// <summary>
+		/// Append the command to the buffer. Do nothing if the backend is not set.
+		/// </summary>
+		void Record( const Command &command );
+
+		/// <summary>
+		/// Returns the count of the recorded commands that are not submitted yet.
+		/// </summary>
+		size_t GetRecordedCount();
+		/// <summary>
+		/// Enable the sorting at Submit(). Default is true. If disabled, the commands are submitted in the recorded order.
+		/// </summary>
+		void SetSortEnable( bool enable );
+
+		/// <summary>
+		/// Sort the recorded commands by the sort-key, and set the "changedStates" of these.<para></para>
+		/// Then pass these to the backend, and clear the buffer. Donya::Present() calls this.
+		/// </summary>
+		void Submit();
+
+		/// <summary>
+		/// The count of the state changes between the neighbor commands.
+		/// </summary>
+		struct StateChanges
+		{
+			size_t blend{};
+			size_t shader{};
+			size_t mesh{};
+			size_t material{};
+		public:
+			size_t Total() const { return blend + shader + mesh + material; }
+		};
+		struct FrameStats
+		{
+			size_t			commandCount{};
+			StateChanges	recordedOrder{};	// In the recorded order, it is the count if without the sorting.
+			StateChanges	submittedOrder{};
+		};
+		/// <summary>
+		/// Returns the stats of the last Submit().
+		/// </summary>
+		FrameStats GetLastFrameStats();
+	}
+}
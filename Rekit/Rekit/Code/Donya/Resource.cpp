@@ -1,18 +1,23 @@
 #include "Resource.h"
 
+#include <cstring>		// Use memcpy(), memcmp(), strlen().
 #include <D3D11.h>
 #include <d3dcompiler.h>
 #include <DirectXMath.h>
 #include <fstream>
 #include <unordered_map>
 #include <memory>
-#include <sstream>
+#include <mutex>
 #include <tchar.h>
 #include <DDSTextureLoader.h>
 #include <WICTextureLoader.h>
 
+#include "Benchmark.h"
+#include "ConcurrentCache.h"
 #include "Constant.h"
 #include "Donya.h"		// Use for GetDevice().
+#include "ObjParser.h"
+#include "ResourceBudget.h"
 #include "Useful.h"
 
 // This resolve un external symbol.
@@ -21,21 +26,6 @@
 using namespace DirectX;
 using namespace Microsoft::WRL;
 
-bool IsContainStr( const std::wstring &str, const wchar_t *searchStr )
-{
-	return ( str.find( searchStr ) != std::wstring::npos ) ? true : false;
-}
-
-// Don't skip delim character.
-void SkipUntilNextDelim( std::wstring *pStr, std::wstringstream *pSS, const wchar_t *delim = L" " )
-{
-	int disposal = pStr->find( delim );
-	*pStr = pStr->substr( disposal, pStr->length() );
-
-	pSS->clear();
-	pSS->str( *pStr );
-}
-
 namespace Donya
 {
 	namespace Resource
@@ -67,449 +57,661 @@ namespace Donya
 			return codeLength;
 		}
 
-		#pragma region VerteShaderCache
+		/// <summary>
+		/// Returns the value of the "key" from the "pCache", or the value that is created by "create" if it is not cached.<para></para>
+		/// If "isEnableCache" is false, the cache is not used, the created value is owned only by the caller.
+		/// </summary>
+		template<typename Key, typename Value, typename Creator>
+		std::shared_ptr<const Value> FetchOrCreate( ConcurrentCache<Key, Value> *pCache, const Key &key, bool isEnableCache, Creator &&create )
+		{
+			if ( isEnableCache ) { return pCache->FindOrCreate( key, std::forward<Creator>( create ) ); }
+			// else
 
-		struct VertexShaderCacheContents
+			auto pCreated = std::make_shared<Value>();
+			if ( !create( pCreated.get() ) ) { return nullptr; }
+			// else
+			return pCreated;
+		}
+
+		#pragma region ShaderBinaryCache
+
+		/// <summary>
+		/// Increase when the layout of the cache file is changed.
+		/// </summary>
+		static constexpr unsigned int SHADER_BINARY_CACHE_VERSION = 1U;
+		static constexpr char SHADER_BINARY_CACHE_MAGIC[4]{ 'D', 'S', 'B', 'C' };
+
+		/// <summary>
+		/// The layout of the file : [Header][Entry]*entryCount. The Entry is [key(8 bytes)][byteSize(4 bytes)][byte-code].
+		/// </summary>
+		struct ShaderBinaryCacheHeader
 		{
-			Microsoft::WRL::ComPtr<ID3D11VertexShader> d3dVertexShader;
-			Microsoft::WRL::ComPtr<ID3D11InputLayout>  d3dInputLayout;
-		public:
-			VertexShaderCacheContents
-			(
-				ID3D11VertexShader	*pVertexShader,
-				ID3D11InputLayout	*pInputLayout
-			) :
-				d3dVertexShader( pVertexShader ),
-				d3dInputLayout( pInputLayout )
-			{}
+			char			magic[4];
+			unsigned int	version;
+			unsigned int	compilerVersion;	// D3D_COMPILER_VERSION.
+			unsigned int	entryCount;
 		};
 
-		static std::unordered_map<std::string, VertexShaderCacheContents> vertexShaderCache{};
-	
-		bool CreateVertexShaderFromCso( ID3D11Device *d3dDevice, const char *csoname, const char *openMode, ID3D11VertexShader **d3dVertexShader, ID3D11InputLayout **d3dInputLayout, const D3D11_INPUT_ELEMENT_DESC *d3dInputElementsDescs, size_t inputElementDescSize, bool enableCache )
+		static std::string shaderBinaryCachePath{ "./Data/ShaderCache.bin" };
+		using ShaderByteCode = std::shared_ptr<const std::vector<unsigned char>>;	// Shared, because an invalid one may be erased while another thread uses it.
+		static std::unordered_map<unsigned long long, ShaderByteCode> shaderBinaryCache{};
+		static bool shaderBinaryCacheWasRead  = false;
+		static bool shaderBinaryCacheIsDirty  = false;
+		static ShaderCacheStats shaderCacheStats{};
+		static std::mutex shaderBinaryCacheMutex{};	// Guards the above, except the constants.
+
+		// FNV-1a.
+		unsigned long long HashBytes( unsigned long long hash, const void *pData, size_t byteSize )
 		{
-			HRESULT hr = S_OK;
+			const unsigned char *pBytes = static_cast<const unsigned char *>( pData );
+			for ( size_t i = 0; i < byteSize; ++i )
+			{
+				hash ^= pBytes[i];
+				hash *= 1099511628211ULL;
+			}
+			return hash;
+		}
+		/// <summary>
+		/// The terminator is also hashed, for separating the neighbor strings.
+		/// </summary>
+		unsigned long long HashString( unsigned long long hash, const char *str )
+		{
+			return HashBytes( hash, str, strlen( str ) + 1 );
+		}
+		unsigned long long MakeShaderKey( const std::string &code, const D3D_SHADER_MACRO *pDefines, const std::string &entryPoint, const char *target, UINT flags )
+		{
+			unsigned long long hash = 14695981039346656037ULL;
+			hash = HashBytes ( hash, code.c_str(), code.size() + 1 );
+			hash = HashString( hash, entryPoint.c_str() );
+			hash = HashString( hash, target );
+			hash = HashBytes ( hash, &flags, sizeof( flags ) );
+			for ( const D3D_SHADER_MACRO *pIt = pDefines; pIt && pIt->Name; ++pIt )
+			{
+				hash = HashString( hash, pIt->Name );
+				hash = HashString( hash, ( pIt->Definition ) ? pIt->Definition : "" );
+			}
+			return hash;
+		}
 
-			std::string strCsoName = csoname;
+		/// <summary>
+		/// Please call while locking the shaderBinaryCacheMutex.
+		/// </summary>
+		void ReadShaderBinaryCache()
+		{
+			shaderBinaryCacheWasRead = true;
 
-			if ( !Donya::IsExistFile( strCsoName ) ) { return false; }
-			// else
+			Benchmark timer{};
+			timer.Begin();
 
-			auto it = vertexShaderCache.find( strCsoName );
-			if ( it != vertexShaderCache.end() )
-			{
-				*d3dVertexShader = it->second.d3dVertexShader.Get();
-				( *d3dVertexShader )->AddRef();
+			std::unique_ptr<unsigned char[]> fileData{};
+			const long fileSize = ReadByteCode( &fileData, shaderBinaryCachePath, "rb" );
 
-				if ( d3dInputLayout != nullptr )
+			auto Read = [&]( size_t *pCursor, void *pOutput, size_t byteSize )->bool
+			{
+				if ( scast<size_t>( fileSize ) < *pCursor + byteSize ) { return false; }
+				if ( !byteSize ) { return true; }
+				// else
+				memcpy( pOutput, fileData.get() + *pCursor, byteSize );
+				*pCursor += byteSize;
+				return true;
+			};
+
+			size_t cursor = 0;
+			ShaderBinaryCacheHeader header{};
+			const bool isValidHeader =
+				0 < fileSize
+				&& Read( &cursor, &header, sizeof( header ) )
+				&& memcmp( header.magic, SHADER_BINARY_CACHE_MAGIC, sizeof( header.magic ) ) == 0
+				&& header.version         == SHADER_BINARY_CACHE_VERSION
+				&& header.compilerVersion == D3D_COMPILER_VERSION;
+			if ( isValidHeader )
+			{
+				for ( unsigned int i = 0; i < header.entryCount; ++i )
 				{
-					*d3dInputLayout = it->second.d3dInputLayout.Get();
-					_ASSERT_EXPR( *d3dInputLayout, L"cached InputLayout must be not Null." );
-					( *d3dInputLayout )->AddRef();
-				}
+					unsigned long long	key{};
+					unsigned int		byteSize{};
+					if ( !Read( &cursor, &key, sizeof( key ) ) || !Read( &cursor, &byteSize, sizeof( byteSize ) ) ) { break; }
+					// else
 
-				return true;
+					std::vector<unsigned char> byteCode( byteSize );
+					if ( !Read( &cursor, byteCode.data(), byteSize ) ) { break; }
+					// else
+
+					shaderBinaryCache[key] = std::make_shared<const std::vector<unsigned char>>( std::move( byteCode ) );
+				}
 			}
+
+			shaderCacheStats.fileReadSeconds += timer.End();
+		}
+
+		void SetShaderBinaryCachePath( const std::string &filePath )
+		{
+			std::lock_guard<std::mutex> lock( shaderBinaryCacheMutex );
+			shaderBinaryCachePath = filePath;
+		}
+		bool SaveShaderBinaryCache()
+		{
+			std::lock_guard<std::mutex> lock( shaderBinaryCacheMutex );
+			if ( !shaderBinaryCacheIsDirty ) { return true; }
 			// else
 
-			std::unique_ptr<unsigned char[]> csoData{ nullptr };
-			long csoSize = ReadByteCode( &csoData, strCsoName, openMode );
-			_ASSERT_EXPR( 0 < csoSize, L"vs cso file not found" );
+			std::ofstream ofs{ shaderBinaryCachePath, std::ios::out | std::ios::binary | std::ios::trunc };
+			if ( !ofs ) { return false; }
+			// else
 
-			hr = d3dDevice->CreateVertexShader
-			(
-				csoData.get(),
-				csoSize,
-				NULL,
-				d3dVertexShader
-			);
-			_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : CreateVertexShader()" );
-			
-			if ( d3dInputLayout != nullptr )
-			{
-				hr = d3dDevice->CreateInputLayout
-				(
-					d3dInputElementsDescs,
-					inputElementDescSize,
-					csoData.get(),
-					csoSize,
-					d3dInputLayout
-				);
-				_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateInputLayout()" ) );
-			}
+			ShaderBinaryCacheHeader header{};
+			memcpy( header.magic, SHADER_BINARY_CACHE_MAGIC, sizeof( header.magic ) );
+			header.version			= SHADER_BINARY_CACHE_VERSION;
+			header.compilerVersion	= D3D_COMPILER_VERSION;
+			header.entryCount		= scast<unsigned int>( shaderBinaryCache.size() );
+			ofs.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
 
-			if ( enableCache )
+			for ( const auto &it : shaderBinaryCache )
 			{
-				vertexShaderCache.insert
-				(
-					std::make_pair
-					(
-						strCsoName,
-						VertexShaderCacheContents
-						{
-							*d3dVertexShader,
-							( ( d3dInputLayout != nullptr ) ? *d3dInputLayout : nullptr )
-						}
-					)
-				);
+				const unsigned int byteSize = scast<unsigned int>( it.second->size() );
+				ofs.write( reinterpret_cast<const char *>( &it.first ), sizeof( it.first ) );
+				ofs.write( reinterpret_cast<const char *>( &byteSize ), sizeof( byteSize ) );
+				ofs.write( reinterpret_cast<const char *>( it.second->data() ), byteSize );
 			}
 
+			if ( !ofs ) { return false; }
+			// else
+
+			shaderBinaryCacheIsDirty = false;
 			return true;
 		}
+		ShaderCacheStats GetShaderCacheStats()
+		{
+			std::lock_guard<std::mutex> lock( shaderBinaryCacheMutex );
+			return shaderCacheStats;
+		}
 
-		bool CreateVertexShaderFromSource( ID3D11Device *pDevice, const std::string &shaderId, const std::string &shaderCode, const std::string &shaderEntryPoint, ID3D11VertexShader **pOutVertexShader, ID3D11InputLayout **pOutInputLayout, const D3D11_INPUT_ELEMENT_DESC *pInputElementsDesc, size_t inputElementsCount, bool isEnableCache )
+		/// <summary>
+		/// Returns the byte-code that is taken from the cache, or compiled by D3DCompile() and stored to the cache.<para></para>
+		/// Returns nullptr if failed the compilation.<para></para>
+		/// If "ignoreCache" is true, the cached one is erased and compiled again. Use it when the cached byte-code could not create the shader.
+		/// </summary>
+		ShaderByteCode CompileShaderWithCache( const std::string &code, const D3D_SHADER_MACRO *pDefines, const std::string &entryPoint, const char *target, bool ignoreCache = false )
 		{
-			HRESULT hr = S_OK;
+			UINT flags = D3DCOMPILE_ENABLE_STRICTNESS;
+		#if DEBUG_MODE
+			flags |= D3DCOMPILE_DEBUG;
+			flags |= D3D10_SHADER_SKIP_OPTIMIZATION;
+		#endif
 
-			auto it = vertexShaderCache.find( shaderId );
-			if ( it != vertexShaderCache.end() )
+			const unsigned long long key = MakeShaderKey( code, pDefines, entryPoint, target, flags );
 			{
-				*pOutVertexShader = it->second.d3dVertexShader.Get();
-				( *pOutVertexShader )->AddRef();
+				std::lock_guard<std::mutex> lock( shaderBinaryCacheMutex );
 
-				if ( pOutInputLayout != nullptr )
+				if ( !shaderBinaryCacheWasRead )
 				{
-					*pOutInputLayout = it->second.d3dInputLayout.Get();
-					_ASSERT_EXPR( *pOutInputLayout, L"Cached InputLayout must be not Null." );
-					( *pOutInputLayout )->AddRef();
+					ReadShaderBinaryCache();
 				}
 
-				return true;
+				auto found = shaderBinaryCache.find( key );
+				if ( found != shaderBinaryCache.end() )
+				{
+					if ( !ignoreCache )
+					{
+						shaderCacheStats.cacheHitCount++;
+						return found->second;
+					}
+					// else
+
+					// Also drop it from the file, so the broken one does not persist across runs.
+					shaderBinaryCache.erase( found );
+					shaderBinaryCacheIsDirty = true;
+					shaderCacheStats.invalidatedCount++;
+				}
 			}
 			// else
 
-			DWORD flags = D3DCOMPILE_ENABLE_STRICTNESS;
-		#if DEBUG_MODE
-			flags |= D3DCOMPILE_DEBUG;
-			flags |= D3D10_SHADER_SKIP_OPTIMIZATION;
-		#endif
+			// Compile out of the lock, the other threads can use the cache meanwhile.
+
+			Benchmark timer{};
+			timer.Begin();
 
 			Microsoft::WRL::ComPtr<ID3DBlob> compiledShaderBlob;
 			Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
 
 			// D3DCompile() : https://docs.microsoft.com/en-us/windows/win32/api/d3dcompiler/nf-d3dcompiler-d3dcompile
-			hr = D3DCompile
+			HRESULT hr = D3DCompile
 			(
-				shaderCode.c_str(),
-				shaderCode.length(),
-				NULL,
+				code.c_str(),
+				code.length(),
 				NULL,
+				pDefines,
 				NULL,
-				shaderEntryPoint.c_str(),
-				"vs_5_0",
+				entryPoint.c_str(),
+				target,
 				flags,
 				NULL,
 				compiledShaderBlob.GetAddressOf(),
 				errorBlob.GetAddressOf()
 			);
+
+			const double compileSeconds = timer.End();
+
+			std::lock_guard<std::mutex> lock( shaderBinaryCacheMutex );
+			shaderCacheStats.compiledCount++;
+			shaderCacheStats.compileSeconds += compileSeconds;
+
 			if ( FAILED( hr ) )
 			{
-				auto errorStr = errorBlob->GetBufferPointer();
-				OutputDebugStringA( ( char * )( errorStr ) );
-				_ASSERT_EXPR( 0, ( wchar_t * )( errorStr ) );
-				return false;
+				const char *errorStr = ( errorBlob ) ? static_cast<const char *>( errorBlob->GetBufferPointer() ) : "Unknown error.";
+				OutputDebugStringA( errorStr );
+				_ASSERT_EXPR( 0, L"Failed : D3DCompile()." );
+				return nullptr;
 			}
 			// else
 
-			hr = pDevice->CreateVertexShader
-			(
-				compiledShaderBlob->GetBufferPointer(),
-				compiledShaderBlob->GetBufferSize(),
-				0,
-				pOutVertexShader
-			);
-			if ( FAILED( hr ) )
+			// If another thread has stored the same key meanwhile, that byte-code is same as this, so keep it.
+			const unsigned char *pBegin = static_cast<const unsigned char *>( compiledShaderBlob->GetBufferPointer() );
+			auto result = shaderBinaryCache.emplace( key, std::make_shared<const std::vector<unsigned char>>( pBegin, pBegin + compiledShaderBlob->GetBufferSize() ) );
+			if ( result.second )
 			{
-				_ASSERT_EXPR( 0, reinterpret_cast<LPWSTR>( errorBlob->GetBufferPointer() ) );
-				return false;
+				shaderBinaryCacheIsDirty = true;
 			}
-			// else
+			return result.first->second;
+		}
+
+		#pragma endregion
+
+		#pragma region VerteShaderCache
+
+		struct VertexShaderCacheContents
+		{
+			Microsoft::WRL::ComPtr<ID3D11VertexShader> d3dVertexShader;
+			Microsoft::WRL::ComPtr<ID3D11InputLayout>  d3dInputLayout;
+		};
+
+		static ConcurrentCache<std::string, VertexShaderCacheContents> vertexShaderCache{};
+
+		void OutputVertexShader( const VertexShaderCacheContents &contents, ID3D11VertexShader **pOutVertexShader, ID3D11InputLayout **pOutInputLayout )
+		{
+			*pOutVertexShader = contents.d3dVertexShader.Get();
+			( *pOutVertexShader )->AddRef();
 
 			if ( pOutInputLayout != nullptr )
 			{
-				hr = pDevice->CreateInputLayout
+				*pOutInputLayout = contents.d3dInputLayout.Get();
+				_ASSERT_EXPR( *pOutInputLayout, L"Cached InputLayout must be not Null." );
+				( *pOutInputLayout )->AddRef();
+			}
+		}
+	
+		bool CreateVertexShaderFromCso( ID3D11Device *d3dDevice, const char *csoname, const char *openMode, ID3D11VertexShader **d3dVertexShader, ID3D11InputLayout **d3dInputLayout, const D3D11_INPUT_ELEMENT_DESC *d3dInputElementsDescs, size_t inputElementDescSize, bool enableCache )
+		{
+			std::string strCsoName = csoname;
+
+			if ( !Donya::IsExistFile( strCsoName ) ) { return false; }
+			// else
+
+			auto Create = [&]( VertexShaderCacheContents *pOutput )->bool
+			{
+				std::unique_ptr<unsigned char[]> csoData{ nullptr };
+				long csoSize = ReadByteCode( &csoData, strCsoName, openMode );
+				_ASSERT_EXPR( 0 < csoSize, L"vs cso file not found" );
+
+				HRESULT hr = d3dDevice->CreateVertexShader
 				(
-					pInputElementsDesc,
-					inputElementsCount,
-					compiledShaderBlob->GetBufferPointer(),
-					compiledShaderBlob->GetBufferSize(),
-					pOutInputLayout
+					csoData.get(),
+					csoSize,
+					NULL,
+					pOutput->d3dVertexShader.GetAddressOf()
 				);
-				if ( FAILED( hr ) )
+				_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : CreateVertexShader()" );
+				if ( FAILED( hr ) ) { return false; }
+				// else
+
+				if ( d3dInputLayout != nullptr )
 				{
-					_ASSERT_EXPR( SUCCEEDED( hr ), reinterpret_cast<LPCSTR>( errorBlob->GetBufferPointer() ) );
-					return false;
+					hr = d3dDevice->CreateInputLayout
+					(
+						d3dInputElementsDescs,
+						inputElementDescSize,
+						csoData.get(),
+						csoSize,
+						pOutput->d3dInputLayout.GetAddressOf()
+					);
+					_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateInputLayout()" ) );
+					if ( FAILED( hr ) ) { return false; }
+					// else
 				}
-				// else
-			}
 
-			if ( isEnableCache )
+				return true;
+			};
+
+			auto pContents = FetchOrCreate( &vertexShaderCache, strCsoName, enableCache, Create );
+			if ( !pContents ) { return false; }
+			// else
+
+			OutputVertexShader( *pContents, d3dVertexShader, d3dInputLayout );
+			return true;
+		}
+
+		bool CreateVertexShaderFromSource( ID3D11Device *pDevice, const std::string &shaderId, const std::string &shaderCode, const std::string &shaderEntryPoint, ID3D11VertexShader **pOutVertexShader, ID3D11InputLayout **pOutInputLayout, const D3D11_INPUT_ELEMENT_DESC *pInputElementsDesc, size_t inputElementsCount, bool isEnableCache )
+		{
+			auto CreateByByteCode = [&]( const std::vector<unsigned char> &byteCode, VertexShaderCacheContents *pOutput )->bool
 			{
-				vertexShaderCache.insert
+				HRESULT hr = pDevice->CreateVertexShader
 				(
-					std::make_pair
-					(
-						shaderId,
-						VertexShaderCacheContents
-						{
-							*pOutVertexShader,
-							( ( pOutInputLayout != nullptr ) ? *pOutInputLayout : nullptr )
-						}
-					)
+					byteCode.data(),
+					byteCode.size(),
+					0,
+					pOutput->d3dVertexShader.ReleaseAndGetAddressOf()
 				);
-			}
+				if ( FAILED( hr ) ) { return false; }
+				// else
+
+				if ( pOutInputLayout != nullptr )
+				{
+					hr = pDevice->CreateInputLayout
+					(
+						pInputElementsDesc,
+						inputElementsCount,
+						byteCode.data(),
+						byteCode.size(),
+						pOutput->d3dInputLayout.ReleaseAndGetAddressOf()
+					);
+					if ( FAILED( hr ) ) { return false; }
+					// else
+				}
 
+				return true;
+			};
+			auto Create = [&]( VertexShaderCacheContents *pOutput )->bool
+			{
+				ShaderByteCode pByteCode = CompileShaderWithCache( shaderCode, /* pDefines = */ nullptr, shaderEntryPoint, "vs_5_0" );
+				if ( !pByteCode ) { return false; }
+				if ( CreateByByteCode( *pByteCode, pOutput ) ) { return true; }
+				// else
+
+				// The cached byte-code may be broken(e.g. a stale cache file), so compile again once.
+				pByteCode = CompileShaderWithCache( shaderCode, /* pDefines = */ nullptr, shaderEntryPoint, "vs_5_0", /* ignoreCache = */ true );
+				if ( pByteCode && CreateByByteCode( *pByteCode, pOutput ) ) { return true; }
+				// else
+
+				_ASSERT_EXPR( 0, L"Failed : CreateVertexShader() or CreateInputLayout()." );
+				return false;
+			};
+
+			auto pContents = FetchOrCreate( &vertexShaderCache, shaderId, isEnableCache, Create );
+			if ( !pContents ) { return false; }
+			// else
+
+			OutputVertexShader( *pContents, pOutVertexShader, pOutInputLayout );
 			return true;
 		}
 
 		void ReleaseAllVertexShaderCaches()
 		{
-			vertexShaderCache.clear();
+			vertexShaderCache.Clear();
 		}
 
 		#pragma endregion
 
 		#pragma region PixelShaderCache
 
-		static std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D11PixelShader>> pixelShaderCache{};
+		static ConcurrentCache<std::string, Microsoft::WRL::ComPtr<ID3D11PixelShader>> pixelShaderCache{};
 		
 		bool CreatePixelShaderFromCso( ID3D11Device  *d3dDevice, const char *csoname, const char *openMode, ID3D11PixelShader **d3dPixelShader, bool enableCache )
 		{
-			HRESULT hr = S_OK;
-
 			std::string strCsoName = csoname;
 
 			if ( !Donya::IsExistFile( strCsoName ) ) { return false; }
 			// else
 
-			auto it = pixelShaderCache.find( strCsoName );
-			if ( it != pixelShaderCache.end() )
+			auto Create = [&]( Microsoft::WRL::ComPtr<ID3D11PixelShader> *pOutput )->bool
 			{
-				*d3dPixelShader = it->second.Get();
-				( *d3dPixelShader )->AddRef();
-
-				return true;
-			}
-			// else
-
-			FILE* fp = nullptr;
-			fopen_s( &fp, strCsoName.c_str(), openMode );
-			if ( !fp ) { _ASSERT_EXPR( 0, L"ps cso file not found" ); }
-
-			fseek( fp, 0, SEEK_END );
-			long csoSize = ftell( fp );
-			fseek( fp, 0, SEEK_SET );
-
-			std::unique_ptr<unsigned char[]> csoData = std::make_unique<unsigned char[]>( csoSize );
-			fread( csoData.get(), csoSize, 1, fp );
-			fclose( fp );
-
-			hr = d3dDevice->CreatePixelShader
-			(
-				csoData.get(),
-				csoSize,
-				NULL,
-				d3dPixelShader
-			);
-			_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : CreatePixelShader()" );
+				std::unique_ptr<unsigned char[]> csoData{ nullptr };
+				long csoSize = ReadByteCode( &csoData, strCsoName, openMode );
+				if ( csoSize <= 0 ) { _ASSERT_EXPR( 0, L"ps cso file not found" ); return false; }
+				// else
 
-			if ( enableCache )
-			{
-				pixelShaderCache.insert
+				HRESULT hr = d3dDevice->CreatePixelShader
 				(
-					std::make_pair
-					(
-						strCsoName,
-						*d3dPixelShader
-					)
+					csoData.get(),
+					csoSize,
+					NULL,
+					pOutput->GetAddressOf()
 				);
-			}
+				_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : CreatePixelShader()" );
+				return SUCCEEDED( hr );
+			};
+
+			auto pShader = FetchOrCreate( &pixelShaderCache, strCsoName, enableCache, Create );
+			if ( !pShader ) { return false; }
+			// else
 
+			*d3dPixelShader = pShader->Get();
+			( *d3dPixelShader )->AddRef();
 			return true;
 		}
 
 		bool CreatePixelShaderFromSource( ID3D11Device *pDevice, const std::string &shaderId, const std::string &shaderCode, const std::string &shaderEntryPoint, ID3D11PixelShader **pOutPixelShader, bool isEnableCache )
 		{
-			HRESULT hr = S_OK;
-
-			auto it = pixelShaderCache.find( shaderId );
-			if ( it != pixelShaderCache.end() )
+			auto CreateByByteCode = [&]( const std::vector<unsigned char> &byteCode, Microsoft::WRL::ComPtr<ID3D11PixelShader> *pOutput )->bool
 			{
-				*pOutPixelShader = it->second.Get();
-				( *pOutPixelShader )->AddRef();
-
-				return true;
-			}
-			// else
-
-			DWORD flags = D3DCOMPILE_ENABLE_STRICTNESS;
-		#if DEBUG_MODE
-			flags |= D3DCOMPILE_DEBUG;
-			flags |= D3D10_SHADER_SKIP_OPTIMIZATION;
-		#endif
+				HRESULT hr = pDevice->CreatePixelShader
+				(
+					byteCode.data(),
+					byteCode.size(),
+					0,
+					pOutput->ReleaseAndGetAddressOf()
+				);
+				return SUCCEEDED( hr );
+			};
+			auto Create = [&]( Microsoft::WRL::ComPtr<ID3D11PixelShader> *pOutput )->bool
+			{
+				ShaderByteCode pByteCode = CompileShaderWithCache( shaderCode, /* pDefines = */ nullptr, shaderEntryPoint, "ps_5_0" );
+				if ( !pByteCode ) { return false; }
+				if ( CreateByByteCode( *pByteCode, pOutput ) ) { return true; }
+				// else
 
-			Microsoft::WRL::ComPtr<ID3DBlob> compiledShaderBlob;
-			Microsoft::WRL::ComPtr<ID3DBlob> errorBlob;
+				// The cached byte-code may be broken(e.g. a stale cache file), so compile again once.
+				pByteCode = CompileShaderWithCache( shaderCode, /* pDefines = */ nullptr, shaderEntryPoint, "ps_5_0", /* ignoreCache = */ true );
+				if ( pByteCode && CreateByByteCode( *pByteCode, pOutput ) ) { return true; }
+				// else
 
-			// D3DCompile() : https://docs.microsoft.com/en-us/windows/win32/api/d3dcompiler/nf-d3dcompiler-d3dcompile
-			hr = D3DCompile
-			(
-				shaderCode.c_str(),
-				shaderCode.length(),
-				NULL,
-				NULL,
-				NULL,
-				shaderEntryPoint.c_str(),
-				"ps_5_0",
-				flags,
-				NULL,
-				compiledShaderBlob.GetAddressOf(),
-				errorBlob.GetAddressOf()
-			);
-			if ( FAILED( hr ) )
-			{
-				_ASSERT_EXPR( 0, reinterpret_cast<LPCSTR>( errorBlob->GetBufferPointer() ) );
+				_ASSERT_EXPR( 0, L"Failed : CreatePixelShader()." );
 				return false;
-			}
-			// else
+			};
 
-			hr = pDevice->CreatePixelShader
-			(
-				compiledShaderBlob->GetBufferPointer(),
-				compiledShaderBlob->GetBufferSize(),
-				0,
-				pOutPixelShader
-			);
-			if ( FAILED( hr ) )
-			{
-				_ASSERT_EXPR( 0, reinterpret_cast<LPCSTR>( errorBlob->GetBufferPointer() ) );
-				return false;
-			}
+			auto pShader = FetchOrCreate( &pixelShaderCache, shaderId, isEnableCache, Create );
+			if ( !pShader ) { return false; }
 			// else
 
-			if ( isEnableCache )
-			{
-				pixelShaderCache.insert
-				(
-					std::make_pair
-					(
-						shaderId,
-						*pOutPixelShader
-					)
-				);
-			}
-
+			*pOutPixelShader = pShader->Get();
+			( *pOutPixelShader )->AddRef();
 			return true;
 		}
 
 		void ReleaseAllPixelShaderCaches()
 		{
-			pixelShaderCache.clear();
+			pixelShaderCache.Clear();
 		}
 
 		#pragma endregion
 
 		#pragma region SpriteCache
 
-		struct SpriteCacheContents
+		/// <summary>
+		/// Returns the bits per pixel of the format. Returns 32 if the format is not listed.
+		/// </summary>
+		size_t CalcBitsPerPixel( DXGI_FORMAT format )
 		{
-			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	d3dShaderResourceView;
-			D3D11_TEXTURE2D_DESC								d3dTexture2DDesc;
-		public:
-			SpriteCacheContents
+			switch ( format )
+			{
+			case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+			case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			case DXGI_FORMAT_R32G32B32A32_UINT:
+			case DXGI_FORMAT_R32G32B32A32_SINT:
+				return 128;
+			case DXGI_FORMAT_R32G32B32_TYPELESS:
+			case DXGI_FORMAT_R32G32B32_FLOAT:
+			case DXGI_FORMAT_R32G32B32_UINT:
+			case DXGI_FORMAT_R32G32B32_SINT:
+				return 96;
+			case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+			case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			case DXGI_FORMAT_R16G16B16A16_UNORM:
+			case DXGI_FORMAT_R16G16B16A16_UINT:
+			case DXGI_FORMAT_R16G16B16A16_SNORM:
+			case DXGI_FORMAT_R16G16B16A16_SINT:
+			case DXGI_FORMAT_R32G32_TYPELESS:
+			case DXGI_FORMAT_R32G32_FLOAT:
+			case DXGI_FORMAT_R32G32_UINT:
+			case DXGI_FORMAT_R32G32_SINT:
+				return 64;
+			case DXGI_FORMAT_R8G8_TYPELESS:
+			case DXGI_FORMAT_R8G8_UNORM:
+			case DXGI_FORMAT_R8G8_UINT:
+			case DXGI_FORMAT_R8G8_SNORM:
+			case DXGI_FORMAT_R8G8_SINT:
+			case DXGI_FORMAT_R16_TYPELESS:
+			case DXGI_FORMAT_R16_FLOAT:
+			case DXGI_FORMAT_R16_UNORM:
+			case DXGI_FORMAT_R16_UINT:
+			case DXGI_FORMAT_R16_SNORM:
+			case DXGI_FORMAT_R16_SINT:
+			case DXGI_FORMAT_B5G6R5_UNORM:
+			case DXGI_FORMAT_B5G5R5A1_UNORM:
+			case DXGI_FORMAT_B4G4R4A4_UNORM:
+				return 16;
+			case DXGI_FORMAT_R8_TYPELESS:
+			case DXGI_FORMAT_R8_UNORM:
+			case DXGI_FORMAT_R8_UINT:
+			case DXGI_FORMAT_R8_SNORM:
+			case DXGI_FORMAT_R8_SINT:
+			case DXGI_FORMAT_A8_UNORM:
+			case DXGI_FORMAT_BC2_TYPELESS:
+			case DXGI_FORMAT_BC2_UNORM:
+			case DXGI_FORMAT_BC2_UNORM_SRGB:
+			case DXGI_FORMAT_BC3_TYPELESS:
+			case DXGI_FORMAT_BC3_UNORM:
+			case DXGI_FORMAT_BC3_UNORM_SRGB:
+			case DXGI_FORMAT_BC5_TYPELESS:
+			case DXGI_FORMAT_BC5_UNORM:
+			case DXGI_FORMAT_BC5_SNORM:
+			case DXGI_FORMAT_BC6H_TYPELESS:
+			case DXGI_FORMAT_BC6H_UF16:
+			case DXGI_FORMAT_BC6H_SF16:
+			case DXGI_FORMAT_BC7_TYPELESS:
+			case DXGI_FORMAT_BC7_UNORM:
+			case DXGI_FORMAT_BC7_UNORM_SRGB:
+				return 8;
+			case DXGI_FORMAT_BC1_TYPELESS:
+			case DXGI_FORMAT_BC1_UNORM:
+			case DXGI_FORMAT_BC1_UNORM_SRGB:
+			case DXGI_FORMAT_BC4_TYPELESS:
+			case DXGI_FORMAT_BC4_UNORM:
+			case DXGI_FORMAT_BC4_SNORM:
+				return 4;
+			default: break;
+			}
+			return 32;
+		}
+		size_t CalcTexture2DBytes( const D3D11_TEXTURE2D_DESC &desc )
+		{
+			const size_t pixelCount = scast<size_t>( desc.Width ) * desc.Height * ( ( desc.ArraySize ) ? desc.ArraySize : 1U );
+			size_t bytes = pixelCount * CalcBitsPerPixel( desc.Format ) / 8U;
+			// The full mip chain is about 4/3 of the top level.
+			if ( 1 < desc.MipLevels ) { bytes = bytes * 4U / 3U; }
+			return bytes;
+		}
+
+		using TextureCache = ConcurrentCache<std::wstring, Texture2DResource>;
+		static TextureCache spriteCache
+		{
+			ResourceBudget::MakeTracker<TextureCache>
 			(
-				ID3D11ShaderResourceView	*pShaderResourceView,
-				D3D11_TEXTURE2D_DESC		*pTexture2DDesc
-			) :
-				d3dShaderResourceView( pShaderResourceView ),
-				d3dTexture2DDesc( *pTexture2DDesc )
-			{}
+				ResourceBudget::Category::Texture,
+				[]( const Texture2DResource &texture )
+				{
+					return CalcTexture2DBytes( texture.d3dTexture2DDesc );
+				},
+				[]( const Texture2DResource &texture )->const ResourceBudget::Usage &
+				{
+					return texture.usage;
+				}
+			)
 		};
+		static ResourceBudget::CachePool<TextureCache> texturePool{ &spriteCache, ResourceBudget::Category::Texture };
 
-		static std::unordered_map<std::wstring, SpriteCacheContents> spriteCache{};
-
-		bool CreateTexture2DFromFile( ID3D11Device *d3dDevice, const std::wstring &filename, ID3D11ShaderResourceView **d3dShaderResourceView, D3D11_TEXTURE2D_DESC *d3dTexture2DDesc, bool isEnableCache )
+		bool LoadTexture2D( ID3D11Device *pDevice, const std::wstring &filename, Texture2DResource *pOutput )
 		{
 			HRESULT hr = S_OK;
 
-			if ( !Donya::IsExistFile( filename ) ) { return false; }
-			// else
-
-			auto it = spriteCache.find( filename );
-			if ( it != spriteCache.end() )
-			{
-				*d3dShaderResourceView = it->second.d3dShaderResourceView.Get();
-				( *d3dShaderResourceView )->AddRef();
-
-				*d3dTexture2DDesc = it->second.d3dTexture2DDesc;
-
-				return true;
-			}
-			// else
-
 			Microsoft::WRL::ComPtr<ID3D11Resource> d3dResource;
 			if ( filename.find( L".dds" ) != std::wstring::npos )
 			{
 				hr = CreateDDSTextureFromFile
 				(
-					d3dDevice, filename.c_str(),
+					pDevice, filename.c_str(),
 					d3dResource.GetAddressOf(),
-					d3dShaderResourceView
+					pOutput->d3dShaderResourceView.GetAddressOf()
 				);
 			}
 			else
 			{
 				hr = CreateWICTextureFromFile	// ID3D11Resource  ID3D11ShaderResourceView ̂Q쐬
 				(
-					d3dDevice, filename.c_str(),
+					pDevice, filename.c_str(),
 					d3dResource.GetAddressOf(),
-					d3dShaderResourceView
+					pOutput->d3dShaderResourceView.GetAddressOf()
 				);
 			}
 			_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateWICTextureFromFile()" ) );
+			if ( FAILED( hr ) ) { return false; }
+			// else
 
 			Microsoft::WRL::ComPtr<ID3D11Texture2D> d3dTexture2D;
 			hr = d3dResource.Get()->QueryInterface<ID3D11Texture2D>( d3dTexture2D.GetAddressOf() );
 			_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : QueryInterface()" ) );
+			if ( FAILED( hr ) ) { return false; }
+			// else
 
-			d3dTexture2D->GetDesc( d3dTexture2DDesc );	// eNX`̎擾
+			d3dTexture2D->GetDesc( &pOutput->d3dTexture2DDesc );	// eNX`̎擾
+			return true;
+		}
 
-			/*
-			if ( d3dTexture2DDesc->BindFlags & D3D11_BIND_SHADER_RESOURCE )
-			{
-				// D3D11 WARNING: Process is terminating. Using simple reporting. Please call ReportLiveObjects() at runtime for standard reporting.
-				// D3D11 WARNING: Live Producer at 0x0023E8CC, Refcount: 2. [ STATE_CREATION WARNING #0: UNKNOWN]
-				D3D11_SHADER_RESOURCE_VIEW_DESC d3dShaderResourceViewDesc{};
-				d3dShaderResourceViewDesc.Format = d3dTexture2DDesc->Format;
-				d3dShaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-				d3dShaderResourceViewDesc.Texture2D.MostDetailedMip = 0;
-				d3dShaderResourceViewDesc.Texture2D.MipLevels = d3dTexture2DDesc->MipLevels;
-
-				hr = d3dDevice->CreateShaderResourceView
-				(
-					d3dResource.Get(),
-					&d3dShaderResourceViewDesc,
-					d3dShaderResourceView
-				);
-				_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateShaderResourceView()" ) );
-			}
-			*/
+		Handle<Texture2DResource> AcquireTexture2D( ID3D11Device *pDevice, const std::wstring &filename )
+		{
+			if ( !Donya::IsExistFile( filename ) ) { return nullptr; }
+			// else
+
+			return spriteCache.FindOrCreate
+			(
+				filename,
+				[&]( Texture2DResource *pOutput )
+				{
+					return LoadTexture2D( pDevice, filename, pOutput );
+				}
+			);
+		}
 
-			if ( isEnableCache )
+		bool CreateTexture2DFromFile( ID3D11Device *d3dDevice, const std::wstring &filename, ID3D11ShaderResourceView **d3dShaderResourceView, D3D11_TEXTURE2D_DESC *d3dTexture2DDesc, bool isEnableCache )
+		{
+			if ( !Donya::IsExistFile( filename ) ) { return false; }
+			// else
+
+			auto Create = [&]( Texture2DResource *pOutput )
 			{
-				spriteCache.insert
-				(
-					std::make_pair
-					(
-						filename,
-						SpriteCacheContents
-						{
-							*d3dShaderResourceView,
-							d3dTexture2DDesc
-						}
-					)
-				);
-			}
+				return LoadTexture2D( d3dDevice, filename, pOutput );
+			};
+
+			auto pContents = FetchOrCreate( &spriteCache, filename, isEnableCache, Create );
+			if ( !pContents ) { return false; }
+			// else
+
+			// The use count can not see the raw pointer, so the eviction may release the texture that is still drawn.
+			if ( isEnableCache ) { spriteCache.Pin( filename ); }
+
+			*d3dShaderResourceView = pContents->d3dShaderResourceView.Get();
+			( *d3dShaderResourceView )->AddRef();
+
+			*d3dTexture2DDesc = pContents->d3dTexture2DDesc;
 
 			return true;
 		}
@@ -536,84 +738,77 @@ namespace Donya
 				RGBA = ( r << 24 ) | ( g << 16 ) | ( b << 8 ) | ( a << 0 );
 			}
 
-			std::wstring dummyFileName = L"UnicolorTexture:[RGBA:" + std::to_wstring( RGBA ) + L"]";
-			auto it =  spriteCache.find( dummyFileName );
-			if ( it != spriteCache.end() )
+			auto Create = [&]( Texture2DResource *pOutput )->bool
 			{
-				*pOutSRV = it->second.d3dShaderResourceView.Get();
-				( *pOutSRV )->AddRef();
-
-				return;
-			}
-			// else
+				HRESULT hr = S_OK;
+
+				D3D11_TEXTURE2D_DESC &texDesc = pOutput->d3dTexture2DDesc;
+				texDesc = {};
+				texDesc.Width				= dimensions;
+				texDesc.Height				= dimensions;
+				texDesc.MipLevels			= 1;
+				texDesc.ArraySize			= 1;
+				texDesc.Format				= DXGI_FORMAT_R8G8B8A8_UNORM;
+				texDesc.SampleDesc.Count	= 1;
+				texDesc.SampleDesc.Quality	= 0;
+				texDesc.Usage				= D3D11_USAGE_DEFAULT;
+				texDesc.BindFlags			= D3D11_BIND_SHADER_RESOURCE;
+				texDesc.CPUAccessFlags		= 0;
+				texDesc.MiscFlags			= 0;
+
+				std::unique_ptr<unsigned int[]> pSysMem = std::make_unique<unsigned int[]>( dimensions * dimensions );
+				for ( unsigned int i = 0; i < dimensions * dimensions; i++ )
+				{
+					pSysMem[i] = RGBA;
+				}
+				D3D11_SUBRESOURCE_DATA subresource{};
+				subresource.pSysMem				= pSysMem.get();
+				subresource.SysMemPitch			= sizeof( unsigned int ) * dimensions;
+				subresource.SysMemSlicePitch	= 0;
+
+				Microsoft::WRL::ComPtr<ID3D11Texture2D> iTexture2D{};
+				hr = pDevice->CreateTexture2D( &texDesc, &subresource, iTexture2D.GetAddressOf() );
+				_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateUnocolorTexture" ) );
+				if ( FAILED( hr ) ) { return false; }
+				// else
 
-			HRESULT hr = S_OK;
+				D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
+				SRVDesc.Format					= texDesc.Format;
+				SRVDesc.ViewDimension			= D3D11_SRV_DIMENSION_TEXTURE2D;
+				SRVDesc.Texture2D.MipLevels		= 1;
 
-			*pOutTexDesc = {};
-			pOutTexDesc->Width				= dimensions;
-			pOutTexDesc->Height				= dimensions;
-			pOutTexDesc->MipLevels			= 1;
-			pOutTexDesc->ArraySize			= 1;
-			pOutTexDesc->Format				= DXGI_FORMAT_R8G8B8A8_UNORM;
-			pOutTexDesc->SampleDesc.Count	= 1;
-			pOutTexDesc->SampleDesc.Quality	= 0;
-			pOutTexDesc->Usage				= D3D11_USAGE_DEFAULT;
-			pOutTexDesc->BindFlags			= D3D11_BIND_SHADER_RESOURCE;
-			pOutTexDesc->CPUAccessFlags		= 0;
-			pOutTexDesc->MiscFlags			= 0;
-
-			std::unique_ptr<unsigned int[]> pSysMem = std::make_unique<unsigned int[]>( dimensions * dimensions );
-			for ( unsigned int i = 0; i < dimensions * dimensions; i++ )
-			{
-				pSysMem[i] = RGBA;
-			}
-			D3D11_SUBRESOURCE_DATA subresource{};
-			subresource.pSysMem				= pSysMem.get();
-			subresource.SysMemPitch			= sizeof( unsigned int ) * dimensions;
-			subresource.SysMemSlicePitch	= 0;
-
-			Microsoft::WRL::ComPtr<ID3D11Texture2D> iTexture2D{};
-			hr = pDevice->CreateTexture2D( pOutTexDesc, &subresource, iTexture2D.GetAddressOf() );
-			_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateUnocolorTexture" ) );
+				hr = pDevice->CreateShaderResourceView( iTexture2D.Get(), &SRVDesc, pOutput->d3dShaderResourceView.GetAddressOf() );
+				_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateUnocolorTexture" ) );
+				return SUCCEEDED( hr );
+			};
 
+			// The dimensions is not contained to the key, because the unicolor texture looks same at any size.
+			const std::wstring dummyFileName = L"UnicolorTexture:[RGBA:" + std::to_wstring( RGBA ) + L"]";
+			auto pContents = FetchOrCreate( &spriteCache, dummyFileName, isEnableCache, Create );
+			if ( !pContents ) { return; }
+			// else
 
-			D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
-			SRVDesc.Format					= pOutTexDesc->Format;
-			SRVDesc.ViewDimension			= D3D11_SRV_DIMENSION_TEXTURE2D;
-			SRVDesc.Texture2D.MipLevels		= 1;
+			if ( isEnableCache ) { spriteCache.Pin( dummyFileName ); }
 
-			hr = pDevice->CreateShaderResourceView( iTexture2D.Get(), &SRVDesc, pOutSRV );
-			_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateUnocolorTexture" ) );
+			*pOutSRV = pContents->d3dShaderResourceView.Get();
+			( *pOutSRV )->AddRef();
 
-			if ( isEnableCache )
-			{
-				spriteCache.insert
-				(
-					std::make_pair
-					(
-						dummyFileName,
-						SpriteCacheContents
-						{
-							*pOutSRV,
-							pOutTexDesc
-						}
-					)
-				);
-			}
+			*pOutTexDesc = pContents->d3dTexture2DDesc;
 		}
 
 		void ReleaseAllTexture2DCaches()
 		{
-			spriteCache.clear();
+			spriteCache.Clear();
 		}
 
 	#pragma region Sampler
 
-		static std::unordered_map<size_t, Microsoft::WRL::ComPtr<ID3D11SamplerState>> samplerCache{};
+		static ConcurrentCache<size_t, Microsoft::WRL::ComPtr<ID3D11SamplerState>> samplerCache{};
 
 		size_t RequireSamplerDescHash( const D3D11_SAMPLER_DESC &key )
 		{
-			std::string bytes( reinterpret_cast<const char *>( &key ) );
+			// Hash the whole bytes, the desc contains zero bytes(e.g. D3D11_FILTER_MIN_MAG_MIP_POINT).
+			std::string bytes( reinterpret_cast<const char *>( &key ), sizeof( key ) );
 			return std::hash<std::string>()( bytes );
 		}
 
@@ -621,36 +816,33 @@ namespace Donya
 		{
 			size_t hash = RequireSamplerDescHash( samplerDesc );
 
-			auto it = samplerCache.find( hash );
-			if ( it != samplerCache.end() )
+			auto Create = [&]( Microsoft::WRL::ComPtr<ID3D11SamplerState> *pOutput )->bool
 			{
-				*pOutSampler = it->second;
-				return;
-			}
-			// else
-
-			HRESULT hr = S_OK;
+				HRESULT hr = pDevice->CreateSamplerState( &samplerDesc, pOutput->GetAddressOf() );
+				_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateSamplerState()" ) );
+				return SUCCEEDED( hr );
+			};
 
-			hr = pDevice->CreateSamplerState( &samplerDesc, pOutSampler->ReleaseAndGetAddressOf() );
-			_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateSamplerState()" ) );
+			auto pSampler = FetchOrCreate( &samplerCache, hash, isEnableCache, Create );
+			if ( !pSampler ) { return; }
+			// else
 
-			if ( isEnableCache )
-			{
-				samplerCache.insert( std::make_pair( hash, *pOutSampler ) );
-			}
+			*pOutSampler = *pSampler;
 		}
 
 		Microsoft::WRL::ComPtr<ID3D11SamplerState> &RequireInvalidSamplerStateComPtr()
 		{
-			static Microsoft::WRL::ComPtr<ID3D11SamplerState> pInvalidSampler;
-			if ( !pInvalidSampler )
+			// The initialization of local static is thread-safe.
+			static Microsoft::WRL::ComPtr<ID3D11SamplerState> pInvalidSampler = []()
 			{
 				D3D11_SAMPLER_DESC null{};
 				null.AddressU = null.AddressV = null.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
 
-				HRESULT hr = Donya::GetDevice()->CreateSamplerState( &null, pInvalidSampler.GetAddressOf() );
+				Microsoft::WRL::ComPtr<ID3D11SamplerState> pSampler{};
+				HRESULT hr = Donya::GetDevice()->CreateSamplerState( &null, pSampler.GetAddressOf() );
 				_ASSERT_EXPR( SUCCEEDED( hr ), _TEXT( "Failed : CreateSamplerState()" ) );
-			}
+				return pSampler;
+			}();
 
 			return pInvalidSampler;
 		}
@@ -661,39 +853,26 @@ namespace Donya
 
 		#pragma region OBJ
 
-		struct ObjFileCacheContents
+		/// <summary>
+		/// Returns the bytes of the elements on the system memory. The textures of materials are counted by the texture cache.
+		/// </summary>
+		size_t CalcObjFileBytes( const ObjFileResource &obj )
 		{
-			std::vector<DirectX::XMFLOAT3>	vertices;
-			std::vector<DirectX::XMFLOAT3>	normals;
-			std::vector<DirectX::XMFLOAT2>	texCoords;
-			std::vector<size_t>				indices;
-			std::vector<Material>			materials;
-		public:
-			ObjFileCacheContents
-			(
-				std::vector<DirectX::XMFLOAT3>	*pVertices,
-				std::vector<DirectX::XMFLOAT3>	*pNormals,
-				std::vector<DirectX::XMFLOAT2>	*pTexCoords,
-				std::vector<size_t>				*pIndices,
-				std::vector<Material>			*pMaterials
-			) :
-				vertices( *pVertices ),
-				normals( *pNormals ),
-				texCoords( *pTexCoords ),
-				indices( *pIndices ),
-				materials( *pMaterials )
-			{}
-			~ObjFileCacheContents()
-			{
-				std::vector<DirectX::XMFLOAT3>().swap( vertices );
-				std::vector<DirectX::XMFLOAT3>().swap( normals );
-				std::vector<DirectX::XMFLOAT2>().swap( texCoords );
-				std::vector<size_t>().swap( indices );
-				std::vector<Material>().swap( materials );
-			}
-		};
+			size_t bytes = sizeof( ObjFileResource );
+			bytes += obj.vertices.capacity()	* sizeof( DirectX::XMFLOAT3 );
+			bytes += obj.normals.capacity()		* sizeof( DirectX::XMFLOAT3 );
+			bytes += obj.texCoords.capacity()	* sizeof( DirectX::XMFLOAT2 );
+			bytes += obj.indices.capacity()		* sizeof( size_t );
+			bytes += obj.materials.capacity()	* sizeof( Material );
+			return bytes;
+		}
 
-		static std::unordered_map<std::wstring, ObjFileCacheContents> objFileCache;
+		using ObjFileCache = ConcurrentCache<std::wstring, ObjFileResource>;
+		static ObjFileCache objFileCache
+		{
+			ResourceBudget::MakeTracker<ObjFileCache>( ResourceBudget::Category::Mesh, &CalcObjFileBytes )
+		};
+		static ResourceBudget::CachePool<ObjFileCache> meshPool{ &objFileCache, ResourceBudget::Category::Mesh };
 
 		/// <summary>
 		/// It is storage of materials by mtl-file.
@@ -702,9 +881,10 @@ namespace Donya
 		{
 		private:
 			std::wstring mtllibName;
+			std::vector<std::wstring> mtlOrder;	// The names in order of the file.
 			std::unordered_map<std::wstring, Material> newMtls;
 		public:
-			MtlFile( ID3D11Device *pDevice, const std::wstring &mtlFileName ) : mtllibName(), newMtls()
+			MtlFile( ID3D11Device *pDevice, const std::wstring &mtlFileName ) : mtllibName(), mtlOrder(), newMtls()
 			{
 				Load( pDevice, mtlFileName );
 			}
@@ -714,8 +894,9 @@ namespace Donya
 		private:
 			void Load( ID3D11Device *pDevice, const std::wstring &mtlFileName )
 			{
-				std::wifstream ifs( mtlFileName.c_str() );
-				if ( !ifs )
+				ObjParser::MappedFile file{};
+				std::vector<ObjParser::Mtl> sources{};
+				if ( !file.Open( Donya::WideToMulti( mtlFileName ) ) || !ObjParser::ParseMtl( file.GetData(), file.GetSize(), &sources ) )
 				{
 					_ASSERT_EXPR( 0, L"Failed : load mtl flie." );
 					return;
@@ -723,177 +904,38 @@ namespace Donya
 				// else
 				mtllibName = mtlFileName;
 
-				std::wstring mtlName{};	// This name is immutable until update.
-				std::wstring lineBuf{};
-				std::wstringstream ss{};
-				for ( size_t i = 0; ifs; ++i )
+				const std::wstring mapPath = Donya::ExtractFileDirectoryFromFullPath( mtlFileName );
+				for ( const auto &source : sources )
 				{
-					std::getline( ifs, lineBuf );
-
-					if ( IsContainStr( lineBuf, L"#" ) )
-					{
-						continue;
-					}
-					// else
-					if ( IsContainStr( lineBuf, L"\n" ) )
-					{
-						continue;
-					}
-					// else
-					if ( IsContainStr( lineBuf, L"newmtl" ) )
-					{
-						#pragma region newmtl
-
-						SkipUntilNextDelim( &lineBuf, &ss );
-						lineBuf.erase( lineBuf.begin() );	// erase space.
-
-						mtlName = lineBuf;
-						newMtls.insert( std::make_pair( mtlName, Material{} ) );
-
-						#pragma endregion
-						continue;
-					}
-					// else
-					if ( IsContainStr( lineBuf, L"map" ) )
+					const std::wstring mtlName = Donya::MultiToWide( source.name );
+					auto result = newMtls.insert( std::make_pair( mtlName, Material{} ) );
+					if ( result.second ) { mtlOrder.emplace_back( mtlName ); }
+
+					Material &mtl	= result.first->second;
+					mtl.illuminate	= source.illuminate;
+					mtl.shininess	= source.shininess;
+					for ( int i = 0; i < 3; ++i )
 					{
-						#pragma region map_
-
-						if ( IsContainStr( lineBuf, L"map_Kd" ) )
-						{
-							#pragma region diffuseMap
-
-							SkipUntilNextDelim( &lineBuf, &ss );
-							lineBuf.erase( lineBuf.begin() );	// erase space.
-							ss.ignore();
-
-							decltype( newMtls )::iterator it = newMtls.find( mtlName );
-							if ( it != newMtls.end() )
-							{
-								std::wstring mapPath = Donya::ExtractFileDirectoryFromFullPath( mtlFileName );
-								std::wstring mapName; ss >> mapName;
-								{
-									if ( IsContainStr( mapName, L"-" ) )
-									{
-										#pragma region options
-
-										// TODO:Apply a options.
-
-										ss.ignore();
-										ss >> mapName;
-
-										#pragma endregion
-									}
-								}
-
-								it->second.diffuseMap.mapName = mapPath + mapName;
-
-								D3D11_SAMPLER_DESC samplerDesc{};
-								samplerDesc.Filter			= D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-								samplerDesc.AddressU		= D3D11_TEXTURE_ADDRESS_WRAP;
-								samplerDesc.AddressV		= D3D11_TEXTURE_ADDRESS_WRAP;
-								samplerDesc.AddressW		= D3D11_TEXTURE_ADDRESS_WRAP;
-								samplerDesc.ComparisonFunc	= D3D11_COMPARISON_NEVER;
-								samplerDesc.MinLOD			= 0;
-								samplerDesc.MaxLOD			= D3D11_FLOAT32_MAX;
-
-								it->second.CreateDiffuseMap( pDevice, samplerDesc );
-							}
-
-							#pragma endregion
-							continue;
-						}
-						// else
-
-						#pragma endregion
-						continue;
+						mtl.ambient[i]	= source.ambient[i];
+						mtl.diffuse[i]	= source.diffuse[i];
+						mtl.specular[i]	= source.specular[i];
 					}
-					// else
-					if ( IsContainStr( lineBuf, L"illum" ) )
-					{
-						#pragma region illum
 
-						SkipUntilNextDelim( &lineBuf, &ss );
-
-						decltype( newMtls )::iterator it = newMtls.find( mtlName );
-						if ( it != newMtls.end() )
-						{
-							ss >> it->second.illuminate;
-						}
-
-						#pragma endregion
-						continue;
-					}
+					if ( source.diffuseMapName.empty() ) { continue; }
 					// else
-					if ( IsContainStr( lineBuf, L"Ns" ) )
-					{
-						#pragma region Ns
 
-						SkipUntilNextDelim( &lineBuf, &ss );
+					mtl.diffuseMap.mapName = mapPath + Donya::MultiToWide( source.diffuseMapName );
 
-						decltype( newMtls )::iterator it = newMtls.find( mtlName );
-						if ( it != newMtls.end() )
-						{
-							ss >> it->second.shininess;
-						}
+					D3D11_SAMPLER_DESC samplerDesc{};
+					samplerDesc.Filter			= D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+					samplerDesc.AddressU		= D3D11_TEXTURE_ADDRESS_WRAP;
+					samplerDesc.AddressV		= D3D11_TEXTURE_ADDRESS_WRAP;
+					samplerDesc.AddressW		= D3D11_TEXTURE_ADDRESS_WRAP;
+					samplerDesc.ComparisonFunc	= D3D11_COMPARISON_NEVER;
+					samplerDesc.MinLOD			= 0;
+					samplerDesc.MaxLOD			= D3D11_FLOAT32_MAX;
 
-						#pragma endregion
-						continue;
-					}
-					// else
-					if ( IsContainStr( lineBuf, L"Ka" ) )
-					{
-						#pragma region Ka
-
-						SkipUntilNextDelim( &lineBuf, &ss );
-
-						decltype( newMtls )::iterator it = newMtls.find( mtlName );
-						if ( it != newMtls.end() )
-						{
-							ss >> it->second.ambient[0]; ss.ignore();
-							ss >> it->second.ambient[1]; ss.ignore();
-							ss >> it->second.ambient[2]; ss.ignore();
-						}
-
-						#pragma endregion
-						continue;
-					}
-					// else
-					if ( IsContainStr( lineBuf, L"Kd" ) )
-					{
-						#pragma region Kd
-
-						SkipUntilNextDelim( &lineBuf, &ss );
-
-						decltype( newMtls )::iterator it = newMtls.find( mtlName );
-						if ( it != newMtls.end() )
-						{
-							ss >> it->second.diffuse[0]; ss.ignore();
-							ss >> it->second.diffuse[1]; ss.ignore();
-							ss >> it->second.diffuse[2]; ss.ignore();
-						}
-
-						#pragma endregion
-						continue;
-					}
-					// else
-					if ( IsContainStr( lineBuf, L"Ks" ) )
-					{
-						#pragma region Ks
-
-						SkipUntilNextDelim( &lineBuf, &ss );
-
-						decltype( newMtls )::iterator it = newMtls.find( mtlName );
-						if ( it != newMtls.end() )
-						{
-							ss >> it->second.specular[0]; ss.ignore();
-							ss >> it->second.specular[1]; ss.ignore();
-							ss >> it->second.specular[2]; ss.ignore();
-						}
-
-						#pragma endregion
-						continue;
-					}
-					// else
+					mtl.CreateDiffuseMap( pDevice, samplerDesc );
 				}
 			}
 		public:
@@ -903,7 +945,7 @@ namespace Donya
 				decltype( newMtls )::iterator it = newMtls.find( useMtlName );
 				if ( it == newMtls.end() )
 				{
-					materialPointer = nullptr;
+					*materialPointer = nullptr;
 					return false;
 				}
 				// else
@@ -913,312 +955,144 @@ namespace Donya
 
 			void CopyAllMaterialsToVector( std::vector<Material> *pMaterials ) const
 			{
-				for ( const auto &it : newMtls )
+				for ( const auto &mtlName : mtlOrder )
 				{
-					pMaterials->push_back( it.second );
+					pMaterials->push_back( newMtls.at( mtlName ) );
 				}
 			}
 		};
 
-		// TODO:There are many unsupported extensions yet.
-		bool LoadObjFile( ID3D11Device *pDevice, const std::wstring &objFileName, std::vector<DirectX::XMFLOAT3> *pVertices, std::vector<DirectX::XMFLOAT3> *pNormals, std::vector<XMFLOAT2> *pTexCoords, std::vector<size_t> *pIndices, std::vector<Material> *pMaterials, bool *hasLoadedMtl, bool isEnableCache )
+		/// <summary>
+		/// Parse the obj-file and the mtl-files, then store all elements to "pOutput".
+		/// </summary>
+		bool LoadObjContents( ID3D11Device *pDevice, const std::wstring &objFileName, ObjFileResource *pOutput )
 		{
-			if ( !Donya::IsExistFile( objFileName ) ) { return false; }
-			// else
-
-			// check objFileName already has cached ?
+			ObjParser::Obj obj{};
 			{
-				decltype( objFileCache )::iterator it = objFileCache.find( objFileName );
-				if ( it != objFileCache.end() )
+				ObjParser::MappedFile file{};
+				if ( !file.Open( Donya::WideToMulti( objFileName ) ) )
 				{
-					if ( pVertices  ) { *pVertices  = it->second.vertices;  }
-					if ( pNormals   ) { *pNormals   = it->second.normals;   }
-					if ( pTexCoords ) { *pNormals   = it->second.normals;   }
-					if ( pIndices   ) { *pIndices   = it->second.indices;   }
-					if ( pMaterials ) { *pMaterials = it->second.materials; }
+					_ASSERT_EXPR( 0, L"Failed : load obj flie." );
+					return false;
+				}
+				// else
 
-					return true;
+				std::string errorMessage{};
+				if ( !ObjParser::ParseObj( file.GetData(), file.GetSize(), &obj, /* dedupeVertices = */ true, &errorMessage ) )
+				{
+					_ASSERT_EXPR( 0, Donya::MultiToWide( errorMessage ).c_str() );
+					return false;
 				}
 			}
-			// else
 
-			if ( pVertices == nullptr ) { return false; }
-			// else
-
-			std::wifstream ifs( objFileName.c_str() );
-			if ( !ifs )
+			const size_t vertexCount = obj.positions.size();
+			pOutput->vertices.resize( vertexCount );
+			pOutput->normals.resize( vertexCount );
+			pOutput->texCoords.resize( vertexCount );
+			for ( size_t i = 0; i < vertexCount; ++i )
 			{
-				_ASSERT_EXPR( 0, L"Failed : load obj flie." );
-				return false;
+				const auto &position = obj.positions[i];
+				const auto &normal   = obj.normals[i];
+				const auto &texCoord = obj.texCoords[i];
+				pOutput->vertices[i]  = XMFLOAT3{ position.x, position.y, position.z };
+				pOutput->normals[i]   = XMFLOAT3{ normal.x, normal.y, normal.z };
+				pOutput->texCoords[i] = XMFLOAT2{ texCoord.x, texCoord.y };
 			}
-			// else
+			pOutput->indices.swap( obj.indices );
 
-			size_t lastVertexIndex   = 0;	// zero-based number.
-			size_t lastNormalIndex   = 0;	// zero-based number.
-			size_t lastTexCoordIndex = 0;	// zero-based number.
-			std::wstring command{};
-			std::wstringstream ss{};
-			std::vector<DirectX::XMFLOAT3> tmpPositions{};
-			std::vector<DirectX::XMFLOAT3> tmpNormals{};
-			std::vector<DirectX::XMFLOAT2> tmpTexCoords{};
-
-			size_t		materialCount = 0;	// zero-based number.
-			Material	*usemtlTarget = nullptr;
-			std::unique_ptr<MtlFile> pMtllib{};
-
-			for ( size_t i = 0; ifs; ++i )	// i is column num.
+			std::vector<std::unique_ptr<MtlFile>> mtllibs{};
+			const std::wstring mtlPath = Donya::ExtractFileDirectoryFromFullPath( objFileName );
+			for ( const auto &mtlName : obj.mtllibNames )
 			{
-				std::getline( ifs, command );
-
-				if ( IsContainStr( command, L"#" ) )
-				{
-					// comment.
-					continue;
-				}
-				// else
-				if ( IsContainStr( command, L"\n" ) )
-				{
-					// linefeed.
-					continue;
-				}
-				// else
-				if ( IsContainStr( command, L"mtllib" ) )
-				{
-					#pragma region mtllib
-
-					SkipUntilNextDelim( &command, &ss );
-
-					std::wstring mtlPath = Donya::ExtractFileDirectoryFromFullPath( objFileName );
-
-					std::wstring mtlName; ss >> mtlName;
-
-					pMtllib = std::make_unique<MtlFile>( pDevice, mtlPath + mtlName );
+				mtllibs.emplace_back( std::make_unique<MtlFile>( pDevice, mtlPath + Donya::MultiToWide( mtlName ) ) );
+			}
 
-					#pragma endregion
-					continue;
-				}
-				// else
-				if ( IsContainStr( command, L"g " ) )
-				{
-					#pragma region Group
-					#pragma endregion
-					continue;
-				}
-				// else
-				if ( IsContainStr( command, L"s " ) )
-				{
-					#pragma region Smooth
-					#pragma endregion
-					continue;
-				}
+			// The parser gathers the faces of a material into one range.
+			for ( const auto &subset : obj.subsets )
+			{
+				if ( subset.mtlName.empty() ) { continue; }
 				// else
-				if ( IsContainStr( command, L"v " ) )
-				{
-					#pragma region Vertex
-
-					SkipUntilNextDelim( &command, &ss );
-
-					float x, y, z;
-					ss >> x;
-					ss >> y;
-					ss >> z;
-
-					tmpPositions.push_back( { x, y, z } );
 
-					lastVertexIndex++;
-
-					#pragma endregion
-					continue;
-				}
-				// else
-				if ( IsContainStr( command, L"vt " ) )
+				const std::wstring mtlName = Donya::MultiToWide( subset.mtlName );
+				for ( auto &pMtllib : mtllibs )
 				{
-					#pragma region TexCoord
-					if ( pTexCoords == nullptr ) { continue; }
+					Material *usemtlTarget = nullptr;
+					if ( !pMtllib->Extract( mtlName, &usemtlTarget ) ) { continue; }
 					// else
 
-					SkipUntilNextDelim( &command, &ss );
-
-					float u, v;
-					ss >> u;
-					ss >> v;
-					
-					// tmpTexCoords.push_back( { u, v } );	// If obj-file is LH
-					tmpTexCoords.push_back( { u, -v } );	// If obj-file is RH
-
-					lastTexCoordIndex++;
-
-					#pragma endregion
-					continue;
+					usemtlTarget->indexStart = subset.indexStart;
+					usemtlTarget->indexCount = subset.indexCount;
+					break;
 				}
-				// else
-				if ( IsContainStr( command, L"vn " ) )
-				{
-					#pragma region Normal
-					if ( pNormals == nullptr ) { continue; }
-					// else
-
-					SkipUntilNextDelim( &command, &ss );
+			}
 
-					float x, y, z;
-					ss >> x;
-					ss >> y;
-					ss >> z;
+			for ( const auto &pMtllib : mtllibs )
+			{
+				pMtllib->CopyAllMaterialsToVector( &pOutput->materials );
+			}
+			pOutput->hasLoadedMtl = !mtllibs.empty();
 
-					tmpNormals.push_back( { x, y, z } );
+			return true;
+		}
 
-					lastNormalIndex++;
+		// TODO:There are many unsupported extensions yet.
+		bool LoadObjFile( ID3D11Device *pDevice, const std::wstring &objFileName, std::vector<DirectX::XMFLOAT3> *pVertices, std::vector<DirectX::XMFLOAT3> *pNormals, std::vector<XMFLOAT2> *pTexCoords, std::vector<size_t> *pIndices, std::vector<Material> *pMaterials, bool *hasLoadedMtl, bool isEnableCache )
+		{
+			if ( !Donya::IsExistFile( objFileName ) ) { return false; }
+			// else
 
-					#pragma endregion
-					continue;
-				}
+			if ( !isEnableCache )
+			{
+				if ( pVertices == nullptr ) { return false; }
 				// else
-				if ( IsContainStr( command, L"usemtl " ) )
-				{
-					#pragma region usemtl
-
-					SkipUntilNextDelim( &command, &ss );
-					command.erase( command.begin() );	// erase space.
-					ss.ignore();
-
-					if ( usemtlTarget != nullptr )
-					{
-						usemtlTarget->indexCount = materialCount;
 
-						usemtlTarget  = nullptr;
-						materialCount = 0;
-					}
-
-					std::wstring materialName; ss >> materialName;
-					pMtllib->Extract( materialName, &usemtlTarget );
-
-					if ( usemtlTarget != nullptr )
-					{
-						usemtlTarget->indexStart = pIndices->size();
-					}
-
-					#pragma endregion
-					continue;
-				}
+				ObjFileResource loaded{};
+				if ( !LoadObjContents( pDevice, objFileName, &loaded ) ) { return false; }
 				// else
-				if ( IsContainStr( command, L"f " ) )
-				{
-					#pragma region Face Indices
-
-					SkipUntilNextDelim( &command, &ss );
-
-					for ( ; !ss.eof(); )
-					{
-						int index = NULL;
-
-						// Vertex
-						{
-							ss >> index;
-							if ( index < 0 )
-							{
-								index++; // convert to minus-one-based.
-								index = lastVertexIndex + index;
-							}
-
-							if ( pIndices->empty() )
-							{
-								pIndices->push_back( 0 );
-							}
-							else
-							{
-								pIndices->push_back( pIndices->back() + 1 );
-							}
-							materialCount++;
-
-							pVertices->push_back( tmpPositions[index - 1] ); // convert one-based -> zero-based.
-						}
-
-						if ( ss.peek() != L'/' ) { ss.ignore( 1024, L' '  ); continue; }
-						// else
-						ss.ignore();
-
-						// TexCoord
-						{
-							ss >> index;
-							if ( index < 0 )
-							{
-								index++; // convert to minus-one-based.
-								index = lastTexCoordIndex + index;
-							}
-
-							if ( tmpTexCoords.size() < scast<size_t>( index ) )
-							{
-								_ASSERT_EXPR( 0, L"obj file error! : not found specified normal-index until specify position." );
-								return false;
-							}
-
-							pTexCoords->push_back( tmpTexCoords[index - 1] ); // convert one-based -> zero-based.
-						}
-
-						if ( ss.peek() != L'/' ) { ss.ignore( 1024, L' ' ); continue; }
-						// else
-						ss.ignore();
-
-						// Normal
-						{
-							ss >> index;
-							if ( index < 0 )
-							{
-								index++; // convert to minus-one-based.
-								index = lastNormalIndex + index;
-							}
-
-							if ( tmpNormals.size() < scast<size_t>( index ) )
-							{
-								_ASSERT_EXPR( 0, L"obj file error! : not found specified normal-index until specify position." );
-								return false;
-							}
-
-							pNormals->push_back( tmpNormals[index - 1] ); // convert one-based -> zero-based.
-						}
-
-						ss.ignore();
-					}
 
-					#pragma endregion
-					continue;
-				}
-				// else
+				// The loaded elements are not shared, so move these.
+				pVertices->swap( loaded.vertices );
+				if ( pNormals     ) { pNormals->swap( loaded.normals );     }
+				if ( pTexCoords   ) { pTexCoords->swap( loaded.texCoords ); }
+				if ( pIndices     ) { pIndices->swap( loaded.indices );     }
+				if ( pMaterials   ) { pMaterials->swap( loaded.materials ); }
+				if ( hasLoadedMtl ) { *hasLoadedMtl = loaded.hasLoadedMtl;  }
+				return true;
 			}
+			// else
 
-			if ( usemtlTarget != nullptr )
-			{
-				usemtlTarget->indexCount = materialCount;
-
-				usemtlTarget  = nullptr;
-				materialCount = 0;
-			}
+			auto pContents = AcquireObjFile( pDevice, objFileName );
+			if ( !pContents ) { return false; }
+			// else
 
-			if ( pMaterials != nullptr && pMtllib != nullptr )
-			{
-				pMtllib->CopyAllMaterialsToVector( pMaterials );
-			}
+			if ( pVertices    ) { *pVertices    = pContents->vertices;     }
+			if ( pNormals     ) { *pNormals     = pContents->normals;      }
+			if ( pTexCoords   ) { *pTexCoords   = pContents->texCoords;    }
+			if ( pIndices     ) { *pIndices     = pContents->indices;      }
+			if ( pMaterials   ) { *pMaterials   = pContents->materials;    }
+			if ( hasLoadedMtl ) { *hasLoadedMtl = pContents->hasLoadedMtl; }
 
-			ifs.close();
+			return true;
+		}
 
-			if ( isEnableCache )
-			{
-				objFileCache.insert
-				(
-					std::make_pair
-					(
-						objFileName,
-						ObjFileCacheContents{ pVertices, pNormals, pTexCoords, pIndices, pMaterials }
-					)
-				);
-			}
+		Handle<ObjFileResource> AcquireObjFile( ID3D11Device *pDevice, const std::wstring &objFileName )
+		{
+			if ( !Donya::IsExistFile( objFileName ) ) { return nullptr; }
+			// else
 
-			return true;
+			return objFileCache.FindOrCreate
+			(
+				objFileName,
+				[&]( ObjFileResource *pOutput )
+				{
+					return LoadObjContents( pDevice, objFileName, pOutput );
+				}
+			);
 		}
 
 		void ReleaseAllObjFileCaches()
 		{
-			objFileCache.clear();
+			objFileCache.Clear();
 		}
 
 		#pragma endregion
@@ -1229,6 +1103,7 @@ namespace Donya
 
 		void ReleaseAllCachedResources()
 		{
+			SaveShaderBinaryCache();
 			ReleaseAllVertexShaderCaches();
 			ReleaseAllPixelShaderCaches();
 			ReleaseAllTexture2DCaches();
@@ -1,15 +1,30 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 #include <D3D11.h>
 #include <DirectXMath.h>
 #include <wrl.h>
 
+#include "ResourceBudget.h"	// Use ResourceBudget::Usage.
+
 namespace Donya
 {
+	/// <summary>
+	/// The creation functions are thread-safe, so the loading threads can share the caches.<para></para>
+	/// If a file is requested while another thread is creating it, the requester waits for that result instead of creating it twice.<para></para>
+	/// The cached textures and obj-files are counted by Donya::ResourceBudget, and the ones that are not held by a Handle may be evicted when over the budget.<para></para>
+	/// The textures that are handed out by the raw pointer(e.g. CreateTexture2DFromFile()) are pinned to the cache, these are never evicted.
+	/// </summary>
 	namespace Resource
 	{
+		/// <summary>
+		/// The shared resource of the cache. The resource is not evicted while a handle is held.
+		/// </summary>
+		template<typename T>
+		using Handle = std::shared_ptr<const T>;
+
 		#pragma region Shader
 
 		/// <summary>
@@ -80,15 +95,61 @@ namespace Donya
 
 		void ReleaseAllPixelShaderCaches();
 
+		/// <summary>
+		/// The byte-codes that are compiled from the embedded source codes are persisted to a file.<para></para>
+		/// Each byte-code is keyed by the hash of [source code, entry point, target profile, compile flags, defines], so the changed shader is compiled again.<para></para>
+		/// The file is read at the first compilation, then the cached byte-code is used instead of D3DCompile().<para></para>
+		/// The whole file is discarded if the version header does not match(e.g. the compiler was updated).<para></para>
+		/// Default path is "./Data/ShaderCache.bin". Please set before the first compilation.
+		/// </summary>
+		void SetShaderBinaryCachePath( const std::string &filePath );
+		/// <summary>
+		/// Write the byte-codes to the file if a new one was added. ReleaseAllCachedResources() calls this.<para></para>
+		/// Returns false if failed to write.
+		/// </summary>
+		bool SaveShaderBinaryCache();
+
+		struct ShaderCacheStats
+		{
+			unsigned int	compiledCount{};	// The count of D3DCompile() calls.
+			unsigned int	cacheHitCount{};	// The count of the byte-codes that were taken from the file cache.
+			unsigned int	invalidatedCount{};	// The count of the cached byte-codes that could not create the shader, these were compiled again.
+			double			compileSeconds{};	// The total time of D3DCompile().
+			double			fileReadSeconds{};	// The time of reading the cache file.
+		};
+		/// <summary>
+		/// Returns the accumulated stats from the start of application. Use for measuring the startup.
+		/// </summary>
+		ShaderCacheStats GetShaderCacheStats();
+
 		#pragma endregion
 
 		#pragma region Texture
 
+		struct Texture2DResource
+		{
+			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	d3dShaderResourceView;
+			D3D11_TEXTURE2D_DESC								d3dTexture2DDesc{};
+			ResourceBudget::Usage								usage{};	// Please Touch() at the drawing.
+		};
+
+		/// <summary>
+		/// Returns the cached texture, or load it if it is not cached. Returns nullptr if failed.<para></para>
+		/// The texture is not evicted while the handle is held. Please call usage.Touch() at the drawing, then the eviction orders by the last drawing.
+		/// </summary>
+		Handle<Texture2DResource> AcquireTexture2D( ID3D11Device *pDevice, const std::wstring &filename );
+
+		/// <summary>
+		/// Returns the estimated bytes of the texture on the video memory.
+		/// </summary>
+		size_t CalcTexture2DBytes( const D3D11_TEXTURE2D_DESC &desc );
+
 		/// <summary>
 		/// If file path is invalid, returns false.<para></para>
 		/// I doing; CreateWICTextureFromFile(), QueryInterface(),<para></para>
 		/// ID3D11Texture2D::GetDesc().<para></para>
-		/// These arguments must be not null.
+		/// These arguments must be not null.<para></para>
+		/// If the cache is enabled, the texture is pinned to the cache and never evicted. Please use AcquireTexture2D() for the evictable texture.
 		/// </summary>
 		bool CreateTexture2DFromFile
 		(
@@ -185,11 +246,29 @@ namespace Donya
 			}
 		};
 
+		struct ObjFileResource
+		{
+			std::vector<DirectX::XMFLOAT3>	vertices;
+			std::vector<DirectX::XMFLOAT3>	normals;
+			std::vector<DirectX::XMFLOAT2>	texCoords;
+			std::vector<size_t>				indices;
+			std::vector<Material>			materials;
+			bool							hasLoadedMtl = false;
+		};
+
+		/// <summary>
+		/// Returns the cached obj-file, or load it if it is not cached. Returns nullptr if failed.<para></para>
+		/// The elements are not copied, and the obj-file is not evicted while the handle is held.
+		/// </summary>
+		Handle<ObjFileResource> AcquireObjFile( ID3D11Device *pDevice, const std::wstring &objFileName );
+
 		/// <summary>
 		/// If file path is invalid, returns false.<para></para>
 		/// If setting nullptr to argument, skip that item.<para></para>
 		/// these pointers: ID3D11ShaderResourceView, ID3D11SamplerState, D3D11_TEXTURE2D_DESC, bool *, are can setting nullptr.<para></para>
 		/// that bool pointer indicate has loaded material or texture.<para></para>
+		/// The vertices, normals and texCoords are parallel arrays. The same vertex is shared by the indices, and the polygons are divided to triangles.<para></para>
+		/// The faces of a material are gathered to one range of indices.
 		/// </summary>
 		bool LoadObjFile
 		(
@@ -214,6 +293,7 @@ namespace Donya
 
 		/// <summary>
 		/// I doing:<para></para>
+		/// SaveShaderBinaryCache,<para></para>
 		/// ReleaseAllVertexShaderCaches,<para></para>
 		/// ReleaseAllPixelShaderCaches,<para></para>
 		/// ReleaseAllTexture2DCaches<para></para>
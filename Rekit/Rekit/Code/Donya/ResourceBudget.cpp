@@ -0,0 +1,251 @@
+#include "ResourceBudget.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "Constant.h"	// Use scast macro.
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	namespace ResourceBudget
+	{
+		struct Counter
+		{
+			std::atomic<long long>			residentBytes{ 0 };
+			std::atomic<long long>			residentCount{ 0 };
+			std::atomic<unsigned long long>	evictedBytes{ 0U };
+			std::atomic<unsigned long long>	evictedCount{ 0U };
+		};
+
+		// Static storage is zero-initialized before any dynamic initialization, so the caches can report in their constructors.
+		static std::array<Counter, CATEGORY_COUNT>	counters{};
+		static std::atomic<size_t>					budgetBytes{ DEFAULT_BUDGET_BYTES };
+		static std::atomic<unsigned long long>		currentTick{ 1U };
+		static std::atomic<unsigned int>			graceTicks{ DEFAULT_GRACE_TICKS };
+
+		// These are function-local statics, because the pools may be registered and unregistered at the initialization and the termination of other files.
+		std::vector<Pool *> &GetPools()
+		{
+			static std::vector<Pool *> pools{};
+			return pools;
+		}
+		std::mutex &GetPoolMutex()
+		{
+			static std::mutex poolMutex{};
+			return poolMutex;
+		}
+
+		const char *GetCategoryName( Category category )
+		{
+			switch ( category )
+			{
+			case Category::Texture:	return "Texture";
+			case Category::Mesh:	return "Mesh";
+			case Category::Sprite:	return "Sprite";
+			default: break;
+			}
+			return "Unknown";
+		}
+
+		void SetBudget( size_t bytes )
+		{
+			budgetBytes.store( bytes );
+		}
+		size_t GetBudget()
+		{
+			return budgetBytes.load();
+		}
+
+		unsigned long long GetTick()
+		{
+			return currentTick.load( std::memory_order_relaxed );
+		}
+
+		void SetGraceTicks( unsigned int tickCount )
+		{
+			graceTicks.store( std::max( 1U, tickCount ) );
+		}
+		unsigned int GetGraceTicks()
+		{
+			return graceTicks.load();
+		}
+
+		void AddResident( Category category, long long bytes, int count )
+		{
+			const size_t index = scast<size_t>( category );
+			if ( CATEGORY_COUNT <= index ) { return; }
+			// else
+
+			counters[index].residentBytes.fetch_add( bytes );
+			counters[index].residentCount.fetch_add( count );
+		}
+
+		void RegisterPool( Pool *pPool )
+		{
+			std::lock_guard<std::mutex> lock( GetPoolMutex() );
+			GetPools().emplace_back( pPool );
+		}
+		void UnregisterPool( Pool *pPool )
+		{
+			std::lock_guard<std::mutex> lock( GetPoolMutex() );
+			auto &pools = GetPools();
+			pools.erase( std::remove( pools.begin(), pools.end(), pPool ), pools.end() );
+		}
+
+		long long CalcTotalBytes()
+		{
+			long long sum = 0;
+			for ( const auto &counter : counters )
+			{
+				sum += counter.residentBytes.load();
+			}
+			return sum;
+		}
+
+		void Update()
+		{
+			currentTick.fetch_add( 1U );
+
+			const size_t budget = GetBudget();
+			if ( !budget ) { return; }
+			// else
+			if ( CalcTotalBytes() <= scast<long long>( budget ) ) { return; }
+			// else
+
+			Trim( budget );
+		}
+
+		size_t Trim( size_t targetBytes )
+		{
+			long long total = CalcTotalBytes();
+			if ( total <= scast<long long>( targetBytes ) ) { return 0; }
+			// else
+
+			const unsigned long long now	= GetTick();
+			const unsigned long long grace	= GetGraceTicks();
+
+			std::lock_guard<std::mutex> lock( GetPoolMutex() );
+
+			std::vector<Pool::Candidate> candidates{};
+			for ( Pool *pPool : GetPools() )
+			{
+				const size_t begin = candidates.size();
+				pPool->CollectUnused( &candidates );
+				for ( size_t i = begin; i < candidates.size(); ++i )
+				{
+					candidates[i].pPool = pPool;
+				}
+			}
+
+			// The resources that are used recently may be used again soon.
+			// Update() advances the tick before the trimming, so the resources of the last frame are protected by the grace too.
+			candidates.erase
+			(
+				std::remove_if
+				(
+					candidates.begin(), candidates.end(),
+					[&now, &grace]( const Pool::Candidate &candidate ) { return now < candidate.lastUsedTick + grace; }
+				),
+				candidates.end()
+			);
+			std::sort
+			(
+				candidates.begin(), candidates.end(),
+				[]( const Pool::Candidate &lhs, const Pool::Candidate &rhs )
+				{
+					// Evict the larger one first if the ticks are same, for reducing the count of evictions.
+					return ( lhs.lastUsedTick != rhs.lastUsedTick ) ? lhs.lastUsedTick < rhs.lastUsedTick : rhs.byteSize < lhs.byteSize;
+				}
+			);
+
+			size_t evictedSum = 0;
+			for ( const auto &candidate : candidates )
+			{
+				if ( total <= scast<long long>( targetBytes ) ) { break; }
+				// else
+
+				const size_t evicted = candidate.pPool->Evict( candidate.id );
+				if ( !evicted ) { continue; }
+				// else
+
+				Counter &counter = counters[scast<size_t>( candidate.pPool->GetCategory() )];
+				counter.evictedBytes.fetch_add( evicted );
+				counter.evictedCount.fetch_add( 1U );
+
+				total		-= scast<long long>( evicted );
+				evictedSum	+= evicted;
+			}
+
+			return evictedSum;
+		}
+
+		Report MakeReport()
+		{
+			Report report{};
+			for ( size_t i = 0; i < CATEGORY_COUNT; ++i )
+			{
+				auto &dest = report.categories[i];
+				dest.residentBytes	= counters[i].residentBytes.load();
+				dest.residentCount	= counters[i].residentCount.load();
+				dest.evictedBytes	= counters[i].evictedBytes.load();
+				dest.evictedCount	= counters[i].evictedCount.load();
+
+				report.totalBytes += dest.residentBytes;
+			}
+			report.budgetBytes = GetBudget();
+			return report;
+		}
+
+	#if USE_IMGUI
+
+		void ShowImGuiNode( const char *nodeCaption )
+		{
+			if ( !ImGui::TreeNode( nodeCaption ) ) { return; }
+			// else
+
+			constexpr double TO_MB = 1.0 / ( 1024.0 * 1024.0 );
+
+			const Report report = MakeReport();
+			ImGui::Text( u8"Total[%.2f MB] / Budget[%.2f MB]", report.totalBytes * TO_MB, report.budgetBytes * TO_MB );
+
+			int budgetMB = scast<int>( report.budgetBytes / ( 1024U * 1024U ) );
+			if ( ImGui::DragInt( u8"Budget(MB), zero is unlimited", &budgetMB, 1.0f, 0, 4096 ) )
+			{
+				SetBudget( scast<size_t>( budgetMB ) * 1024U * 1024U );
+			}
+
+			int grace = scast<int>( GetGraceTicks() );
+			if ( ImGui::DragInt( u8"Grace ticks", &grace, 1.0f, 1, 600 ) )
+			{
+				SetGraceTicks( scast<unsigned int>( grace ) );
+			}
+
+			ImGui::Separator();
+
+			for ( size_t i = 0; i < CATEGORY_COUNT; ++i )
+			{
+				const auto &category = report.categories[i];
+				ImGui::Text
+				(
+					u8"[%s] Resident[%d] %.2f MB, Evicted[%llu] %.2f MB",
+					GetCategoryName( scast<Category>( i ) ),
+					scast<int>( category.residentCount ), category.residentBytes * TO_MB,
+					category.evictedCount, category.evictedBytes * TO_MB
+				);
+			}
+
+			if ( ImGui::Button( u8"Evict all unused" ) )
+			{
+				Trim( 0U );
+			}
+
+			ImGui::TreePop();
+		}
+
+	#endif // USE_IMGUI
+	}
+}
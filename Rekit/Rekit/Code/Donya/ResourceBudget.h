@@ -0,0 +1,228 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>	// Use size_t.
+#include <vector>
+
+#include "ConcurrentCache.h"
+#include "UseImgui.h"	// Use USE_IMGUI macro.
+
+namespace Donya
+{
+	/// <summary>
+	/// Count the bytes of the cached resources per category, and evict the least recently used resources while the total is over the budget.<para></para>
+	/// Only the resources that are not held by the others are evicted, and the evicted one is loaded again at the next request.
+	/// The bytes are the ones that the caches hold, so the resource that is still used by the others after the eviction is not counted.
+	/// </summary>
+	namespace ResourceBudget
+	{
+		enum class Category
+		{
+			Texture = 0,	// Donya::Resource's textures.
+			Mesh,			// Donya::Resource's obj-files.
+			Sprite,			// Donya::Sprite's sprites and atlases.
+
+			CategoryCount
+		};
+		constexpr size_t CATEGORY_COUNT = static_cast<size_t>( Category::CategoryCount );
+
+		/// <summary>
+		/// Returns "Unknown" if the category is invalid.
+		/// </summary>
+		const char *GetCategoryName( Category category );
+
+		/// <summary>
+		/// The default budget is 256 MB.
+		/// </summary>
+		constexpr size_t DEFAULT_BUDGET_BYTES = 256U * 1024U * 1024U;
+		/// <summary>
+		/// If set zero, nothing is evicted.
+		/// </summary>
+		void SetBudget( size_t bytes );
+		size_t GetBudget();
+
+		/// <summary>
+		/// Returns the current time of the LRU. It is advanced by Update().
+		/// </summary>
+		unsigned long long GetTick();
+
+		/// <summary>
+		/// The default grace keeps the resources that were used at the current or the last two ticks.
+		/// </summary>
+		constexpr unsigned int DEFAULT_GRACE_TICKS = 3U;
+		/// <summary>
+		/// The resources that were used within the last "tickCount" ticks(contains the current tick) are not evicted.
+		/// It is clamped to one at least, so the resources of the current tick are always kept.
+		/// </summary>
+		void SetGraceTicks( unsigned int tickCount );
+		unsigned int GetGraceTicks();
+
+		/// <summary>
+		/// Embed to a cached resource that is used out of the cache, then Touch() it at the use(e.g. drawing).
+		/// The eviction orders by the later one of the last request and the last touch.
+		/// </summary>
+		class Usage
+		{
+		private:
+			mutable std::atomic<unsigned long long> lastTouched{ 0U };
+		public:
+			Usage() = default;
+			Usage( const Usage &source ) : lastTouched( source.GetLastTouched() ) {}
+			Usage &operator = ( const Usage &source )
+			{
+				lastTouched.store( source.GetLastTouched(), std::memory_order_relaxed );
+				return *this;
+			}
+		public:
+			/// <summary>
+			/// Stamp the current tick. This is thread-safe and lock-free, so you can call at every drawing.
+			/// </summary>
+			void Touch() const
+			{
+				lastTouched.store( GetTick(), std::memory_order_relaxed );
+			}
+			unsigned long long GetLastTouched() const
+			{
+				return lastTouched.load( std::memory_order_relaxed );
+			}
+		};
+
+		/// <summary>
+		/// Report the difference of resident bytes and count of the category. This is thread-safe.
+		/// </summary>
+		void AddResident( Category category, long long bytes, int count );
+
+		/// <summary>
+		/// A container of the evictable resources. Register it by RegisterPool(), and unregister it before the destruction.
+		/// </summary>
+		class Pool
+		{
+		public:
+			struct Candidate
+			{
+				unsigned long long	lastUsedTick{};
+				size_t				byteSize{};
+				unsigned long long	id{};			// The identifier in the pool.
+				Pool				*pPool{};		// Set by the caller of CollectUnused().
+			};
+		public:
+			virtual ~Pool() = default;
+		public:
+			virtual Category GetCategory() const = 0;
+			/// <summary>
+			/// Append the resources that can be evicted now.
+			/// </summary>
+			virtual void CollectUnused( std::vector<Candidate> *pOutput ) = 0;
+			/// <summary>
+			/// Release the resource of the "id" if it is still evictable. Returns the released bytes.
+			/// </summary>
+			virtual size_t Evict( unsigned long long id ) = 0;
+		};
+		void RegisterPool( Pool *pPool );
+		void UnregisterPool( Pool *pPool );
+
+		/// <summary>
+		/// Please call at first of each frame on the main thread. Donya::SystemUpdate() calls this.<para></para>
+		/// Advance the tick, then Trim() if the total is over the budget.
+		/// </summary>
+		void Update();
+		/// <summary>
+		/// Evict the resources in order of the last used, until the total becomes under the "targetBytes".
+		/// The resources that are used within the grace ticks are not evicted.<para></para>
+		/// Please call on the main thread, because the Sprite's pool is not thread-safe. Returns the evicted bytes.
+		/// </summary>
+		size_t Trim( size_t targetBytes );
+
+		struct CategoryReport
+		{
+			long long			residentBytes{};
+			long long			residentCount{};
+			unsigned long long	evictedBytes{};	// The total since the start.
+			unsigned long long	evictedCount{};	// The total since the start.
+		};
+		struct Report
+		{
+			std::array<CategoryReport, CATEGORY_COUNT>	categories{};
+			long long									totalBytes{};
+			size_t										budgetBytes{};
+		};
+		Report MakeReport();
+
+		/// <summary>
+		/// The Tracker that reports the values of a ConcurrentCache to the "category".
+		/// </summary>
+		template<typename Cache, typename Measurer>
+		typename Cache::Tracker MakeTracker( Category category, Measurer measure )
+		{
+			typename Cache::Tracker tracker{};
+			tracker.measure		= measure;
+			tracker.now			= &GetTick;
+			tracker.onChanged	= [category]( long long bytes, int count ) { AddResident( category, bytes, count ); };
+			return tracker;
+		}
+		/// <summary>
+		/// The "usageOf" returns the Usage of a value, as const Usage &( const Value & ).
+		/// </summary>
+		template<typename Cache, typename Measurer, typename UsageGetter>
+		typename Cache::Tracker MakeTracker( Category category, Measurer measure, UsageGetter usageOf )
+		{
+			typename Cache::Tracker tracker = MakeTracker<Cache>( category, measure );
+			tracker.touched = [usageOf]( const typename Cache::ValuePtr::element_type &value )
+			{
+				return usageOf( value ).GetLastTouched();
+			};
+			return tracker;
+		}
+
+		/// <summary>
+		/// The Pool of a ConcurrentCache that has the Tracker of MakeTracker().<para></para>
+		/// It is registered while alive, so please define it after the cache.
+		/// </summary>
+		template<typename Cache>
+		class CachePool : public Pool
+		{
+		private:
+			Cache		*pCache;
+			Category	category;
+		public:
+			CachePool( Cache *pCache, Category category ) : pCache( pCache ), category( category )
+			{
+				RegisterPool( this );
+			}
+			~CachePool()
+			{
+				UnregisterPool( this );
+			}
+			CachePool( const CachePool & ) = delete;
+			CachePool &operator = ( const CachePool & ) = delete;
+		public:
+			Category GetCategory() const override { return category; }
+			void CollectUnused( std::vector<Candidate> *pOutput ) override
+			{
+				pCache->ForEachUnused
+				(
+					[&]( unsigned long long id, unsigned long long lastUsed, size_t byteSize )
+					{
+						Candidate candidate{};
+						candidate.lastUsedTick	= lastUsed;
+						candidate.byteSize		= byteSize;
+						candidate.id			= id;
+						pOutput->emplace_back( candidate );
+					}
+				);
+			}
+			size_t Evict( unsigned long long id ) override
+			{
+				return pCache->EraseIfUnused( id );
+			}
+		};
+
+	#if USE_IMGUI
+		/// <summary>
+		/// Show the report and the budget by ImGui::TreeNode(). Please call between ImGui::Begin() and ImGui::End().
+		/// </summary>
+		void ShowImGuiNode( const char *nodeCaption );
+	#endif // USE_IMGUI
+	}
+}
@@ -0,0 +1,1174 @@
+#include "SoftwareMixer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>		// Use memcmp(), memset().
+#include <functional>	// Use std::hash.
+
+#if defined( _M_X64 ) || defined( _M_AMD64 ) || defined( __SSE2__ ) || ( defined( _M_IX86_FP ) && 2 <= _M_IX86_FP )
+#define USE_SSE_MIXING 1
+#include <xmmintrin.h>
+#else
+#define USE_SSE_MIXING 0
+#endif
+
+#undef max
+#undef min
+
+namespace
+{
+	// The wav-file is little endian, these read it regardless of the platform.
+
+	std::uint16_t ReadU16( const unsigned char *p )
+	{
+		return scast<std::uint16_t>( p[0] | ( p[1] << 8 ) );
+	}
+	std::uint32_t ReadU32( const unsigned char *p )
+	{
+		return scast<std::uint32_t>( p[0] ) | ( scast<std::uint32_t>( p[1] ) << 8 ) | ( scast<std::uint32_t>( p[2] ) << 16 ) | ( scast<std::uint32_t>( p[3] ) << 24 );
+	}
+	void WriteU16( std::ostream &stream, std::uint16_t value )
+	{
+		const char bytes[2]{ scast<char>( value & 0xFF ), scast<char>( value >> 8 ) };
+		stream.write( bytes, 2 );
+	}
+	void WriteU32( std::ostream &stream, std::uint32_t value )
+	{
+		WriteU16( stream, scast<std::uint16_t>( value & 0xFFFF ) );
+		WriteU16( stream, scast<std::uint16_t>( value >> 16 ) );
+	}
+
+	constexpr std::uint16_t WAVE_FORMAT_PCM			= 0x0001;
+	constexpr std::uint16_t WAVE_FORMAT_IEEE_FLOAT	= 0x0003;
+	constexpr std::uint16_t WAVE_FORMAT_EXTENSIBLE	= 0xFFFE;
+
+	/// <summary>
+	/// Returns the sample of "pSample" as -1.0f ~ 1.0f.
+	/// </summary>
+	float ReadSample( const unsigned char *pSample, std::uint16_t format, std::uint16_t bitsPerSample )
+	{
+		if ( format == WAVE_FORMAT_IEEE_FLOAT )
+		{
+			float value{};
+			std::uint32_t bits = ReadU32( pSample );
+			memcpy( &value, &bits, sizeof( float ) );
+			return value;
+		}
+		// else
+
+		switch ( bitsPerSample )
+		{
+		case 8:		return ( scast<float>( pSample[0] ) - 128.0f ) / 128.0f;	// 8 bits is unsigned.
+		case 16:	return scast<float>( scast<std::int16_t>( ReadU16( pSample ) ) ) / 32768.0f;
+		case 24:
+			{
+				std::int32_t value = scast<std::int32_t>( pSample[0] | ( pSample[1] << 8 ) | ( pSample[2] << 16 ) );
+				if ( value & 0x800000 ) { value -= 0x1000000; }
+				return scast<float>( value ) / 8388608.0f;
+			}
+		case 32:	return scast<float>( scast<std::int32_t>( ReadU32( pSample ) ) ) / 2147483648.0f;
+		default:	break;
+		}
+		return 0.0f;
+	}
+
+	struct WaveFormat
+	{
+		std::uint16_t	format{};
+		std::uint16_t	channelCount{};
+		std::uint32_t	sampleRate{};
+		std::uint16_t	blockAlign{};
+		std::uint16_t	bitsPerSample{};
+		std::streamoff	dataOffset{};	// The position of the samples in the file.
+		size_t			dataSize{};
+	public:
+		size_t GetBytesPerSample()	const { return bitsPerSample / 8U; }
+		size_t GetFrameBytes()		const { return std::max( scast<size_t>( blockAlign ), GetBytesPerSample() * channelCount ); }
+		size_t GetFrameCount()		const { return dataSize / GetFrameBytes(); }
+	};
+
+	/// <summary>
+	/// Read the chunks of the wav-file until the "fmt " and the "data" are found.<para></para>
+	/// Returns false if the stream is not a wav-file, or the format is not supported.
+	/// </summary>
+	bool ReadWaveFormat( std::istream &stream, WaveFormat *pOutput )
+	{
+		stream.seekg( 0, std::ios::end );
+		const std::streamoff fileSize = stream.tellg();
+		stream.seekg( 0, std::ios::beg );
+
+		unsigned char header[12]{};
+		if ( !stream.read( reinterpret_cast<char *>( header ), 12 ) ) { return false; }
+		if ( memcmp( header, "RIFF", 4 ) != 0 || memcmp( header + 8, "WAVE", 4 ) != 0 ) { return false; }
+		// else
+
+		WaveFormat	result{};
+		bool		foundFormat	= false;
+		bool		foundData	= false;
+		while ( !( foundFormat && foundData ) )
+		{
+			unsigned char chunkHeader[8]{};
+			if ( !stream.read( reinterpret_cast<char *>( chunkHeader ), 8 ) ) { break; }
+			// else
+
+			const std::streamoff	bodyPos		= stream.tellg();
+			const size_t			chunkSize	= ReadU32( chunkHeader + 4 );
+
+			if ( memcmp( chunkHeader, "fmt ", 4 ) == 0 && 16U <= chunkSize )
+			{
+				unsigned char body[40]{};
+				const size_t readSize = std::min( chunkSize, sizeof( body ) );
+				if ( !stream.read( reinterpret_cast<char *>( body ), readSize ) ) { return false; }
+				// else
+
+				result.format			= ReadU16( body + 0  );
+				result.channelCount		= ReadU16( body + 2  );
+				result.sampleRate		= ReadU32( body + 4  );
+				result.blockAlign		= ReadU16( body + 12 );
+				result.bitsPerSample	= ReadU16( body + 14 );
+				// The first two bytes of the sub-format GUID are the format.
+				if ( result.format == WAVE_FORMAT_EXTENSIBLE && 26U <= readSize )
+				{
+					result.format = ReadU16( body + 24 );
+				}
+				foundFormat = true;
+			}
+			else if ( memcmp( chunkHeader, "data", 4 ) == 0 )
+			{
+				result.dataOffset	= bodyPos;
+				result.dataSize		= std::min( chunkSize, scast<size_t>( fileSize - bodyPos ) );
+				foundData = true;
+			}
+
+			// The chunks are aligned by two bytes.
+			stream.seekg( bodyPos + scast<std::streamoff>( chunkSize + ( chunkSize & 1U ) ), std::ios::beg );
+		}
+		stream.clear();
+
+		if ( !foundFormat || !foundData ) { return false; }
+		if ( !result.channelCount || !result.sampleRate ) { return false; }
+		if ( result.format != WAVE_FORMAT_PCM && result.format != WAVE_FORMAT_IEEE_FLOAT ) { return false; }
+		if ( result.format == WAVE_FORMAT_IEEE_FLOAT && result.bitsPerSample != 32 ) { return false; }
+		if ( result.bitsPerSample != 8 && result.bitsPerSample != 16 && result.bitsPerSample != 24 && result.bitsPerSample != 32 ) { return false; }
+		// else
+
+		*pOutput = result;
+		return true;
+	}
+
+	/// <summary>
+	/// Convert the "frameCount" frames of the "pSource" to stereo floats. The "pStereoOutput" must have "frameCount" * 2 elements.
+	/// </summary>
+	void DecodeFrames( const unsigned char *pSource, size_t frameCount, const WaveFormat &format, float *pStereoOutput )
+	{
+		const size_t bytesPerSample	= format.GetBytesPerSample();
+		const size_t frameBytes		= format.GetFrameBytes();
+		for ( size_t i = 0; i < frameCount; ++i )
+		{
+			const unsigned char *pFrame = pSource + i * frameBytes;
+			const float left  = ReadSample( pFrame, format.format, format.bitsPerSample );
+			const float right = ( 2U <= format.channelCount ) ? ReadSample( pFrame + bytesPerSample, format.format, format.bitsPerSample ) : left;
+			pStereoOutput[i * 2 + 0] = left;
+			pStereoOutput[i * 2 + 1] = right;
+		}
+	}
+
+	/// <summary>
+	/// Read the whole wav-file as stereo interleaved samples. Returns false if the file is not found or the format is not supported.
+	/// </summary>
+	bool LoadWave( const std::string &filePath, std::vector<float> *pStereoSamples, unsigned int *pSampleRate )
+	{
+		std::ifstream ifs( filePath, std::ios::binary );
+		if ( !ifs ) { return false; }
+		// else
+
+		WaveFormat format{};
+		if ( !ReadWaveFormat( ifs, &format ) ) { return false; }
+		// else
+
+		const size_t frameCount = format.GetFrameCount();
+		std::vector<unsigned char> bytes( frameCount * format.GetFrameBytes() );
+		ifs.seekg( format.dataOffset, std::ios::beg );
+		if ( !ifs.read( reinterpret_cast<char *>( bytes.data() ), bytes.size() ) ) { return false; }
+		// else
+
+		pStereoSamples->resize( frameCount * 2U );
+		DecodeFrames( bytes.data(), frameCount, format, pStereoSamples->data() );
+		*pSampleRate = format.sampleRate;
+		return true;
+	}
+
+	/// <summary>
+	/// Convert the sample rate by the linear interpolation.
+	/// </summary>
+	std::vector<float> Resample( std::vector<float> stereoSamples, unsigned int sourceRate, unsigned int destinationRate )
+	{
+		const size_t sourceFrameCount = stereoSamples.size() / 2U;
+		if ( sourceRate == destinationRate || !sourceFrameCount ) { return stereoSamples; }
+		// else
+
+		const double	ratio				= scast<double>( sourceRate ) / scast<double>( destinationRate );
+		const size_t	destinationCount	= std::max( size_t( 1 ), scast<size_t>( scast<double>( sourceFrameCount ) / ratio ) );
+
+		std::vector<float> result( destinationCount * 2U );
+		for ( size_t i = 0; i < destinationCount; ++i )
+		{
+			const double	position	= scast<double>( i ) * ratio;
+			const size_t	index		= std::min( scast<size_t>( position ), sourceFrameCount - 1U );
+			const size_t	next		= std::min( index + 1U, sourceFrameCount - 1U );
+			const float		t			= scast<float>( position - scast<double>( index ) );
+			for ( size_t c = 0; c < 2U; ++c )
+			{
+				const float a = stereoSamples[index * 2 + c];
+				const float b = stereoSamples[next  * 2 + c];
+				result[i * 2 + c] = a + ( b - a ) * t;
+			}
+		}
+		return result;
+	}
+
+	/// <summary>
+	/// Add the "pSource" * gain to the "pDestination". Both are stereo interleaved.<para></para>
+	/// The gain is increased by "gainStep" per frame, so the fade is applied per sample.
+	/// </summary>
+	void MixScaled( float *pDestination, const float *pSource, size_t frameCount, float gain, float gainStep )
+	{
+		const size_t floatCount = frameCount * 2U;
+		size_t i = 0;
+
+	#if USE_SSE_MIXING
+
+		// The four floats are two stereo frames.
+		__m128			gains	= _mm_setr_ps( gain, gain, gain + gainStep, gain + gainStep );
+		const __m128	steps	= _mm_set1_ps( gainStep * 2.0f );
+		for ( ; i + 4U <= floatCount; i += 4U )
+		{
+			const __m128 source	= _mm_loadu_ps( pSource + i );
+			const __m128 dest	= _mm_loadu_ps( pDestination + i );
+			_mm_storeu_ps( pDestination + i, _mm_add_ps( dest, _mm_mul_ps( source, gains ) ) );
+			gains = _mm_add_ps( gains, steps );
+		}
+		gain += gainStep * scast<float>( i / 2U );
+
+	#endif // USE_SSE_MIXING
+
+		for ( ; i < floatCount; i += 2U )
+		{
+			pDestination[i + 0] += pSource[i + 0] * gain;
+			pDestination[i + 1] += pSource[i + 1] * gain;
+			gain += gainStep;
+		}
+	}
+}
+
+namespace Donya
+{
+#pragma region WavFileAudioOutput
+
+	WavFileAudioOutput::WavFileAudioOutput( const std::string &filePath ) :
+		filePath( filePath ), stream(), channelCount( 0 ), dataBytes( 0 ), converted()
+	{}
+	WavFileAudioOutput::~WavFileAudioOutput()
+	{
+		Close();
+	}
+
+	bool WavFileAudioOutput::Open( unsigned int sampleRate, unsigned int outputChannelCount )
+	{
+		Close();
+
+		stream.open( filePath, std::ios::binary | std::ios::trunc );
+		if ( !stream ) { return false; }
+		// else
+
+		channelCount	= outputChannelCount;
+		dataBytes		= 0;
+
+		// The sizes are written at Close().
+		constexpr std::uint16_t BITS_PER_SAMPLE = 16;
+		const std::uint16_t blockAlign = scast<std::uint16_t>( channelCount * BITS_PER_SAMPLE / 8U );
+		stream.write( "RIFF", 4 );
+		WriteU32( stream, 0 );
+		stream.write( "WAVE", 4 );
+		stream.write( "fmt ", 4 );
+		WriteU32( stream, 16 );
+		WriteU16( stream, WAVE_FORMAT_PCM );
+		WriteU16( stream, scast<std::uint16_t>( channelCount ) );
+		WriteU32( stream, sampleRate );
+		WriteU32( stream, sampleRate * blockAlign );
+		WriteU16( stream, blockAlign );
+		WriteU16( stream, BITS_PER_SAMPLE );
+		stream.write( "data", 4 );
+		WriteU32( stream, 0 );
+
+		return stream.good();
+	}
+	void WavFileAudioOutput::Write( const float *pSamples, size_t frameCount )
+	{
+		if ( !stream.is_open() ) { return; }
+		// else
+
+		const size_t sampleCount = frameCount * channelCount;
+		converted.resize( sampleCount );
+		for ( size_t i = 0; i < sampleCount; ++i )
+		{
+			const float clamped = std::max( -1.0f, std::min( 1.0f, pSamples[i] ) );
+			converted[i] = scast<short>( clamped * 32767.0f );
+		}
+
+		// Write as little endian.
+		for ( const short &sample : converted )
+		{
+			WriteU16( stream, scast<std::uint16_t>( sample ) );
+		}
+		dataBytes += sampleCount * sizeof( std::int16_t );
+	}
+	void WavFileAudioOutput::Close()
+	{
+		if ( !stream.is_open() ) { return; }
+		// else
+
+		constexpr size_t HEADER_BYTES = 44U;
+		stream.seekp( 4 );
+		WriteU32( stream, scast<std::uint32_t>( HEADER_BYTES - 8U + dataBytes ) );
+		stream.seekp( 40 );
+		WriteU32( stream, scast<std::uint32_t>( dataBytes ) );
+		stream.close();
+	}
+
+#pragma endregion
+
+#pragma region Stream
+
+	/// <summary>
+	/// The streaming sound. The decoder thread fills two blocks alternately, and the mixer reads the filled block.<para></para>
+	/// The members of the file and the resampler are used only by the decoder thread. The blocks are guarded by the "mutex".
+	/// </summary>
+	class SoftwareMixer::Stream
+	{
+	private:
+		static constexpr size_t READ_FRAME_COUNT = 4096U; // The source frames that are read from the file at once.
+
+		struct Block
+		{
+			std::vector<float>	samples{};		// Stereo, interleaved, at the sample rate of the mixer.
+			size_t				frameCount{};
+			bool				isFilled{};
+			bool				isLast{};		// The end of the sound. This is not set if the sound is looping.
+		};
+	private:
+		// Used by the decoder thread.
+
+		std::ifstream				file;
+		WaveFormat					format;
+		std::vector<unsigned char>	readBuffer;
+		std::vector<float>			sourceFrames;	// The decoded frames of the "readBuffer".
+		size_t						sourceIndex;	// The next frame of the "sourceFrames".
+		size_t						sourceRemain;	// The frames that are not read from the file yet.
+		double						ratio;			// The source frames per an output frame.
+		double						position;		// The position between the "previous" and the "next", 0.0 ~ 1.0.
+		float						previous[2];
+		float						next[2];
+		bool						isSourceEnd;
+		const bool					isEnableLoop;
+		bool						isValid;
+
+		// Guarded by the "mutex".
+
+		std::mutex					mutex;
+		std::array<Block, 2>		blocks;
+		size_t						fillingIndex;
+		size_t						readingIndex;
+		size_t						readingFrame;
+		unsigned long long			generation;		// Increased by Rewind(), the block that was being decoded before that is discarded.
+		bool						wantRewind;
+		bool						isFinished;
+		bool						isAtBeginning;
+	public:
+		Stream( const std::string &filePath, unsigned int destinationRate, bool isEnableLoop ) :
+			file( filePath, std::ios::binary ), format(),
+			readBuffer(), sourceFrames(), sourceIndex( 0 ), sourceRemain( 0 ),
+			ratio( 1.0 ), position( 0.0 ), previous(), next(), isSourceEnd( false ),
+			isEnableLoop( isEnableLoop ), isValid( false ),
+			mutex(), blocks(), fillingIndex( 0 ), readingIndex( 0 ), readingFrame( 0 ),
+			generation( 0 ), wantRewind( true ), isFinished( false ), isAtBeginning( true )
+		{
+			if ( !file || !ReadWaveFormat( file, &format ) || !format.GetFrameCount() ) { return; }
+			// else
+
+			ratio = scast<double>( format.sampleRate ) / scast<double>( destinationRate );
+
+			readBuffer.resize( READ_FRAME_COUNT * format.GetFrameBytes() );
+			sourceFrames.reserve( READ_FRAME_COUNT * 2U );
+			for ( auto &block : blocks )
+			{
+				block.samples.resize( STREAM_BLOCK_FRAME_COUNT * 2U );
+			}
+			isValid = true;
+		}
+		DELETE_COPY_AND_ASSIGN( Stream )
+	public:
+		bool IsValid() const { return isValid; }
+	public:
+		// Called from the decoder thread.
+
+		/// <summary>
+		/// Decode a block if there is an empty one. Returns false if there is nothing to do.
+		/// </summary>
+		bool DecodeStep()
+		{
+			size_t				index	= 0;
+			unsigned long long	current	= 0;
+			bool				rewind	= false;
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				if ( blocks[fillingIndex].isFilled ) { return false; }
+				if ( !wantRewind && isSourceEnd ) { return false; }
+				// else
+
+				index		= fillingIndex;
+				current		= generation;
+				rewind		= wantRewind;
+				wantRewind	= false;
+			}
+
+			if ( rewind ) { Prime(); }
+
+			// The mixer does not touch the samples of the block that is not filled.
+			Block	&block		= blocks[index];
+			bool	isLast		= false;
+			size_t	frameCount	= Decode( block.samples.data(), STREAM_BLOCK_FRAME_COUNT, &isLast );
+
+			std::lock_guard<std::mutex> lock( mutex );
+			// Rewound while decoding, the next step decodes from the beginning.
+			if ( current != generation ) { return true; }
+			// else
+
+			block.frameCount	= frameCount;
+			block.isLast		= isLast;
+			block.isFilled		= true;
+			fillingIndex		= 1U - fillingIndex;
+			return true;
+		}
+	private:
+		/// <summary>
+		/// Seek to the beginning of the samples, and read the first two frames for the interpolation.
+		/// </summary>
+		void Prime()
+		{
+			file.clear();
+			file.seekg( format.dataOffset, std::ios::beg );
+			sourceFrames.clear();
+			sourceIndex		= 0;
+			sourceRemain	= format.GetFrameCount();
+			position		= 0.0;
+			isSourceEnd		= false;
+
+			if ( !ReadSourceFrame( previous ) ) { isSourceEnd = true; return; }
+			// else
+			if ( !ReadSourceFrame( next ) )
+			{
+				// The sound that has only one frame.
+				next[0] = previous[0];
+				next[1] = previous[1];
+			}
+		}
+		/// <summary>
+		/// Returns false if the source is end. If looping, the first frame follows the last one.
+		/// </summary>
+		bool ReadSourceFrame( float *pStereoFrame )
+		{
+			if ( sourceFrames.size() <= sourceIndex * 2U )
+			{
+				if ( !sourceRemain )
+				{
+					if ( !isEnableLoop ) { return false; }
+					// else
+
+					file.clear();
+					file.seekg( format.dataOffset, std::ios::beg );
+					sourceRemain = format.GetFrameCount();
+				}
+
+				const size_t readCount = std::min( sourceRemain, READ_FRAME_COUNT );
+				if ( !file.read( reinterpret_cast<char *>( readBuffer.data() ), readCount * format.GetFrameBytes() ) ) { return false; }
+				// else
+
+				sourceFrames.resize( readCount * 2U );
+				DecodeFrames( readBuffer.data(), readCount, format, sourceFrames.data() );
+				sourceIndex		=  0;
+				sourceRemain	-= readCount;
+			}
+
+			pStereoFrame[0] = sourceFrames[sourceIndex * 2U + 0];
+			pStereoFrame[1] = sourceFrames[sourceIndex * 2U + 1];
+			sourceIndex++;
+			return true;
+		}
+		/// <summary>
+		/// Write the resampled frames to the "pOutput" up to "maxFrameCount". Same interpolation as the one of the loaded sound.
+		/// </summary>
+		size_t Decode( float *pOutput, size_t maxFrameCount, bool *pIsLast )
+		{
+			size_t i = 0;
+			for ( ; i < maxFrameCount; ++i )
+			{
+				if ( isSourceEnd ) { break; }
+				// else
+
+				const float t = scast<float>( position );
+				pOutput[i * 2 + 0] = previous[0] + ( next[0] - previous[0] ) * t;
+				pOutput[i * 2 + 1] = previous[1] + ( next[1] - previous[1] ) * t;
+
+				position += ratio;
+				while ( 1.0 <= position )
+				{
+					position -= 1.0;
+					previous[0] = next[0];
+					previous[1] = next[1];
+					if ( !ReadSourceFrame( next ) )
+					{
+						isSourceEnd = true;
+						break;
+					}
+				}
+			}
+
+			*pIsLast = isSourceEnd;
+			return i;
+		}
+	public:
+		// Called from the mixer.
+
+		/// <summary>
+		/// Copy the filled frames to the "pOutput" up to "frameCount", and returns the copied count.<para></para>
+		/// The "pConsumed" is set true if a block became empty.
+		/// </summary>
+		size_t Read( float *pOutput, size_t frameCount, bool *pConsumed )
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+
+			size_t copiedCount = 0;
+			while ( copiedCount < frameCount && !isFinished )
+			{
+				Block &block = blocks[readingIndex];
+				if ( !block.isFilled ) { break; }
+				// else
+
+				const size_t count = std::min( frameCount - copiedCount, block.frameCount - readingFrame );
+				memcpy( pOutput + copiedCount * 2U, block.samples.data() + readingFrame * 2U, sizeof( float ) * count * 2U );
+				copiedCount		+= count;
+				readingFrame	+= count;
+				if ( count ) { isAtBeginning = false; }
+
+				if ( readingFrame < block.frameCount ) { continue; }
+				// else
+
+				if ( block.isLast ) { isFinished = true; }
+				block.isFilled	= false;
+				readingIndex	= 1U - readingIndex;
+				readingFrame	= 0;
+				*pConsumed		= true;
+			}
+			return copiedCount;
+		}
+		/// <summary>
+		/// Discard the blocks and request to decode from the beginning.
+		/// </summary>
+		void Rewind()
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			generation++;
+			for ( auto &block : blocks )
+			{
+				block.isFilled = false;
+			}
+			fillingIndex	= 0;
+			readingIndex	= 0;
+			readingFrame	= 0;
+			wantRewind		= true;
+			isFinished		= false;
+			isAtBeginning	= true;
+		}
+		bool IsFinished()
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			return isFinished;
+		}
+		bool IsAtBeginning()
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			return isAtBeginning;
+		}
+	};
+
+	constexpr size_t SoftwareMixer::Stream::READ_FRAME_COUNT;
+
+#pragma endregion
+
+#pragma region SoftwareMixer
+
+	// The definitions of static members, these are required if these are passed by reference(e.g. std::min()).
+	constexpr unsigned int	SoftwareMixer::CHANNEL_COUNT;
+	constexpr unsigned int	SoftwareMixer::DEFAULT_SAMPLE_RATE;
+	constexpr size_t		SoftwareMixer::DEFAULT_VOICE_COUNT;
+	constexpr size_t		SoftwareMixer::MIX_BLOCK_FRAME_COUNT;
+	constexpr int			SoftwareMixer::DEFAULT_PRIORITY;
+	constexpr int			SoftwareMixer::DEFAULT_LOOP_PRIORITY;
+	constexpr size_t		SoftwareMixer::STREAM_BLOCK_FRAME_COUNT;
+
+	SoftwareMixer::SoftwareMixer( std::unique_ptr<AudioOutput> pAudioOutput, unsigned int mixerSampleRate, size_t voiceCount ) :
+		pOutput( std::move( pAudioOutput ) ), sampleRate( ( mixerSampleRate ) ? mixerSampleRate : DEFAULT_SAMPLE_RATE ),
+		clips(), voices( std::max( size_t( 1 ), voiceCount ) ),
+		mixBuffer( MIX_BLOCK_FRAME_COUNT * CHANNEL_COUNT ), streamBuffer( MIX_BLOCK_FRAME_COUNT * CHANNEL_COUNT ),
+		nextSerial( 0 ), stats(),
+		lastUpdate(), pendingFrames( 0.0 ), wasUpdated( false ),
+		streams(), streamMutex(), decoderWakeUp(), hasDecodeRequest( false ), wantStopDecoder( false ), decoder()
+	{
+		if ( !pOutput || !pOutput->Open( sampleRate, CHANNEL_COUNT ) )
+		{
+			pOutput = std::make_unique<NullAudioOutput>();
+			pOutput->Open( sampleRate, CHANNEL_COUNT );
+		}
+	}
+	SoftwareMixer::~SoftwareMixer()
+	{
+		ReleaseAll();
+		StopDecoder();
+		pOutput->Close();
+	}
+
+	void SoftwareMixer::Update()
+	{
+		const auto now = std::chrono::steady_clock::now();
+		if ( !wasUpdated )
+		{
+			lastUpdate = now;
+			wasUpdated = true;
+			return;
+		}
+		// else
+
+		// Do not catch up a long stall(e.g. dragging the window), the sounds are delayed instead.
+		constexpr double MAX_ELAPSED_SECONDS = 0.25;
+		const double elapsed = std::chrono::duration<double>( now - lastUpdate ).count();
+		lastUpdate = now;
+
+		pendingFrames += std::min( elapsed, MAX_ELAPSED_SECONDS ) * sampleRate;
+		const size_t frameCount = scast<size_t>( pendingFrames );
+		pendingFrames -= scast<double>( frameCount );
+
+		Render( frameCount );
+	}
+	void SoftwareMixer::Render( size_t frameCount )
+	{
+		while ( frameCount )
+		{
+			const size_t blockFrameCount = std::min( frameCount, MIX_BLOCK_FRAME_COUNT );
+			Mix( mixBuffer.data(), blockFrameCount );
+			pOutput->Write( mixBuffer.data(), blockFrameCount );
+			frameCount -= blockFrameCount;
+		}
+	}
+	void SoftwareMixer::Mix( float *pMixed, size_t frameCount )
+	{
+		const auto begin = std::chrono::steady_clock::now();
+
+		memset( pMixed, 0, sizeof( float ) * frameCount * CHANNEL_COUNT );
+		for ( auto &voice : voices )
+		{
+			if ( voice.clipHandle == NULL || voice.isPaused ) { continue; }
+			// else
+			MixVoice( &voice, pMixed, frameCount );
+		}
+
+		stats.mixedFrameCount	+= frameCount;
+		stats.mixSeconds		+= std::chrono::duration<double>( std::chrono::steady_clock::now() - begin ).count();
+	}
+	void SoftwareMixer::MixVoice( Voice *pVoice, float *pMixed, size_t frameCount )
+	{
+		const auto found = clips.find( pVoice->clipHandle );
+		if ( found == clips.end() )
+		{
+			*pVoice = Voice{};
+			return;
+		}
+		// else
+		const Clip &clip = found->second;
+
+		if ( clip.pStream )
+		{
+			MixStreamVoice( pVoice, clip.pStream.get(), pMixed, frameCount );
+			return;
+		}
+		// else
+
+		size_t mixedCount = 0;
+		while ( mixedCount < frameCount )
+		{
+			const size_t chunk = ClampByFade( *pVoice, std::min( frameCount - mixedCount, clip.frameCount - pVoice->frame ) );
+			MixChunk
+			(
+				pVoice,
+				pMixed + mixedCount * CHANNEL_COUNT,
+				clip.samples.data() + pVoice->frame * CHANNEL_COUNT,
+				chunk
+			);
+
+			pVoice->frame	+= chunk;
+			mixedCount		+= chunk;
+
+			if ( pVoice->frame < clip.frameCount ) { continue; }
+			// else
+
+			if ( !clip.isEnableLoop )
+			{
+				*pVoice = Voice{};
+				return;
+			}
+			// else
+			pVoice->frame = 0;
+		}
+	}
+	void SoftwareMixer::MixStreamVoice( Voice *pVoice, Stream *pStream, float *pMixed, size_t frameCount )
+	{
+		bool	isConsumed	= false;
+		size_t	mixedCount	= 0;
+		while ( mixedCount < frameCount )
+		{
+			const size_t wantCount = ClampByFade( *pVoice, std::min( frameCount - mixedCount, MIX_BLOCK_FRAME_COUNT ) );
+			const size_t readCount = pStream->Read( streamBuffer.data(), wantCount, &isConsumed );
+			if ( !readCount ) { break; }
+			// else
+
+			MixChunk( pVoice, pMixed + mixedCount * CHANNEL_COUNT, streamBuffer.data(), readCount );
+
+			pVoice->frame	+= readCount;
+			mixedCount		+= readCount;
+		}
+
+		if ( isConsumed ) { RequestDecode(); }
+
+		if ( pStream->IsFinished() )
+		{
+			FreeVoice( pVoice );
+			return;
+		}
+		// else
+
+		// The decoder could not keep up with. The lack is silent rather than waiting for the decoder.
+		if ( mixedCount < frameCount ) { stats.underrunCount++; }
+	}
+	void SoftwareMixer::MixChunk( Voice *pVoice, float *pMixed, const float *pSource, size_t frameCount )
+	{
+		const float step = ( pVoice->fadeRemainFrames ) ? pVoice->fadeStep : 0.0f;
+
+		// The silent voice is only advanced.
+		if ( pVoice->volume != 0.0f || step != 0.0f )
+		{
+			MixScaled( pMixed, pSource, frameCount, pVoice->volume, step );
+		}
+
+		if ( pVoice->fadeRemainFrames )
+		{
+			pVoice->fadeRemainFrames -= frameCount;
+			pVoice->volume = ( pVoice->fadeRemainFrames ) ? pVoice->volume + step * scast<float>( frameCount ) : pVoice->fadeDestination;
+		}
+	}
+	size_t SoftwareMixer::ClampByFade( const Voice &voice, size_t frameCount ) const
+	{
+		// The step of the fade is constant in a chunk.
+		return ( voice.fadeRemainFrames ) ? std::min( frameCount, voice.fadeRemainFrames ) : frameCount;
+	}
+
+	size_t SoftwareMixer::MakeHandle( const std::string &name )
+	{
+		size_t hash = std::hash<std::string>()( name );
+		if ( hash == NULL )	// NULL using error code.
+		{
+			hash = 1;
+		}
+		return hash;
+	}
+
+	size_t SoftwareMixer::Load( std::string fileName, bool isEnableLoop, bool isStreaming )
+	{
+		const size_t hash = MakeHandle( fileName );
+		if ( clips.find( hash ) != clips.end() ) { return hash; }
+		// else
+
+		return Register( Prepare( fileName, isEnableLoop, isStreaming ) );
+	}
+	SoftwareMixer::PreparedSound SoftwareMixer::Prepare( const std::string &fileName, bool isEnableLoop, bool isStreaming ) const
+	{
+		PreparedSound prepared{};
+		prepared.name			= fileName;
+		prepared.isEnableLoop	= isEnableLoop;
+
+		if ( isStreaming )
+		{
+			auto pStream = std::make_shared<Stream>( fileName, sampleRate, isEnableLoop );
+			if ( !pStream->IsValid() ) { return prepared; }
+			// else
+
+			prepared.pStream = std::move( pStream );
+			prepared.isValid = true;
+			return prepared;
+		}
+		// else
+
+		std::vector<float>	samples{};
+		unsigned int		sourceRate = 0;
+		if ( !LoadWave( fileName, &samples, &sourceRate ) ) { return prepared; }
+		if ( samples.size() < CHANNEL_COUNT ) { return prepared; }
+		// else
+
+		prepared.samples = Resample( std::move( samples ), sourceRate, sampleRate );
+		prepared.isValid = true;
+		return prepared;
+	}
+	size_t SoftwareMixer::Register( PreparedSound &&prepared )
+	{
+		if ( !prepared.isValid ) { return NULL; }
+		// else
+
+		const size_t hash = MakeHandle( prepared.name );
+		if ( clips.find( hash ) != clips.end() ) { return hash; }
+		// else
+
+		Clip clip{};
+		clip.samples		= std::move( prepared.samples );
+		clip.frameCount		= clip.samples.size() / CHANNEL_COUNT;
+		clip.isEnableLoop	= prepared.isEnableLoop;
+		clip.priority		= ( prepared.isEnableLoop ) ? DEFAULT_LOOP_PRIORITY : DEFAULT_PRIORITY;
+		clip.pStream		= std::move( prepared.pStream );
+
+		std::shared_ptr<Stream> pStream = clip.pStream;
+		clips.insert( std::make_pair( hash, std::move( clip ) ) );
+
+		if ( pStream )
+		{
+			StartDecoderIfNeeded();
+			{
+				std::lock_guard<std::mutex> lock( streamMutex );
+				streams.emplace_back( std::move( pStream ) );
+			}
+			// Fill the first blocks before the Play().
+			RequestDecode();
+		}
+
+		return hash;
+	}
+	size_t SoftwareMixer::Register( const std::string &name, const std::vector<float> &stereoSamples, unsigned int sourceSampleRate, bool isEnableLoop )
+	{
+		const size_t hash = MakeHandle( name );
+		if ( clips.find( hash ) != clips.end() ) { return hash; }
+		// else
+		if ( stereoSamples.size() < CHANNEL_COUNT || !sourceSampleRate ) { return NULL; }
+		// else
+
+		PreparedSound prepared{};
+		prepared.name			= name;
+		prepared.samples		= Resample( stereoSamples, sourceSampleRate, sampleRate );
+		prepared.isEnableLoop	= isEnableLoop;
+		prepared.isValid		= true;
+		return Register( std::move( prepared ) );
+	}
+
+	bool SoftwareMixer::SetPriority( size_t handle, int priority )
+	{
+		auto found = clips.find( handle );
+		if ( found == clips.end() ) { return false; }
+		// else
+
+		found->second.priority = priority;
+		return true;
+	}
+
+	SoftwareMixer::Voice *SoftwareMixer::FindFreeOrStealableVoice( int priority )
+	{
+		Voice *pCandidate = nullptr;
+		for ( auto &voice : voices )
+		{
+			if ( voice.clipHandle == NULL ) { return &voice; }
+			// else
+
+			if ( !pCandidate
+			||   voice.priority <  pCandidate->priority
+			|| ( voice.priority == pCandidate->priority && voice.serial < pCandidate->serial )
+			)
+			{
+				pCandidate = &voice;
+			}
+		}
+
+		if ( pCandidate && priority < pCandidate->priority ) { return nullptr; }
+		// else
+		return pCandidate;
+	}
+
+	bool SoftwareMixer::Play( size_t handle )
+	{
+		const auto found = clips.find( handle );
+		if ( found == clips.end() ) { return false; }
+		// else
+
+		Stream *pStream = found->second.pStream.get();
+		if ( pStream )
+		{
+			// A stream has only one reading position, so play it again from the beginning.
+			for ( auto &voice : voices )
+			{
+				if ( voice.clipHandle == handle ) { FreeVoice( &voice ); }
+			}
+			if ( !pStream->IsAtBeginning() ) { RewindStream( pStream ); }
+		}
+
+		Voice *pVoice = FindFreeOrStealableVoice( found->second.priority );
+		if ( !pVoice )
+		{
+			stats.rejectedCount++;
+			return false;
+		}
+		// else
+
+		if ( pVoice->clipHandle != NULL )
+		{
+			stats.stolenCount++;
+			FreeVoice( pVoice );
+		}
+
+		*pVoice				= Voice{};
+		pVoice->clipHandle	= handle;
+		pVoice->volume		= 1.0f;
+		pVoice->priority	= found->second.priority;
+		pVoice->serial		= ++nextSerial;
+
+		stats.playedCount++;
+		stats.peakVoiceCount = std::max( stats.peakVoiceCount, scast<unsigned int>( GetNowPlayingSoundsCount() ) );
+		return true;
+	}
+
+	void SoftwareMixer::FreeVoice( Voice *pVoice )
+	{
+		const auto found = clips.find( pVoice->clipHandle );
+		if ( found != clips.end() && found->second.pStream )
+		{
+			RewindStream( found->second.pStream.get() );
+		}
+
+		*pVoice = Voice{};
+	}
+	void SoftwareMixer::RewindStream( Stream *pStream )
+	{
+		pStream->Rewind();
+		RequestDecode();
+	}
+
+	template<typename Applier>
+	bool SoftwareMixer::ApplyToVoices( size_t handle, bool isEnableForAll, Applier &&apply )
+	{
+		if ( clips.find( handle ) == clips.end() ) { return false; }
+		// else
+
+		std::vector<Voice *> targets{};
+		for ( auto &voice : voices )
+		{
+			if ( voice.clipHandle == handle ) { targets.emplace_back( &voice ); }
+		}
+		// Process from the latest voice, because I think the target of who want to operate is recently-played one.
+		std::sort
+		(
+			targets.begin(), targets.end(),
+			[]( const Voice *lhs, const Voice *rhs ) { return rhs->serial < lhs->serial; }
+		);
+
+		for ( Voice *pVoice : targets )
+		{
+			if ( apply( *pVoice ) && !isEnableForAll ) { break; }
+		}
+		return true;
+	}
+
+	bool SoftwareMixer::Pause( size_t handle, bool isEnableForAll )
+	{
+		return ApplyToVoices
+		(
+			handle, isEnableForAll,
+			[]( Voice &voice )
+			{
+				if ( voice.isPaused ) { return false; }
+				// else
+				voice.isPaused = true;
+				return true;
+			}
+		);
+	}
+	bool SoftwareMixer::Resume( size_t handle, bool isEnableForAll, bool fromTheBeginning )
+	{
+		return ApplyToVoices
+		(
+			handle, isEnableForAll,
+			[&]( Voice &voice )
+			{
+				if ( !voice.isPaused ) { return false; }
+				// else
+				if ( fromTheBeginning )
+				{
+					voice.frame = 0;
+
+					const Clip &clip = clips.at( voice.clipHandle );
+					if ( clip.pStream ) { RewindStream( clip.pStream.get() ); }
+				}
+				voice.isPaused = false;
+				return true;
+			}
+		);
+	}
+	bool SoftwareMixer::Stop( size_t handle, bool isEnableForAll )
+	{
+		return ApplyToVoices
+		(
+			handle, isEnableForAll,
+			[this]( Voice &voice )
+			{
+				FreeVoice( &voice );
+				return true;
+			}
+		);
+	}
+	bool SoftwareMixer::SetVolume( size_t handle, float volume, bool isEnableForAll )
+	{
+		return ApplyToVoices
+		(
+			handle, isEnableForAll,
+			[&volume]( Voice &voice )
+			{
+				voice.volume			= volume;
+				voice.fadeRemainFrames	= 0;
+				return true;
+			}
+		);
+	}
+	bool SoftwareMixer::AppendFadePoint( size_t handle, float takeSeconds, float destinationVolume, bool isEnableForAll )
+	{
+		const size_t distance = scast<size_t>( std::max( 0.0, scast<double>( takeSeconds ) * sampleRate ) );
+		return ApplyToVoices
+		(
+			handle, isEnableForAll,
+			[&]( Voice &voice )
+			{
+				if ( !distance )
+				{
+					voice.volume			= destinationVolume;
+					voice.fadeRemainFrames	= 0;
+					return true;
+				}
+				// else
+
+				voice.fadeStep			= ( destinationVolume - voice.volume ) / scast<float>( distance );
+				voice.fadeDestination	= destinationVolume;
+				voice.fadeRemainFrames	= distance;
+				return true;
+			}
+		);
+	}
+
+	bool SoftwareMixer::Release( size_t handle )
+	{
+		if ( !Stop( handle, /* isEnableForAll = */ true ) ) { return false; }
+		// else
+
+		const auto found = clips.find( handle );
+		if ( found->second.pStream )
+		{
+			// The decoder thread does not pick the stream after this. A step that is running keeps its own reference.
+			std::lock_guard<std::mutex> lock( streamMutex );
+			streams.erase( std::remove( streams.begin(), streams.end(), found->second.pStream ), streams.end() );
+		}
+
+		clips.erase( found );
+		return true;
+	}
+	bool SoftwareMixer::ReleaseAll()
+	{
+		for ( auto &voice : voices )
+		{
+			voice = Voice{};
+		}
+		{
+			std::lock_guard<std::mutex> lock( streamMutex );
+			streams.clear();
+		}
+		clips.clear();
+		return true;
+	}
+
+	int SoftwareMixer::GetNowPlayingSoundsCount()
+	{
+		int count = 0;
+		for ( const auto &voice : voices )
+		{
+			if ( voice.clipHandle != NULL ) { count++; }
+		}
+		return count;
+	}
+
+	void SoftwareMixer::StartDecoderIfNeeded()
+	{
+		if ( decoder.joinable() ) { return; }
+		// else
+
+		wantStopDecoder	= false;
+		decoder			= std::thread( [this]() { DecoderLoop(); } );
+	}
+	void SoftwareMixer::StopDecoder()
+	{
+		if ( !decoder.joinable() ) { return; }
+		// else
+
+		{
+			std::lock_guard<std::mutex> lock( streamMutex );
+			wantStopDecoder = true;
+		}
+		decoderWakeUp.notify_one();
+		decoder.join();
+	}
+	void SoftwareMixer::RequestDecode()
+	{
+		hasDecodeRequest.store( true );
+		decoderWakeUp.notify_one();
+	}
+	void SoftwareMixer::DecoderLoop()
+	{
+		// Decode outside the lock, because the Register() and the Release() take it on the main thread.
+		std::vector<std::shared_ptr<Stream>> decodings{};
+
+		std::unique_lock<std::mutex> lock( streamMutex );
+		while ( !wantStopDecoder )
+		{
+			hasDecodeRequest.store( false );
+			decodings.assign( streams.begin(), streams.end() );
+			lock.unlock();
+
+			bool isDecoded = false;
+			for ( const auto &pStream : decodings )
+			{
+				if ( pStream->DecodeStep() ) { isDecoded = true; }
+			}
+			// Drop the references here, a released stream should be freed without waiting the next step.
+			decodings.clear();
+
+			lock.lock();
+			if ( isDecoded ) { continue; }
+			// else
+
+			// The request is not guarded by the mutex, so it may be missed. The timeout covers that.
+			constexpr auto WAIT_LIMIT = std::chrono::milliseconds( 10 );
+			decoderWakeUp.wait_for( lock, WAIT_LIMIT, [this]() { return wantStopDecoder || hasDecodeRequest.load(); } );
+		}
+	}
+
+#pragma endregion
+}
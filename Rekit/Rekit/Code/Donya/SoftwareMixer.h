@@ -0,0 +1,274 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>	// Use size_t.
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Constant.h"	// Use DELETE_COPY_AND_ASSIGN macro.
+
+namespace Donya
+{
+	/// <summary>
+	/// The destination of the mixed samples. The samples are interleaved, and the range is -1.0f ~ 1.0f.
+	/// </summary>
+	class AudioOutput
+	{
+	public:
+		virtual ~AudioOutput() = default;
+	public:
+		/// <summary>
+		/// Returns false if the device can not be opened.
+		/// </summary>
+		virtual bool Open( unsigned int sampleRate, unsigned int channelCount ) = 0;
+		virtual void Write( const float *pSamples, size_t frameCount ) = 0;
+		virtual void Close() = 0;
+	};
+
+	/// <summary>
+	/// Discard the samples. Use for the machine that has no audio device, or for measuring the cost of the mixing.
+	/// </summary>
+	class NullAudioOutput : public AudioOutput
+	{
+	private:
+		unsigned long long writtenFrameCount = 0;
+	public:
+		bool Open( unsigned int, unsigned int ) override { return true; }
+		void Write( const float *, size_t frameCount ) override { writtenFrameCount += frameCount; }
+		void Close() override {}
+	public:
+		unsigned long long GetWrittenFrameCount() const { return writtenFrameCount; }
+	};
+
+	/// <summary>
+	/// Write the samples to a wav-file as 16 bits PCM. The sizes in the header are written at Close().
+	/// </summary>
+	class WavFileAudioOutput : public AudioOutput
+	{
+	private:
+		std::string		filePath;
+		std::ofstream	stream;
+		unsigned int	channelCount;
+		size_t			dataBytes;
+		std::vector<short> converted; // The buffer of conversion, it is kept for reducing the allocation.
+	public:
+		WavFileAudioOutput( const std::string &filePath );
+		~WavFileAudioOutput() override;
+		DELETE_COPY_AND_ASSIGN( WavFileAudioOutput )
+	public:
+		bool Open( unsigned int sampleRate, unsigned int channelCount ) override;
+		void Write( const float *pSamples, size_t frameCount ) override;
+		void Close() override;
+	};
+
+	/// <summary>
+	/// This class provides the audio system by the software mixing, it does not depend on the platform.<para></para>
+	/// The methods are same as the AudioSystem's, so the Donya::Sound can use either.<para></para>
+	/// The voices are allocated once at the construction. If all voices are playing, the voice that has the lowest priority is stolen.<para></para>
+	/// The output is always stereo, and the sounds are converted to the sample rate of the mixer at loading.<para></para>
+	/// The streaming sound is decoded from the file by the decoder thread into two buffers, while the mixer reads the other one.<para></para>
+	/// This class is not thread-safe, the Donya::Sound guards it.
+	/// </summary>
+	class SoftwareMixer
+	{
+	public:
+		static constexpr unsigned int	CHANNEL_COUNT			= 2U;
+		static constexpr unsigned int	DEFAULT_SAMPLE_RATE		= 48000U;
+		static constexpr size_t			DEFAULT_VOICE_COUNT		= 32U;
+		static constexpr size_t			MIX_BLOCK_FRAME_COUNT	= 1024U;	// The max frames that are mixed at once.
+		static constexpr int			DEFAULT_PRIORITY		= 128;		// The greater one is more important.
+		static constexpr int			DEFAULT_LOOP_PRIORITY	= 192;		// The looping sounds are usually BGMs.
+		static constexpr size_t			STREAM_BLOCK_FRAME_COUNT	= 16384U;	// The frames of each buffer of a streaming sound. About 0.34 seconds at 48kHz.
+
+		struct Stats
+		{
+			unsigned long long	mixedFrameCount{};
+			double				mixSeconds{};		// The time spent for Mix().
+			unsigned int		playedCount{};
+			unsigned int		stolenCount{};		// The count of voices that were stopped for playing another.
+			unsigned int		rejectedCount{};	// The count of Play() that failed by all voices have higher priority.
+			unsigned int		peakVoiceCount{};
+			unsigned int		underrunCount{};	// The count of Mix() that a streaming sound could not fill, the lack was silent.
+		};
+	private:
+		class Stream;
+	public:
+		/// <summary>
+		/// The sound that is decoded but not registered yet. Made by Prepare(), and consumed by Register().
+		/// </summary>
+		struct PreparedSound
+		{
+			std::string				name{};
+			std::vector<float>		samples{};		// Stereo, interleaved, at the sample rate of the mixer.
+			std::shared_ptr<Stream>	pStream{};
+			bool					isEnableLoop{};
+			bool					isValid{};		// False if the decoding failed.
+		};
+	private:
+		struct Clip
+		{
+			std::vector<float>		samples{};	// Stereo, interleaved, at the sample rate of the mixer. Empty if the sound is streaming.
+			size_t					frameCount{};
+			bool					isEnableLoop{};
+			int						priority{};
+			std::shared_ptr<Stream>	pStream{};	// Valid only if the sound is streaming.
+		};
+		struct Voice
+		{
+			size_t				clipHandle{};	// NULL means this voice is free.
+			size_t				frame{};		// The next frame to mix.
+			float				volume{};
+			float				fadeStep{};		// The change of volume per frame.
+			float				fadeDestination{};
+			size_t				fadeRemainFrames{};
+			bool				isPaused{};
+			int					priority{};
+			unsigned long long	serial{};		// Use for finding the latest voice.
+		};
+	private:
+		std::unique_ptr<AudioOutput>			pOutput;
+		unsigned int							sampleRate;
+		std::unordered_map<size_t, Clip>		clips;
+		std::vector<Voice>						voices;
+		std::vector<float>						mixBuffer;
+		std::vector<float>						streamBuffer;	// The frames that are read from a stream, then mixed.
+		unsigned long long						nextSerial;
+		Stats									stats;
+
+		std::chrono::steady_clock::time_point	lastUpdate;
+		double									pendingFrames;	// The frames that should be rendered by Update(), with the fraction.
+		bool									wasUpdated;
+
+		// These are shared with the decoder thread. The "streams" is guarded by the "streamMutex".
+		// The decoder holds copies of the "streams" while decoding, so a released stream lives until its step ends.
+
+		std::vector<std::shared_ptr<Stream>>	streams;
+		std::mutex								streamMutex;
+		std::condition_variable					decoderWakeUp;
+		std::atomic<bool>						hasDecodeRequest;
+		bool									wantStopDecoder;
+		std::thread								decoder;		// Started at the first streaming sound is loaded.
+	public:
+		/// <summary>
+		/// If the "pOutput" is null or can not be opened, use the NullAudioOutput.
+		/// </summary>
+		SoftwareMixer( std::unique_ptr<AudioOutput> pOutput = nullptr, unsigned int sampleRate = DEFAULT_SAMPLE_RATE, size_t voiceCount = DEFAULT_VOICE_COUNT );
+		~SoftwareMixer();
+		DELETE_COPY_AND_ASSIGN( SoftwareMixer )
+	public:
+		/// <summary>
+		/// Please call every frame.<para></para>
+		/// Render the frames of the elapsed time from the last call to the output.
+		/// </summary>
+		void Update();
+		/// <summary>
+		/// Mix the "frameCount" frames and write these to the output. Use for the output that is not real time(e.g. the benchmark).
+		/// </summary>
+		void Render( size_t frameCount );
+		/// <summary>
+		/// Overwrite the "pOutput" by the mix of playing voices. The "pOutput" must have "frameCount" * CHANNEL_COUNT elements.
+		/// </summary>
+		void Mix( float *pOutput, size_t frameCount );
+	public:
+		/// <summary>
+		/// Please set relative-path or whole-path to fileName. The supported format is wav of PCM(8, 16, 24, 32 bits) or float.<para></para>
+		/// If load successed, returns unique handle of sound.<para></para>
+		/// If load failed, returns NULL. <para></para>
+		/// If fileName is already loaded, returns that loaded handle.<para></para>
+		/// If "isStreaming" is true, only the header is read here, and the samples are read from the file while playing.
+		/// A streaming sound can be played by one voice at once, Play() restarts it.
+		/// </summary>
+		size_t Load( std::string fileName, bool isEnableLoop, bool isStreaming = false );
+		/// <summary>
+		/// The first half of Load(). This reads and resamples the file, and can be called from any thread.
+		/// </summary>
+		PreparedSound Prepare( const std::string &fileName, bool isEnableLoop, bool isStreaming = false ) const;
+		/// <summary>
+		/// The second half of Load(). Please call from the thread that uses this.<para></para>
+		/// If the preparation failed, returns NULL. If the name is already registered, the prepared one is discarded and returns that handle.
+		/// </summary>
+		size_t Register( PreparedSound &&prepared );
+		/// <summary>
+		/// Register the stereo interleaved samples as a sound. The "name" is used as the file name of Load().<para></para>
+		/// If the "name" is already registered, returns that handle.
+		/// </summary>
+		size_t Register( const std::string &name, const std::vector<float> &stereoSamples, unsigned int sourceSampleRate, bool isEnableLoop );
+
+		/// <summary>
+		/// Change the priority of the sound. It is applied from the next Play().
+		/// </summary>
+		bool SetPriority( size_t soundHandle, int priority );
+
+		/// <summary>
+		/// Play the sound identified by handle.<para></para>
+		/// If all voices are used, steal the voice that has lowest priority(the oldest one in the same priority).<para></para>
+		/// If not found, or all voices have higher priority, returns false.
+		/// </summary>
+		bool Play( size_t soundHandle );
+
+		// These methods apply to the latest voice of the sound, or all voices of it(when "isEnableForAll" is true).
+
+		bool Pause( size_t soundHandle, bool isEnableForAll = false );
+		bool Resume( size_t soundHandle, bool isEnableForAll = false, bool fromTheBeginning = false );
+		bool Stop( size_t soundHandle, bool isEnableForAll = false );
+		bool SetVolume( size_t soundHandle, float volume, bool isEnableForAll = false );
+		/// <summary>
+		/// Change the volume linearly to the "destinationVolume" in the "takeSeconds". The fade in progress is replaced.
+		/// </summary>
+		bool AppendFadePoint( size_t soundHandle, float takeSeconds, float destinationVolume, bool isEnableForAll = false );
+
+		/// <summary>
+		/// Stop the voices of the sound, and release it.
+		/// </summary>
+		bool Release( size_t soundHandle );
+		bool ReleaseAll();
+	public:
+		/// <summary>
+		/// Returns the count of voices that are playing or pausing.
+		/// </summary>
+		int GetNowPlayingSoundsCount();
+		size_t GetVoiceCount() const { return voices.size(); }
+		unsigned int GetSampleRate() const { return sampleRate; }
+		const Stats &GetStats() const { return stats; }
+		void ResetStats() { stats = Stats{}; }
+	private:
+		static size_t MakeHandle( const std::string &name );
+		/// <summary>
+		/// Returns nullptr if all voices have higher priority than the "priority".
+		/// </summary>
+		Voice *FindFreeOrStealableVoice( int priority );
+		/// <summary>
+		/// Make the voice free. If the voice was playing a streaming sound, rewind it for the next Play().
+		/// </summary>
+		void FreeVoice( Voice *pVoice );
+		void RewindStream( Stream *pStream );
+		/// <summary>
+		/// Call the "apply" as bool( Voice & ) from the latest voice of the sound, and stop at the first true if "isEnableForAll" is false.<para></para>
+		/// Returns false if the sound is not found, or "apply" did not return true.
+		/// </summary>
+		template<typename Applier>
+		bool ApplyToVoices( size_t soundHandle, bool isEnableForAll, Applier &&apply );
+		void MixVoice( Voice *pVoice, float *pOutput, size_t frameCount );
+		void MixStreamVoice( Voice *pVoice, Stream *pStream, float *pOutput, size_t frameCount );
+		/// <summary>
+		/// Add the "pSource" with the volume and the fade of the voice. The "frameCount" must not exceed the remain of the fade.
+		/// </summary>
+		void MixChunk( Voice *pVoice, float *pOutput, const float *pSource, size_t frameCount );
+		/// <summary>
+		/// Returns the frames that can be mixed by the same fade step.
+		/// </summary>
+		size_t ClampByFade( const Voice &voice, size_t frameCount ) const;
+
+		void StartDecoderIfNeeded();
+		void StopDecoder();
+		void RequestDecode();
+		void DecoderLoop();
+	};
+}
@@ -1,13 +1,23 @@
 #include "Sound.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "fmod.hpp"
 
 #include "AudioSystem.h"
 #include "Constant.h"		// Use for DEBUG_MODE.
+#include "SoftwareMixer.h"
 
 #if DEBUG_MODE
 
@@ -15,35 +25,252 @@
 
 #endif // DEBUG_MODE
 
+#undef max
+#undef min
+
 namespace Donya
 {
 	namespace Sound
 	{
+		/// <summary>
+		/// The threads that prepare the sounds of LoadAsync(). The prepared sounds are registered by the thread that calls Update().
+		/// </summary>
+		class AsyncLoader
+		{
+		public:
+			using Registerer	= std::function<size_t()>;		// Called by the thread that uses the sound system. Returns the handle.
+			using Preparer		= std::function<Registerer()>;	// Called by a loading thread.
+			struct Finished
+			{
+				int			id{};
+				Registerer	registerer{};
+			};
+		private:
+			struct Job
+			{
+				int			id{};
+				Preparer	preparer{};
+			};
+		private:
+			std::vector<std::thread>	workers;
+			std::mutex					mutex;
+			std::condition_variable		cvWakeUp;
+			std::condition_variable		cvFinished;
+
+			// These are guarded by the "mutex".
+
+			std::deque<Job>				jobs;
+			std::vector<Finished>		finished;
+			size_t						runningCount;
+			bool						wantQuit;
+		public:
+			AsyncLoader() : workers(), mutex(), cvWakeUp(), cvFinished(), jobs(), finished(), runningCount( 0 ), wantQuit( false ) {}
+			~AsyncLoader()
+			{
+				Cancel();
+			}
+			DELETE_COPY_AND_ASSIGN( AsyncLoader )
+		public:
+			void Push( int id, Preparer preparer )
+			{
+				StartWorkersIfNeeded();
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+					jobs.emplace_back( Job{ id, std::move( preparer ) } );
+				}
+				cvWakeUp.notify_one();
+			}
+			std::vector<Finished> PopFinished()
+			{
+				std::lock_guard<std::mutex> lock( mutex );
+				std::vector<Finished> result{};
+				result.swap( finished );
+				return result;
+			}
+			void WaitAll()
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				cvFinished.wait( lock, [this]() { return jobs.empty() && !runningCount; } );
+			}
+			/// <summary>
+			/// Discard the jobs that are not started and the finished ones, and stop the threads after the running jobs.
+			/// </summary>
+			void Cancel()
+			{
+				{
+					std::lock_guard<std::mutex> lock( mutex );
+					jobs.clear();
+					wantQuit = true;
+				}
+				cvWakeUp.notify_all();
+				for ( auto &worker : workers )
+				{
+					worker.join();
+				}
+				workers.clear();
+
+				std::lock_guard<std::mutex> lock( mutex );
+				finished.clear();
+				wantQuit = false;
+			}
+		private:
+			void StartWorkersIfNeeded()
+			{
+				if ( !workers.empty() ) { return; }
+				// else
+
+				// The loading is mostly waiting for the storage, so a few threads are enough.
+				constexpr unsigned int MAX_WORKER_COUNT = 4U;
+				const unsigned int hardwareCount	= std::thread::hardware_concurrency();
+				const unsigned int workerCount		= std::max( 1U, std::min( MAX_WORKER_COUNT, ( hardwareCount ) ? hardwareCount - 1U : 1U ) );
+				for ( unsigned int i = 0; i < workerCount; ++i )
+				{
+					workers.emplace_back( [this]() { WorkerLoop(); } );
+				}
+			}
+			void WorkerLoop()
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				while ( true )
+				{
+					cvWakeUp.wait( lock, [this]() { return wantQuit || !jobs.empty(); } );
+					if ( wantQuit ) { return; }
+					// else
+
+					Job job = std::move( jobs.front() );
+					jobs.pop_front();
+					runningCount++;
+
+					lock.unlock();
+					Finished result{};
+					result.id			= job.id;
+					result.registerer	= job.preparer();
+					lock.lock();
+
+					runningCount--;
+					finished.emplace_back( std::move( result ) );
+					cvFinished.notify_all();
+				}
+			}
+		};
+
+		struct PendingSound
+		{
+			std::string	fileName{};
+			PendingPlay	whilePending{};
+			bool		wantPlay{};		// Play() was called while loading.
+		};
+
 		typedef std::unordered_map<int, size_t> SoundHandleMap;
 
 		// Instances does not create until use.
 		static std::unique_ptr<AudioSystem>		pAudio{ nullptr };
+		static std::unique_ptr<SoftwareMixer>	pMixer{ nullptr };	// Used instead of the "pAudio" if it is valid.
 		static std::unique_ptr<SoundHandleMap>	pSoundHandles{ nullptr };
 
+		// The gimmicks may play a sound from the worker threads(e.g. the parallel physic update).
+		// The Init() is called from another functions by InitIfNullptr(), so I use the recursive one.
+		static std::recursive_mutex				soundMutex{};
+
+		// These are used by LoadAsync(), and guarded by the "soundMutex".
+		// The "loader" is defined after the backends, so it stops before these are destructed.
+		static std::unordered_map<int, PendingSound>	pendingSounds{};
+		static AsyncLoader								loader{};
+
+		/// <summary>
+		/// The request of Play(), Stop(), etc. These are stored while a frame, and executed at Update() in the order.
+		/// </summary>
+		struct Command
+		{
+			enum class Type
+			{
+				Play,
+				Pause,
+				Resume,
+				Stop,
+				SetVolume,
+				AppendFadePoint,
+			};
+		public:
+			Type	type{};
+			int		id{};
+			bool	isEnableForAll{};
+			bool	fromTheBeginning{};
+			float	volume{};		// The volume of SetVolume(), or the destination volume of AppendFadePoint().
+			float	seconds{};
+		};
+		struct PlayLimit
+		{
+			std::chrono::duration<double>			minInterval{};
+			std::chrono::steady_clock::time_point	lastPlayed{};
+			bool									wasPlayed{};
+		};
+
+		// These are guarded by the "soundMutex".
+
+		static std::vector<Command>					commands{};
+		static std::unordered_set<int>				mergeablePlays{};	// The sounds that have the Play() that is not followed by the other command of the same sound in this frame.
+		static std::unordered_map<int, PlayLimit>	playLimits{};
+		static CommandStats							commandStats{};
+
 		void Init()
 		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			Uninit();
+
 			pAudio			= std::make_unique<AudioSystem>();
 			pSoundHandles	= std::make_unique<SoundHandleMap>();
 		}
+		void InitWithSoftwareMixer( unsigned int voiceCount, const std::string &wavOutputPath )
+		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			Uninit();
+
+			std::unique_ptr<AudioOutput> pOutput{ nullptr };
+			if ( !wavOutputPath.empty() )
+			{
+				pOutput = std::make_unique<WavFileAudioOutput>( wavOutputPath );
+			}
+
+			pMixer			= std::make_unique<SoftwareMixer>( std::move( pOutput ), SoftwareMixer::DEFAULT_SAMPLE_RATE, voiceCount );
+			pSoundHandles	= std::make_unique<SoundHandleMap>();
+		}
 		void Uninit()
 		{
-			if ( !pAudio ) { return; }	// Already Uninitialized.
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			// The loading threads use the backend.
+			loader.Cancel();
+			pendingSounds.clear();
+			commands.clear();
+			mergeablePlays.clear();
+
+			if ( !pAudio && !pMixer ) { return; }	// Already Uninitialized.
 			// else
 
-			pAudio->ReleaseAll();
+			if ( pAudio ) { pAudio->ReleaseAll(); }
 
 			pAudio.reset( nullptr ); // Doing release of sounds by AudioSystem::destructor.
+			pMixer.reset( nullptr );
 			pSoundHandles.reset( nullptr );
 		}
 
 		void InitIfNullptr()
 		{
-			if ( pAudio == nullptr ) { Init(); }
+			if ( pAudio == nullptr && pMixer == nullptr ) { Init(); }
+		}
+
+		/// <summary>
+		/// Call the "function" with the backend in use. The AudioSystem and the SoftwareMixer have same methods.
+		/// </summary>
+		template<typename Function>
+		auto CallBackend( Function &&function ) -> decltype( function( *pAudio ) )
+		{
+			if ( pMixer ) { return function( *pMixer ); }
+			// else
+			return function( *pAudio );
 		}
 
 		size_t GetHandleOrNull( int id )
@@ -56,34 +283,206 @@ namespace Donya
 			return it->second;
 		}
 
-		void Update()
+		void OutputLoadError( const std::string &fileName )
 		{
-			InitIfNullptr();
+		#if DEBUG_MODE
+
+			std::wstring errorMessage = L"[Load Error] ";
+			errorMessage += Donya::MultiToWide( fileName );
+			errorMessage += L"\n";
+
+			Donya::OutputDebugStr( errorMessage.c_str() );
+
+		#endif // DEBUG_MODE
+		}
+
+		/// <summary>
+		/// Register the sounds that the "loader" finished, and play the queued ones.
+		/// </summary>
+		void RegisterLoadedSounds()
+		{
+			for ( auto &loaded : loader.PopFinished() )
+			{
+				auto pending = pendingSounds.find( loaded.id );
+				if ( pending == pendingSounds.end() ) { continue; }
+				// else
+
+				const size_t handle = loaded.registerer();
+				if ( handle == NULL )
+				{
+					OutputLoadError( pending->second.fileName );
+				}
+				else
+				{
+					pSoundHandles->insert( std::make_pair( loaded.id, handle ) );
+					if ( pending->second.wantPlay )
+					{
+						CallBackend( [&]( auto &audio ) { return audio.Play( handle ); } );
+					}
+				}
+
+				pendingSounds.erase( pending );
+			}
+		}
+
+	#pragma region CommandQueue
+
+		bool PushCommand( const Command &command )
+		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			commandStats.requestedCount++;
 
-			pAudio->Update();
+			if ( command.type == Command::Type::Play )
+			{
+				// Playing the same sound many times at once only makes it louder, so these are merged to one.
+				if ( !mergeablePlays.insert( command.id ).second )
+				{
+					commandStats.mergedCount++;
+					return true;
+				}
+				// else
+			}
+			else
+			{
+				// The Play() after this must not be merged to the one before this. e.g. Play() -> Stop() -> Play() must restart.
+				mergeablePlays.erase( command.id );
+			}
+
+			commands.emplace_back( command );
+			return true;
 		}
 
-		bool Load( int id, std::string fileName, bool isEnableLoop )
+		bool ExecutePlay( int id, std::chrono::steady_clock::time_point now )
 		{
 			size_t handle = GetHandleOrNull( id );
-			if ( handle != NULL ) { return true; }	// already loaded.
+			if ( handle == NULL )
+			{
+				auto pending = pendingSounds.find( id );
+				if ( pending == pendingSounds.end() ) { return false; }
+				if ( pending->second.whilePending != PendingPlay::Queue ) { return false; }
+				// else
+
+				pending->second.wantPlay = true;
+				return true;
+			}
 			// else
 
-			handle = pAudio->Load( fileName.c_str(), isEnableLoop );
+			auto limit = playLimits.find( id );
+			if ( limit != playLimits.end() )
+			{
+				PlayLimit &data = limit->second;
+				if ( data.wasPlayed && now - data.lastPlayed < data.minInterval )
+				{
+					commandStats.rateLimitedCount++;
+					return false;
+				}
+				// else
+
+				data.lastPlayed	= now;
+				data.wasPlayed	= true;
+			}
 
+			return CallBackend( [&]( auto &audio ) { return audio.Play( handle ); } );
+		}
+		bool ExecuteStop( int id, bool isEnableForAll )
+		{
+			size_t handle = GetHandleOrNull( id );
 			if ( handle == NULL )
 			{
+				// Cancel the queued play.
+				auto pending = pendingSounds.find( id );
+				if ( pending == pendingSounds.end() ) { return false; }
+				// else
+
+				const bool wasQueued = pending->second.wantPlay;
+				pending->second.wantPlay = false;
+				return wasQueued;
+			}
+			// else
+			return CallBackend( [&]( auto &audio ) { return audio.Stop( handle, isEnableForAll ); } );
+		}
+		bool ExecuteCommand( const Command &command, std::chrono::steady_clock::time_point now )
+		{
+			using Type = Command::Type;
 
-			#if DEBUG_MODE
+			switch ( command.type )
+			{
+			case Type::Play: return ExecutePlay( command.id, now );
+			case Type::Stop: return ExecuteStop( command.id, command.isEnableForAll );
+			default: break;
+			}
 
-				std::wstring errorMessage = L"[Load Error] ";
-				errorMessage += Donya::MultiToWide( fileName );
-				errorMessage += L"\n";
+			size_t handle = GetHandleOrNull( command.id );
+			if ( handle == NULL ) { return false; }
+			// else
 
-				Donya::OutputDebugStr( errorMessage.c_str() );
+			switch ( command.type )
+			{
+			case Type::Pause:
+				return CallBackend( [&]( auto &audio ) { return audio.Pause( handle, command.isEnableForAll ); } );
+			case Type::Resume:
+				return CallBackend( [&]( auto &audio ) { return audio.Resume( handle, command.isEnableForAll, command.fromTheBeginning ); } );
+			case Type::SetVolume:
+				return CallBackend( [&]( auto &audio ) { return audio.SetVolume( handle, command.volume, command.isEnableForAll ); } );
+			case Type::AppendFadePoint:
+				return CallBackend( [&]( auto &audio ) { return audio.AppendFadePoint( handle, command.seconds, command.volume, command.isEnableForAll ); } );
+			default: break;
+			}
+			return false;
+		}
 
-			#endif // DEBUG_MODE
+		void FlushCommands()
+		{
+			if ( commands.empty() ) { return; }
+			// else
+
+			const auto now = std::chrono::steady_clock::now();
+			for ( const auto &command : commands )
+			{
+				ExecuteCommand( command, now );
+			}
+			commandStats.executedCount += commands.size();
+
+			// The capacity is kept for the next frame.
+			commands.clear();
+			mergeablePlays.clear();
+		}
+
+	#pragma endregion
+
+		void Update()
+		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			InitIfNullptr();
+
+			RegisterLoadedSounds();
+			FlushCommands();
+
+			CallBackend( []( auto &audio ) { audio.Update(); } );
+		}
+
+		bool Load( int id, std::string fileName, bool isEnableLoop, bool isStreaming )
+		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			size_t handle = GetHandleOrNull( id );
+			if ( handle != NULL ) { return true; }	// already loaded.
+			// else
+
+			if ( pendingSounds.find( id ) != pendingSounds.end() )
+			{
+				WaitForLoading();
+				return ( GetHandleOrNull( id ) != NULL );
+			}
+			// else
 
+			handle = CallBackend( [&]( auto &audio ) { return audio.Load( fileName.c_str(), isEnableLoop, isStreaming ); } );
+
+			if ( handle == NULL )
+			{
+				OutputLoadError( fileName );
 				return false;
 			}
 			// else
@@ -93,73 +492,154 @@ namespace Donya
 			return true;
 		}
 
-		bool Play( int id )
+		bool LoadAsync( int id, std::string fileName, bool isEnableLoop, bool isStreaming, PendingPlay whilePending )
 		{
-			// TODO:I want user can specify play mode(ex:loop).
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
 
 			InitIfNullptr();
 
-			size_t handle = GetHandleOrNull( id );
-			if ( handle == NULL ) { return false; }
+			if ( GetHandleOrNull( id ) != NULL ) { return true; }	// already loaded.
+			if ( pendingSounds.find( id ) != pendingSounds.end() ) { return true; }
+			// else
+
+			// Check the file here, so the caller knows the typo soon. The failure of the reading is reported at the registering by Update().
+			if ( !Donya::IsExistFile( fileName ) )
+			{
+				OutputLoadError( fileName );
+				return false;
+			}
 			// else
-			return pAudio->Play( handle );
+
+			// The loading thread prepares by the backend of now, then the Update() registers it to that backend.
+			// The Uninit() waits for the loading threads before releasing the backend.
+			AsyncLoader::Preparer preparer = CallBackend
+			(
+				[&]( auto &audio ) -> AsyncLoader::Preparer
+				{
+					auto *pBackend = &audio;
+					return [pBackend, fileName, isEnableLoop, isStreaming]() -> AsyncLoader::Registerer
+					{
+						using Prepared = decltype( pBackend->Prepare( fileName, isEnableLoop, isStreaming ) );
+						auto pPrepared = std::make_shared<Prepared>( pBackend->Prepare( fileName, isEnableLoop, isStreaming ) );
+						return [pBackend, pPrepared]() { return pBackend->Register( std::move( *pPrepared ) ); };
+					};
+				}
+			);
+
+			PendingSound pending{};
+			pending.fileName		= fileName;
+			pending.whilePending	= whilePending;
+			pendingSounds.insert( std::make_pair( id, std::move( pending ) ) );
+
+			loader.Push( id, std::move( preparer ) );
+			return true;
 		}
 
-		bool Pause( int id, bool isEnableForAll )
+		size_t GetLoadingCount()
 		{
-			InitIfNullptr();
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
 
-			size_t handle = GetHandleOrNull( id );
-			if ( handle == NULL ) { return false; }
-			// else
-			return pAudio->Pause( handle, isEnableForAll );
+			return pendingSounds.size();
 		}
 
-		bool Resume( int id, bool isEnableForAll, bool fromTheBeginning )
+		void WaitForLoading()
 		{
-			InitIfNullptr();
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
 
-			size_t handle = GetHandleOrNull( id );
-			if ( handle == NULL ) { return false; }
+			if ( pendingSounds.empty() ) { return; }
 			// else
-			return pAudio->Resume( handle, isEnableForAll, fromTheBeginning );
+
+			loader.WaitAll();
+			RegisterLoadedSounds();
 		}
 
-		bool Stop( int id, bool isEnableForAll )
+		bool Play( int id )
 		{
-			InitIfNullptr();
+			// TODO:I want user can specify play mode(ex:loop).
 
-			size_t handle = GetHandleOrNull( id );
-			if ( handle == NULL ) { return false; }
-			// else
-			return pAudio->Stop( handle, isEnableForAll );
+			Command command{};
+			command.type	= Command::Type::Play;
+			command.id		= id;
+			return PushCommand( command );
 		}
 
-		bool SetVolume( int id, float volume, bool isEnableForAll )
+		bool Pause( int id, bool isEnableForAll )
 		{
-			InitIfNullptr();
+			Command command{};
+			command.type			= Command::Type::Pause;
+			command.id				= id;
+			command.isEnableForAll	= isEnableForAll;
+			return PushCommand( command );
+		}
 
-			size_t handle = GetHandleOrNull( id );
-			if ( handle == NULL ) { return false; }
-			// else
-			return pAudio->SetVolume( handle, volume, isEnableForAll );
+		bool Resume( int id, bool isEnableForAll, bool fromTheBeginning )
+		{
+			Command command{};
+			command.type				= Command::Type::Resume;
+			command.id					= id;
+			command.isEnableForAll		= isEnableForAll;
+			command.fromTheBeginning	= fromTheBeginning;
+			return PushCommand( command );
+		}
+
+		bool Stop( int id, bool isEnableForAll )
+		{
+			Command command{};
+			command.type			= Command::Type::Stop;
+			command.id				= id;
+			command.isEnableForAll	= isEnableForAll;
+			return PushCommand( command );
+		}
+
+		bool SetVolume( int id, float volume, bool isEnableForAll )
+		{
+			Command command{};
+			command.type			= Command::Type::SetVolume;
+			command.id				= id;
+			command.volume			= volume;
+			command.isEnableForAll	= isEnableForAll;
+			return PushCommand( command );
 		}
 
 		bool AppendFadePoint( int id, float sec, float destVol, bool isEnableForAll )
 		{
-			InitIfNullptr();
+			Command command{};
+			command.type			= Command::Type::AppendFadePoint;
+			command.id				= id;
+			command.seconds			= sec;
+			command.volume			= destVol;
+			command.isEnableForAll	= isEnableForAll;
+			return PushCommand( command );
+		}
 
-			size_t handle = GetHandleOrNull( id );
-			if ( handle == NULL ) { return false; }
+		void SetPlayInterval( int id, float minSeconds )
+		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			if ( minSeconds <= 0.0f )
+			{
+				playLimits.erase( id );
+				return;
+			}
 			// else
-			return pAudio->AppendFadePoint( handle, sec, destVol, isEnableForAll );
+
+			playLimits[id].minInterval = std::chrono::duration<double>( minSeconds );
+		}
+
+		CommandStats GetCommandStats()
+		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
+			return commandStats;
 		}
 
 		int  GetNowPlayingSoundsCount()
 		{
+			std::lock_guard<std::recursive_mutex> enterCS( soundMutex );
+
 			InitIfNullptr();
 
-			return pAudio->GetNowPlayingSoundsCount();
+			return CallBackend( []( auto &audio ) { return audio.GetNowPlayingSoundsCount(); } );
 		}
 	}
 }
\ No newline at end of file
@@ -16,50 +16,82 @@ namespace Donya
 		/// </summary>
 		void Init();
 		/// <summary>
+		/// Use the Donya::SoftwareMixer instead of FMOD. It works without the audio device.<para></para>
+		/// If the "wavOutputPath" is not empty, the mixed sound is written to that file. Else it is discarded.<para></para>
+		/// The loaded sounds are released, so please load these after this.
+		/// </summary>
+		void InitWithSoftwareMixer( unsigned int voiceCount = 32U, const std::string &wavOutputPath = "" );
+		/// <summary>
 		/// Doing release sounds and uninitialize.
 		/// </summary>
 		void Uninit();
 
 		/// <summary>
-		/// Please call every frame.
+		/// Please call every frame.<para></para>
+		/// The requests of Play(), Stop(), etc. in the last frame are executed here in the order.
 		/// </summary>
 		void Update();
 
 		/// <summary>
 		/// The soundIdentifier is became identifier of the sound of another sound function.<para></para>
 		/// Please set relative-path or whole-path to fileName.<para></para>
-		/// If load successed or already loaded, returns true.
+		/// If load successed or already loaded, returns true.<para></para>
+		/// If "isStreaming" is true, the sound is read from the file while playing. Use it for the long sound(e.g. BGM), the startup time and the memory do not grow by the length.
+		/// </summary>
+		bool Load( int soundIdentifier, std::string fileName, bool isEnableLoop, bool isStreaming = false );
+
+		/// <summary>
+		/// How the Play() behaves to the sound that is loading by LoadAsync().
+		/// </summary>
+		enum class PendingPlay
+		{
+			Queue,	// Play it when the loading is finished.
+			Skip,	// Do nothing.
+		};
+		/// <summary>
+		/// Same as Load(), but the file is read by the loading threads, and the sound is usable after the Update() that finds the loading is finished.<para></para>
+		/// The other functions to the loading sound behave as not loaded, except the Play() follows the "whilePending", and the Stop() cancels the queued play.<para></para>
+		/// If the loading is started or the sound is already loaded, returns true. If the file is not found, returns false.<para></para>
+		/// The failure of the reading is output to the debug output at the Update() that finds it.
+		/// </summary>
+		bool LoadAsync( int soundIdentifier, std::string fileName, bool isEnableLoop, bool isStreaming = false, PendingPlay whilePending = PendingPlay::Queue );
+		/// <summary>
+		/// Returns the count of sounds that are loading by LoadAsync(), or loaded but not registered by Update() yet.
+		/// </summary>
+		size_t GetLoadingCount();
+		/// <summary>
+		/// Wait for all loading of LoadAsync(), and register these.
 		/// </summary>
-		bool Load( int soundIdentifier, std::string fileName, bool isEnableLoop );
+		void WaitForLoading();
+
+		// These requests are stored, and executed at the next Update() in the order. So these return true, the failure is not reported.
+		// The Play() of the same sound is merged to one while it is not followed by the other request of that sound in the frame.
 
 		/// <summary>
-		/// If failed play sound, or the identifier is incorrect, returns false.
+		/// The plays that are requested within the interval of SetPlayInterval() are ignored.
 		/// </summary>
 		bool Play( int soundIdentifier );
 		// TODO:I want user can specify play mode(ex:loop).
 
 		/// <summary>
-		/// If you want apply for all, set true to "isEnableForAll".<para></para>
-		/// If failed pause sound, or the identifier is incorrect, returns false.
+		/// If you want apply for all, set true to "isEnableForAll".
 		/// </summary>
 		bool Pause( int soundIdentifier, bool isEnableForAll = false );
 
 		/// <summary>
-		/// If you want apply for all, set true to "isEnableForAll".<para></para>
-		/// If failed resume sound, or the identifier is incorrect, returns false.
+		/// If you want apply for all, set true to "isEnableForAll".
 		/// </summary>
 		bool Resume( int soundIdentifier, bool isEnableForAll = false, bool fromTheBeginning = false );
 
 		/// <summary>
 		/// If you want apply for all, set true to "isEnableForAll".<para></para>
-		/// If failed stop sound, or the identifier is incorrect, returns false.
+		/// If the sound is loading by LoadAsync(), the queued play is canceled.
 		/// </summary>
 		bool Stop( int soundIdentifier, bool isEnableForAll = false );
 
 		/// <summary>
 		/// "The volume level can be below 0 to invert a signal and above 1 to amplify the signal. Note that increasing the signal level too far may cause audible distortion."<para></para>
-		/// If you want apply for all, set true to "isEnableForAll".<para></para>
-		/// If failed setting volume of sound, or the identifier is incorrect, returns false.
+		/// If you want apply for all, set true to "isEnableForAll".
 		/// </summary>
 		bool SetVolume( int soundIdentifier, float volume, bool isEnableForAll = false );
 
@@ -67,13 +99,28 @@ namespace Donya
 		/// Append the fade-point to sound identified by handle.<para></para>
 		/// Take seconds is specified by "takeSeconds".<para></para>
 		/// The volume at destination specified by "destinationVolume".<para></para>
-		/// If you want apply for all, set true to "isEnableForAll".<para></para>
-		/// If failed setting volume of sound, or the identifier is incorrect, returns false.
+		/// If you want apply for all, set true to "isEnableForAll".
 		/// </summary>
 		bool AppendFadePoint( int soundIdentifier, float takeSeconds, float destinationVolume, bool isEnableForAll = false );
 
 		/// <summary>
-		/// If failed count, returns -1.
+		/// Limit the rate of playing the sound. The Play() within "minSeconds" from the last play is ignored.<para></para>
+		/// Use it for the sound that many objects play(e.g. explosion). Zero or less removes the limit.
+		/// </summary>
+		void SetPlayInterval( int soundIdentifier, float minSeconds );
+
+		struct CommandStats
+		{
+			unsigned long long requestedCount{};	// The count of Play(), Stop(), etc.
+			unsigned long long mergedCount{};		// The count of Play() that was merged to the same one in the frame.
+			unsigned long long rateLimitedCount{};	// The count of Play() that was ignored by SetPlayInterval().
+			unsigned long long executedCount{};		// The count of requests that were sent to the audio system.
+		};
+		CommandStats GetCommandStats();
+
+		/// <summary>
+		/// If failed count, returns -1.<para></para>
+		/// The requests that are not executed by Update() yet are not reflected.
 		/// </summary>
 		int  GetNowPlayingSoundsCount();
 	}
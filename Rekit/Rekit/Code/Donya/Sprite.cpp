@@ -1,5 +1,6 @@
 #include "Sprite.h"
 
+#include <algorithm>
 #include <array>
 #include <d3d11.h>
 #include <memory>
@@ -8,11 +9,15 @@
 #include <vector>
 #include <WICTextureLoader.h>
 
+#include "Blend.h"
 #include "Constant.h"
 #include "Direct3DUtil.h"
 #include "Donya.h"
 #include "Random.h"
+#include "RectPacker.h"
+#include "RenderCommand.h"
 #include "Resource.h"
+#include "ResourceBudget.h"
 #include "ScreenShake.h"
 #include "Useful.h"
 
@@ -214,14 +219,12 @@ namespace Donya
 					d3dSamplerDesc
 				);
 
-				Resource::CreateTexture2DFromFile
-				(
-					pDevice,
-					spriteFilename,
-					d3dShaderResourceView.GetAddressOf(),
-					&d3dTexture2DDesc,
-					&d3dSamplerDesc
-				);
+				pTexture = Resource::AcquireTexture2D( pDevice, spriteFilename );
+				if ( pTexture )
+				{
+					d3dShaderResourceView	= pTexture->d3dShaderResourceView;
+					d3dTexture2DDesc		= pTexture->d3dTexture2DDesc;
+				}
 			}
 		}
 		Single::~Single()
@@ -406,6 +409,7 @@ namespace Donya
 				pImmediateContext->OMSetDepthStencilState( d3dDepthStencilState.Get(), 0xffffffff );
 			}
 
+			if ( pTexture ) { pTexture->usage.Touch(); }
 			pImmediateContext->Draw( NDCVertices.size(), 0 );
 
 			// PostProcessing
@@ -562,11 +566,72 @@ namespace Donya
 		}
 
 		Batch::Batch( const std::wstring filename, size_t maxInstancesCount )
-			: MAX_INSTANCES( maxInstancesCount ), reserveCount( NULL ), instances()
+			: INSTANCES_PER_PAGE( ( maxInstancesCount ) ? maxInstancesCount : 1U ),
+			reserveCount( NULL ), bufferCapacity( NULL ), peakInstanceCount( NULL ),
+			fileName( filename ), pAtlas( nullptr ), partPos(), partSize(), instances()
 		{
-			HRESULT hr = S_OK;
 			ID3D11Device *pDevice = ::Donya::GetDevice();
 
+			CreatePipeline( pDevice );
+
+			// Read Texture
+			{
+				D3D11_SAMPLER_DESC d3dSamplerDesc = SpriteSamplerDesc();
+
+				Resource::CreateSamplerState
+				(
+					pDevice,
+					&d3dSamplerState,
+					d3dSamplerDesc
+				);
+
+				// The Agent does not load the same file twice, and the batch owns the texture so the eviction of the batch releases it.
+				Resource::CreateTexture2DFromFile
+				(
+					pDevice,
+					filename,
+					d3dShaderResourceView.GetAddressOf(),
+					&d3dTexture2DDesc,
+					/* isEnableCache = */ false
+				);
+			}
+		}
+		Batch::Batch( ID3D11ShaderResourceView *pAtlasSRV, const D3D11_TEXTURE2D_DESC &atlasDesc, const std::wstring atlasName, size_t maxInstancesCount )
+			: INSTANCES_PER_PAGE( ( maxInstancesCount ) ? maxInstancesCount : 1U ),
+			reserveCount( NULL ), bufferCapacity( NULL ), peakInstanceCount( NULL ),
+			fileName( atlasName ), pAtlas( nullptr ), partPos(), partSize(), instances()
+		{
+			ID3D11Device *pDevice = ::Donya::GetDevice();
+
+			CreatePipeline( pDevice );
+
+			Resource::CreateSamplerState
+			(
+				pDevice,
+				&d3dSamplerState,
+				SpriteSamplerDesc()
+			);
+
+			d3dShaderResourceView	= pAtlasSRV;
+			d3dTexture2DDesc		= atlasDesc;
+		}
+		Batch::Batch( Batch *pAtlas, const std::wstring filename, const Donya::Int2 &partPos, const Donya::Int2 &partSize )
+			: INSTANCES_PER_PAGE( pAtlas->GetInstancesPerPage() ),
+			reserveCount( NULL ), bufferCapacity( NULL ), peakInstanceCount( NULL ),
+			fileName( filename ), pAtlas( pAtlas ), partPos( partPos ), partSize( partSize ), instances()
+		{
+			// The resources are not needed, the atlas has these.
+		}
+		Batch::~Batch()
+		{
+			instances.clear();
+			instances.shrink_to_fit();
+		}
+
+		void Batch::CreatePipeline( ID3D11Device *pDevice )
+		{
+			HRESULT hr = S_OK;
+
 			constexpr std::array<Batch::Vertex, 4> VERTICES =
 			{
 				Batch::Vertex{ XMFLOAT3( 0.0f, 1.0f, 0.0f ), XMFLOAT2{ 0.0f, 1.0f } },
@@ -587,7 +652,7 @@ namespace Donya
 			}
 			// Create Instances and InstanceBuffer
 			{
-				instances.resize( MAX_INSTANCES );
+				instances.resize( INSTANCES_PER_PAGE );
 
 				hr = ::Donya::CreateVertexBuffer<Batch::Instance>
 				(
@@ -596,6 +661,8 @@ namespace Donya
 					d3dInstanceBuffer.GetAddressOf()
 				);
 				_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : Create vertex-buffer()" );
+
+				bufferCapacity = ( SUCCEEDED( hr ) ) ? instances.size() : NULL;
 			}
 			// Create VertexShader and InputLayout
 			{
@@ -648,40 +715,15 @@ namespace Donya
 				hr = pDevice->CreateDepthStencilState( &d3dDepthStencilDesc, d3dDepthStencilState.GetAddressOf() );
 				_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : CreateDepthStencilState" );
 			}
-			// Read Texture
-			{
-				D3D11_SAMPLER_DESC d3dSamplerDesc = SpriteSamplerDesc();
-
-				Resource::CreateSamplerState
-				(
-					pDevice,
-					&d3dSamplerState,
-					d3dSamplerDesc
-				);
-
-				Resource::CreateTexture2DFromFile
-				(
-					pDevice,
-					filename,
-					d3dShaderResourceView.GetAddressOf(),
-					&d3dTexture2DDesc,
-					&d3dSamplerDesc
-				);
-			}
-		}
-		Batch::~Batch()
-		{
-			instances.clear();
-			instances.shrink_to_fit();
 		}
 
 		int Batch::GetTextureWidth() const
 		{
-			return d3dTexture2DDesc.Width;
+			return ( pAtlas ) ? partSize.x : scast<int>( d3dTexture2DDesc.Width );
 		}
 		int Batch::GetTextureHeight() const
 		{
-			return d3dTexture2DDesc.Height;
+			return ( pAtlas ) ? partSize.y : scast<int>( d3dTexture2DDesc.Height );
 		}
 		float Batch::GetTextureWidthF() const
 		{
@@ -991,7 +1033,25 @@ namespace Donya
 		}
 		bool Batch::ReserveGeneralExt( float scrX, float scrY, float scrW, float scrH, float texX, float texY, float texW, float texH, float scaleX, float scaleY, float degree, DirectX::XMFLOAT2 center, float alpha, float R, float G, float B )
 		{
-			if ( MAX_INSTANCES <= reserveCount ) { return false; }
+			if ( pAtlas )
+			{
+				// The "center" is already calculated by the size of the part, so use as is.
+				return pAtlas->ReserveGeneralExt
+				(
+					scrX, scrY, scrW, scrH,
+					texX + scast<float>( partPos.x ), texY + scast<float>( partPos.y ), texW, texH,
+					scaleX, scaleY,
+					degree, center,
+					alpha, R, G, B
+				);
+			}
+			// else
+
+			if ( instances.size() <= reserveCount )
+			{
+				if ( !AppendPage() ) { return false; }
+			}
+			// else
 
 			// Set rotation center to origin.
 			// If don't set, origin is fixed to left-top.
@@ -1045,11 +1105,234 @@ namespace Donya
 		}
 	#pragma endregion
 
+	#pragma region Bulk
+
+		// The members are loaded by four floats.
+		static_assert( sizeof( Batch::ReserveDesc ) == sizeof( float ) * 17, "The layout of Batch::ReserveDesc is changed." );
+
+		size_t Batch::ReserveBulk( const ReserveDesc *pDescs, size_t count )
+		{
+			if ( !pDescs || !count ) { return NULL; }
+			// else
+
+			if ( pAtlas )
+			{
+				return pAtlas->ReserveBulkWithOffset( pDescs, count, scast<float>( partPos.x ), scast<float>( partPos.y ) );
+			}
+			// else
+			return ReserveBulkWithOffset( pDescs, count, 0.0f, 0.0f );
+		}
+		size_t Batch::ReserveBulkWithOffset( const ReserveDesc *pDescs, size_t count, float texOffsetX, float texOffsetY )
+		{
+			while ( instances.size() < reserveCount + count )
+			{
+				if ( !AppendPage() ) { break; }
+			}
+			count = std::min( count, instances.size() - reserveCount );
+			if ( !count ) { return NULL; }
+			// else
+
+			// These are same in all sprites, so calculate only once.
+
+			float shakeX = 0.0f;
+			float shakeY = 0.0f;
+			if ( ::Donya::ScreenShake::GetEnableState() )
+			{
+				shakeX = ::Donya::ScreenShake::GetX();
+				shakeY = ::Donya::ScreenShake::GetY();
+			}
+
+			// Same as Donya::Color::FilteringAlpha().
+			const bool  isEnabledATC = ::Donya::Blend::IsEnabledATC();
+			const float alphaScale	 = ( isEnabledATC ) ? 0.5f : 1.0f;
+			const float alphaBias	 = ( isEnabledATC ) ? 0.5f : 0.0f;
+
+			const XMVECTOR vW			= XMVectorReplicate(  2.0f / ::Donya::Private::RegisteredScreenWidthF()  );
+			const XMVECTOR vH			= XMVectorReplicate( -2.0f / ::Donya::Private::RegisteredScreenHeightF() );
+			const XMVECTOR vOne			= XMVectorReplicate( 1.0f );
+			const XMVECTOR vToRadian	= XMVectorReplicate( ToRadian( 1.0f ) );
+			const XMVECTOR vShakeX		= XMVectorReplicate( shakeX );
+			const XMVECTOR vShakeY		= XMVectorReplicate( shakeY );
+			const XMVECTOR vTexOffsetX	= XMVectorReplicate( texOffsetX );
+			const XMVECTOR vTexOffsetY	= XMVectorReplicate( texOffsetY );
+			const XMVECTOR vInvTexW		= XMVectorReplicate( 1.0f / GetTextureWidthF()  );
+			const XMVECTOR vInvTexH		= XMVectorReplicate( 1.0f / GetTextureHeightF() );
+			const XMVECTOR vAlphaScale	= XMVectorReplicate( alphaScale );
+			const XMVECTOR vAlphaBias	= XMVectorReplicate( alphaBias  );
+			const XMFLOAT4 row3{ 0.0f, 0.0f, 0.0f, GetDrawDepth() };
+			const XMFLOAT4 row4{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+			constexpr size_t LANE_COUNT = 4U;
+			ReserveDesc tail[LANE_COUNT]{};	// Use when the remaining count is less than LANE_COUNT.
+			for ( size_t i = 0; i < count; i += LANE_COUNT )
+			{
+				const size_t laneCount = std::min( LANE_COUNT, count - i );
+				const ReserveDesc *pLanes = pDescs + i;
+				if ( laneCount < LANE_COUNT )
+				{
+					std::copy( pLanes, pLanes + laneCount, tail );
+					pLanes = tail;
+				}
+
+				// Transpose the four sprites to the SoA, e.g. "screen.r[0]" has the screenX of each sprite.
+				auto LoadLanes = [&pLanes]( const float ReserveDesc::*pFirst )
+				{
+					return XMMatrixTranspose
+					(
+						XMMATRIX
+						(
+							XMLoadFloat4( reinterpret_cast<const XMFLOAT4 *>( &( pLanes[0].*pFirst ) ) ),
+							XMLoadFloat4( reinterpret_cast<const XMFLOAT4 *>( &( pLanes[1].*pFirst ) ) ),
+							XMLoadFloat4( reinterpret_cast<const XMFLOAT4 *>( &( pLanes[2].*pFirst ) ) ),
+							XMLoadFloat4( reinterpret_cast<const XMFLOAT4 *>( &( pLanes[3].*pFirst ) ) )
+						)
+					);
+				};
+				const XMMATRIX screen		= LoadLanes( &ReserveDesc::screenX	);
+				const XMMATRIX texture		= LoadLanes( &ReserveDesc::textureX	);
+				const XMMATRIX centerScale	= LoadLanes( &ReserveDesc::centerX	);
+				const XMMATRIX color		= LoadLanes( &ReserveDesc::R		);
+				const XMVECTOR degree		= XMVectorSet( pLanes[0].degree, pLanes[1].degree, pLanes[2].degree, pLanes[3].degree );
+
+				XMVECTOR sin, cos;
+				XMVectorSinCos( &sin, &cos, XMVectorMultiply( degree, vToRadian ) );
+
+				const XMVECTOR rotX = centerScale.r[0];
+				const XMVECTOR rotY = centerScale.r[1];
+				const XMVECTOR scrX = XMVectorSubtract( XMVectorSubtract( screen.r[0], rotX ), vShakeX );
+				const XMVECTOR scrY = XMVectorSubtract( XMVectorSubtract( screen.r[1], rotY ), vShakeY );
+				const XMVECTOR scrW = XMVectorMultiply( screen.r[2], centerScale.r[2] );
+				const XMVECTOR scrH = XMVectorMultiply( screen.r[3], centerScale.r[3] );
+
+				// Same as MakeMatrixNDCTransform().
+				const XMVECTOR m11 = XMVectorMultiply( XMVectorMultiply( vW, scrW ), cos );
+				const XMVECTOR m21 = XMVectorMultiply( XMVectorMultiply( vH, scrW ), sin );
+				const XMVECTOR m12 = XMVectorNegate  ( XMVectorMultiply( XMVectorMultiply( vW, scrH ), sin ) );
+				const XMVECTOR m22 = XMVectorMultiply( XMVectorMultiply( vH, scrH ), cos );
+				// w * ( ( -rotX * cos ) + ( -rotY * -sin ) + rotX + scrX ) - 1.0f
+				XMVECTOR m14 = XMVectorAdd( XMVectorSubtract( XMVectorMultiply( rotY, sin ), XMVectorMultiply( rotX, cos ) ), XMVectorAdd( rotX, scrX ) );
+				m14 = XMVectorSubtract( XMVectorMultiply( vW, m14 ), vOne );
+				// h * ( ( -rotX * sin ) + ( -rotY *  cos ) + rotY + scrY ) + 1.0f
+				XMVECTOR m24 = XMVectorSubtract( XMVectorAdd( rotY, scrY ), XMVectorAdd( XMVectorMultiply( rotX, sin ), XMVectorMultiply( rotY, cos ) ) );
+				m24 = XMVectorAdd( XMVectorMultiply( vH, m24 ), vOne );
+
+				// Transpose to per sprite, e.g. "row1.r[0]" is the first row of the first sprite.
+				const XMMATRIX row1 = XMMatrixTranspose( XMMATRIX( m11, m12, XMVectorZero(), m14 ) );
+				const XMMATRIX row2 = XMMatrixTranspose( XMMATRIX( m21, m22, XMVectorZero(), m24 ) );
+				const XMMATRIX texCoord = XMMatrixTranspose
+				(
+					XMMATRIX
+					(
+						XMVectorMultiply( XMVectorAdd( texture.r[0], vTexOffsetX ), vInvTexW ),
+						XMVectorMultiply( XMVectorAdd( texture.r[1], vTexOffsetY ), vInvTexH ),
+						XMVectorMultiply( texture.r[2], vInvTexW ),
+						XMVectorMultiply( texture.r[3], vInvTexH )
+					)
+				);
+				const XMMATRIX filteredColor = XMMatrixTranspose
+				(
+					XMMATRIX
+					(
+						color.r[0],
+						color.r[1],
+						color.r[2],
+						XMVectorMultiplyAdd( color.r[3], vAlphaScale, vAlphaBias )
+					)
+				);
+
+				for ( size_t lane = 0; lane < laneCount; ++lane )
+				{
+					Instance &dest = instances[reserveCount + lane];
+					XMStoreFloat4( &dest.color, filteredColor.r[lane] );
+					XMStoreFloat4( reinterpret_cast<XMFLOAT4 *>( dest.NDCTransform.m[0] ), row1.r[lane] );
+					XMStoreFloat4( reinterpret_cast<XMFLOAT4 *>( dest.NDCTransform.m[1] ), row2.r[lane] );
+					XMStoreFloat4( reinterpret_cast<XMFLOAT4 *>( dest.NDCTransform.m[2] ), XMLoadFloat4( &row3 ) );
+					XMStoreFloat4( reinterpret_cast<XMFLOAT4 *>( dest.NDCTransform.m[3] ), XMLoadFloat4( &row4 ) );
+					XMStoreFloat4( &dest.texCoordTransform, texCoord.r[lane] );
+				}
+				reserveCount += laneCount;
+			}
+
+			return count;
+		}
+
+	#pragma endregion
+
+		bool Batch::AppendPage()
+		{
+			if ( MAX_PAGE_COUNT <= GetPageCount() ) { return false; }
+			// else
+
+			// The instance-buffer will be re-created at Render().
+			instances.resize( instances.size() + INSTANCES_PER_PAGE );
+			return true;
+		}
+		bool Batch::ReserveInstanceBuffer( size_t instanceCount )
+		{
+			if ( instanceCount <= bufferCapacity ) { return true; }
+			// else
+
+			// Fit to the all pages, so the buffer is re-created only when a page was appended.
+			HRESULT hr = ::Donya::CreateVertexBuffer<Batch::Instance>
+			(
+				::Donya::GetDevice(), instances,
+				D3D11_USAGE_DYNAMIC, D3D11_CPU_ACCESS_WRITE,
+				d3dInstanceBuffer.ReleaseAndGetAddressOf()
+			);
+			if ( FAILED( hr ) )
+			{
+				_ASSERT_EXPR( 0, L"Failed : Create vertex-buffer()" );
+				bufferCapacity = NULL;
+				return false;
+			}
+			// else
+
+			bufferCapacity = instances.size();
+			return true;
+		}
+
 		void Batch::Render()
 		{
+			if ( pAtlas )
+			{
+				pAtlas->Render();
+				return;
+			}
+			// else
+
 			if ( !reserveCount ) { return; }
 			// else
 
+			peakInstanceCount = std::max( peakInstanceCount, reserveCount );
+
+			if ( Donya::RenderCommand::IsRecording() )
+			{
+				// The instances are overwritten by the next reserves, so the command has a copy.
+				RecordedInstances draw{};
+				draw.pBatch		= this;
+				draw.pInstances	= Donya::RenderCommand::MakePayload( instances.data(), reserveCount );
+
+				// The texture may have the alpha, so the sprites keep the painter's order.
+				Donya::RenderCommand::Record( Donya::RenderCommand::Make( Donya::RenderCommand::Type::SpriteBatch, this, 0U, scast<unsigned int>( reserveCount ), Donya::Vector4x4{}, Donya::Vector4{ 1.0f, 1.0f, 1.0f, 1.0f }, Donya::RenderCommand::DRAW_TRANSLUCENT, &Batch::Replay, Donya::RenderCommand::MakePayload( &draw ) ) );
+			}
+			else
+			{
+				Draw( instances.data(), reserveCount );
+			}
+
+			// The instances are kept for the next frame, these will be overwritten by the reserves.
+			reserveCount = 0;
+		}
+		void Batch::Replay( const Donya::RenderCommand::Command &command )
+		{
+			const RecordedInstances *pDraw = scast<const RecordedInstances *>( command.pPayload );
+			pDraw->pBatch->Draw( pDraw->pInstances, command.instanceCount );
+		}
+		void Batch::Draw( const Instance *pInstances, size_t instanceCount )
+		{
+			if ( !ReserveInstanceBuffer( instanceCount ) ) { return; }
+			// else
+
 			HRESULT hr = S_OK;
 			ID3D11DeviceContext *pImmediateContext = ::Donya::GetImmediateContext();
 
@@ -1060,7 +1343,7 @@ namespace Donya
 				hr = pImmediateContext->Map( d3dInstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &d3d11MappedSubresource );
 				_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : Map()" );
 
-				memcpy( d3d11MappedSubresource.pData, instances.data(), sizeof( Instance ) * reserveCount );
+				memcpy( d3d11MappedSubresource.pData, pInstances, sizeof( Instance ) * instanceCount );
 
 				pImmediateContext->Unmap( d3dInstanceBuffer.Get(), 0 );
 			}
@@ -1110,15 +1393,10 @@ namespace Donya
 				pImmediateContext->OMSetDepthStencilState( d3dDepthStencilState.Get(), 0xffffffff );
 			}
 
-			pImmediateContext->DrawInstanced( 4, reserveCount, 0, 0 );
+			pImmediateContext->DrawInstanced( 4, scast<UINT>( instanceCount ), 0, 0 );
 
 			// PostProcessing
 			{
-				reserveCount = 0;
-
-				instances.clear();
-				instances.resize( MAX_INSTANCES );
-
 				ID3D11ShaderResourceView *NullSRV = nullptr;
 
 				pImmediateContext->IASetInputLayout( 0 );
@@ -1850,6 +2128,32 @@ namespace Donya
 
 	#pragma region Agent
 
+		struct Agent;
+
+		/// <summary>
+		/// Evict the own batches of the Agent that are not drawn recently. The parts of atlases are not evicted.
+		/// </summary>
+		class SpritePool : public ResourceBudget::Pool
+		{
+		private:
+			Agent *pAgent;
+		public:
+			SpritePool( Agent *pAgent ) : pAgent( pAgent )
+			{
+				ResourceBudget::RegisterPool( this );
+			}
+			~SpritePool()
+			{
+				ResourceBudget::UnregisterPool( this );
+			}
+			SpritePool( const SpritePool & ) = delete;
+			SpritePool &operator = ( const SpritePool & ) = delete;
+		public:
+			ResourceBudget::Category GetCategory() const override { return ResourceBudget::Category::Sprite; }
+			void CollectUnused( std::vector<Candidate> *pOutput ) override;
+			size_t Evict( unsigned long long id ) override;
+		};
+
 		struct Agent
 		{
 			// Note: container's type isn't need std::unique_ptr, but Sprite::Batch can not copy, so I wrapped by pointer.
@@ -1863,26 +2167,120 @@ namespace Donya
 
 			std::unordered_map<size_t, std::unique_ptr<Sprite::Batch>> pSprites;
 
+			// The parts in "pSprites" refer these, so these must be released after the "pSprites".
+			std::vector<std::unique_ptr<Sprite::Batch>> pAtlases;
+
+			// Used between BeginAtlas() and EndAtlas().
+			struct AtlasRequest
+			{
+				bool	nowBuilding{ false };
+				int		width{};
+				int		height{};
+				size_t	maxInstancesCount{};
+				std::vector<std::pair<size_t, std::wstring>> pendings;	// Identifier, file name.
+			};
+			AtlasRequest atlasRequest;
+
+			// Use for reloading the evicted batch. Only the own batches are registered.
+			struct Usage
+			{
+				std::wstring		fileName{};
+				size_t				maxInstancesCount{};
+				unsigned long long	lastUsedTick{};
+				size_t				byteSize{};		// Zero while evicted.
+			};
+			std::unordered_map<size_t, Usage> usages;
+			size_t atlasBytes;
+
 			bool nowBatchingPrimitive;	// Used to associate Rect and Batch.
+
+			// Declare at last, so it is unregistered before the batches are released.
+			SpritePool pool;
 		public:
 			Agent( unsigned int maxInstanceCntOfPrim, unsigned int vertexCntOfCirclePerQuad ) :
 				lastReservedIdentifier( NULL ),
 				pRect( std::make_unique<Sprite::Rect>( maxInstanceCntOfPrim ) ),
 				pCircle( std::make_unique<Sprite::Circle>( vertexCntOfCirclePerQuad, maxInstanceCntOfPrim ) ),
-				ppDrawList(), pSprites(),
-				nowBatchingPrimitive( false )
+				ppDrawList(), pSprites(), pAtlases(), atlasRequest(),
+				usages(), atlasBytes( 0 ),
+				nowBatchingPrimitive( false ),
+				pool( this )
 			{
 			
 			}
 			~Agent()
 			{
+				for ( const auto &it : usages )
+				{
+					if ( !it.second.byteSize ) { continue; }
+					// else
+					ResourceBudget::AddResident( ResourceBudget::Category::Sprite, -scast<long long>( it.second.byteSize ), -1 );
+				}
+				ResourceBudget::AddResident( ResourceBudget::Category::Sprite, -scast<long long>( atlasBytes ), -scast<int>( pAtlases.size() ) );
+
 				pRect.reset( nullptr );
 				ppDrawList.clear();
 				pSprites.clear();
+				pAtlases.clear();
 			}
 		};
 		static std::unique_ptr<Agent> pAgent;
 
+		void SpritePool::CollectUnused( std::vector<Candidate> *pOutput )
+		{
+			// The draw list refers the batches.
+			if ( !pAgent->ppDrawList.empty() ) { return; }
+			// else
+
+			for ( const auto &it : pAgent->usages )
+			{
+				if ( !it.second.byteSize ) { continue; }
+				// else
+
+				Candidate candidate{};
+				candidate.lastUsedTick	= it.second.lastUsedTick;
+				candidate.byteSize		= it.second.byteSize;
+				candidate.id			= it.first;
+				pOutput->emplace_back( candidate );
+			}
+		}
+		size_t SpritePool::Evict( unsigned long long id )
+		{
+			if ( !pAgent->ppDrawList.empty() ) { return 0; }
+			// else
+
+			auto usage  = pAgent->usages.find( scast<size_t>( id ) );
+			auto sprite = pAgent->pSprites.find( scast<size_t>( id ) );
+			if ( usage == pAgent->usages.end() || sprite == pAgent->pSprites.end() ) { return 0; }
+			if ( !sprite->second ) { return 0; }
+			// else
+
+			// Keep the element, so the identifier is still valid and the batch is loaded again at the next use.
+			sprite->second.reset();
+
+			const size_t byteSize = usage->second.byteSize;
+			usage->second.byteSize = 0;
+			ResourceBudget::AddResident( ResourceBudget::Category::Sprite, -scast<long long>( byteSize ), -1 );
+			return byteSize;
+		}
+
+		/// <summary>
+		/// Create the own batch of the "spriteIdentifier", and count it to the budget.
+		/// </summary>
+		std::unique_ptr<Sprite::Batch> LoadOwnBatch( size_t spriteIdentifier, const std::wstring &spriteFileName, size_t maxInstancesCount )
+		{
+			auto pBatch = std::make_unique<Sprite::Batch>( spriteFileName, maxInstancesCount );
+
+			Agent::Usage &usage		= pAgent->usages[spriteIdentifier];
+			usage.fileName			= spriteFileName;
+			usage.maxInstancesCount	= maxInstancesCount;
+			usage.lastUsedTick		= ResourceBudget::GetTick();
+			usage.byteSize			= Resource::CalcTexture2DBytes( pBatch->GetTextureDesc() );	// Contains the mip chain and the block compression.
+			ResourceBudget::AddResident( ResourceBudget::Category::Sprite, scast<long long>( usage.byteSize ), 1 );
+
+			return pBatch;
+		}
+
 		void Init( unsigned int maxInstanceCntOfPrim, unsigned int vertexCntOfCirclePerQuad )
 		{
 			pAgent = std::make_unique<Agent>( maxInstanceCntOfPrim, vertexCntOfCirclePerQuad );
@@ -1927,13 +2325,35 @@ namespace Donya
 				}
 			}
 
+			// The sprite will be loaded at EndAtlas().
+			if ( pAgent->atlasRequest.nowBuilding )
+			{
+				auto &pendings = pAgent->atlasRequest.pendings;
+				const auto found = std::find_if
+				(
+					pendings.begin(), pendings.end(),
+					[&hash]( const std::pair<size_t, std::wstring> &element )
+					{
+						return ( element.first == hash ) ? true : false;
+					}
+				);
+				if ( found == pendings.end() )
+				{
+					pendings.emplace_back( std::make_pair( hash, spriteFileName ) );
+				}
+
+				return hash;
+			}
+			// else
+
 			pAgent->pSprites.insert
 			(
 				std::make_pair
 				(
 					hash,
-					std::make_unique<Sprite::Batch>
+					LoadOwnBatch
 					(
+						hash,
 						spriteFileName,
 						maxInstancesCount
 					)
@@ -1943,8 +2363,259 @@ namespace Donya
 			return hash;
 		}
 
+		void BeginAtlas( int atlasWidth, int atlasHeight, size_t maxInstancesCount )
+		{
+			if ( AssertIfNotInitialized() ) { return; }
+			// else
+
+			auto &request = pAgent->atlasRequest;
+			if ( request.nowBuilding )
+			{
+				_ASSERT_EXPR( 0, L"Error : BeginAtlas() was called twice without EndAtlas()." );
+				return;
+			}
+			// else
+
+			request.nowBuilding			= true;
+			request.width				= atlasWidth;
+			request.height				= atlasHeight;
+			request.maxInstancesCount	= maxInstancesCount;
+			request.pendings.clear();
+		}
+
+		bool IsBlockCompressed( DXGI_FORMAT format )
+		{
+			if ( DXGI_FORMAT_BC1_TYPELESS	<= format && format <= DXGI_FORMAT_BC5_SNORM		) { return true; }
+			if ( DXGI_FORMAT_BC6H_TYPELESS	<= format && format <= DXGI_FORMAT_BC7_UNORM_SRGB	) { return true; }
+			// else
+			return false;
+		}
+
+		/// <summary>
+		/// Returns the smallest power of two that is greater than or equal to the "value".
+		/// </summary>
+		int CeilPowerOfTwo( int value )
+		{
+			int result = 1;
+			while ( result < value ) { result <<= 1; }
+			return result;
+		}
+
+		/// <summary>
+		/// Pack the "sources" into the atlases, and register the parts of these to the "pSprites".<para></para>
+		/// Returns the count of packed sources.
+		/// </summary>
+		size_t BuildAtlases( const std::vector<std::pair<size_t, std::wstring>> &sources, int atlasWidth, int atlasHeight, size_t maxInstancesCount )
+		{
+			constexpr int PADDING = 2; // Prevent the bleeding of the neighbor part.
+
+			struct Source
+			{
+				size_t												identifier{};
+				std::wstring										fileName{};
+				Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	srv{};
+				D3D11_TEXTURE2D_DESC								desc{};
+				bool												packed{};
+			};
+
+			ID3D11Device		*pDevice			= ::Donya::GetDevice();
+			ID3D11DeviceContext	*pImmediateContext	= ::Donya::GetImmediateContext();
+
+			std::vector<Source> loadedSources{};
+			for ( const auto &it : sources )
+			{
+				Source source{};
+				source.identifier	= it.first;
+				source.fileName		= it.second;
+
+				// Do not cache, these are only used for the copy.
+				const bool succeeded = Resource::CreateTexture2DFromFile( pDevice, source.fileName, source.srv.GetAddressOf(), &source.desc, /* isEnableCache = */ false );
+				if ( !succeeded ) { continue; }
+				// else
+
+				loadedSources.emplace_back( std::move( source ) );
+			}
+
+			size_t packedCount = 0;
+			bool   packedAtLast = true;
+			while ( packedAtLast )
+			{
+				packedAtLast = false;
+
+				// Gather the remaining sources that can be copied to the same texture.
+				std::vector<size_t>					indices{};
+				std::vector<RectPacker::Rect>		rects{};
+				DXGI_FORMAT							format = DXGI_FORMAT_UNKNOWN;
+				for ( size_t i = 0; i < loadedSources.size(); ++i )
+				{
+					const Source &source = loadedSources[i];
+					if ( source.packed ) { continue; }
+					if ( source.desc.ArraySize != 1 || source.desc.SampleDesc.Count != 1 ) { continue; }
+					if ( IsBlockCompressed( source.desc.Format ) ) { continue; } // The copy of these must be aligned by the block.
+					// else
+
+					if ( format == DXGI_FORMAT_UNKNOWN ) { format = source.desc.Format; }
+					if ( format != source.desc.Format ) { continue; }
+					// else
+
+					RectPacker::Rect rect{};
+					rect.width	= scast<int>( source.desc.Width  );
+					rect.height	= scast<int>( source.desc.Height );
+
+					indices.emplace_back( i );
+					rects.emplace_back( rect );
+				}
+
+				RectPacker packer{ atlasWidth, atlasHeight, PADDING };
+				const size_t currentPackedCount = packer.InsertAll( rects.data(), rects.size() );
+				// An atlas of one sprite is meaningless.
+				if ( currentPackedCount < 2U ) { break; }
+				// else
+
+				// The packer fills from the left-top, so the atlas can be shrunk to the packed parts.
+				// The power of two size is kept for the friendliness to the hardware, and the remaining sources go to the next atlas.
+				int usedWidth  = 1;
+				int usedHeight = 1;
+				for ( const auto &rect : rects )
+				{
+					if ( !rect.packed ) { continue; }
+					// else
+					usedWidth  = std::max( usedWidth,  rect.x + rect.width  + PADDING );
+					usedHeight = std::max( usedHeight, rect.y + rect.height + PADDING );
+				}
+				const int textureWidth  = std::min( atlasWidth,  CeilPowerOfTwo( usedWidth  ) );
+				const int textureHeight = std::min( atlasHeight, CeilPowerOfTwo( usedHeight ) );
+
+				D3D11_TEXTURE2D_DESC atlasDesc{};
+				atlasDesc.Width					= scast<UINT>( textureWidth  );
+				atlasDesc.Height				= scast<UINT>( textureHeight );
+				atlasDesc.MipLevels				= 1;
+				atlasDesc.ArraySize				= 1;
+				atlasDesc.Format				= format;
+				atlasDesc.SampleDesc.Count		= 1;
+				atlasDesc.SampleDesc.Quality	= 0;
+				atlasDesc.Usage					= D3D11_USAGE_DEFAULT;
+				atlasDesc.BindFlags				= D3D11_BIND_SHADER_RESOURCE;
+				atlasDesc.CPUAccessFlags		= 0;
+				atlasDesc.MiscFlags				= 0;
+
+				// The contents of a texture that is created without the initial data are undefined,
+				// so clear the padding and the unused space to the transparent black, because the neighbor of a part may be sampled.
+				const size_t atlasBytes = Resource::CalcTexture2DBytes( atlasDesc );
+				std::vector<unsigned char> clearTexels( atlasBytes, 0U );
+				D3D11_SUBRESOURCE_DATA initialData{};
+				initialData.pSysMem				= clearTexels.data();
+				initialData.SysMemPitch			= scast<UINT>( atlasBytes / atlasDesc.Height );
+				initialData.SysMemSlicePitch	= 0;
+
+				Microsoft::WRL::ComPtr<ID3D11Texture2D>				atlasTexture{};
+				Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	atlasSRV{};
+				HRESULT hr = pDevice->CreateTexture2D( &atlasDesc, &initialData, atlasTexture.GetAddressOf() );
+				if ( SUCCEEDED( hr ) )
+				{
+					hr = pDevice->CreateShaderResourceView( atlasTexture.Get(), nullptr, atlasSRV.GetAddressOf() );
+				}
+				if ( FAILED( hr ) )
+				{
+					_ASSERT_EXPR( 0, L"Failed : Create the atlas texture." );
+					break;
+				}
+				// else
+
+				const std::wstring atlasName = L"Atlas" + std::to_wstring( pAgent->pAtlases.size() );
+				pAgent->pAtlases.emplace_back( std::make_unique<Sprite::Batch>( atlasSRV.Get(), atlasDesc, atlasName, maxInstancesCount ) );
+				Sprite::Batch *pAtlas = pAgent->pAtlases.back().get();
+
+				// The atlases are not evicted, but counted for the budget.
+				pAgent->atlasBytes += atlasBytes;
+				ResourceBudget::AddResident( ResourceBudget::Category::Sprite, scast<long long>( atlasBytes ), 1 );
+
+				for ( size_t i = 0; i < rects.size(); ++i )
+				{
+					const RectPacker::Rect &rect = rects[i];
+					if ( !rect.packed ) { continue; }
+					// else
+
+					Source &source = loadedSources[indices[i]];
+
+					Microsoft::WRL::ComPtr<ID3D11Resource> sourceResource{};
+					source.srv->GetResource( sourceResource.GetAddressOf() );
+
+					// Copy only the top mip level.
+					const D3D11_BOX box{ 0, 0, 0, source.desc.Width, source.desc.Height, 1 };
+					pImmediateContext->CopySubresourceRegion
+					(
+						atlasTexture.Get(), 0,
+						scast<UINT>( rect.x ), scast<UINT>( rect.y ), 0,
+						sourceResource.Get(), 0,
+						&box
+					);
+
+					pAgent->pSprites.insert
+					(
+						std::make_pair
+						(
+							source.identifier,
+							std::make_unique<Sprite::Batch>
+							(
+								pAtlas, source.fileName,
+								Donya::Int2{ rect.x, rect.y },
+								Donya::Int2{ rect.width, rect.height }
+							)
+						)
+					);
+
+					source.packed = true;
+				}
+
+				packedCount += currentPackedCount;
+				packedAtLast = true;
+			}
+
+			return packedCount;
+		}
+
+		size_t EndAtlas()
+		{
+			if ( AssertIfNotInitialized() ) { return NULL; }
+			// else
+
+			auto &request = pAgent->atlasRequest;
+			if ( !request.nowBuilding ) { return NULL; }
+			// else
+
+			request.nowBuilding = false;
+
+			const size_t packedCount = BuildAtlases( request.pendings, request.width, request.height, request.maxInstancesCount );
+
+			// Load the remaining as an own batch.
+			for ( const auto &it : request.pendings )
+			{
+				if ( pAgent->pSprites.find( it.first ) != pAgent->pSprites.end() ) { continue; }
+				// else
+
+				pAgent->pSprites.insert
+				(
+					std::make_pair
+					(
+						it.first,
+						LoadOwnBatch
+						(
+							it.first,
+							it.second,
+							request.maxInstancesCount
+						)
+					)
+				);
+			}
+
+			request.pendings.clear();
+			return packedCount;
+		}
+
 		/// <summary>
-		/// If this function returns valid iterator, that iterator is guarantee to valid.
+		/// If this function returns valid iterator, that iterator is guarantee to valid.<para></para>
+		/// The evicted batch is loaded again in here.
 		/// </summary>
 		decltype( pAgent->pSprites )::iterator FindSpriteOrEnd( size_t spriteIdentifier )
 		{
@@ -1952,7 +2623,24 @@ namespace Donya
 			if ( spriteIdentifier == NULL ) { return pAgent->pSprites.end(); }
 			// else
 
-			return pAgent->pSprites.find( spriteIdentifier );
+			auto found = pAgent->pSprites.find( spriteIdentifier );
+			if ( found == pAgent->pSprites.end() ) { return found; }
+			// else
+
+			auto usage = pAgent->usages.find( spriteIdentifier );
+			if ( usage == pAgent->usages.end() ) { return found; }	// It is a part of atlas.
+			// else
+
+			if ( !found->second )
+			{
+				found->second = LoadOwnBatch( spriteIdentifier, usage->second.fileName, usage->second.maxInstancesCount );
+			}
+			else
+			{
+				usage->second.lastUsedTick = ResourceBudget::GetTick();
+			}
+
+			return found;
 		}
 
 	#pragma region GetTextureSizes
@@ -2010,6 +2698,23 @@ namespace Donya
 
 	#pragma endregion
 
+		size_t GetPeakInstanceCount( size_t spriteIdentifier )
+		{
+			auto it = FindSpriteOrEnd( spriteIdentifier );
+			if ( it == pAgent->pSprites.end() ) { return NULL; }
+			// else
+
+			return it->second->GetPeakInstanceCount();
+		}
+		size_t GetPageCount( size_t spriteIdentifier )
+		{
+			auto it = FindSpriteOrEnd( spriteIdentifier );
+			if ( it == pAgent->pSprites.end() ) { return NULL; }
+			// else
+
+			return it->second->GetPageCount();
+		}
+
 	#pragma region Draw Functions
 
 		/*
@@ -2044,6 +2749,27 @@ namespace Donya
 			FlushBatch();
 			pAgent->nowBatchingPrimitive = true;
 		}
+		/// <summary>
+		/// Render the last batch if the drawing sprite is changed. But the parts of the same atlas are merged, so that is not rendered.
+		/// </summary>
+		void SwitchBatchIfChanged( size_t sprId, std::unique_ptr<Sprite::Batch> *ppSprite )
+		{
+			if ( pAgent->lastReservedIdentifier == sprId ) { return; }
+			// else
+
+			if ( pAgent->lastReservedIdentifier != NULL )
+			{
+				auto &pLast = *pAgent->ppDrawList.back();
+				if ( pLast->GetRenderBatch() != ( *ppSprite )->GetRenderBatch() )
+				{
+					pLast->Render();
+				}
+			}
+
+			pAgent->lastReservedIdentifier = sprId;
+
+			pAgent->ppDrawList.push_back( ppSprite );
+		}
 
 	#pragma region Normal
 		bool Draw( size_t sprId, float scrX, float scrY, float degree, DirectX::XMFLOAT2 center, float alpha )
@@ -2321,17 +3047,7 @@ namespace Donya
 				SwitchBatchFromPrimitive();
 			}
 
-			if ( pAgent->lastReservedIdentifier != sprId )
-			{
-				if ( pAgent->lastReservedIdentifier != NULL )
-				{
-					( *pAgent->ppDrawList.back() )->Render();
-				}
-
-				pAgent->lastReservedIdentifier = sprId;
-
-				pAgent->ppDrawList.push_back( &it->second );
-			}
+			SwitchBatchIfChanged( sprId, &it->second );
 
 			return ( *pAgent->ppDrawList.back() )->ReserveGeneralExt
 			(
@@ -2359,6 +3075,24 @@ namespace Donya
 		}
 	#pragma endregion
 
+	#pragma region Bulk
+		size_t DrawBulk( size_t sprId, const Batch::ReserveDesc *pDescs, size_t count )
+		{
+			auto it = FindSpriteOrEnd( sprId );
+			if ( it == pAgent->pSprites.end() ) { return NULL; }
+			// else
+
+			if ( pAgent->nowBatchingPrimitive )
+			{
+				SwitchBatchFromPrimitive();
+			}
+
+			SwitchBatchIfChanged( sprId, &it->second );
+
+			return ( *pAgent->ppDrawList.back() )->ReserveBulk( pDescs, count );
+		}
+	#pragma endregion
+
 	#pragma region String
 		Donya::Int2 CalcTextCharPlace( char character )
 		{
@@ -2408,17 +3142,7 @@ namespace Donya
 				SwitchBatchFromPrimitive();
 			}
 
-			if ( pAgent->lastReservedIdentifier != sprId )
-			{
-				if ( pAgent->lastReservedIdentifier != NULL )
-				{
-					( *pAgent->ppDrawList.back() )->Render();
-				}
-
-				pAgent->lastReservedIdentifier = sprId;
-
-				pAgent->ppDrawList.push_back( &it->second );
-			}
+			SwitchBatchIfChanged( sprId, &it->second );
 
 			Donya::Vector2 texPos{};
 			bool succeeded = true;
@@ -2602,5 +3326,64 @@ namespace Donya
 
 	#pragma endregion
 
+	#if USE_IMGUI
+
+		void ShowImGuiNode( const char *nodeCaption )
+		{
+			if ( !ImGui::TreeNode( nodeCaption ) ) { return; }
+			// else
+
+			if ( pAgent )
+			{
+				for ( auto &it : pAgent->pSprites )
+				{
+					const auto &pBatch = it.second;
+					if ( !pBatch ) { continue; } // Evicted.
+					// else
+
+					const std::string fileName = Donya::WideToUTF8( Donya::ExtractFileNameFromFullPath( pBatch->GetFileName() ) );
+
+					ImGui::Text
+					(
+						u8"[%s] Peak[%d], PerPage[%d], Page[%d]",
+						fileName.c_str(),
+						scast<int>( pBatch->GetPeakInstanceCount() ),
+						scast<int>( pBatch->GetInstancesPerPage() ),
+						scast<int>( pBatch->GetPageCount() )
+					);
+				}
+
+				for ( auto &pAtlas : pAgent->pAtlases )
+				{
+					ImGui::Text
+					(
+						u8"[%s] Peak[%d], PerPage[%d], Page[%d]",
+						Donya::WideToUTF8( pAtlas->GetFileName() ).c_str(),
+						scast<int>( pAtlas->GetPeakInstanceCount() ),
+						scast<int>( pAtlas->GetInstancesPerPage() ),
+						scast<int>( pAtlas->GetPageCount() )
+					);
+				}
+
+				if ( ImGui::Button( u8"Reset the peaks" ) )
+				{
+					for ( auto &it : pAgent->pSprites )
+					{
+						if ( !it.second ) { continue; }
+						// else
+						it.second->ResetPeakInstanceCount();
+					}
+					for ( auto &pAtlas : pAgent->pAtlases )
+					{
+						pAtlas->ResetPeakInstanceCount();
+					}
+				}
+			}
+
+			ImGui::TreePop();
+		}
+
+	#endif // USE_IMGUI
+
 	}
 }
\ No newline at end of file
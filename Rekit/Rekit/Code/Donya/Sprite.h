@@ -8,10 +8,17 @@
 #include <wrl.h>
 
 #include "Color.h"
+#include "Resource.h"	// Use Resource::Handle.
+#include "UseImgui.h"	// Use USE_IMGUI macro.
 #include "Vector.h" // Use Donya::Int2
 
 namespace Donya
 {
+	namespace RenderCommand
+	{
+		struct Command;
+	}
+
 	/// <summary>
 	/// The sprite's draw methods do Donya::Color::FilteringAlpha() internally.
 	/// </summary>
@@ -75,6 +82,7 @@ namespace Donya
 			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	d3dShaderResourceView;
 			Microsoft::WRL::ComPtr<ID3D11SamplerState>			d3dSamplerState;
 			Microsoft::WRL::ComPtr<ID3D11DepthStencilState>		d3dDepthStencilState;
+			Resource::Handle<Resource::Texture2DResource>		pTexture;	// Keeps the cached texture from the eviction.
 		public:
 			Single( const std::wstring spriteFilename );
 			~Single();
@@ -148,9 +156,22 @@ namespace Donya
 				DirectX::XMFLOAT3 pos;
 				DirectX::XMFLOAT2 texCoord;
 			};
+		public:
+			/// <summary>
+			/// The upper-limit of the count of pages. Prevent the unlimited growth by a reserve without Render().
+			/// </summary>
+			static constexpr size_t MAX_PAGE_COUNT = 64U;
 		private:
-			const size_t MAX_INSTANCES;
+			const size_t INSTANCES_PER_PAGE;
 			size_t reserveCount;
+			size_t bufferCapacity;		// The count of instances that the instance-buffer can store.
+			size_t peakInstanceCount;	// The max count of instances that were rendered at once.
+			const std::wstring fileName;
+
+			// If this is a part of an atlas, the reserves are forwarded to the atlas, and this does not have own resources.
+			Batch		*pAtlas;
+			Donya::Int2	partPos;	// Left-top in the atlas.
+			Donya::Int2	partSize;
 
 			struct Instance
 			{
@@ -158,10 +179,18 @@ namespace Donya
 				DirectX::XMFLOAT4X4	NDCTransform;
 				DirectX::XMFLOAT4	texCoordTransform;
 			};
+			/// <summary>
+			/// The copy of the reserves that the recorded command replays with.
+			/// </summary>
+			struct RecordedInstances
+			{
+				Batch			*pBatch;
+				const Instance	*pInstances;
+			};
 
 			// std::unique_ptr<Instance[]> pInstances; // see https://qiita.com/bluepost59/items/b7490ee0cb19857b8cd0
 			// Instance *pInstances;
-			std::vector<Instance> instances;
+			std::vector<Instance> instances; // The size is the count of pages * INSTANCES_PER_PAGE. It is not shrunk, so reused over the frames.
 
 			D3D11_TEXTURE2D_DESC								d3dTexture2DDesc;
 
@@ -178,17 +207,29 @@ namespace Donya
 			Microsoft::WRL::ComPtr<ID3D11SamplerState>			d3dSamplerState;
 			Microsoft::WRL::ComPtr<ID3D11DepthStencilState>		d3dDepthStencilState;
 		public:
+			/// <summary>
+			/// The "maxInstancesCount" is the count of instances per page. A new page is appended when the reserving is over than current capacity.
+			/// </summary>
 			Batch( const std::wstring spriteFilename, size_t maxInstancesCount = 32U );
+			/// <summary>
+			/// Create the batch of an atlas, by the texture that already packed.
+			/// </summary>
+			Batch( ID3D11ShaderResourceView *pAtlasSRV, const D3D11_TEXTURE2D_DESC &atlasDesc, const std::wstring atlasName, size_t maxInstancesCount );
+			/// <summary>
+			/// Create the part of the "pAtlas". The part behaves like a sprite of "partSize", but its reserves are forwarded to the atlas, so the parts of same atlas are drawn by one batch.<para></para>
+			/// The "pAtlas" must be alive while this is alive.
+			/// </summary>
+			Batch( Batch *pAtlas, const std::wstring spriteFilename, const Donya::Int2 &partPos, const Donya::Int2 &partSize );
 			~Batch();
 			Batch( const Batch & ) = delete;
 			Batch &operator = ( const Batch & ) = delete;
 		public:
 			/// <summary>
-			/// Returns whole-size.
+			/// Returns whole-size. If this is a part of an atlas, returns the size of the part.
 			/// </summary>
 			int GetTextureWidth() const;
 			/// <summary>
-			/// Returns height-size.
+			/// Returns height-size. If this is a part of an atlas, returns the size of the part.
 			/// </summary>
 			int GetTextureHeight() const;
 			/// <summary>
@@ -209,6 +250,45 @@ namespace Donya
 			/// You can ignore to setting nullptr.
 			/// </summary>
 			void GetTextureSize( float *width, float *height ) const;
+			/// <summary>
+			/// Returns the desc of the own texture. It is meaningless if this is a part of an atlas.
+			/// </summary>
+			const D3D11_TEXTURE2D_DESC &GetTextureDesc() const { return d3dTexture2DDesc; }
+		public:
+			const std::wstring &GetFileName() const { return fileName; }
+			size_t GetInstancesPerPage()	const { return INSTANCES_PER_PAGE; }
+			size_t GetPageCount()			const { return ( pAtlas ) ? pAtlas->GetPageCount() : instances.size() / INSTANCES_PER_PAGE; }
+			/// <summary>
+			/// Returns the max count of instances that were rendered at once. Use for tuning the "maxInstancesCount".<para></para>
+			/// If this is a part of an atlas, returns the atlas's one.
+			/// </summary>
+			size_t GetPeakInstanceCount()	const { return ( pAtlas ) ? pAtlas->GetPeakInstanceCount() : peakInstanceCount; }
+			void ResetPeakInstanceCount() { peakInstanceCount = 0; }
+
+			bool IsAtlasPart() const { return ( pAtlas ) ? true : false; }
+			/// <summary>
+			/// Returns the atlas if this is a part of that, otherwise returns this. The draws to same render-batch are merged.
+			/// </summary>
+			Batch *GetRenderBatch() { return ( pAtlas ) ? pAtlas : this; }
+		private:
+			/// <summary>
+			/// Create the resources except the texture.
+			/// </summary>
+			void CreatePipeline( ID3D11Device *pDevice );
+
+			/// <summary>
+			/// Returns false if the count of pages reached the MAX_PAGE_COUNT.
+			/// </summary>
+			bool AppendPage();
+			/// <summary>
+			/// Re-create the instance-buffer if that can not store the "instanceCount" instances. Returns false if failed.
+			/// </summary>
+			bool ReserveInstanceBuffer( size_t instanceCount );
+			/// <summary>
+			/// Draw the instances by one draw call. The count must not be greater than the size of the pages.
+			/// </summary>
+			void Draw( const Instance *pInstances, size_t instanceCount );
+			static void Replay( const Donya::RenderCommand::Command &command );
 		public:
 			/// <summary>
 			/// Calculate center pos of sprite space by "center" bit, from whole size of sprite.
@@ -222,7 +302,7 @@ namespace Donya
 
 		#pragma region Normal
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is sprite size.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
@@ -235,7 +315,7 @@ namespace Donya
 				float  alpha = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is sprite size.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
@@ -248,7 +328,7 @@ namespace Donya
 				float  alpha = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is sprite size.<para></para>
 			/// Rotation center is sprite center.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
@@ -261,7 +341,7 @@ namespace Donya
 				float alpha  = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is sprite size.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
@@ -278,7 +358,7 @@ namespace Donya
 				float B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is sprite size.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
@@ -295,7 +375,7 @@ namespace Donya
 				float  B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is sprite size.<para></para>
 			/// Rotation center is sprite center.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
@@ -315,7 +395,7 @@ namespace Donya
 
 		#pragma region Stretched
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -328,7 +408,7 @@ namespace Donya
 				float alpha = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -341,7 +421,7 @@ namespace Donya
 				float  alpha = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Rotation center is sprite center.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
@@ -354,7 +434,7 @@ namespace Donya
 				float alpha  = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -371,7 +451,7 @@ namespace Donya
 				float B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -388,7 +468,7 @@ namespace Donya
 				float  B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Rotation center is sprite center.<para></para>
 			/// Texture origin is left-top(0, 0), using whole size.<para></para>
 			/// Colors are 1.0f.
@@ -408,7 +488,7 @@ namespace Donya
 
 		#pragma region Part
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is specified texture size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -422,7 +502,7 @@ namespace Donya
 				float alpha = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is specified texture size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -436,7 +516,7 @@ namespace Donya
 				float  alpha  = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is specified texture size.<para></para>
 			/// Rotation center is sprite center.<para></para>
 			/// Colors are 1.0f.
@@ -450,7 +530,7 @@ namespace Donya
 				float alpha = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is specified texture size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -468,7 +548,7 @@ namespace Donya
 				float B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is specified texture size.<para></para>
 			/// Colors are 1.0f.
 			/// </summary>
@@ -486,7 +566,7 @@ namespace Donya
 				float  B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// Drawing size is specified texture size.<para></para>
 			/// Rotation center is sprite center.<para></para>
 			/// Colors are 1.0f.
@@ -511,7 +591,7 @@ namespace Donya
 
 		#pragma region General
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// </summary>
 			bool ReserveGeneral
 			(
@@ -527,7 +607,7 @@ namespace Donya
 				float B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// </summary>
 			bool ReserveGeneral
 			(
@@ -543,7 +623,7 @@ namespace Donya
 				float  B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// </summary>
 			bool ReserveGeneralExt
 			(
@@ -560,7 +640,7 @@ namespace Donya
 				float B = 1.0f
 			);
 			/// <summary>
-			/// If current reserving instances over than MAX_INSTACES, returns false, and not reserving.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), returns false, and not reserving.<para></para>
 			/// </summary>
 			bool ReserveGeneralExt
 			(
@@ -578,6 +658,35 @@ namespace Donya
 			);
 		#pragma endregion
 
+		#pragma region Bulk
+			/// <summary>
+			/// A sprite of ReserveBulk(). The members are grouped by four floats, because these are loaded as a vector at once.
+			/// </summary>
+			struct ReserveDesc
+			{
+				float screenX{},  screenY{};	// Coordinate of sprite's center in screen space.
+				float screenW{},  screenH{};	// Whole Size of sprite in screen space.
+				float textureX{}, textureY{};	// Coordinate of sprite's left-top in texture space.
+				float textureW{}, textureH{};	// Whole Size of sprite in texture space.
+				float centerX{},  centerY{};	// Rotation center in sprite space, it is made by MakeSpecifiedCenter().
+				float scaleX{ 1.0f }, scaleY{ 1.0f };
+				float R{ 1.0f }, G{ 1.0f }, B{ 1.0f }, alpha{ 1.0f };
+				float degree{};					// Rotation angle, Unit is degree.
+			};
+			/// <summary>
+			/// Reserve the "count" sprites at once. The result is same as ReserveGeneralExt() per sprite, but the transforms of four sprites are made at once by SIMD.<para></para>
+			/// If the all pages are full(the count of pages reached MAX_PAGE_COUNT), the remaining sprites are not reserved.<para></para>
+			/// Returns the count of reserved sprites.
+			/// </summary>
+			size_t ReserveBulk( const ReserveDesc *pDescs, size_t count );
+		private:
+			/// <summary>
+			/// The body of ReserveBulk(). The "texOffset" is added to the texture coordinate of each sprite.
+			/// </summary>
+			size_t ReserveBulkWithOffset( const ReserveDesc *pDescs, size_t count, float texOffsetX, float texOffsetY );
+		public:
+		#pragma endregion
+
 			void Render();
 		};
 
@@ -788,11 +897,38 @@ namespace Donya
 		/// <summary>
 		/// Returns created sprite's identifier,<para></para>
 		/// but if failed to create, returns NULL.(NULL is invalid identifier)<para></para>
-		/// "maxInstancesCount" is upper-limit of batching of sprite,<para></para>
-		/// and relate in memory usage.
+		/// "maxInstancesCount" is the count of instances per page of batching of sprite,<para></para>
+		/// and relate in memory usage. The page is appended automatically if the drawing count is over than that.
 		/// </summary>
 		size_t Load( const std::wstring &spriteFileName, size_t maxInstancesCount = 32 );
 
+		/// <summary>
+		/// The sprites that are loaded by Load() until EndAtlas() are packed into the atlas textures of "atlasWidth" x "atlasHeight" at most.<para></para>
+		/// Each atlas is shrunk to the smallest power of two size that holds its parts, and the sprites that overflow an atlas are packed into the next atlas.<para></para>
+		/// The parts are separated by two texels of the transparent black.<para></para>
+		/// The sprites in the same atlas are drawn by one batch, so the continuous drawing of these does not flush.<para></para>
+		/// Their identifiers are returned by Load() as usual, but usable after EndAtlas(). The "maxInstancesCount" of Load() is ignored, the "maxInstancesCount" of here is used.<para></para>
+		/// Please do not use for the sprite that samples outside of its size, because it will sample the neighbor in the atlas.
+		/// </summary>
+		void BeginAtlas( int atlasWidth = 2048, int atlasHeight = 2048, size_t maxInstancesCount = 64U );
+		/// <summary>
+		/// Build the atlases of the sprites that are loaded after BeginAtlas().<para></para>
+		/// The sprite that could not be packed(too large, or the pixel format differs) is loaded as an own batch.<para></para>
+		/// Returns the count of the sprites that were packed into the atlases.
+		/// </summary>
+		size_t EndAtlas();
+
+		/// <summary>
+		/// Returns the max count of instances that were rendered at once. Use for tuning the "maxInstancesCount" of Load().<para></para>
+		/// If "spriteIdentifier" was invalid, returns NULL.
+		/// </summary>
+		size_t GetPeakInstanceCount( size_t spriteIdentifier );
+		/// <summary>
+		/// Returns the count of pages of the batch.<para></para>
+		/// If "spriteIdentifier" was invalid, returns NULL.
+		/// </summary>
+		size_t GetPageCount( size_t spriteIdentifier );
+
 	#pragma region GetTextureSizes
 
 		/// <summary>
@@ -839,7 +975,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool Draw
 		(
@@ -858,7 +994,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool Draw
 		(
@@ -878,7 +1014,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool Draw
 		(
@@ -896,7 +1032,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawExt
 		(
@@ -919,7 +1055,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawExt
 		(
@@ -943,7 +1079,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawExt
 		(
@@ -967,7 +1103,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStretched
 		(
@@ -987,7 +1123,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStretched
 		(
@@ -1008,7 +1144,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStretched
 		(
@@ -1027,7 +1163,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStretchedExt
 		(
@@ -1051,7 +1187,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStretchedExt
 		(
@@ -1076,7 +1212,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStretchedExt
 		(
@@ -1102,7 +1238,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawPart
 		(
@@ -1124,7 +1260,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawPart
 		(
@@ -1147,7 +1283,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawPart
 		(
@@ -1168,7 +1304,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawPartExt
 		(
@@ -1194,7 +1330,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawPartExt
 		(
@@ -1221,7 +1357,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawPartExt
 		(
@@ -1250,7 +1386,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawGeneral
 		(
@@ -1270,7 +1406,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawGeneral
 		(
@@ -1290,7 +1426,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawGeneralExt
 		(
@@ -1311,7 +1447,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawGeneralExt
 		(
@@ -1330,6 +1466,21 @@ namespace Donya
 		);
 	#pragma endregion
 
+	#pragma region Bulk
+		/// <summary>
+		/// Draw the "count" sprites at once, the transforms are made per four sprites by SIMD. Use this for many sprites of same identifier, like particles or tiles.<para></para>
+		/// Returns the count of drawn sprites. It is less than "count" if:<para></para>
+		/// * the "spriteIdentifier" was invalid identifier(returns NULL).<para></para>
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
+		/// </summary>
+		size_t DrawBulk
+		(
+			size_t spriteIdentifier,		// NULL is invalid identifier.
+			const Batch::ReserveDesc *pDescs,
+			size_t count
+		);
+	#pragma endregion
+
 	#pragma region Text
 		/// <summary>
 		/// Calculate place(0-based) of specified character in texture.<para></para>
@@ -1341,7 +1492,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawString
 		(
@@ -1361,7 +1512,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawString
 		(
@@ -1381,7 +1532,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStringExt
 		(
@@ -1402,7 +1553,7 @@ namespace Donya
 		/// In case of we can not drawing, returns false.<para></para>
 		/// may be considered why it can not drawn, the following reasons:<para></para>
 		/// * the "spriteIdentifier" was invalid identifier.<para></para>
-		/// * drawn count ware over than "maxInstancesCount" of when created.
+		/// * drawn count ware over than "maxInstancesCount" * Batch::MAX_PAGE_COUNT of when created.
 		/// </summary>
 		bool DrawStringExt
 		(
@@ -1516,5 +1667,12 @@ namespace Donya
 		/// Please call before Present().
 		/// </summary>
 		void PostDraw();
+
+	#if USE_IMGUI
+		/// <summary>
+		/// Show the peak instances and the pages of each batch by ImGui::TreeNode(). Please call between ImGui::Begin() and ImGui::End().
+		/// </summary>
+		void ShowImGuiNode( const char *nodeCaption );
+	#endif // USE_IMGUI
 	}
 }
@@ -12,6 +12,7 @@
 #include "Direct3DUtil.h"
 #include "Donya.h"
 #include "Loader.h"
+#include "RenderCommand.h"
 #include "Resource.h"
 #include "Vector.h"
 #include "Useful.h"
@@ -25,6 +26,12 @@ namespace Donya
 {
 	// TODO : User can be specify the ID3D11Device when create mesh.
 
+	static_assert( sizeof( StaticMesh::InstanceData ) == sizeof( float ) * 20U, "The InstanceData must be packed, it is uploaded to the instance buffer as is." );
+
+	// The rendering is done at the main thread only, so these are not guarded.
+	static StaticMesh::RenderStats currentStats{};
+	static StaticMesh::RenderStats lastStats{};
+
 	bool StaticMesh::Create( const Loader &loader, StaticMesh &outputInstance )
 	{
 		const std::vector<Loader::Mesh> *pLoadedMeshes = loader.GetMeshes();
@@ -219,6 +226,85 @@ namespace Donya
 		return "PSMain";
 	}
 
+	constexpr const char *InstancedShaderSourceCode()
+	{
+		return
+		"struct VS_IN\n"
+		"{\n"
+		"	float4 pos			: POSITION;\n"
+		"	float4 normal		: NORMAL;\n"
+		"	float2 texCoord		: TEXCOORD;\n"
+		"	float4 worldRow0	: INSTANCE_WORLD0;\n"
+		"	float4 worldRow1	: INSTANCE_WORLD1;\n"
+		"	float4 worldRow2	: INSTANCE_WORLD2;\n"
+		"	float4 worldRow3	: INSTANCE_WORLD3;\n"
+		"	float4 color		: INSTANCE_COLOR;\n"
+		"};\n"
+		"struct VS_OUT\n"
+		"{\n"
+		"	float4 pos			: SV_POSITION;\n"
+		"	float4 normal		: NORMAL;\n"
+		"	float2 texCoord		: TEXCOORD0;\n"
+		"	float4 color		: COLOR;\n"
+		"};\n"
+		"cbuffer CONSTANT_BUFFER : register( b0 )\n"
+		"{\n"
+		"	row_major\n"
+		"	float4x4	viewProjection;\n"
+		"	row_major\n"
+		"	float4x4	meshTransform;\n"
+		"	float4		lightDirection;\n"
+		"	float4		lightColor;\n"
+		"};\n"
+		"cbuffer MATERIAL_BUFFER : register( b1 )\n"
+		"{\n"
+		"	float4 ambient;\n"
+		"	float4 diffuse;\n"
+		"	float4 specular;\n"
+		"};\n"
+		"VS_OUT VSMain( VS_IN vin )\n"
+		"{\n"
+		"	float4x4 instanceWorld	= float4x4( vin.worldRow0, vin.worldRow1, vin.worldRow2, vin.worldRow3 );\n"
+		"	float4x4 world			= mul( meshTransform, instanceWorld );\n"
+		"\n"
+		"	vin.normal.w	= 0;\n"
+		"	float4 nNorm	= normalize( mul( vin.normal, world ) );\n"
+		"\n"
+		"	VS_OUT vout		= (VS_OUT)( 0 );\n"
+		"	vout.pos		= mul( mul( vin.pos, world ), viewProjection );\n"
+		"	vout.normal		= nNorm;\n"
+		"	vout.texCoord	= vin.texCoord;\n"
+		"	vout.color		= vin.color;\n"
+		"\n"
+		"	return vout;\n"
+		"}\n"
+		"\n"
+		"Texture2D		diffuseMap			: register( t0 );\n"
+		"SamplerState	diffuseMapSampler	: register( s0 );\n"
+		"float4 PSMain( VS_OUT pin ) : SV_TARGET\n"
+		"{\n"
+		"	float3	nLightDir	= normalize( -lightDirection.rgb );\n"
+		"	float	NL			= saturate( dot( pin.normal.rgb, nLightDir ) );\n"
+		"			NL			= NL * 0.5f + 0.5f;\n"
+		"\n"
+		"	float4	diffuseColor= ( diffuse * pin.color ) * NL;\n"
+		"	float4	sampleColor	= diffuseMap.Sample( diffuseMapSampler, pin.texCoord );\n"
+		"\n"
+		"	float3	outputColor	= sampleColor.rgb * diffuseColor.rgb;\n"
+		"	float3	light		= lightColor.rgb * lightColor.w;\n"
+		"	return	float4( saturate( outputColor + ambient ) * light, sampleColor.a * pin.color.a );\n"
+		"}\n"
+		;
+	}
+	constexpr const char *InstancedShaderNameVS()
+	{
+		return "InstancedStaticMeshVS";
+	}
+	constexpr const char *InstancedShaderNamePS()
+	{
+		return "InstancedStaticMeshPS";
+	}
+
 	constexpr std::array<D3D11_INPUT_ELEMENT_DESC, 3>	InputElementDescs()
 	{
 		return std::array<D3D11_INPUT_ELEMENT_DESC, 3>
@@ -228,6 +314,21 @@ namespace Donya
 			D3D11_INPUT_ELEMENT_DESC{ "TEXCOORD",	0, DXGI_FORMAT_R32G32_FLOAT,	0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA, 0 },
 		};
 	}
+	constexpr std::array<D3D11_INPUT_ELEMENT_DESC, 8>	InstancedInputElementDescs()
+	{
+		// The slot 0 is the vertices, the slot 1 is the instances.
+		return std::array<D3D11_INPUT_ELEMENT_DESC, 8>
+		{
+			D3D11_INPUT_ELEMENT_DESC{ "POSITION",		0, DXGI_FORMAT_R32G32B32_FLOAT,		0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA,	0 },
+			D3D11_INPUT_ELEMENT_DESC{ "NORMAL",			0, DXGI_FORMAT_R32G32B32_FLOAT,		0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA,	0 },
+			D3D11_INPUT_ELEMENT_DESC{ "TEXCOORD",		0, DXGI_FORMAT_R32G32_FLOAT,		0, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA,	0 },
+			D3D11_INPUT_ELEMENT_DESC{ "INSTANCE_WORLD",	0, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1 },
+			D3D11_INPUT_ELEMENT_DESC{ "INSTANCE_WORLD",	1, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1 },
+			D3D11_INPUT_ELEMENT_DESC{ "INSTANCE_WORLD",	2, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1 },
+			D3D11_INPUT_ELEMENT_DESC{ "INSTANCE_WORLD",	3, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1 },
+			D3D11_INPUT_ELEMENT_DESC{ "INSTANCE_COLOR",	0, DXGI_FORMAT_R32G32B32A32_FLOAT,	1, D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1 },
+		};
+	}
 	constexpr D3D11_RASTERIZER_DESC						RasterizerDesc( D3D11_FILL_MODE fillMode )
 	{
 		D3D11_RASTERIZER_DESC standard{};
@@ -287,6 +388,8 @@ namespace Donya
 		iDefaultCBuffer(), iDefaultMaterialCBuffer(),
 		iDefaultInputLayout(), iDefaultVS(), iDefaultPS(),
 		iRasterizerStateSurface(), iRasterizerStateWire(), iDepthStencilState(),
+		iInstancedCBuffer(), iInstancedInputLayout(), iInstancedVS(), iInstancedPS(),
+		iInstanceBuffer(), instanceCapacity( 0 ),
 		meshes(), collisionFaces(),
 		wasLoaded( false )
 	{}
@@ -323,6 +426,14 @@ namespace Donya
 				iDefaultMaterialCBuffer.GetAddressOf()
 			);
 			_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : Create Material-Constant-Buffer." );
+
+			hr = CreateConstantBuffer
+			(
+				pDevice,
+				sizeof( InstancedConstantBuffer ),
+				iInstancedCBuffer.GetAddressOf()
+			);
+			_ASSERT_EXPR( SUCCEEDED( hr ), L"Failed : Create Instanced-Constant-Buffer." );
 		}
 
 	#if DEBUG_MODE
@@ -361,6 +472,34 @@ namespace Donya
 				ENABLE_CACHE
 			);
 		}
+
+		// Create the shaders for RenderInstanced()
+		{
+			auto inputElementDescs = InstancedInputElementDescs();
+
+			Resource::CreateVertexShaderFromSource
+			(
+				pDevice,
+				InstancedShaderNameVS(),
+				InstancedShaderSourceCode(),
+				DefaultShaderEntryPointVS(),
+				iInstancedVS.GetAddressOf(),
+				iInstancedInputLayout.GetAddressOf(),
+				inputElementDescs.data(),
+				inputElementDescs.size(),
+				ENABLE_CACHE
+			);
+
+			Resource::CreatePixelShaderFromSource
+			(
+				pDevice,
+				InstancedShaderNamePS(),
+				InstancedShaderSourceCode(),
+				DefaultShaderEntryPointPS(),
+				iInstancedPS.GetAddressOf(),
+				ENABLE_CACHE
+			);
+		}
 	}
 	void StaticMesh::CreateRasterizerState( ID3D11Device *pDevice )
 	{
@@ -433,14 +572,26 @@ namespace Donya
 			for ( size_t i = 0; i < textureCount; ++i )
 			{
 				auto &tex = pMtl->textures[i];
-				Resource::CreateTexture2DFromFile
-				(
-					pDevice,
-					Donya::MultiToWide( tex.fileName ),
-					tex.iSRV.GetAddressOf(),
-					&tex.texture2DDesc,
-					ENABLE_CACHE
-				);
+				if ( !ENABLE_CACHE )
+				{
+					Resource::CreateTexture2DFromFile
+					(
+						pDevice,
+						Donya::MultiToWide( tex.fileName ),
+						tex.iSRV.GetAddressOf(),
+						&tex.texture2DDesc,
+						/* isEnableCache = */ false
+					);
+					continue;
+				}
+				// else
+
+				tex.pResource = Resource::AcquireTexture2D( pDevice, Donya::MultiToWide( tex.fileName ) );
+				if ( !tex.pResource ) { continue; }
+				// else
+
+				tex.iSRV			= tex.pResource->d3dShaderResourceView;
+				tex.texture2DDesc	= tex.pResource->d3dTexture2DDesc;
 			}
 		};
 
@@ -639,6 +790,24 @@ namespace Donya
 		if ( !wasLoaded ) { return; }
 		// else
 
+		// The replay uses the default shading, so the own shading is drawn immediately.
+		if ( Donya::RenderCommand::IsRecording() && useDefaultShading )
+		{
+			RecordedDraw draw{};
+			draw.matW			= defMatW;
+			draw.lightDir		= defLightDir;
+			draw.isEnableFill	= isEnableFill;
+
+			const unsigned char drawFlags
+				= ( defMtlColor.w < 1.0f )
+				? Donya::RenderCommand::DRAW_TRANSLUCENT
+				: Donya::RenderCommand::DRAW_OPAQUE;
+
+			RecordCommands( false, 1U, defMatWVP, defMtlColor, drawFlags, Donya::RenderCommand::MakePayload( &draw ) );
+			return;
+		}
+		// else
+
 		HRESULT hr = S_OK;
 
 		// Use default context.
@@ -698,6 +867,7 @@ namespace Donya
 				cb.materialColor.w		= Donya::Color::FilteringAlpha( cb.materialColor.w );
 
 				pImmediateContext->UpdateSubresource( iDefaultCBuffer.Get(), 0, nullptr, &cb, 0, 0 );
+				currentStats.constantBufferUpdates++;
 				pImmediateContext->VSSetConstantBuffers( 0, 1, iDefaultCBuffer.GetAddressOf() );
 				pImmediateContext->PSSetConstantBuffers( 0, 1, iDefaultCBuffer.GetAddressOf() );
 			}
@@ -718,6 +888,7 @@ namespace Donya
 					mtlCB.specular = it.specular.color;
 
 					pImmediateContext->UpdateSubresource( iDefaultMaterialCBuffer.Get(), 0, nullptr, &mtlCB, 0, 0 );
+					currentStats.constantBufferUpdates++;
 					pImmediateContext->VSSetConstantBuffers( 1, 1, iDefaultMaterialCBuffer.GetAddressOf() );
 					pImmediateContext->PSSetConstantBuffers( 1, 1, iDefaultMaterialCBuffer.GetAddressOf() );
 				}
@@ -730,8 +901,11 @@ namespace Donya
 
 				pImmediateContext->PSSetSamplers( 0, 1, it.diffuse.iSampler.GetAddressOf() );
 				pImmediateContext->PSSetShaderResources( 0, 1, it.diffuse.textures[0].iSRV.GetAddressOf() );
+				it.diffuse.textures[0].Touch();
 
 				pImmediateContext->DrawIndexed( it.indexCount, it.indexStart, 0 );
+				currentStats.drawCalls++;
+				currentStats.instanceCount++;
 			}
 		}
 
@@ -760,6 +934,434 @@ namespace Donya
 		}
 	}
 
+	bool StaticMesh::ReserveInstanceBuffer( size_t instanceCount ) const
+	{
+		if ( instanceCount <= instanceCapacity && iInstanceBuffer ) { return true; }
+		// else
+
+		// Grow geometrically, so the buffer is re-created only a few times.
+		constexpr size_t MIN_CAPACITY = 64U;
+		const size_t newCapacity = std::max( instanceCount, std::max( instanceCapacity * 2U, MIN_CAPACITY ) );
+
+		D3D11_BUFFER_DESC bufferDesc{};
+		bufferDesc.ByteWidth			= scast<UINT>( sizeof( InstanceData ) * newCapacity );
+		bufferDesc.Usage				= D3D11_USAGE_DYNAMIC;
+		bufferDesc.BindFlags			= D3D11_BIND_VERTEX_BUFFER;
+		bufferDesc.CPUAccessFlags		= D3D11_CPU_ACCESS_WRITE;
+		bufferDesc.MiscFlags			= 0;
+		bufferDesc.StructureByteStride	= 0;
+
+		HRESULT hr = Donya::GetDevice()->CreateBuffer( &bufferDesc, nullptr, iInstanceBuffer.ReleaseAndGetAddressOf() );
+		if ( FAILED( hr ) )
+		{
+			_ASSERT_EXPR( 0, L"Failed : Create Instance-Buffer." );
+			instanceCapacity = 0;
+			return false;
+		}
+		// else
+
+		instanceCapacity = newCapacity;
+		return true;
+	}
+
+	bool StaticMesh::UploadInstances( ID3D11DeviceContext *pImmediateContext, const InstanceData *pInstances, size_t instanceCount ) const
+	{
+		if ( !ReserveInstanceBuffer( instanceCount ) ) { return false; }
+		// else
+
+		D3D11_MAPPED_SUBRESOURCE mapped{};
+		HRESULT hr = pImmediateContext->Map( iInstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped );
+		if ( FAILED( hr ) )
+		{
+			_ASSERT_EXPR( 0, L"Failed : Map the Instance-Buffer." );
+			return false;
+		}
+		// else
+
+		InstanceData *pDest = scast<InstanceData *>( mapped.pData );
+		for ( size_t i = 0; i < instanceCount; ++i )
+		{
+			pDest[i] = pInstances[i];
+			pDest[i].color.w = Donya::Color::FilteringAlpha( pDest[i].color.w );
+		}
+
+		pImmediateContext->Unmap( iInstanceBuffer.Get(), 0 );
+		return true;
+	}
+
+	void StaticMesh::RecordCommands( bool isInstanced, unsigned int instanceCount, const Donya::Vector4x4 &matWVP, const Donya::Vector4 &color, unsigned char drawFlags, const void *pPayload ) const
+	{
+		const Donya::RenderCommand::Type type
+			= ( isInstanced )
+			? Donya::RenderCommand::Type::StaticMeshInstanced
+			: Donya::RenderCommand::Type::StaticMesh;
+		const Donya::RenderCommand::Replayer replay
+			= ( isInstanced )
+			? &StaticMesh::ReplayInstancedSubset
+			: &StaticMesh::ReplaySubset;
+
+		unsigned int subsetIndex = 0;
+		for ( const auto &mesh : meshes )
+		{
+			const Donya::Vector4x4 globalAdjusted = mesh.globalTransform * mesh.coordinateConversion;
+			const Donya::Vector4x4 transform = globalAdjusted * matWVP;
+
+			for ( const auto &it : mesh.subsets )
+			{
+				// The subset that does not have a texture is not drawn, same as Render().
+				if ( !it.diffuse.textures.empty() )
+				{
+					Donya::RenderCommand::Record( Donya::RenderCommand::Make( type, this, subsetIndex, instanceCount, transform, color, drawFlags, replay, pPayload ) );
+				}
+
+				subsetIndex++;
+			}
+		}
+	}
+
+	bool StaticMesh::FindSubset( unsigned int subsetIndex, const Mesh **ppOutputMesh, const Subset **ppOutputSubset ) const
+	{
+		for ( const auto &mesh : meshes )
+		{
+			if ( subsetIndex < mesh.subsets.size() )
+			{
+				*ppOutputMesh	= &mesh;
+				*ppOutputSubset	= &mesh.subsets[subsetIndex];
+				return true;
+			}
+			// else
+
+			subsetIndex -= scast<unsigned int>( mesh.subsets.size() );
+		}
+
+		return false;
+	}
+
+	void StaticMesh::ReplaySubset( const Donya::RenderCommand::Command &command )
+	{
+		using namespace Donya::RenderCommand;
+
+		const StaticMesh	*pModel	= scast<const StaticMesh *>( command.pSource );
+		const RecordedDraw	*pDraw	= scast<const RecordedDraw *>( command.pPayload );
+		const Mesh			*pMesh	= nullptr;
+		const Subset		*pSubset= nullptr;
+		if ( !pModel->FindSubset( command.material, &pMesh, &pSubset ) ) { return; }
+		// else
+
+		ID3D11DeviceContext *pImmediateContext = Donya::GetImmediateContext();
+
+		// The other type's draw may have changed any state, and the shaders and the buffers are per model.
+		const bool bindShader	= ( command.changedStates & ( STATE_SHADER | STATE_MESH ) ) ? true : false;
+		const bool bindMaterial	= ( bindShader || ( command.changedStates & STATE_MATERIAL ) ) ? true : false;
+
+		if ( bindShader )
+		{
+			pImmediateContext->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+			pImmediateContext->IASetInputLayout( pModel->iDefaultInputLayout.Get() );
+			pImmediateContext->VSSetShader( pModel->iDefaultVS.Get(), nullptr, 0 );
+			pImmediateContext->PSSetShader( pModel->iDefaultPS.Get(), nullptr, 0 );
+			pImmediateContext->OMSetDepthStencilState( pModel->iDepthStencilState.Get(), 0xffffffff );
+
+			pImmediateContext->VSSetConstantBuffers( 0, 1, pModel->iDefaultCBuffer.GetAddressOf() );
+			pImmediateContext->PSSetConstantBuffers( 0, 1, pModel->iDefaultCBuffer.GetAddressOf() );
+			pImmediateContext->VSSetConstantBuffers( 1, 1, pModel->iDefaultMaterialCBuffer.GetAddressOf() );
+			pImmediateContext->PSSetConstantBuffers( 1, 1, pModel->iDefaultMaterialCBuffer.GetAddressOf() );
+		}
+
+		ID3D11RasterizerState	*pRasterizerState
+								= ( pDraw->isEnableFill )
+								? pModel->iRasterizerStateSurface.Get()
+								: pModel->iRasterizerStateWire.Get();
+		pImmediateContext->RSSetState( pRasterizerState );
+
+		// The subsets of a mesh share the buffers, but the material index does not tell the mesh.
+		if ( bindMaterial )
+		{
+			UINT stride = sizeof( Vertex );
+			UINT offset = 0;
+			pImmediateContext->IASetVertexBuffers( 0, 1, pMesh->iVertexBuffer.GetAddressOf(), &stride, &offset );
+			pImmediateContext->IASetIndexBuffer( pMesh->iIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0 );
+		}
+
+		// Per draw.
+		{
+			const Donya::Vector4x4 globalAdjusted = pMesh->globalTransform * pMesh->coordinateConversion;
+
+			ConstantBuffer cb{};
+			cb.worldViewProjection	= command.transform.XMFloat(); // It was adjusted at the recording.
+			cb.world				= ( globalAdjusted * pDraw->matW ).XMFloat();
+			cb.lightDirection		= pDraw->lightDir.XMFloat();
+			cb.lightColor			= XMFLOAT4{ 1.0f, 1.0f, 1.0f, 1.0f };
+			cb.materialColor		= command.color.XMFloat();
+			cb.materialColor.w		= Donya::Color::FilteringAlpha( cb.materialColor.w );
+
+			pImmediateContext->UpdateSubresource( pModel->iDefaultCBuffer.Get(), 0, nullptr, &cb, 0, 0 );
+			currentStats.constantBufferUpdates++;
+		}
+
+		if ( bindMaterial )
+		{
+			MaterialConstBuffer mtlCB;
+			mtlCB.ambient  = pSubset->ambient.color;
+			mtlCB.diffuse  = pSubset->diffuse.color;
+			mtlCB.specular = pSubset->specular.color;
+
+			pImmediateContext->UpdateSubresource( pModel->iDefaultMaterialCBuffer.Get(), 0, nullptr, &mtlCB, 0, 0 );
+			currentStats.constantBufferUpdates++;
+
+			pImmediateContext->PSSetSamplers( 0, 1, pSubset->diffuse.iSampler.GetAddressOf() );
+			pImmediateContext->PSSetShaderResources( 0, 1, pSubset->diffuse.textures[0].iSRV.GetAddressOf() );
+			pSubset->diffuse.textures[0].Touch();
+		}
+
+		pImmediateContext->DrawIndexed( pSubset->indexCount, pSubset->indexStart, 0 );
+		currentStats.drawCalls++;
+		currentStats.instanceCount++;
+	}
+
+	void StaticMesh::ReplayInstancedSubset( const Donya::RenderCommand::Command &command )
+	{
+		using namespace Donya::RenderCommand;
+
+		const StaticMesh		*pModel		= scast<const StaticMesh *>( command.pSource );
+		const RecordedInstances	*pDraw		= scast<const RecordedInstances *>( command.pPayload );
+		const Mesh				*pMesh		= nullptr;
+		const Subset			*pSubset	= nullptr;
+		if ( !pModel->FindSubset( command.material, &pMesh, &pSubset ) ) { return; }
+		// else
+
+		ID3D11DeviceContext *pImmediateContext = Donya::GetImmediateContext();
+
+		// The instance buffer is per model, so the instances are uploaded when the previous command used the other ones.
+		const bool uploadInstances = ( command.changedStates & STATE_INSTANCE ) ? true : false;
+		if ( uploadInstances )
+		{
+			if ( !pModel->UploadInstances( pImmediateContext, pDraw->pInstances, pDraw->instanceCount ) ) { return; }
+			// else
+		}
+
+		const bool bindShader	= ( command.changedStates & ( STATE_SHADER | STATE_MESH ) ) ? true : false;
+		const bool bindMaterial	= ( bindShader || ( command.changedStates & STATE_MATERIAL ) ) ? true : false;
+
+		if ( bindShader )
+		{
+			pImmediateContext->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+			pImmediateContext->IASetInputLayout( pModel->iInstancedInputLayout.Get() );
+			pImmediateContext->VSSetShader( pModel->iInstancedVS.Get(), nullptr, 0 );
+			pImmediateContext->PSSetShader( pModel->iInstancedPS.Get(), nullptr, 0 );
+			pImmediateContext->OMSetDepthStencilState( pModel->iDepthStencilState.Get(), 0xffffffff );
+
+			pImmediateContext->VSSetConstantBuffers( 0, 1, pModel->iInstancedCBuffer.GetAddressOf() );
+			pImmediateContext->PSSetConstantBuffers( 0, 1, pModel->iInstancedCBuffer.GetAddressOf() );
+			pImmediateContext->VSSetConstantBuffers( 1, 1, pModel->iDefaultMaterialCBuffer.GetAddressOf() );
+			pImmediateContext->PSSetConstantBuffers( 1, 1, pModel->iDefaultMaterialCBuffer.GetAddressOf() );
+		}
+
+		ID3D11RasterizerState	*pRasterizerState
+								= ( pDraw->isEnableFill )
+								? pModel->iRasterizerStateSurface.Get()
+								: pModel->iRasterizerStateWire.Get();
+		pImmediateContext->RSSetState( pRasterizerState );
+
+		// The upload may re-create the instance buffer.
+		if ( bindMaterial || uploadInstances )
+		{
+			ID3D11Buffer *buffers[2]{ pMesh->iVertexBuffer.Get(), pModel->iInstanceBuffer.Get() };
+			UINT strides[2]{ sizeof( Vertex ), sizeof( InstanceData ) };
+			UINT offsets[2]{ 0, 0 };
+			pImmediateContext->IASetVertexBuffers( 0, 2, buffers, strides, offsets );
+			pImmediateContext->IASetIndexBuffer( pMesh->iIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0 );
+		}
+
+		// Per draw.
+		{
+			InstancedConstantBuffer cb{};
+			cb.viewProjection	= pDraw->matVP.XMFloat();
+			cb.meshTransform	= ( pMesh->globalTransform * pMesh->coordinateConversion ).XMFloat();
+			cb.lightDirection	= pDraw->lightDir.XMFloat();
+			cb.lightColor		= XMFLOAT4{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+			pImmediateContext->UpdateSubresource( pModel->iInstancedCBuffer.Get(), 0, nullptr, &cb, 0, 0 );
+			currentStats.constantBufferUpdates++;
+		}
+
+		if ( bindMaterial )
+		{
+			MaterialConstBuffer mtlCB;
+			mtlCB.ambient  = pSubset->ambient.color;
+			mtlCB.diffuse  = pSubset->diffuse.color;
+			mtlCB.specular = pSubset->specular.color;
+
+			pImmediateContext->UpdateSubresource( pModel->iDefaultMaterialCBuffer.Get(), 0, nullptr, &mtlCB, 0, 0 );
+			currentStats.constantBufferUpdates++;
+
+			pImmediateContext->PSSetSamplers( 0, 1, pSubset->diffuse.iSampler.GetAddressOf() );
+			pImmediateContext->PSSetShaderResources( 0, 1, pSubset->diffuse.textures[0].iSRV.GetAddressOf() );
+			pSubset->diffuse.textures[0].Touch();
+		}
+
+		const UINT drawCount = scast<UINT>( pDraw->instanceCount );
+		pImmediateContext->DrawIndexedInstanced( pSubset->indexCount, drawCount, pSubset->indexStart, 0, 0 );
+		currentStats.drawCalls++;
+		currentStats.instanceCount += drawCount;
+	}
+
+	void StaticMesh::RenderInstanced( const InstanceData *pInstances, size_t instanceCount, const Donya::Vector4x4 &matVP, const Donya::Vector4 &lightDir, bool isEnableFill, ID3D11DeviceContext *pImmediateContext ) const
+	{
+		if ( !wasLoaded || !pInstances || !instanceCount ) { return; }
+		// else
+
+		if ( Donya::RenderCommand::IsRecording() )
+		{
+			RecordedInstances draw{};
+			draw.pInstances		= Donya::RenderCommand::MakePayload( pInstances, instanceCount );
+			draw.instanceCount	= instanceCount;
+			draw.matVP			= matVP;
+			draw.lightDir		= lightDir;
+			draw.isEnableFill	= isEnableFill;
+
+			unsigned char drawFlags = Donya::RenderCommand::DRAW_OPAQUE;
+			for ( size_t i = 0; i < instanceCount; ++i )
+			{
+				if ( pInstances[i].color.w < 1.0f )
+				{
+					drawFlags = Donya::RenderCommand::DRAW_TRANSLUCENT;
+					break;
+				}
+			}
+
+			RecordCommands( true, scast<unsigned int>( instanceCount ), matVP, Donya::Vector4{ 1.0f, 1.0f, 1.0f, 1.0f }, drawFlags, Donya::RenderCommand::MakePayload( &draw ) );
+			return;
+		}
+		// else
+
+		// Use default context.
+		if ( !pImmediateContext )
+		{
+			pImmediateContext = Donya::GetImmediateContext();
+		}
+
+		if ( !UploadInstances( pImmediateContext, pInstances, instanceCount ) ) { return; }
+		// else
+
+		// For PostProcessing.
+		Microsoft::WRL::ComPtr<ID3D11RasterizerState>	prevRasterizerState;
+		Microsoft::WRL::ComPtr<ID3D11VertexShader>		prevVS;
+		Microsoft::WRL::ComPtr<ID3D11PixelShader>		prevPS;
+		Microsoft::WRL::ComPtr<ID3D11SamplerState>		prevSamplerState;
+		Microsoft::WRL::ComPtr<ID3D11DepthStencilState>	prevDepthStencilState;
+		{
+			pImmediateContext->RSGetState( prevRasterizerState.ReleaseAndGetAddressOf() );
+			pImmediateContext->VSGetShader( prevVS.GetAddressOf(), 0, 0 );
+			pImmediateContext->PSGetShader( prevPS.GetAddressOf(), 0, 0 );
+			pImmediateContext->PSGetSamplers( 0, 1, prevSamplerState.ReleaseAndGetAddressOf() );
+			pImmediateContext->OMGetDepthStencilState( prevDepthStencilState.ReleaseAndGetAddressOf(), 0 );
+		}
+
+		// Common Settings
+		{
+			pImmediateContext->IASetPrimitiveTopology( D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+			pImmediateContext->IASetInputLayout( iInstancedInputLayout.Get() );
+			pImmediateContext->VSSetShader( iInstancedVS.Get(), nullptr, 0 );
+
+			ID3D11RasterizerState	*ppRasterizerState
+									= ( isEnableFill )
+									? iRasterizerStateSurface.Get()
+									: iRasterizerStateWire.Get();
+			pImmediateContext->RSSetState( ppRasterizerState );
+
+			pImmediateContext->PSSetShader( iInstancedPS.Get(), nullptr, 0 );
+			pImmediateContext->OMSetDepthStencilState( iDepthStencilState.Get(), 0xffffffff );
+		}
+
+		const UINT drawCount = scast<UINT>( instanceCount );
+		for ( const auto &mesh : meshes )
+		{
+			// Update ConstantBuffer.
+			{
+				InstancedConstantBuffer cb{};
+				cb.viewProjection	= matVP.XMFloat();
+				cb.meshTransform	= ( mesh.globalTransform * mesh.coordinateConversion ).XMFloat();
+				cb.lightDirection	= lightDir.XMFloat();
+				cb.lightColor		= XMFLOAT4{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+				pImmediateContext->UpdateSubresource( iInstancedCBuffer.Get(), 0, nullptr, &cb, 0, 0 );
+				currentStats.constantBufferUpdates++;
+				pImmediateContext->VSSetConstantBuffers( 0, 1, iInstancedCBuffer.GetAddressOf() );
+				pImmediateContext->PSSetConstantBuffers( 0, 1, iInstancedCBuffer.GetAddressOf() );
+			}
+
+			ID3D11Buffer *buffers[2]{ mesh.iVertexBuffer.Get(), iInstanceBuffer.Get() };
+			UINT strides[2]{ sizeof( Vertex ), sizeof( InstanceData ) };
+			UINT offsets[2]{ 0, 0 };
+			pImmediateContext->IASetVertexBuffers( 0, 2, buffers, strides, offsets );
+			pImmediateContext->IASetIndexBuffer( mesh.iIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0 );
+
+			for ( const auto &it : mesh.subsets )
+			{
+				// Update Material Constant Buffer.
+				{
+					MaterialConstBuffer mtlCB;
+					mtlCB.ambient  = it.ambient.color;
+					mtlCB.diffuse  = it.diffuse.color;
+					mtlCB.specular = it.specular.color;
+
+					pImmediateContext->UpdateSubresource( iDefaultMaterialCBuffer.Get(), 0, nullptr, &mtlCB, 0, 0 );
+					currentStats.constantBufferUpdates++;
+					pImmediateContext->VSSetConstantBuffers( 1, 1, iDefaultMaterialCBuffer.GetAddressOf() );
+					pImmediateContext->PSSetConstantBuffers( 1, 1, iDefaultMaterialCBuffer.GetAddressOf() );
+				}
+
+				// Note:Currently support only diffuse, and only one texture. Same as Render().
+				if ( it.diffuse.textures.empty() ) { continue; }
+				// else
+
+				pImmediateContext->PSSetSamplers( 0, 1, it.diffuse.iSampler.GetAddressOf() );
+				pImmediateContext->PSSetShaderResources( 0, 1, it.diffuse.textures[0].iSRV.GetAddressOf() );
+				it.diffuse.textures[0].Touch();
+
+				pImmediateContext->DrawIndexedInstanced( it.indexCount, drawCount, it.indexStart, 0, 0 );
+				currentStats.drawCalls++;
+				currentStats.instanceCount += drawCount;
+			}
+		}
+
+		// PostProcessing
+		{
+			pImmediateContext->RSSetState( prevRasterizerState.Get() );
+
+			pImmediateContext->IASetInputLayout( 0 );
+			pImmediateContext->VSSetShader( prevVS.Get(), nullptr, 0 );
+			pImmediateContext->PSSetShader( prevPS.Get(), nullptr, 0 );
+
+			// Unbind the instance buffer from the slot 1, the other users does not expect it.
+			ID3D11Buffer *nullBuffer{};
+			UINT zero = 0;
+			pImmediateContext->IASetVertexBuffers( 1, 1, &nullBuffer, &zero, &zero );
+
+			pImmediateContext->VSSetConstantBuffers( 0, 1, &nullBuffer );
+			pImmediateContext->PSSetConstantBuffers( 0, 1, &nullBuffer );
+			pImmediateContext->VSSetConstantBuffers( 1, 1, &nullBuffer );
+			pImmediateContext->PSSetConstantBuffers( 1, 1, &nullBuffer );
+
+			ID3D11ShaderResourceView *pNullSRV = nullptr;
+			pImmediateContext->PSSetShaderResources( 0, 1, &pNullSRV );
+			pImmediateContext->PSSetSamplers( 0, 1, prevSamplerState.GetAddressOf() );
+
+			pImmediateContext->OMSetDepthStencilState( prevDepthStencilState.Get(), 1 );
+		}
+	}
+
+	StaticMesh::RenderStats StaticMesh::GetLastRenderStats()
+	{
+		return lastStats;
+	}
+	void StaticMesh::FlushRenderStats()
+	{
+		lastStats		= currentStats;
+		currentStats	= RenderStats{};
+	}
+
 	StaticMesh::RayPickResult StaticMesh::RayPick( const Donya::Vector3 &rayStart, const Donya::Vector3 &rayEnd, bool enoughOnlyPickFirst )
 	{
 		RayPickResult rpResult{};
@@ -9,11 +9,16 @@
 #include <vector>
 #include <wrl.h>
 
+#include "Resource.h"	// Use Resource::Handle.
 #include "Vector.h"	// Use at Face.
 
 namespace Donya
 {
 	class Loader;
+	namespace RenderCommand
+	{
+		struct Command;
+	}
 
 	/// <summary>
 	/// If you want load the obj-file, you specify obj-file-path then you call LoadObjFile().
@@ -42,6 +47,13 @@ namespace Donya
 			DirectX::XMFLOAT4	lightColor;
 			DirectX::XMFLOAT4	materialColor;
 		};
+		struct InstancedConstantBuffer
+		{
+			DirectX::XMFLOAT4X4	viewProjection;
+			DirectX::XMFLOAT4X4	meshTransform;
+			DirectX::XMFLOAT4	lightDirection;
+			DirectX::XMFLOAT4	lightColor;
+		};
 		struct MaterialConstBuffer
 		{
 			DirectX::XMFLOAT4	ambient;
@@ -57,8 +69,17 @@ namespace Donya
 				std::string fileName;	// absolute path.
 				D3D11_TEXTURE2D_DESC texture2DDesc;
 				Microsoft::WRL::ComPtr<ID3D11ShaderResourceView>	iSRV;
+				Resource::Handle<Resource::Texture2DResource>		pResource;	// Keeps the cached texture from the eviction. It is null if the cache is disabled.
+			public:
+				Texture() : fileName( "" ), texture2DDesc(), iSRV(), pResource() {}
 			public:
-				Texture() : fileName( "" ), texture2DDesc(), iSRV() {}
+				/// <summary>
+				/// Tell the drawing to the eviction order of the cache.
+				/// </summary>
+				void Touch() const
+				{
+					if ( pResource ) { pResource->usage.Touch(); }
+				}
 			};
 			std::vector<Texture> textures;
 		public:
@@ -94,6 +115,24 @@ namespace Donya
 			Mesh( const Mesh & ) = default;
 		};
 
+		/// <summary>
+		/// The per-instance data of RenderInstanced(). This is uploaded to the instance buffer as is.
+		/// </summary>
+		struct InstanceData
+		{
+			Donya::Vector4x4	world{};
+			Donya::Vector4		color{ 1.0f, 1.0f, 1.0f, 1.0f };
+		};
+		/// <summary>
+		/// The counts of the rendering commands that were issued by all StaticMeshes.
+		/// </summary>
+		struct RenderStats
+		{
+			unsigned int drawCalls{};
+			unsigned int constantBufferUpdates{};
+			unsigned int instanceCount{};
+		};
+
 		/// <summary>
 		/// Use for collision.
 		/// </summary>
@@ -102,6 +141,27 @@ namespace Donya
 			int materialIndex{ -1 };				// -1 is invalid.
 			std::array<Donya::Vector3, 3> points{};	// Store local-space vertices of a triangle. CW.
 		};
+	private:
+		/// <summary>
+		/// The arguments of Render() that the recorded commands replay with. The subsets of one call share it.
+		/// </summary>
+		struct RecordedDraw
+		{
+			Donya::Vector4x4	matW{};
+			Donya::Vector4		lightDir{};
+			bool				isEnableFill{};
+		};
+		/// <summary>
+		/// The arguments of RenderInstanced() that the recorded commands replay with. The "pInstances" is a copy that lives until the commands are submitted.
+		/// </summary>
+		struct RecordedInstances
+		{
+			const InstanceData	*pInstances{};
+			size_t				instanceCount{};
+			Donya::Vector4x4	matVP{};
+			Donya::Vector4		lightDir{};
+			bool				isEnableFill{};
+		};
 	private:
 		template<typename T> using ComPtr = Microsoft::WRL::ComPtr<T>;
 		mutable ComPtr<ID3D11Buffer>			iDefaultCBuffer;
@@ -112,6 +172,13 @@ namespace Donya
 		mutable ComPtr<ID3D11RasterizerState>	iRasterizerStateSurface;
 		mutable ComPtr<ID3D11RasterizerState>	iRasterizerStateWire;
 		mutable ComPtr<ID3D11DepthStencilState>	iDepthStencilState;
+
+		mutable ComPtr<ID3D11Buffer>			iInstancedCBuffer;
+		mutable ComPtr<ID3D11InputLayout>		iInstancedInputLayout;
+		mutable ComPtr<ID3D11VertexShader>		iInstancedVS;
+		mutable ComPtr<ID3D11PixelShader>		iInstancedPS;
+		mutable ComPtr<ID3D11Buffer>			iInstanceBuffer;	// Dynamic. Reuse between frames, grow when the capacity is not enough.
+		mutable size_t							instanceCapacity;
 	
 		std::vector<Mesh>						meshes;
 		std::vector<Face>						collisionFaces;
@@ -125,6 +192,31 @@ namespace Donya
 		void CreateDepthStencilState( ID3D11Device *pDevice );
 		void LoadTextures( ID3D11Device *pDevice );
 
+		/// <summary>
+		/// Returns false if the creation of the instance buffer failed.
+		/// </summary>
+		bool ReserveInstanceBuffer( size_t instanceCount ) const;
+
+		/// <summary>
+		/// Copy the instances to the instance buffer. Returns false if the buffer is not usable.
+		/// </summary>
+		bool UploadInstances( ID3D11DeviceContext *pImmediateContext, const InstanceData *pInstances, size_t instanceCount ) const;
+
+		/// <summary>
+		/// Record the commands instead of drawing, per subset. Use while the RenderCommand is recording.<para></para>
+		/// The "pPayload" is the RecordedDraw, or the RecordedInstances if the "isInstanced" is true.
+		/// </summary>
+		void RecordCommands( bool isInstanced, unsigned int instanceCount, const Donya::Vector4x4 &matWVP, const Donya::Vector4 &color, unsigned char drawFlags, const void *pPayload ) const;
+		/// <summary>
+		/// Returns false if the "subsetIndex" is out of range. The index counts the subsets of all meshes in order.
+		/// </summary>
+		bool FindSubset( unsigned int subsetIndex, const Mesh **ppOutputMesh, const Subset **ppOutputSubset ) const;
+		/// <summary>
+		/// The replay functions of the recorded commands. These bind only the states that the "changedStates" of the command has.
+		/// </summary>
+		static void ReplaySubset( const Donya::RenderCommand::Command &command );
+		static void ReplayInstancedSubset( const Donya::RenderCommand::Command &command );
+
 		/// <summary>
 		/// Return false if the initialize failed, or already initialized.
 		/// </summary>
@@ -137,7 +229,8 @@ namespace Donya
 		bool LoadObjFile( const std::wstring &objFilePath );
 
 		/// <summary>
-		/// In using a default shading, this render method do Donya::Color::FilteringAlpha() internally.
+		/// In using a default shading, this render method do Donya::Color::FilteringAlpha() internally.<para></para>
+		/// While the Donya::RenderCommand is recording, the default shading records the commands per subset instead. The color of alpha less than 1 makes these translucent.
 		/// </summary>
 		void Render
 		(
@@ -149,6 +242,30 @@ namespace Donya
 			const Donya::Vector4	&defaultLightDir	= { 0.0f, 1.0f, 1.0f, 0.0f },
 			const Donya::Vector4	&defaultMtlColor	= { 1.0f, 1.0f, 1.0f, 1.0f }
 		) const;
+		/// <summary>
+		/// Render the "instanceCount" instances by one draw call per subset, with the default instanced shading.<para></para>
+		/// The instances are copied to an instance buffer that this mesh holds, so the "pInstances" can be released after this call.<para></para>
+		/// This method do Donya::Color::FilteringAlpha() to the color of each instance.<para></para>
+		/// While the Donya::RenderCommand is recording, this records the commands per subset instead. The instances are copied, and these are translucent if an instance has the alpha less than 1.
+		/// </summary>
+		void RenderInstanced
+		(
+			const InstanceData		*pInstances,
+			size_t					instanceCount,
+			const Donya::Vector4x4	&matViewProjection,
+			const Donya::Vector4	&lightDirection		= { 0.0f, 1.0f, 1.0f, 0.0f },
+			bool isEnableFill							= true,
+			ID3D11DeviceContext		*pImmediateContext	= nullptr
+		) const;
+	public:
+		/// <summary>
+		/// Returns the counts of last frame.
+		/// </summary>
+		static RenderStats GetLastRenderStats();
+		/// <summary>
+		/// The counts of current frame will become the last frame's. Donya::SystemUpdate() calls this.
+		/// </summary>
+		static void FlushRenderStats();
 	public:
 		/// <summary>
 		/// The members are valid when the "wasHit" is true.
@@ -0,0 +1,132 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+#include "AllocationTracker.h"
+
+#undef max
+#undef min
+
+namespace Donya
+{
+	ThreadPool::ThreadPool( int workerCount ) :
+		workers(), mutex(), cvWakeUp(), cvFinished(),
+		pJob( nullptr ), invoker( nullptr ), jobCount( 0 ), callerZone( 0 ), generation( 0 ),
+		busyWorkerCount( 0 ), wantQuit( false ),
+		nextJobIndex( 0 ), finishedJobCount( 0 )
+	{
+		if ( workerCount < 0 )
+		{
+			const int hardwareCount = scast<int>( std::thread::hardware_concurrency() );
+			workerCount = std::max( 0, hardwareCount - 1 );
+		}
+
+		workers.reserve( scast<size_t>( workerCount ) );
+		for ( int i = 0; i < workerCount; ++i )
+		{
+			workers.emplace_back( [this]() { WorkerLoop(); } );
+		}
+	}
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> enterCS( mutex );
+			wantQuit = true;
+		}
+		cvWakeUp.notify_all();
+
+		for ( auto &it : workers )
+		{
+			if ( it.joinable() ) { it.join(); }
+		}
+	}
+
+	void ThreadPool::Dispatch( size_t count, const void *pCallerJob, Invoker callerInvoker )
+	{
+		if ( !count ) { return; }
+		// else
+
+		if ( workers.empty() || count == 1 )
+		{
+			for ( size_t i = 0; i < count; ++i )
+			{
+				callerInvoker( pCallerJob, i );
+			}
+			return;
+		}
+		// else
+
+		{
+			std::unique_lock<std::mutex> enterCS( mutex );
+
+			// A worker that woke up late may still refer the previous job.
+			cvFinished.wait( enterCS, [&]() { return busyWorkerCount == 0; } );
+
+			pJob		= pCallerJob;
+			invoker		= callerInvoker;
+			jobCount	= count;
+			callerZone	= AllocationTracker::GetCurrentZoneIndex();
+			nextJobIndex.store( 0 );
+			finishedJobCount.store( 0 );
+			++generation;
+		}
+		cvWakeUp.notify_all();
+
+		ConsumeJobs();
+
+		std::unique_lock<std::mutex> enterCS( mutex );
+		cvFinished.wait
+		(
+			enterCS,
+			[&]()
+			{
+				return ( finishedJobCount.load() == jobCount && busyWorkerCount == 0 );
+			}
+		);
+		pJob	= nullptr;
+		invoker	= nullptr;
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		unsigned long long seenGeneration = 0;
+		for ( ;; )
+		{
+			{
+				std::unique_lock<std::mutex> enterCS( mutex );
+				cvWakeUp.wait( enterCS, [&]() { return wantQuit || seenGeneration != generation; } );
+				if ( wantQuit ) { return; }
+				// else
+
+				seenGeneration = generation;
+				++busyWorkerCount;
+			}
+
+			ConsumeJobs();
+
+			{
+				std::lock_guard<std::mutex> enterCS( mutex );
+				--busyWorkerCount;
+			}
+			cvFinished.notify_all();
+		}
+	}
+
+	size_t ThreadPool::ConsumeJobs()
+	{
+		// The "pJob", "invoker", "jobCount" and "callerZone" are not rewritten while this thread is working.
+		AllocationTracker::Zone zone{ callerZone };
+
+		size_t consumedCount = 0;
+		size_t index = nextJobIndex.fetch_add( 1 );
+		while ( index < jobCount )
+		{
+			invoker( pJob, index );
+			++consumedCount;
+			finishedJobCount.fetch_add( 1 );
+
+			index = nextJobIndex.fetch_add( 1 );
+		}
+		return consumedCount;
+	}
+}
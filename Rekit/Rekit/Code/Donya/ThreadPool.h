@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Constant.h"	// Use DELETE_COPY_AND_ASSIGN macro.
+
+namespace Donya
+{
+	/// <summary>
+	/// Keeps some worker threads for the parallel-for.<para></para>
+	/// The caller thread also works while waiting, so the pool that has zero worker is same as a serial for-loop.
+	/// </summary>
+	class ThreadPool
+	{
+	private:
+		// Calls the job that is pointed by "pJob". The job is not wrapped by std::function, so the ParallelFor() does not allocate.
+		using Invoker = void( * )( const void *pJob, size_t jobIndex );
+	private:
+		std::vector<std::thread>	workers;
+		std::mutex					mutex;
+		std::condition_variable		cvWakeUp;
+		std::condition_variable		cvFinished;
+
+		// These are rewrite only when the "busyWorkerCount" is zero, and guarded by the "mutex".
+		const void					*pJob;
+		Invoker						invoker;
+		size_t						jobCount;
+		size_t						callerZone;	// The AllocationTracker's zone of the caller, the workers use it while the job.
+		unsigned long long			generation;
+		size_t						busyWorkerCount;
+		bool						wantQuit;
+
+		std::atomic<size_t>			nextJobIndex;
+		std::atomic<size_t>			finishedJobCount;
+	public:
+		/// <summary>
+		/// If the "workerCount" is negative, use a count of the hardware threads - 1(the caller thread).
+		/// </summary>
+		ThreadPool( int workerCount = -1 );
+		~ThreadPool();
+		DELETE_COPY_AND_ASSIGN( ThreadPool )
+	public:
+		/// <summary>
+		/// Call the "job" with [0 ~ jobCount - 1] by some threads, and wait for all jobs finished.<para></para>
+		/// The order of calls is not guaranteed, please do not share a writable data between the jobs.<para></para>
+		/// The allocations in the jobs are attributed to the AllocationTracker's zone of the caller thread.
+		/// </summary>
+		template<typename Job>
+		void ParallelFor( size_t jobCount, const Job &job )
+		{
+			Invoker invoke = []( const void *pJob, size_t jobIndex )
+			{
+				( *scast<const Job *>( pJob ) )( jobIndex );
+			};
+			Dispatch( jobCount, &job, invoke );
+		}
+
+		/// <summary>
+		/// Returns the count of worker threads. The caller thread is not contained.
+		/// </summary>
+		size_t GetWorkerCount() const { return workers.size(); }
+	private:
+		void Dispatch( size_t jobCount, const void *pJob, Invoker invoker );
+
+		void WorkerLoop();
+		/// <summary>
+		/// Returns the count of finished jobs by this call.
+		/// </summary>
+		size_t ConsumeJobs();
+	};
+}
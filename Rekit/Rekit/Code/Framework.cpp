@@ -2,21 +2,30 @@
 
 #include <array>
 
+#include "Donya/AllocationTracker.h"
 #include "Donya/Blend.h"
 #include "Donya/Constant.h"
+#include "Donya/DebugDraw.h"
 #include "Donya/Donya.h"
+#include "Donya/Input.h"
 #include "Donya/Keyboard.h"
 #include "Donya/Mouse.h"
+#include "Donya/RenderCommand.h"
 #include "Donya/Resource.h"
+#include "Donya/ResourceBudget.h"
 #include "Donya/ScreenShake.h"
 #include "Donya/Sound.h"
+#include "Donya/Sprite.h"
+#include "Donya/StaticMesh.h"
 #include "Donya/Useful.h"
 #include "Donya/UseImGui.h"
 
 #include "Common.h"
 #include "Music.h"
+#include "ViewCulling.h"
 
 #include "GimmickUtil.h"	// Use for initialize.
+#include "GimmickImpl/GimmickBase.h"
 
 using namespace DirectX;
 
@@ -50,6 +59,9 @@ void Framework::Uninit()
 
 void Framework::Update( float elapsedTime/*Elapsed seconds from last frame*/ )
 {
+	ViewCulling::FlushStats();
+	GimmickBase::FlushTransformStats();
+
 #if DEBUG_MODE
 
 	if ( Donya::Keyboard::Press( VK_MENU ) )
@@ -89,7 +101,8 @@ void Framework::Draw( float elapsedTime/*Elapsed seconds from last frame*/ )
 
 bool Framework::LoadSounds()
 {
-	using Donya::Sound::Load;
+	using Donya::Sound::LoadAsync;
+	using Donya::Sound::PendingPlay;
 	using Music::ID;
 
 	struct Bundle
@@ -97,43 +110,53 @@ bool Framework::LoadSounds()
 		ID id;
 		std::string fileName;
 		bool isEnableLoop;
+		bool isStreaming; // The long sound should be streamed, for the startup time and the memory.
 	public:
-		Bundle() : id(), fileName(), isEnableLoop( false ) {}
-		Bundle( ID id, const char *fileName, bool isEnableLoop ) : id( id ), fileName( fileName ), isEnableLoop( isEnableLoop ) {}
-		Bundle( ID id, const std::string &fileName, bool isEnableLoop ) : id( id ), fileName( fileName ), isEnableLoop( isEnableLoop ) {}
+		Bundle() : id(), fileName(), isEnableLoop( false ), isStreaming( false ) {}
+		Bundle( ID id, const char *fileName, bool isEnableLoop, bool isStreaming = false ) : id( id ), fileName( fileName ), isEnableLoop( isEnableLoop ), isStreaming( isStreaming ) {}
+		Bundle( ID id, const std::string &fileName, bool isEnableLoop, bool isStreaming = false ) : id( id ), fileName( fileName ), isEnableLoop( isEnableLoop ), isStreaming( isStreaming ) {}
 	};
 
 	const std::array<Bundle, ID::MUSIC_COUNT> bandles =
 	{
-		{	// ID, FilePath, isEnableLoop
-			{ ID::BGM_Main,				"./Data/Sounds/BGM/ARPCHAIN.wav",				true  },
-			{ ID::BGM_Last,				"./Data/Sounds/BGM/Battle-Sonic.wav",			true  },
-			{ ID::BGM_Clear,			"./Data/Sounds/BGM/Time_Warp.wav",				true  },
+		{	// ID, FilePath, isEnableLoop, isStreaming
+			{ ID::BGM_Main,				"./Data/Sounds/BGM/ARPCHAIN.wav",				true,  true  },
+			{ ID::BGM_Last,				"./Data/Sounds/BGM/Battle-Sonic.wav",			true,  true  },
+			{ ID::BGM_Clear,			"./Data/Sounds/BGM/Time_Warp.wav",				true,  true  },
 			
-			{ ID::ItemChoose,			"./Data/Sounds/SE/UI/ItemChoose.wav",			false },
-			{ ID::ItemDecision,			"./Data/Sounds/SE/UI/ItemDecision.wav",			false },
-
-			{ ID::Alert,				"./Data/Sounds/SE/UI/Alert.wav",				true  },
-			{ ID::Jump,					"./Data/Sounds/SE/PL_Jump.wav",					false },
-			{ ID::Throw,				"./Data/Sounds/SE/HK_Throw.wav",				false },
-			{ ID::Appearance,			"./Data/Sounds/SE/HK_Appearance.wav",			false },
-			{ ID::Pull,					"./Data/Sounds/SE/HK_Pull.wav",					false },
-			{ ID::Insert,				"./Data/Sounds/SE/HK_Insert.wav",				false },
-			{ ID::GetKey,				"./Data/Sounds/SE/GetKey.wav",					false },
-			{ ID::BombExplotion,		"./Data/Sounds/SE/BombExplotion.wav",			false },
-			{ ID::DoorOpenOrClose,		"./Data/Sounds/SE/DoorOpen_orClose.wav",		false },
+			{ ID::ItemChoose,			"./Data/Sounds/SE/UI/ItemChoose.wav",			false, false },
+			{ ID::ItemDecision,			"./Data/Sounds/SE/UI/ItemDecision.wav",			false, false },
+
+			{ ID::Alert,				"./Data/Sounds/SE/UI/Alert.wav",				true,  false },
+			{ ID::Jump,					"./Data/Sounds/SE/PL_Jump.wav",					false, false },
+			{ ID::Throw,				"./Data/Sounds/SE/HK_Throw.wav",				false, false },
+			{ ID::Appearance,			"./Data/Sounds/SE/HK_Appearance.wav",			false, false },
+			{ ID::Pull,					"./Data/Sounds/SE/HK_Pull.wav",					false, false },
+			{ ID::Insert,				"./Data/Sounds/SE/HK_Insert.wav",				false, false },
+			{ ID::GetKey,				"./Data/Sounds/SE/GetKey.wav",					false, false },
+			{ ID::BombExplotion,		"./Data/Sounds/SE/BombExplotion.wav",			false, false },
+			{ ID::DoorOpenOrClose,		"./Data/Sounds/SE/DoorOpen_orClose.wav",		false, false },
 
 		},
 	};
 
 	bool result = true, successed = true;
 
+	// The sounds are loaded in the background, so the first scene can start before finishing.
+	// The looping sounds(BGMs) are played late if these are requested while loading, the others are skipped because the late SE is wrong.
 	for ( size_t i = 0; i < ID::MUSIC_COUNT; ++i )
 	{
-		result = Load( bandles[i].id, bandles[i].fileName.c_str(), bandles[i].isEnableLoop );
+		const PendingPlay whilePending = ( bandles[i].isEnableLoop ) ? PendingPlay::Queue : PendingPlay::Skip;
+		result = LoadAsync( bandles[i].id, bandles[i].fileName.c_str(), bandles[i].isEnableLoop, bandles[i].isStreaming, whilePending );
 		if ( !result ) { successed = false; }
 	}
 
+	// These are played by many gimmicks at once(e.g. a chain of explosions), the sounds in a short interval are not distinguishable.
+	constexpr float CROWDED_SE_INTERVAL = 0.05f; // Seconds.
+	Donya::Sound::SetPlayInterval( ID::BombExplotion,	CROWDED_SE_INTERVAL );
+	Donya::Sound::SetPlayInterval( ID::Insert,			CROWDED_SE_INTERVAL );
+	Donya::Sound::SetPlayInterval( ID::DoorOpenOrClose,	CROWDED_SE_INTERVAL );
+
 	return successed;
 }
 
@@ -161,9 +184,42 @@ void Framework::DebugShowInformation()
 			RB = Donya::Mouse::Press( Donya::Mouse::RIGHT );
 			ImGui::Text( "LB : %d, MB : %d, RB : %d", LB, MB, RB );
 
+			const auto meshStats = Donya::StaticMesh::GetLastRenderStats();
+			ImGui::Text( "StaticMesh : DrawCall[%u], CBUpdate[%u], Instance[%u]", meshStats.drawCalls, meshStats.constantBufferUpdates, meshStats.instanceCount );
+
+			const auto commandStats = Donya::RenderCommand::GetLastFrameStats();
+			ImGui::Text( "RenderCommand : Command[%d], StateChange[Recorded:%d, Submitted:%d]", scast<int>( commandStats.commandCount ), scast<int>( commandStats.recordedOrder.Total() ), scast<int>( commandStats.submittedOrder.Total() ) );
+
+			const auto cullingStats = ViewCulling::GetLastStats();
+			ImGui::Text( "ViewCulling : Culled[%d / %d], GridQuery[%d]", scast<int>( cullingStats.culledCount ), scast<int>( cullingStats.totalCount ), scast<int>( cullingStats.queryCount ) );
+			bool enableCulling = ViewCulling::IsEnabled();
+			if ( ImGui::Checkbox( "Enable ViewCulling", &enableCulling ) )
+			{
+				ViewCulling::SetEnable( enableCulling );
+			}
+
+			const auto transformStats = GimmickBase::GetLastTransformStats();
+			ImGui::Text( "Gimmick Transform : Build[%u], Hit[%u], MatrixMul[%u]", transformStats.worldMatrixBuilds, transformStats.worldMatrixHits, transformStats.matrixMultiplies );
+
+			const auto debugDrawStats = Donya::DebugDraw::GetLastStats();
+			ImGui::Text( "DebugDraw : Line[%d / %d], Overflow[%d], DrawCall[%d]", scast<int>( debugDrawStats.lineCount ), scast<int>( Donya::DebugDraw::GetBudget() ), scast<int>( debugDrawStats.overflowCount ), scast<int>( debugDrawStats.drawCalls ) );
+			int debugDrawBudget = scast<int>( Donya::DebugDraw::GetBudget() );
+			if ( ImGui::DragInt( "DebugDraw Budget", &debugDrawBudget, 16.0f, 0, scast<int>( Donya::DebugDraw::DEFAULT_MAX_LINE_COUNT ) ) )
+			{
+				Donya::DebugDraw::SetBudget( scast<size_t>( debugDrawBudget ) );
+			}
+
+			const auto shaderStats = Donya::Resource::GetShaderCacheStats();
+			ImGui::Text( "Shader : Compiled[%u] in %.2f ms, CacheHit[%u], Invalidated[%u]", shaderStats.compiledCount, shaderStats.compileSeconds * 1000.0, shaderStats.cacheHitCount, shaderStats.invalidatedCount );
+
 			ImGui::TreePop();
 		}
 
+		Donya::AllocationTracker::ShowImGuiNode( "Allocation" );
+		Donya::Sprite::ShowImGuiNode( "Sprite" );
+		Donya::ResourceBudget::ShowImGuiNode( "Resource Budget" );
+		Donya::Input::ShowImGuiNode( "Input" );
+
 		if ( ImGui::TreeNode( u8"C[WOf" ) )
 		{
 			using namespace Donya::Easing;
@@ -46,6 +46,28 @@ namespace
 		if ( source.exist != false ) { return false; }
 		return true;
 	}
+
+	/// <summary>
+	/// Returns the "L" that is expanded to cover the "R".
+	/// </summary>
+	AABBEx	Cover( AABBEx L, const AABBEx &R )
+	{
+		const Donya::Vector3 min
+		{
+			std::min( L.pos.x - L.size.x, R.pos.x - R.size.x ),
+			std::min( L.pos.y - L.size.y, R.pos.y - R.size.y ),
+			std::min( L.pos.z - L.size.z, R.pos.z - R.size.z )
+		};
+		const Donya::Vector3 max
+		{
+			std::max( L.pos.x + L.size.x, R.pos.x + R.size.x ),
+			std::max( L.pos.y + L.size.y, R.pos.y + R.size.y ),
+			std::max( L.pos.z + L.size.z, R.pos.z + R.size.z )
+		};
+		L.pos  = ( min + max ) * 0.5f;
+		L.size = ( max - min ) * 0.5f;
+		return L;
+	}
 }
 
 #pragma region Bomb
@@ -258,6 +280,13 @@ void Bomb::Init( int gimmickKind, float roll, const Donya::Vector3 &wsPos )
 	rollDegree	= roll;
 	pos			= wsPos;
 	velocity	= 0.0f;
+
+	// The instance may be recycled by the generator, so reset the states also.
+	wasCompressed = false;
+	status	= State::Bomb;
+	scale	= 1.0f;
+	alpha	= 1.0f;
+	contacts.Clear();
 }
 void Bomb::Uninit()
 {
@@ -293,25 +322,20 @@ void Bomb::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, const s
 
 void Bomb::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	if ( NowExplosioning() )
 	{
 		const Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, alpha };
-		modelExplosion.Render
-		(
-			nullptr,
-			/* useDefaultShading	= */ true,
-			/* isEnableFill			= */ true,
-			W * V * P, W, lightDir, color
-		);
+		CountMatrixMultiply( 2U );
+		// Drawn after the batched opaque gimmicks, because the explosion is translucent.
+		DrawUnbatched( &modelExplosion, W * V * P, W, lightDir, color );
 		return;
 	}
 	// else
 
 	const Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, alpha };
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 }
 
 void Bomb::WakeUp()
@@ -344,6 +368,17 @@ AABBEx Bomb::GetHitBox() const
 	return base;
 }
 
+AABBEx Bomb::GetInfluenceArea() const
+{
+	if ( NowExplosioning() ) { return GetHitBox(); }
+	// else
+
+	// The ignition moves me by velocity, then explodes.
+	AABBEx explosion = ParamBomb::Get().Data().hitBoxExpl;
+	explosion.pos += pos + velocity;
+	return Cover( GetHitBox(), explosion );
+}
+
 Donya::Vector4x4 Bomb::GetWorldMatrix( bool useDrawing ) const
 {
 	auto wsBox = GetHitBox();
@@ -353,17 +388,7 @@ Donya::Vector4x4 Bomb::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamBomb::Get().Data().drawScale * scale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamBomb::Get().Data().drawScale * scale, ToRadian( rollDegree ) );
 }
 
 void Bomb::Fall( float elapsedTime )
@@ -678,6 +703,8 @@ void BombGenerator::Init( int gimmickKind, float roll, const Donya::Vector3 &wsP
 	velocity	= 0.0f;
 
 	generateTimer = ParamBombGenerator::Get().Data().generateFrame;
+
+	bombs.Reserve( MAX_BOMB_COUNT );
 }
 void BombGenerator::Uninit()
 {
@@ -698,16 +725,16 @@ void BombGenerator::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox
 
 void BombGenerator::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 
-	for ( const auto &it : bombs )
+	const size_t bombCount = bombs.Size();
+	for ( size_t i = 0; i < bombCount; ++i )
 	{
-		it.Draw( V, P, lightDir );
+		bombs.At( i ).Draw( V, P, lightDir );
 	}
 }
 
@@ -735,18 +762,30 @@ bool BombGenerator::HasMultipleHitBox() const
 {
 	return true;
 }
-std::vector<AABBEx> BombGenerator::GetAnotherHitBoxes() const
+Donya::FrameVector<AABBEx> BombGenerator::GetAnotherHitBoxes() const
 {
-	const size_t boxCount = bombs.size();
-	std::vector<AABBEx> multipleHitBoxes{ boxCount };
+	const size_t boxCount = bombs.Size();
+	Donya::FrameVector<AABBEx> multipleHitBoxes( boxCount );
 
 	for ( size_t i = 0; i < boxCount; ++i )
 	{
-		multipleHitBoxes[i] = bombs[i].GetHitBox();
+		multipleHitBoxes[i] = bombs.At( i ).GetHitBox();
 	}
 
 	return multipleHitBoxes;
 }
+AABBEx BombGenerator::GetInfluenceArea() const
+{
+	AABBEx area = GetHitBox();
+
+	const size_t bombCount = bombs.Size();
+	for ( size_t i = 0; i < bombCount; ++i )
+	{
+		area = Cover( area, bombs.At( i ).GetInfluenceArea() );
+	}
+
+	return area;
+}
 
 void BombGenerator::CountDown( float elapsedTime )
 {
@@ -757,41 +796,46 @@ void BombGenerator::Generate()
 	if ( 0.0f < generateTimer ) { return; }
 	// else
 
+	// Keep the timer as expired, so generate as soon as a bomb is released.
+	const auto handle = bombs.Acquire();
+	Bomb *pBomb = bombs.Find( handle );
+	if ( !pBomb ) { return; }
+	// else
+
 	const auto &param = ParamBombGenerator::Get().Data();
 	generateTimer = param.generateFrame;
 
-	bombs.push_back( Bomb{} );
-	bombs.back().Init( scast<int>( GimmickKind::Bomb ), 0.0f, pos + param.generateOffset );
+	pBomb->Init( scast<int>( GimmickKind::Bomb ), 0.0f, pos + param.generateOffset );
 }
 
 void BombGenerator::UpdateBombs( float elapsedTime )
 {
-	for ( auto &it : bombs )
+	const size_t bombCount = bombs.Size();
+	for ( size_t i = 0; i < bombCount; ++i )
 	{
-		it.Update( elapsedTime );
+		bombs.At( i ).Update( elapsedTime );
 	}
 
 	EraseBombs();
 }
 void BombGenerator::PhysicUpdateBombs( const BoxEx &player, const BoxEx &accompanyBox, const std::vector<BoxEx> &terrains, bool collideToPlayer, bool ignoreHitBoxExist )
 {
-	for ( auto &it : bombs )
+	const size_t bombCount = bombs.Size();
+	for ( size_t i = 0; i < bombCount; ++i )
 	{
-		it.PhysicUpdate( player, accompanyBox, terrains, collideToPlayer, ignoreHitBoxExist );
+		bombs.At( i ).PhysicUpdate( player, accompanyBox, terrains, collideToPlayer, ignoreHitBoxExist );
 	}
 }
 void BombGenerator::EraseBombs()
 {
-	auto itr = std::remove_if
+	// The released bomb returns to the pool without deallocation, and the order of the others is kept.
+	bombs.ReleaseIf
 	(
-		bombs.begin(), bombs.end(),
-		[]( Bomb &element )
+		[]( const Bomb &element )
 		{
 			return element.ShouldRemove();
 		}
 	);
-	
-	bombs.erase( itr, bombs.end() );
 }
 
 Donya::Vector4x4 BombGenerator::GetWorldMatrix( bool useDrawing ) const
@@ -803,17 +847,7 @@ Donya::Vector4x4 BombGenerator::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamBombGenerator::Get().Data().drawScale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamBombGenerator::Get().Data().drawScale, ToRadian( rollDegree ) );
 }
 
 #if USE_IMGUI
@@ -827,7 +861,7 @@ void BombGenerator::ShowImGuiNode()
 	ImGui::DragFloat3( u8"[hW",	&pos.x,			0.1f	);
 	ImGui::DragFloat3( u8"x",			&velocity.x,	0.01f	);
 
-	const size_t bombCount = bombs.size();
+	const size_t bombCount = bombs.Size();
 
 	const std::string nodeCaption = u8"F[" + std::to_string( bombCount ) + u8"]";
 	if ( ImGui::TreeNode(  nodeCaption.c_str() ) )
@@ -840,7 +874,7 @@ void BombGenerator::ShowImGuiNode()
 				instanceCaption = "[" + std::to_string( i ) + "]";
 				if ( ImGui::TreeNode( instanceCaption.c_str() ) )
 				{
-					bombs[i].ShowImGuiNode();
+					bombs.At( i ).ShowImGuiNode();
 
 					ImGui::TreePop();
 				}
@@ -1018,12 +1052,11 @@ void BombDuct::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, con
 
 void BombDuct::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 }
 
 bool BombDuct::ShouldRemove() const
@@ -1050,17 +1083,7 @@ Donya::Vector4x4 BombDuct::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamBombDuct::Get().Data().drawScale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamBombDuct::Get().Data().drawScale, ToRadian( rollDegree ) );
 }
 
 #if USE_IMGUI
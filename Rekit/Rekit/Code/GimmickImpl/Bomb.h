@@ -6,6 +6,7 @@
 #undef min
 #include <cereal/types/polymorphic.hpp>
 
+#include "Donya/ObjectPool.h"
 #include "Donya/StaticMesh.h"
 #include "Donya/UseImGui.h"
 #include "Donya/Vector.h"
@@ -80,6 +81,10 @@ public:
 	/// Returns world space hit-box.
 	/// </summary>
 	AABBEx GetHitBox() const override;
+	/// <summary>
+	/// Contains the explosion area, because I may explode in a PhysicUpdate().
+	/// </summary>
+	AABBEx GetInfluenceArea() const override;
 private:
 	Donya::Vector4x4 GetWorldMatrix( bool useDrawing = false ) const;
 
@@ -122,9 +127,11 @@ public:
 	/// </summary>
 	static void UseParameterImGui();
 #endif // USE_IMGUI
+private:
+	static constexpr size_t MAX_BOMB_COUNT = 16U; // The generation waits while the pool is full.
 private:
 	float generateTimer;
-	std::vector<Bomb> bombs;
+	Donya::ObjectPool<Bomb> bombs;
 public:
 	BombGenerator();
 	~BombGenerator();
@@ -162,7 +169,11 @@ public:
 	/// </summary>
 	AABBEx GetHitBox() const override;
 	bool HasMultipleHitBox() const override;
-	std::vector<AABBEx> GetAnotherHitBoxes() const override;
+	Donya::FrameVector<AABBEx> GetAnotherHitBoxes() const override;
+	/// <summary>
+	/// Contains the influence area of all generated bombs.
+	/// </summary>
+	AABBEx GetInfluenceArea() const override;
 private:
 	Donya::Vector4x4 GetWorldMatrix( bool useDrawing = false ) const;
 private:
@@ -240,12 +240,11 @@ void Elevator::PhysicUpdate ( const BoxEx & player, const BoxEx & accompanyBox,
 
 void Elevator::Draw ( const Donya::Vector4x4 & V, const Donya::Vector4x4 & P, const Donya::Vector4 & lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix ( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix ( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw ( WVP, W, lightDir, color );
+	BaseDraw ( W, lightDir, color );
 }
 
 void Elevator::WakeUp ()
@@ -282,14 +281,7 @@ Donya::Vector4x4 Elevator::GetWorldMatrix ( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamElevator::Get().Data().drawScale;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix ( wsBox.pos, ParamElevator::Get().Data().drawScale, 0.0f, /* enableRotation = */ false );
 }
 
 #if USE_IMGUI
@@ -186,12 +186,11 @@ void FlammableBlock::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBo
 
 void FlammableBlock::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 }
 
 bool FlammableBlock::ShouldRemove() const
@@ -220,17 +219,7 @@ Donya::Vector4x4 FlammableBlock::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamFlammableBlock::Get().Data().drawScale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamFlammableBlock::Get().Data().drawScale, ToRadian( rollDegree ) );
 }
 
 #if USE_IMGUI
@@ -203,12 +203,11 @@ void FragileBlock::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox,
 
 void FragileBlock::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 }
 
 void FragileBlock::WakeUp()
@@ -243,17 +242,7 @@ Donya::Vector4x4 FragileBlock::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamFragileBlock::Get().Data().drawScale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamFragileBlock::Get().Data().drawScale, ToRadian( rollDegree ) );
 }
 
 void FragileBlock::Fall( float elapsedTime )
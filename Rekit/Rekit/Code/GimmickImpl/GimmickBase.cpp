@@ -1,54 +1,256 @@
 #include "GimmickBase.h"
 
+#include <algorithm>		// Use std::max().
+#include <array>
+#include <cstring>			// Use memcmp().
+
+#include "Donya/FrameArena.h"
+#include "Donya/Quaternion.h"
 #include "Donya/Useful.h"	// Use SignBit(), ZeroEqual().
 #include "Donya/Sound.h"
 
 #if DEBUG_MODE
-#include "Donya/GeometricPrimitive.h"	// Use for drawing a collision.
+#include "Donya/DebugDraw.h"			// Use for drawing a collision.
 #endif // DEBUG_MODE
 
 #include "Common.h"
 #include "Music.h"
 #include "GimmickUtil.h"
 
+#undef max
+#undef min
+
 using namespace GimmickUtility;
 
+namespace
+{
+	// The buffers are reused between frames. The drawing is done at the main thread only.
+	static std::array<std::vector<Donya::StaticMesh::InstanceData>, scast<size_t>( GimmickKind::GimmicksCount )> batchInstances{};
+	static bool nowBatching = false;
+
+	// The translucent surfaces must be drawn after the opaque geometry, so these are queued while the batching.
+	struct UnbatchedDraw
+	{
+		const Donya::StaticMesh	*pModel{ nullptr };
+		Donya::Vector4x4		WVP{};
+		Donya::Vector4x4		W{};
+		Donya::Vector4			lightDir{};
+		Donya::Vector4			color{};
+	};
+	static std::vector<UnbatchedDraw> unbatchedDraws{};
+
+	void RenderUnbatched( const UnbatchedDraw &draw )
+	{
+		draw.pModel->Render
+		(
+			nullptr,
+			/* useDefaultShading	= */ true,
+			/* isEnableFill			= */ true,
+			draw.WVP, draw.W, draw.lightDir, draw.color
+		);
+	}
+
+	static Donya::Vector4x4	viewProjection{};
+	static unsigned int		VPVersion = 0;	// Increase when the "viewProjection" is changed. It invalidates the cached WVPs.
+
+	static GimmickBase::TransformStats currentTransformStats{};
+	static GimmickBase::TransformStats lastTransformStats{};
+
+	// Per thread, because the islands are solved in parallel.
+	struct CollisionGrid
+	{
+		const std::vector<BoxEx>	*pTerrains{ nullptr };
+		const ViewCulling::Grid		*pGrid{ nullptr };
+		const size_t				*pMovingIndices{ nullptr };
+		size_t						movingCount{};
+	};
+	static thread_local CollisionGrid collisionGrid{};
+
+	// Compare by bits, because the cache should be invalidated by any change.
+	template<typename T>
+	bool IsSameBits( const T &L, const T &R )
+	{
+		return ( memcmp( &L, &R, sizeof( T ) ) == 0 );
+	}
+}
+void GimmickBase::BeginBatchDraw( const Donya::Vector4x4 &VP )
+{
+	for ( auto &it : batchInstances )
+	{
+		it.clear();
+	}
+	unbatchedDraws.clear();
+	nowBatching = true;
+
+	if ( !IsSameBits( viewProjection, VP ) )
+	{
+		viewProjection = VP;
+		VPVersion++;
+	}
+}
+void GimmickBase::EndBatchDraw( const Donya::Vector4 &lightDir )
+{
+	const Donya::Vector4x4 &VP = viewProjection;
+
+	nowBatching = false;
+
+	const size_t kindCount = batchInstances.size();
+	for ( size_t i = 0; i < kindCount; ++i )
+	{
+		auto &instances = batchInstances[i];
+		if ( instances.empty() ) { continue; }
+		// else
+
+		const Donya::StaticMesh *pModel = GetModelAddress( scast<GimmickKind>( i ) );
+		if ( pModel )
+		{
+			pModel->RenderInstanced( instances.data(), instances.size(), VP, lightDir );
+		}
+
+		instances.clear();
+	}
+
+	for ( const auto &it : unbatchedDraws )
+	{
+		RenderUnbatched( it );
+	}
+	unbatchedDraws.clear();
+}
+
+void GimmickBase::BeginCollisionGrid( const std::vector<BoxEx> &terrains, const ViewCulling::Grid &grid, const size_t *pMovingIndices, size_t movingCount )
+{
+	collisionGrid.pTerrains			= &terrains;
+	collisionGrid.pGrid				= &grid;
+	collisionGrid.pMovingIndices	= pMovingIndices;
+	collisionGrid.movingCount		= movingCount;
+}
+void GimmickBase::EndCollisionGrid()
+{
+	collisionGrid = CollisionGrid{};
+}
+
+GimmickBase::TransformStats GimmickBase::GetLastTransformStats()
+{
+	return lastTransformStats;
+}
+void GimmickBase::FlushTransformStats()
+{
+	lastTransformStats		= currentTransformStats;
+	currentTransformStats	= TransformStats{};
+}
+void GimmickBase::CountMatrixMultiply( unsigned int count )
+{
+	currentTransformStats.matrixMultiplies += count;
+}
+
 GimmickBase::GimmickBase() :
 	kind(),
 	rollDegree(),
 	pos(), velocity(),
-	wasCompressed( false )
+	wasCompressed( false ),
+	contacts(), pushedDirections(),
+	transformCache()
 {}
 GimmickBase::~GimmickBase() = default;
 
 void GimmickBase::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, const std::vector<BoxEx> &terrains, bool collideToPlayer, bool ignoreHitBoxExist, bool allowCompress )
 {
-	std::vector<BoxEx> wholeCollisions = terrains;
-	if ( collideToPlayer )
+	// The collisions are regarded as arranged in the order : [terrains][player(if collideToPlayer)].
+	// The player is not copied into the terrains, so the terrains are not re-built per gimmick.
+	const size_t terrainCount	= terrains.size();
+	const size_t playerIndex	= terrainCount;
+	const size_t collisionCount	= ( collideToPlayer ) ? terrainCount + 1U : terrainCount;
+	auto GetCollision = [&]( size_t index )->const BoxEx &
 	{
-		wholeCollisions.emplace_back( player );
-	}
+		return ( index < terrainCount ) ? terrains[index] : player;
+	};
+
+	// Use the grid only if it was built from the "terrains".
+	const CollisionGrid grid = collisionGrid;
+	const bool useGrid = ( grid.pTerrains == &terrains && grid.pGrid && !grid.pGrid->IsEmpty() );
+	Donya::FrameVector<size_t> candidates{};
 
-	auto CalcCollidingBox = [&]( const BoxEx &myself, const BoxEx &previousMyself )->BoxEx
+	const AABBEx actualBody		= GetHitBox();
+	const BoxEx  previousXYBody	= actualBody.Get2D();
+
+	contacts.Begin();
+
+	auto IsColliding = [&]( const BoxEx &it, const BoxEx &myself )->bool
+	{
+		if ( it.mass < myself.mass ) { return false; }
+		if ( it == previousXYBody  ) { return false; }
+		// else
+
+		return Donya::Box::IsHitBox( it, myself, ignoreHitBoxExist );
+	};
+	// Returns the index of collisions that is matched to the previous contact, or ContactCache::NOT_FOUND.
+	auto ValidateContact = [&]( const ContactCache::Contact &contact )->size_t
 	{
-		for ( const auto &it : wholeCollisions )
+		if ( contact.hintIndex == playerIndex )
 		{
-			if ( it.mass < myself.mass ) { continue; }
-			if ( it == previousMyself  ) { continue; }
+			if ( !collideToPlayer ) { return ContactCache::NOT_FOUND; }
+			// else
+			return ( ContactCache::MakeKey( previousXYBody, player ) == contact.key ) ? playerIndex : ContactCache::NOT_FOUND;
+		}
+		// else
+		return contacts.Validate( contact, previousXYBody, terrains.data(), terrainCount );
+	};
+	// Returns the index of collisions, or ContactCache::NOT_FOUND if does not collide.
+	auto CalcCollidingIndex = [&]( const BoxEx &myself )->size_t
+	{
+		// Warm-start : Check the contacts that resolved at last frame before the whole search.
+		// A resting(or moving together) stack will collide with these again.
+		size_t index{};
+		for ( const auto &it : contacts.Previous() )
+		{
+			index = ValidateContact( it );
+			if ( index == ContactCache::NOT_FOUND ) { continue; }
 			// else
 
-			if ( Donya::Box::IsHitBox( it, myself, ignoreHitBoxExist ) )
+			if ( IsColliding( GetCollision( index ), myself ) )
 			{
-				return it;
+				return index;
 			}
 		}
 
-		return BoxEx::Nil();
+		if ( !useGrid )
+		{
+			for ( size_t i = 0; i < collisionCount; ++i )
+			{
+				if ( IsColliding( GetCollision( i ), myself ) )
+				{
+					return i;
+				}
+			}
+
+			return ContactCache::NOT_FOUND;
+		}
+		// else
+
+		// The grid returns the candidates in any order, so take the smallest index as same as the whole search.
+		size_t found = ContactCache::NOT_FOUND;
+		auto Consider = [&]( size_t i )
+		{
+			if ( found <= i ) { return; }
+			// else
+			if ( IsColliding( terrains[i], myself ) ) { found = i; }
+		};
+
+		candidates.clear();
+		grid.pGrid->Query( myself, &candidates );
+		for ( const auto &it : candidates ) { Consider( it ); }
+		for ( size_t i = 0; i < grid.movingCount; ++i ) { Consider( grid.pMovingIndices[i] ); }
+
+		if ( found == ContactCache::NOT_FOUND && collideToPlayer && IsColliding( player, myself ) )
+		{
+			found = playerIndex;
+		}
+		return found;
 	};
 
-	std::vector<Donya::Vector2> pushedDirections{}; // Store a normalized-vector of [wall->myself].
+	pushedDirections.clear();
 	// Returns true if it is determined to compressed. The "pushDir" expect {0, 1} or {1, 0}.
-	auto JudgeWillCompressed = [&pushedDirections]( const Donya::Vector2 pushDir )->bool
+	auto JudgeWillCompressed = [&]( const Donya::Vector2 pushDir )->bool
 	{
 		pushedDirections.emplace_back( pushDir );
 		if ( pushedDirections.size() < 2U ) { return false; } // The myself does not compress if a vectors count less than two.
@@ -67,8 +269,33 @@ void GimmickBase::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox,
 		return false;
 	};
 
-	const AABBEx actualBody		= GetHitBox();
-	const BoxEx  previousXYBody	= actualBody.Get2D();
+	if ( allowCompress )
+	{
+		// Keep the compression state of last frame.
+		// A contact that pushed me at last frame is still effective while it touching to me,
+		// so a stack that is pushed by each side at alternate frames can be compressed.
+
+		// The resolver leaves a gap of ERROR_MARGIN, so I should expand my body a little for detecting the touching.
+		constexpr float TOUCH_MARGIN = 0.001f;
+		BoxEx touchArea =  previousXYBody;
+		touchArea.size  += TOUCH_MARGIN;
+
+		size_t index{};
+		for ( const auto &it : contacts.Previous() )
+		{
+			if ( it.pushDirection.IsZero() ) { continue; }
+			// else
+
+			index = ValidateContact( it );
+			if ( index == ContactCache::NOT_FOUND ) { continue; }
+			if ( !Donya::Box::IsHitBox( GetCollision( index ), touchArea, ignoreHitBoxExist ) ) { continue; }
+			// else
+
+			pushedDirections.emplace_back( it.pushDirection );
+			// The push is effective in this frame only. Register without the direction, so it is cleared if the contact does not push me again.
+			contacts.Register( it.key, index, Donya::Vector2{} );
+		}
+	}
 
 	if ( Donya::Box::IsHitBox( accompanyBox, previousXYBody, ignoreHitBoxExist ) )
 	{
@@ -107,17 +334,23 @@ void GimmickBase::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox,
 	BoxEx movedXYBody = previousXYBody;
 	movedXYBody.pos  += xyVelocity;
 
-	BoxEx other{};
+	BoxEx  other{};
+	size_t otherIndex{};
 
 	constexpr unsigned int MAX_LOOP_COUNT = 1000U;
 	unsigned int loopCount{};
 	while ( ++loopCount < MAX_LOOP_COUNT )
 	{
-		other = CalcCollidingBox( movedXYBody, previousXYBody );
-		if ( other == BoxEx::Nil() ) { break; } // Does not detected a collision.
+		otherIndex = CalcCollidingIndex( movedXYBody );
+		if ( otherIndex == ContactCache::NOT_FOUND ) { break; } // Does not detected a collision.
 		// else
 
-		if ( other.mass < movedXYBody.mass ) { continue; }
+		other = GetCollision( otherIndex );
+
+		// Nothing changes in the below cases, so the next loop would detect the same contact again.
+		// Stop here instead of spinning until the MAX_LOOP_COUNT.
+
+		if ( other.mass < movedXYBody.mass ) { break; }
 		// else
 
 		if ( ZeroEqual( moveSign.x ) && !ZeroEqual( other.velocity.x ) )
@@ -131,7 +364,7 @@ void GimmickBase::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox,
 			moveSign.y = scast<float>( Donya::SignBit( -other.velocity.y ) );
 		}
 
-		if ( moveSign.IsZero() ) { continue; } // Each other does not move, so collide is no possible.
+		if ( moveSign.IsZero() ) { break; } // Each other does not move, so collide is no possible.
 		// else
 
 		auto CalcPenetration	= []( const BoxEx &myself, const Donya::Vector2 &myMoveSign, const BoxEx &other )
@@ -216,6 +449,8 @@ void GimmickBase::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox,
 			pushDirection = Donya::Vector2{ moveSign.x, 0.0f };
 		}
 
+		contacts.Register( ContactCache::MakeKey( previousXYBody, other ), otherIndex, pushDirection );
+
 		if ( allowCompress && JudgeWillCompressed( pushDirection ) )
 		{
 			Donya::Sound::Play( Music::Insert );
@@ -233,35 +468,141 @@ void GimmickBase::BaseDraw( const Donya::Vector4x4 &matWVP, const Donya::Vector4
 	if ( !pModel ) { return; }
 	// else
 
-	pModel->Render
-	(
-		nullptr,
-		/* useDefaultShading	= */ true,
-		/* isEnableFill			= */ true,
-		matWVP, matW, lightDir, materialColor
-	);
+	// The translucent one is not batched, for keeping the order of blending.
+	const bool canBatch = ( nowBatching && 1.0f <= materialColor.w && 0 <= kind && kind < scast<int>( batchInstances.size() ) );
+	if ( canBatch )
+	{
+		batchInstances[kind].emplace_back( Donya::StaticMesh::InstanceData{ matW, materialColor } );
+	}
+	else
+	{
+		DrawUnbatched( pModel, matWVP, matW, lightDir, materialColor );
+	}
 
 #if DEBUG_MODE
 	if ( Common::IsShowCollision() )
 	{
-		static Donya::Geometric::Cube cube = Donya::Geometric::CreateCube();
+		// These are drawn at Donya::DebugDraw::Flush().
 
-		cube.Render
-		(
-			nullptr,
-			/* useDefaultShading	= */ true,
-			/* isEnableFill			= */ true,
-			matWVP, matW, lightDir, materialColor
-		);
+		constexpr Donya::Vector4 normalColor{ 0.2f, 1.0f, 0.2f, 1.0f };
+		constexpr Donya::Vector4 pathColor  { 1.0f, 0.8f, 0.2f, 1.0f };
+
+		const AABBEx wsBox = GetHitBox();
+		Donya::DebugDraw::ReserveAABB( wsBox, Donya::Vector4{ materialColor.x, materialColor.y, materialColor.z, 1.0f } );
+
+		// The directions that pushed myself at last update.
+		const float normalLength = std::max( wsBox.size.x, wsBox.size.y );
+		for ( const auto &it : pushedDirections )
+		{
+			Donya::DebugDraw::ReserveRay( wsBox.pos, Donya::Vector3{ it, 0.0f }, normalLength, normalColor );
+		}
+
+		if ( !velocity.IsZero() )
+		{
+			Donya::DebugDraw::ReserveLine( wsBox.pos, wsBox.pos + velocity, pathColor );
+		}
 	}
 #endif // DEBUG_MODE
 }
 
+void GimmickBase::BaseDraw( const Donya::Vector4x4 &W, const Donya::Vector4 &lightDir, const Donya::Vector4 &materialColor ) const
+{
+	// The batched one does not use the WVP, the instanced draw uses the view-projection.
+	const bool willBatch = ( nowBatching && 1.0f <= materialColor.w && 0 <= kind && kind < scast<int>( batchInstances.size() ) );
+	if ( willBatch )
+	{
+		BaseDraw( W, W, lightDir, materialColor );
+		return;
+	}
+	// else
+
+	TransformCache &cache = transformCache;
+	const bool isCachedW = ( cache.validW && IsSameBits( cache.W, W ) );
+	if ( !isCachedW )
+	{
+		CountMatrixMultiply();
+		BaseDraw( W * viewProjection, W, lightDir, materialColor );
+		return;
+	}
+	// else
+
+	if ( !cache.validWVP || cache.VPVersion != VPVersion )
+	{
+		CountMatrixMultiply();
+		cache.WVP		= cache.W * viewProjection;
+		cache.VPVersion	= VPVersion;
+		cache.validWVP	= true;
+	}
+
+	BaseDraw( cache.WVP, cache.W, lightDir, materialColor );
+}
+
+void GimmickBase::DrawUnbatched( const Donya::StaticMesh *pModel, const Donya::Vector4x4 &matWVP, const Donya::Vector4x4 &matW, const Donya::Vector4 &lightDir, const Donya::Vector4 &materialColor )
+{
+	if ( !pModel ) { return; }
+	// else
+
+	const UnbatchedDraw draw{ pModel, matWVP, matW, lightDir, materialColor };
+	if ( nowBatching )
+	{
+		unbatchedDraws.emplace_back( draw );
+		return;
+	}
+	// else
+
+	RenderUnbatched( draw );
+}
+
+const Donya::Vector4x4 &GimmickBase::MakeWorldMatrix( const Donya::Vector3 &translation, float scale, float rollRadian, bool enableRotation ) const
+{
+	TransformCache &cache = transformCache;
+	if ( cache.validW
+	&&   IsSameBits( cache.translation, translation )
+	&&   IsSameBits( cache.scale, scale )
+	&&   IsSameBits( cache.rollRadian, rollRadian )
+	&&   cache.enableRotation == enableRotation
+	)
+	{
+		currentTransformStats.worldMatrixHits++;
+		return cache.W;
+	}
+	// else
+
+	currentTransformStats.worldMatrixBuilds++;
+
+	Donya::Vector4x4 mat{};
+	mat._11 =
+	mat._22 =
+	mat._33 = scale;
+	if ( enableRotation )
+	{
+		const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), rollRadian );
+		mat *= rotation.RequireRotationMatrix();
+		CountMatrixMultiply();
+	}
+	mat._41 = translation.x;
+	mat._42 = translation.y;
+	mat._43 = translation.z;
+
+	cache.translation		= translation;
+	cache.scale				= scale;
+	cache.rollRadian		= rollRadian;
+	cache.enableRotation	= enableRotation;
+	cache.W					= mat;
+	cache.validW			= true;
+	cache.validWVP			= false;
+	return cache.W;
+}
+
 int				GimmickBase::GetKind()		const { return kind;	}
 Donya::Vector3	GimmickBase::GetPosition()	const { return pos;		}
 
 bool GimmickBase::HasMultipleHitBox() const { return false; }
-std::vector<AABBEx> GimmickBase::GetAnotherHitBoxes() const
+Donya::FrameVector<AABBEx> GimmickBase::GetAnotherHitBoxes() const
+{
+	return Donya::FrameVector<AABBEx>();
+}
+AABBEx GimmickBase::GetInfluenceArea() const
 {
-	return std::vector<AABBEx>();
+	return GetHitBox();
 }
@@ -1,19 +1,89 @@
 #pragma once
 
+#include "Donya/FrameArena.h"
 #include "Donya/Serializer.h"
 #include "Donya/UseImGui.h"
 #include "Donya/Vector.h"
 
+#include "ContactCache.h"
 #include "DerivedCollision.h"
+#include "ViewCulling.h"
+
+namespace Donya
+{
+	class StaticMesh;
+}
 
 class GimmickBase
 {
+public:
+	/// <summary>
+	/// Start collecting the BaseDraw() of opaque gimmicks per kind, instead of drawing immediately.<para></para>
+	/// The "matViewProjection" is used by the BaseDraw() until the next call.
+	/// </summary>
+	static void BeginBatchDraw( const Donya::Vector4x4 &matViewProjection );
+	/// <summary>
+	/// Draw the collected gimmicks by one instanced draw per kind, then draw the queued unbatched ones(e.g. translucent) in the order of the queuing, then stop collecting.
+	/// </summary>
+	static void EndBatchDraw( const Donya::Vector4 &lightDirection );
+
+	/// <summary>
+	/// While the "terrains" is passed, the PhysicUpdate() of this thread finds the colliding box by the "grid" instead of testing all boxes.<para></para>
+	/// The "grid" must be built from the "terrains". The boxes of "pMovingIndices" may be moved while the solving, so these are always tested.
+	/// </summary>
+	static void BeginCollisionGrid( const std::vector<BoxEx> &terrains, const ViewCulling::Grid &grid, const size_t *pMovingIndices, size_t movingCount );
+	/// <summary>
+	/// Stop using the grid at this thread.
+	/// </summary>
+	static void EndCollisionGrid();
+public:
+	/// <summary>
+	/// The counts of the matrix calculations of all gimmicks.
+	/// </summary>
+	struct TransformStats
+	{
+		unsigned int worldMatrixBuilds{};	// The count of the world matrices that were re-calculated.
+		unsigned int worldMatrixHits{};		// The count of the world matrices that were returned from the cache.
+		unsigned int matrixMultiplies{};	// The count of the 4x4 matrix multiplications.
+	};
+	/// <summary>
+	/// Returns the counts of last frame.
+	/// </summary>
+	static TransformStats GetLastTransformStats();
+	/// <summary>
+	/// The counts of current frame will become the last frame's. Please call once per frame.
+	/// </summary>
+	static void FlushTransformStats();
+	/// <summary>
+	/// Add the count of the matrix multiplications that are done out of the GimmickBase.
+	/// </summary>
+	static void CountMatrixMultiply( unsigned int count = 1U );
+private:
+	/// <summary>
+	/// The inputs and the results of the last MakeWorldMatrix() and BaseDraw().
+	/// </summary>
+	struct TransformCache
+	{
+		Donya::Vector3		translation{};
+		float				scale{};
+		float				rollRadian{};
+		bool				enableRotation{};
+		bool				validW{ false };
+		bool				validWVP{ false };
+		unsigned int		VPVersion{};	// The version of the view-projection that the "WVP" was made by.
+		Donya::Vector4x4	W{};
+		Donya::Vector4x4	WVP{};
+	};
 protected:
 	int				kind;
 	float			rollDegree;	// The rotation amount with Z-axis.
 	Donya::Vector3	pos;		// World space.
 	Donya::Vector3	velocity;
 	bool			wasCompressed;
+	ContactCache	contacts;			// Persist the resolved contacts between frames. This is not serialize.
+	std::vector<Donya::Vector2> pushedDirections; // Store a normalized-vector of [wall->myself]. Reuse the buffer between frames.
+private:
+	mutable TransformCache transformCache;	// This is not serialize.
 public:
 	GimmickBase();
 	~GimmickBase();
@@ -54,6 +124,23 @@ public:
 	virtual void Draw( const Donya::Vector4x4 &matView, const Donya::Vector4x4 &matProjection, const Donya::Vector4 &lightDirection ) const = 0;
 protected:
 	void BaseDraw( const Donya::Vector4x4 &matWVP, const Donya::Vector4x4 &matW, const Donya::Vector4 &lightDir, const Donya::Vector4 &materialColor ) const;
+	/// <summary>
+	/// The WVP is made only if it is necessary(when this gimmick is not batched), by the view-projection of BeginBatchDraw().
+	/// So please call this between BeginBatchDraw() and EndBatchDraw(), even if the gimmick is translucent.<para></para>
+	/// If the "matW" is same as the last MakeWorldMatrix() and the view-projection is not changed, the cached WVP is used.
+	/// </summary>
+	void BaseDraw( const Donya::Vector4x4 &matW, const Donya::Vector4 &lightDir, const Donya::Vector4 &materialColor ) const;
+	/// <summary>
+	/// Draw the "pModel" without the batching. Between BeginBatchDraw() and EndBatchDraw(), it is queued and drawn after the batched opaque gimmicks.<para></para>
+	/// The "pModel" must be alive until the EndBatchDraw().
+	/// </summary>
+	static void DrawUnbatched( const Donya::StaticMesh *pModel, const Donya::Vector4x4 &matWVP, const Donya::Vector4x4 &matW, const Donya::Vector4 &lightDir, const Donya::Vector4 &materialColor );
+
+	/// <summary>
+	/// Returns the matrix of [Scaling * Rotation(Z-axis, if enabled) * Translation].<para></para>
+	/// The result is cached per gimmick, so the matrix is re-calculated only when an argument is changed from the last call.
+	/// </summary>
+	const Donya::Vector4x4 &MakeWorldMatrix( const Donya::Vector3 &translation, float scale, float rollRadian, bool enableRotation = true ) const;
 public:
 	/// <summary>
 	/// Tell something trigger to the gimmick.
@@ -82,9 +169,15 @@ public:
 	/// </summary>
 	virtual bool HasMultipleHitBox() const;
 	/// <summary>
-	/// Usually returns empty. If the HasMultipleHitBox() returns true, I returns another hit-boxes(the hit-box that returns by GetHitBox() isn't contain).
+	/// Usually returns empty. If the HasMultipleHitBox() returns true, I returns another hit-boxes(the hit-box that returns by GetHitBox() isn't contain).<para></para>
+	/// The result is allocated from the frame arena, so please do not keep it over the frame.
+	/// </summary>
+	virtual Donya::FrameVector<AABBEx> GetAnotherHitBoxes() const;
+	/// <summary>
+	/// Returns world space box that covers the area I may touch to others in a PhysicUpdate(), except the moving by velocity(e.g. an explosion).<para></para>
+	/// Usually returns GetHitBox().
 	/// </summary>
-	virtual std::vector<AABBEx> GetAnotherHitBoxes() const;
+	virtual AABBEx GetInfluenceArea() const;
 
 #if USE_IMGUI
 	virtual void ShowImGuiNode() {}
@@ -186,12 +186,11 @@ void HardBlock::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, co
 
 void HardBlock::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 }
 
 void HardBlock::WakeUp()
@@ -227,17 +226,7 @@ Donya::Vector4x4 HardBlock::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamHardBlock::Get().Data().drawScale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamHardBlock::Get().Data().drawScale, ToRadian( rollDegree ) );
 }
 
 void HardBlock::Fall( float elapsedTime )
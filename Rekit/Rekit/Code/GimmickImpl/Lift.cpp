@@ -207,15 +207,14 @@ void Lift::PhysicUpdate ( const BoxEx & player, const BoxEx & accompanyBox, cons
 
 void Lift::Draw ( const Donya::Vector4x4 & V, const Donya::Vector4x4 & P, const Donya::Vector4 & lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix ( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix ( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 colors[] = {
 		{ 1.0f, 1.0f, 1.0f, 1.0f },		// Horizontal
 		{ 1.0f, 1.0f, 1.0f, 1.0f }		// Vertical
 	};
 
-	BaseDraw ( WVP, W, lightDir, colors[scast<int> ( direction.x * direction.x )] );
+	BaseDraw ( W, lightDir, colors[scast<int> ( direction.x * direction.x )] );
 }
 
 void Lift::WakeUp ()
@@ -252,14 +251,7 @@ Donya::Vector4x4 Lift::GetWorldMatrix ( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamLift::Get().Data().drawScale;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix ( wsBox.pos, ParamLift::Get().Data().drawScale, 0.0f, /* enableRotation = */ false );
 }
 
 #if USE_IMGUI
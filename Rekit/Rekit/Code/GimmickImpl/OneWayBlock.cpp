@@ -208,48 +208,21 @@ void OneWayBlock::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox,
 }
 
 #if DEBUG_MODE
-#include "Donya/GeometricPrimitive.h"
+#include "Donya/DebugDraw.h"
 #include "Common.h"
 #endif // DEBUG_MODE
 void OneWayBlock::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 
 #if DEBUG_MODE
 	if ( Common::IsShowCollision() )
 	{
-		static Donya::Geometric::Cube cube = Donya::Geometric::CreateCube();
-		const auto trgArea = GetTriggerArea();
-
-		// Change the W matrix here.
-		{
-			const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-			const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-			Donya::Vector4x4 mat{};
-			mat._11 = trgArea.size.x * 2.0f;
-			mat._22 = trgArea.size.y * 2.0f;
-			mat._33 = trgArea.size.z * 2.0f;
-			mat *= R;
-			mat._41 = trgArea.pos.x;
-			mat._42 = trgArea.pos.y;
-			mat._43 = trgArea.pos.z;
-
-			W   = mat;
-			WVP = W * V * P;
-		}
-
-		cube.Render
-		(
-			nullptr,
-			/* useDefaultShading	= */ true,
-			/* isEnableFill			= */ true,
-			WVP, W, lightDir, { 0.2f, 0.5f, 1.0f, 0.5f }
-		);
+		Donya::DebugDraw::ReserveAABB( GetTriggerArea(), { 0.2f, 0.5f, 1.0f, 1.0f } );
 	}
 #endif // DEBUG_MODE
 }
@@ -320,17 +293,7 @@ Donya::Vector4x4 OneWayBlock::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamOneWayBlock::Get().Data().drawScale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamOneWayBlock::Get().Data().drawScale, ToRadian( rollDegree ) );
 }
 
 #if USE_IMGUI
@@ -176,12 +176,11 @@ void SpikeBlock::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, c
 
 void SpikeBlock::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
 {
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 }
 
 void SpikeBlock::WakeUp()
@@ -213,15 +212,7 @@ Donya::Vector4x4 SpikeBlock::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), radian + ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	const Donya::Vector4x4 S = Donya::Vector4x4::MakeScaling( ParamSpikeBlock::Get().Data().drawScale );
-
-	Donya::Vector4x4 mat = S * R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamSpikeBlock::Get().Data().drawScale, radian + ToRadian( rollDegree ) );
 }
 
 #if USE_IMGUI
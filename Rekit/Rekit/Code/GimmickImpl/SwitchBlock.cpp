@@ -249,12 +249,11 @@ void SwitchBlock::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, co
 	if ( WasBroken() ) { return; }
 	// else
 
-	Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
-	Donya::Vector4x4 WVP = W * V * P;
+	const Donya::Vector4x4 W = GetWorldMatrix( /* useDrawing = */ true );
 
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	BaseDraw( WVP, W, lightDir, color );
+	BaseDraw( W, lightDir, color );
 }
 
 void SwitchBlock::WakeUp()
@@ -287,17 +286,7 @@ Donya::Vector4x4 SwitchBlock::GetWorldMatrix( bool useDrawing ) const
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
-	mat._11 =
-	mat._22 =
-	mat._33 = ParamSwitchBlock::Get().Data().drawScale * scale;
-	mat *= R;
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, ParamSwitchBlock::Get().Data().drawScale * scale, ToRadian( rollDegree ) );
 }
 
 void SwitchBlock::Fall( float elapsedTime )
@@ -400,7 +400,7 @@ void Trigger::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, cons
 }
 
 #if DEBUG_MODE
-#include "Donya/GeometricPrimitive.h"
+#include "Donya/DebugDraw.h"
 #include "Common.h"
 #endif // DEBUG_MODE
 void Trigger::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
@@ -452,52 +452,26 @@ void Trigger::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const
 		W._41 = pos.x; // Discard the offset of hit-box for draw.
 		W._42 = pos.y; // Discard the offset of hit-box for draw.
 		W._43 = pos.z; // Discard the offset of hit-box for draw.
-		Donya::Vector4x4	VP		=  V * P;
-		Donya::Vector4x4	WVP		=  W * VP;
 
-		BaseDraw( WVP, W, lightDir, color );
+		BaseDraw( W, lightDir, color );
 
 	#if DEBUG_MODE
 		if ( Common::IsShowCollision() )
 		{
-			static Donya::Geometric::Cube cube = Donya::Geometric::CreateCube();
-
-			// Donya::Quaternion rotation{};
-			// Donya::Vector4x4  R{};
 			for ( int i = BASE_INDEX + 1; i < DrawCount; ++i )
 			{
-				W = Donya::Vector4x4::Identity();
-
-				// rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-				// R = rotation.RequireRotationMatrix();
-				W._11 = wsHitBoxes[i].size.x * 2.0f;
-				W._22 = wsHitBoxes[i].size.y * 2.0f;
-				W._33 = wsHitBoxes[i].size.z * 2.0f;
-				// W *= R;
-				W._41 = wsHitBoxes[i].pos.x;
-				W._42 = wsHitBoxes[i].pos.y;
-				W._43 = wsHitBoxes[i].pos.z;
-
-				WVP = W * VP;
-
 				color = colors[i];
 				if ( IsEnable() ) { color += lightenFactors[i]; }
+				color.w = 1.0f; // The wireframe is drawn as opaque.
 
-				cube.Render
-				(
-					nullptr,
-					/* useDefaultShading	= */ true,
-					/* isEnableFill			= */ true,
-					WVP, W, lightDir, color
-				);
+				Donya::DebugDraw::ReserveAABB( wsHitBoxes[i], color );
 			}
 		}
 	#endif // DEBUG_MODE
 	};
 	auto DrawOther  = [&]()
 	{
-		Donya::Vector4x4 W = GetWorldMatrix( GetHitBox(), /* useDrawing = */ true );
-		Donya::Vector4x4 WVP = W * V * P;
+		const Donya::Vector4x4 W = GetWorldMatrix( GetHitBox(), /* useDrawing = */ true );
 
 		constexpr Donya::Vector4 colors[]
 		{
@@ -516,7 +490,7 @@ void Trigger::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const
 		Donya::Vector4 color = colors[kindIndex];
 		if ( IsEnable() ) { color += lightenFactors[kindIndex]; }
 
-		BaseDraw( WVP, W, lightDir, color );
+		BaseDraw( W, lightDir, color );
 	};
 
 	if ( GimmickUtility::ToKind( kind ) == GimmickKind::TriggerSwitch )
@@ -571,7 +545,7 @@ bool Trigger::HasMultipleHitBox() const
 {
 	return ( GimmickUtility::ToKind( kind ) == GimmickKind::TriggerSwitch ) ? true : false;
 }
-std::vector<AABBEx> Trigger::GetAnotherHitBoxes() const
+Donya::FrameVector<AABBEx> Trigger::GetAnotherHitBoxes() const
 {
 	const auto &param = ParamTrigger::Get().Data();
 	const AABBEx hitBoxes[]
@@ -590,7 +564,7 @@ std::vector<AABBEx> Trigger::GetAnotherHitBoxes() const
 		return lsHitBox;
 	};
 
-	std::vector<AABBEx> multiHitBoxes{};
+	Donya::FrameVector<AABBEx> multiHitBoxes{};
 	multiHitBoxes.reserve( ArraySize( hitBoxes ) );
 
 	bool isGathering = false;
@@ -624,9 +598,6 @@ Donya::Vector4x4 Trigger::GetWorldMatrix( const AABBEx &inputBox, bool useDrawin
 		// wsBox.size *= 2.0f;
 	}
 
-	const Donya::Quaternion rotation = Donya::Quaternion::Make( Donya::Vector3::Front(), ToRadian( rollDegree ) );
-	const Donya::Vector4x4 R = rotation.RequireRotationMatrix();
-	Donya::Vector4x4 mat{};
 	const float drawScales[]
 	{
 		ParamTrigger::Get().Data().mKey.drawScale,		// Key
@@ -635,16 +606,7 @@ Donya::Vector4x4 Trigger::GetWorldMatrix( const AABBEx &inputBox, bool useDrawin
 	};
 	const int kindIndex = GetTriggerKindIndex();
 
-	mat._11 =
-	mat._22 =
-	mat._33 = drawScales[kindIndex];
-
-	if ( enableRotation ) { mat *= R; }
-
-	mat._41 = wsBox.pos.x;
-	mat._42 = wsBox.pos.y;
-	mat._43 = wsBox.pos.z;
-	return mat;
+	return MakeWorldMatrix( wsBox.pos, drawScales[kindIndex], ToRadian( rollDegree ), enableRotation );
 }
 
 AABBEx Trigger::RollHitBox( AABBEx box ) const
@@ -93,7 +93,7 @@ public:
 	/// </summary>
 	AABBEx GetHitBox() const override;
 	bool HasMultipleHitBox() const override;
-	std::vector<AABBEx> GetAnotherHitBoxes() const override;
+	Donya::FrameVector<AABBEx> GetAnotherHitBoxes() const override;
 private:
 	/// <summary>
 	/// Returns index is kind of triggers(following the GimmickKind, start by TriggerKey), 0-based.
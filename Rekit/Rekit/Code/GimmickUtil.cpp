@@ -1,6 +1,7 @@
 #include "GimmickUtil.h"
 
 #include <map>
+#include <mutex>
 
 #include "Donya/Loader.h"
 #include "Donya/Useful.h"
@@ -277,13 +278,18 @@ namespace GimmickUtility
 namespace GimmickStatus
 {
 	static std::map<int, bool> statuses{};
+	static std::mutex statusMutex{}; // The gimmicks may register a status from the worker threads.
 
 	void Reset()
 	{
+		std::lock_guard<std::mutex> enterCS( statusMutex );
+
 		statuses.clear();
 	}
 	void Register( int id, bool configure )
 	{
+		std::lock_guard<std::mutex> enterCS( statusMutex );
+
 		auto found =  statuses.find( id );
 		if ( found == statuses.end() )
 		{
@@ -296,6 +302,8 @@ namespace GimmickStatus
 	}
 	bool Refer( int id )
 	{
+		std::lock_guard<std::mutex> enterCS( statusMutex );
+
 		auto found =  statuses.find( id );
 		if ( found == statuses.end() ) { return false; }
 		// else
@@ -304,6 +312,8 @@ namespace GimmickStatus
 	}
 	void Remove( int id )
 	{
+		std::lock_guard<std::mutex> enterCS( statusMutex );
+
 		statuses.erase( id );
 	}
 }
@@ -1,7 +1,9 @@
 #include "Gimmicks.h"
 
 #include <array>			// Use at collision.
-#include <algorithm>		// Use std::remove_if.
+#include <algorithm>		// Use std::remove_if, std::max, std::min.
+#include <cfloat>
+#include <cmath>			// Use fabsf().
 #include <map>
 #include <vector>			// Use at collision, and load models.
 
@@ -9,6 +11,8 @@
 #include "Donya/Loader.h"
 #include "Donya/Sound.h"
 #include "Donya/Template.h"
+#include "Donya/FrameArena.h"
+#include "Donya/ThreadPool.h"	// Use for solving the islands in parallel.
 #include "Donya/Useful.h"	// Use convert string functions.
 
 #include "Common.h"
@@ -16,6 +20,7 @@
 #include "GimmickUtil.h"
 #include "Music.h"
 #include "SceneEditor.h"	// Use The "StageConfiguration".
+#include "ViewCulling.h"
 
 #undef max
 #undef min
@@ -74,15 +79,136 @@ void Gimmick::UpdateLifts( float elapsedTime )
 	}
 }
 
+namespace
+{
+	Donya::ThreadPool &IslandSolverPool()
+	{
+		static Donya::ThreadPool pool{};
+		return pool;
+	}
+
+	// The island that has boxes more than this uses the grid for finding the collisions. Testing all boxes is faster for the small island.
+	constexpr size_t COLLISION_GRID_THRESHOLD = 64U;
+
+	/// <summary>
+	/// Returns a box that covers the both.
+	/// </summary>
+	BoxEx Merge( const BoxEx &L, const BoxEx &R )
+	{
+		const Donya::Vector2 min
+		{
+			std::min( L.pos.x - L.size.x, R.pos.x - R.size.x ),
+			std::min( L.pos.y - L.size.y, R.pos.y - R.size.y )
+		};
+		const Donya::Vector2 max
+		{
+			std::max( L.pos.x + L.size.x, R.pos.x + R.size.x ),
+			std::max( L.pos.y + L.size.y, R.pos.y + R.size.y )
+		};
+
+		BoxEx merged{};
+		merged.pos  = ( min + max ) * 0.5f;
+		merged.size = ( max - min ) * 0.5f;
+		return merged;
+	}
+	/// <summary>
+	/// Returns a box that covers the box before and after the move by velocity.
+	/// </summary>
+	BoxEx Sweep( const BoxEx &box, const Donya::Vector2 &velocity )
+	{
+		BoxEx moved = box;
+		moved.pos  += velocity;
+		return Merge( box, moved );
+	}
+
+	/// <summary>
+	/// Group the regions that overlap each other(also indirectly). Each group stores the indices by ascending order.
+	/// </summary>
+	Donya::FrameVector<Donya::FrameVector<size_t>> BuildIslands( const Donya::FrameVector<BoxEx> &regions )
+	{
+		const size_t regionCount = regions.size();
+
+		// Union-Find.
+		Donya::FrameVector<size_t> parents( regionCount );
+		for ( size_t i = 0; i < regionCount; ++i ) { parents[i] = i; }
+
+		auto FindRoot = [&parents]( size_t i )
+		{
+			while ( parents[i] != i )
+			{
+				parents[i] = parents[parents[i]];
+				i = parents[i];
+			}
+			return i;
+		};
+
+		for ( size_t i = 0; i < regionCount; ++i )
+		{
+			for ( size_t j = i + 1; j < regionCount; ++j )
+			{
+				if ( !Donya::Box::IsHitBox( regions[i], regions[j], /* ignoreExistFlag = */ true ) ) { continue; }
+				// else
+
+				const size_t rootI = FindRoot( i );
+				const size_t rootJ = FindRoot( j );
+				if ( rootI == rootJ ) { continue; }
+				// else
+
+				// Keep the smaller index as root, so the order of islands is decided by the first member.
+				parents[std::max( rootI, rootJ )] = std::min( rootI, rootJ );
+			}
+		}
+
+		Donya::FrameVector<Donya::FrameVector<size_t>> islands{};
+		Donya::FrameVector<size_t> islandIndices( regionCount );
+		islands.reserve( regionCount );
+		for ( size_t i = 0; i < regionCount; ++i )
+		{
+			const size_t root = FindRoot( i );
+			if ( root == i )
+			{
+				islandIndices[i] = islands.size();
+				islands.emplace_back();
+			}
+
+			islands[islandIndices[root]].emplace_back( i );
+		}
+
+		return islands;
+	}
+}
+
 void Gimmick::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, const std::vector<BoxEx> &terrains, bool alsoLifts )
 {
 	// The "pGimmicks" will update at PhysicUpdate().
 	// So I prepare a temporary vector of terrains and update this every time update elements.
 
+	// The gimmicks that far from each other does not interact,
+	// so I group the gimmicks into some islands, then update each island in parallel.
+	// The update order within an island is the same as serial, so the result is deterministic.
+
 	const size_t gimmickCount = pGimmicks.size();
 
-	std::vector<BoxEx> boxes{};			// Contains main hit-boxes of all gimmicks.
-	std::vector<BoxEx> anotherBoxes{};	// Contains another hit-boxes of all gimmicks.
+	// These temporaries are allocated from the frame arena.
+	Donya::FrameVector<size_t> targets{};		// Indices of "pGimmicks" that will be updated.
+	Donya::FrameVector<BoxEx>  boxes{};			// Contains main hit-boxes of target gimmicks. Same order as "targets".
+	Donya::FrameVector<BoxEx>  anotherBoxes{};	// Contains another hit-boxes of target gimmicks.
+	Donya::FrameVector<size_t> anotherOwners{};	// Index of "targets" that has the another hit-box. Same order as "anotherBoxes".
+	Donya::FrameVector<BoxEx>  regions{};		// The area that the target gimmick may interact in this frame. Same order as "targets".
+	targets.reserve( gimmickCount );
+	boxes.reserve( gimmickCount );
+	regions.reserve( gimmickCount );
+
+	// Prevent the two regions that just touching are regarded as apart.
+	constexpr float REGION_MARGIN = 0.01f;
+
+	// The fastest moving of all boxes. A gimmick can be pushed(or carried by the belt conveyor) by others at most this amount in this frame.
+	float maxSpeed = std::max( fabsf( accompanyBox.velocity.x ), fabsf( accompanyBox.velocity.y ) );
+	auto  CountSpeed = [&maxSpeed]( const BoxEx &box )
+	{
+		maxSpeed = std::max( maxSpeed, std::max( fabsf( box.velocity.x ), fabsf( box.velocity.y ) ) );
+	};
+	for ( const auto &it : terrains ) { CountSpeed( it ); }
 
 	// Prepare the blocks hit-boxes.
 	for ( size_t i = 0; i < gimmickCount; ++i )
@@ -95,39 +221,140 @@ void Gimmick::PhysicUpdate( const BoxEx &player, const BoxEx &accompanyBox, cons
 		if ( !alsoLifts && ToKind( pElement->GetKind() ) == GimmickKind::Lift ) { continue; }
 		// else
 
-		boxes.emplace_back( pElement->GetHitBox().Get2D() );
+		const size_t targetIndex = targets.size();
+		targets.emplace_back( i );
+
+		const BoxEx mainBox = pElement->GetHitBox().Get2D();
+		boxes.emplace_back( mainBox );
+		CountSpeed( mainBox );
+
+		BoxEx region = Merge( Sweep( mainBox, mainBox.velocity ), pElement->GetInfluenceArea().Get2D() );
+		if ( Donya::Box::IsHitBox( accompanyBox, mainBox, /* ignoreExistFlag = */ true ) )
+		{
+			// The gimmick will follow to the accompanyBox.
+			region = Merge( region, Sweep( mainBox, accompanyBox.velocity ) );
+		}
 
 		if ( pElement->HasMultipleHitBox() )
 		{
 			auto anotherHitBoxes = pElement->GetAnotherHitBoxes();
 			for ( const auto &it : anotherHitBoxes )
 			{
-				anotherBoxes.emplace_back( it.Get2D() );
+				const BoxEx anotherBox = it.Get2D();
+				anotherBoxes.emplace_back( anotherBox );
+				anotherOwners.emplace_back( targetIndex );
+				CountSpeed( anotherBox );
+
+				region = Merge( region, Sweep( anotherBox, anotherBox.velocity ) );
 			}
 		}
+
+		regions.emplace_back( region );
 	}
 
+	// A gimmick that is pushed may move into a region of another island while the solving.
+	// So expand the regions by the displacement of the push, the pusher moves by its velocity and also may be carried by the belt conveyor.
+	const float pushDisplacement = maxSpeed * 2.0f;
+	for ( auto &it : regions )
+	{
+		it.size += pushDisplacement + REGION_MARGIN;
+	}
+
+	const size_t targetCount  = targets.size();
+	const size_t anotherCount = anotherBoxes.size();
+
 	// This "allTerrains" stores boxes arranged in the order : [gimmicks][anothers][terrains],
 	// so I can access to the gimmicks hit-box by index.
 	// The reason for that arranges is I should update a hit-box after every PhysicUpdate().
 	// Because that method will moves the gimmicks.
 	// I want to update is the gimmicks, but I should send to gimmicks all hit-boxes.
-	std::vector<BoxEx>  allTerrains = boxes; // [gimmicks][anothers][terrains]
+	Donya::FrameVector<BoxEx> allTerrains{}; // [gimmicks][anothers][terrains]
+	allTerrains.reserve( targetCount + anotherCount + terrains.size() );
+	allTerrains.insert( allTerrains.end(), boxes.begin(),        boxes.end()        );
 	allTerrains.insert( allTerrains.end(), anotherBoxes.begin(), anotherBoxes.end() );
 	allTerrains.insert( allTerrains.end(), terrains.begin(),     terrains.end()     );
 
-	for ( size_t i = 0; i < gimmickCount; ++i )
+	const Donya::FrameVector<Donya::FrameVector<size_t>> islands = BuildIslands( regions );
+
+	Donya::FrameVector<size_t> islandOf( targetCount ); // Index of "islands" per target.
+	for ( size_t i = 0; i < islands.size(); ++i )
 	{
-		if ( !pGimmicks[i] ) { continue; }
-		// else
+		for ( const auto &it : islands[i] )
+		{
+			islandOf[it] = i;
+		}
+	}
 
-		// Prevent double update by PhysicUpdateLifts().
-		if ( !alsoLifts && ToKind( pGimmicks[i]->GetKind() ) == GimmickKind::Lift ) { continue; }
-		// else
+	auto SolveIsland = [&]( size_t islandIndex )
+	{
+		const auto &members = islands[islandIndex];
 
-		pGimmicks[i]->PhysicUpdate( player, accompanyBox, allTerrains );
-		allTerrains[i] = pGimmicks[i]->GetHitBox().Get2D();
-	}
+		BoxEx islandRegion = regions[members.front()];
+		for ( const auto &it : members )
+		{
+			islandRegion = Merge( islandRegion, regions[it] );
+		}
+
+		// Collect the boxes that the members may interact, with keeping the order of "allTerrains".
+		// Any gimmick box that overlaps to the region belongs to this island, so only the terrains need the culling.
+		// The gimmick's PhysicUpdate() requires the std::vector, so reuse a buffer per thread instead of the frame arena.
+		static thread_local std::vector<BoxEx> islandTerrains{};
+		islandTerrains.clear();
+		Donya::FrameVector<size_t> localIndices( targetCount ); // Index of "islandTerrains" per target. Valid only for members. This is allocated from the arena of the solving thread.
+		const size_t allCount = allTerrains.size();
+		for ( size_t i = 0; i < allCount; ++i )
+		{
+			if ( i < targetCount )
+			{
+				if ( islandOf[i] != islandIndex ) { continue; }
+				// else
+				localIndices[i] = islandTerrains.size();
+			}
+			else if ( i < targetCount + anotherCount )
+			{
+				if ( islandOf[anotherOwners[i - targetCount]] != islandIndex ) { continue; }
+			}
+			else if ( !Donya::Box::IsHitBox( allTerrains[i], islandRegion, /* ignoreExistFlag = */ true ) )
+			{
+				continue;
+			}
+
+			islandTerrains.emplace_back( allTerrains[i] );
+		}
+
+		// Find the collisions by the grid, instead of testing all boxes per gimmick.
+		// The members are moved while the solving, so these are tested without the grid.
+		static thread_local ViewCulling::Grid islandGrid{};
+		const bool useGrid = ( COLLISION_GRID_THRESHOLD < islandTerrains.size() );
+		Donya::FrameVector<size_t> movingIndices{};
+		if ( useGrid )
+		{
+			movingIndices.reserve( members.size() );
+			for ( const auto &it : members )
+			{
+				movingIndices.emplace_back( localIndices[it] );
+			}
+
+			// The BoxEx is passed as the Donya::Box, so copy to the array of Donya::Box.
+			const Donya::FrameVector<Donya::Box> baseBoxes( islandTerrains.begin(), islandTerrains.end() );
+			islandGrid.Build( baseBoxes.data(), baseBoxes.size() );
+			GimmickBase::BeginCollisionGrid( islandTerrains, islandGrid, movingIndices.data(), movingIndices.size() );
+		}
+
+		for ( const auto &it : members )
+		{
+			auto &pElement = pGimmicks[targets[it]];
+			pElement->PhysicUpdate( player, accompanyBox, islandTerrains );
+			islandTerrains[localIndices[it]] = pElement->GetHitBox().Get2D();
+		}
+
+		if ( useGrid )
+		{
+			GimmickBase::EndCollisionGrid();
+		}
+	};
+
+	IslandSolverPool().ParallelFor( islands.size(), SolveIsland );
 
 	// Erase the should remove blocks.
 	{
@@ -162,30 +389,92 @@ void Gimmick::PhysicUpdateLifts( const BoxEx &player, const BoxEx &accompanyBox,
 
 void Gimmick::Draw( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir, bool alsoLifts ) const
 {
-	for ( auto &it : pGimmicks )
+	// Prevent double draw by DrawLifts().
+	DrawVisibles( V, P, lightDir, /* drawNotLifts = */ true, /* drawLifts = */ alsoLifts );
+}
+void Gimmick::DrawLifts( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
+{
+	DrawVisibles( V, P, lightDir, /* drawNotLifts = */ false, /* drawLifts = */ true );
+}
+void Gimmick::DrawVisibles( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir, bool drawNotLifts, bool drawLifts ) const
+{
+	struct Candidate
 	{
-		if ( !it ) { continue; }
+		const GimmickBase	*pGimmick;
+		Donya::AABB			bounds;		// Contains all hit-boxes.
+	};
+	auto CalcBounds = []( const GimmickBase &gimmick )
+	{
+		const Donya::AABB hitBox = gimmick.GetHitBox();
+		if ( !gimmick.HasMultipleHitBox() ) { return hitBox; }
 		// else
 
-		// Prevent double draw by DrawLifts().
-		if ( !alsoLifts && ToKind( it->GetKind() ) == GimmickKind::Lift ) { continue; }
-		// else
+		Donya::Vector3 min = hitBox.pos - hitBox.size;
+		Donya::Vector3 max = hitBox.pos + hitBox.size;
+		for ( const auto &it : gimmick.GetAnotherHitBoxes() )
+		{
+			min.x = std::min( min.x, it.pos.x - it.size.x );
+			min.y = std::min( min.y, it.pos.y - it.size.y );
+			min.z = std::min( min.z, it.pos.z - it.size.z );
+			max.x = std::max( max.x, it.pos.x + it.size.x );
+			max.y = std::max( max.y, it.pos.y + it.size.y );
+			max.z = std::max( max.z, it.pos.z + it.size.z );
+		}
 
-		it->Draw( V, P, lightDir );
-	}
-}
-void Gimmick::DrawLifts( const Donya::Vector4x4 &V, const Donya::Vector4x4 &P, const Donya::Vector4 &lightDir ) const
-{
-	for ( auto &it : pGimmicks )
+		Donya::AABB bounds{};
+		bounds.pos  = ( min + max ) * 0.5f;
+		bounds.size = ( max - min ) * 0.5f;
+		return bounds;
+	};
+
+	Donya::FrameVector<Candidate> candidates{};
+	candidates.reserve( pGimmicks.size() );
+
+	float minZ = +FLT_MAX;
+	float maxZ = -FLT_MAX;
+	for ( const auto &it : pGimmicks )
 	{
 		if ( !it ) { continue; }
 		// else
 
-		if ( ToKind( it->GetKind() ) == GimmickKind::Lift )
+		const bool isLift = ( ToKind( it->GetKind() ) == GimmickKind::Lift );
+		if ( ( isLift ) ? !drawLifts : !drawNotLifts ) { continue; }
+		// else
+
+		const Donya::AABB bounds = CalcBounds( *it );
+		minZ = std::min( minZ, bounds.pos.z - bounds.size.z );
+		maxZ = std::max( maxZ, bounds.pos.z + bounds.size.z );
+
+		candidates.emplace_back( Candidate{ it.get(), bounds } );
+	}
+	if ( candidates.empty() ) { return; }
+	// else
+
+	const Donya::Vector4x4 VP = V * P;
+	GimmickBase::CountMatrixMultiply();
+	const Donya::Box viewRect = ViewCulling::CalcVisibleRect( VP, minZ, maxZ );
+
+	// The same kind gimmicks are drawn by one instanced draw.
+	GimmickBase::BeginBatchDraw( VP );
+
+	size_t culledCount = 0;
+	for ( const auto &it : candidates )
+	{
+		// The model may be larger than the hit-box(e.g. a rotating one), so the hit-box is regarded as double size.
+		const float margin = std::max( it.bounds.size.x, it.bounds.size.y );
+		if ( !ViewCulling::IsVisible( viewRect, it.bounds, margin ) )
 		{
-			it->Draw( V, P, lightDir );
+			culledCount++;
+			continue;
 		}
+		// else
+
+		it.pGimmick->Draw( V, P, lightDir );
 	}
+
+	GimmickBase::EndBatchDraw( lightDir );
+
+	ViewCulling::CountResult( candidates.size(), culledCount );
 }
 
 bool Gimmick::HasLift() const
@@ -206,7 +495,6 @@ bool Gimmick::HasLift() const
 std::vector<AABBEx> Gimmick::RequireHitBoxes() const
 {
 	std::vector<AABBEx> boxes{};
-	std::vector<AABBEx> anotherBoxes{};
 	for ( const auto &it : pGimmicks )
 	{
 		if ( !it ) { continue; }
@@ -216,7 +504,7 @@ std::vector<AABBEx> Gimmick::RequireHitBoxes() const
 
 		if ( it->HasMultipleHitBox() )
 		{
-			anotherBoxes = it->GetAnotherHitBoxes();
+			const auto anotherBoxes = it->GetAnotherHitBoxes();
 			for ( const auto &itr : anotherBoxes )
 			{
 				boxes.emplace_back( itr );
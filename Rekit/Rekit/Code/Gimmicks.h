@@ -63,6 +63,11 @@ private:
 	/// Replace the gimmicks.
 	/// </summary>
 	void ApplyConfig( const StageConfiguration &stageConfig, const Donya::Vector3 &worldOffset );
+
+	/// <summary>
+	/// Draw the gimmicks that are in the view, and the kind is specified.
+	/// </summary>
+	void DrawVisibles( const Donya::Vector4x4 &matView, const Donya::Vector4x4 &matProjection, const Donya::Vector4 &lightDirection, bool drawNotLifts, bool drawLifts ) const;
 	
 	void LoadParameter( bool fromBinary = true );
 #if USE_IMGUI
@@ -498,7 +498,7 @@ void Hook::PhysicUpdate(const std::vector<BoxEx>& terrains, const Donya::Vector3
 }
 
 #if DEBUG_MODE
-#include "Donya/GeometricPrimitive.h"
+#include "Donya/DebugDraw.h"
 #include "Common.h"
 #endif // DEBUG_MODE
 void Hook::Draw(const Donya::Vector4x4& matViewProjection, const Donya::Vector4& lightDirection, const Donya::Vector4& lightColor) const
@@ -531,20 +531,14 @@ void Hook::Draw(const Donya::Vector4x4& matViewProjection, const Donya::Vector4&
 #if DEBUG_MODE
 	if ( Common::IsShowCollision() )
 	{
-		static Donya::Geometric::Cube cube = Donya::Geometric::CreateCube();
-
-		const auto wsBody = GetVacuumHitBox();
-		T = Donya::Vector4x4::MakeTranslation( wsBody.pos );
-		S = Donya::Vector4x4::MakeScaling( wsBody.size * 2.0f );
-		W = S * T;
-
-		cube.Render
-		(
-			nullptr,
-			true, true,
-			W * matViewProjection, W,
-			lightDirection, Donya::Vector4{ 1.0f, 1.0f, 1.0f, 0.5f }
-		);
+		Donya::DebugDraw::ReserveAABB( GetVacuumHitBox(), Donya::Vector4{ 1.0f, 1.0f, 1.0f, 1.0f } );
+		Donya::DebugDraw::ReserveAABB( wsHitBox, Donya::Vector4{ 0.8f, 0.0f, 0.6f, 1.0f } );
+
+		// The ray of the hook's movement.
+		if ( !velocity.IsZero() )
+		{
+			Donya::DebugDraw::ReserveRay( wsHitBox.pos, velocity.Normalized(), wsHitBox.size.Length() * 4.0f, Donya::Vector4{ 1.0f, 0.4f, 0.8f, 1.0f } );
+		}
 	}
 #endif // DEBUG_MODE
 }
@@ -808,7 +808,7 @@ void Player::PhysicUpdate( const std::vector<BoxEx> &terrains )
 }
 
 #if DEBUG_MODE
-#include "Donya/GeometricPrimitive.h"
+#include "Donya/DebugDraw.h"
 #endif // DEBUG_MODE
 void Player::Draw( const Donya::Vector4x4 &matViewProjection, const Donya::Vector4 &lightDirection, const Donya::Vector4 &lightColor ) const
 {
@@ -837,20 +837,11 @@ void Player::Draw( const Donya::Vector4x4 &matViewProjection, const Donya::Vecto
 #if DEBUG_MODE
 	if ( Common::IsShowCollision() )
 	{
-		static Donya::Geometric::Cube cube = Donya::Geometric::CreateCube();
-		
 		const auto wsBody = GetHitBox();
-		T = Donya::Vector4x4::MakeTranslation( wsBody.pos );
-		S = Donya::Vector4x4::MakeScaling( wsBody.size );
-		W = S * T;
-
-		cube.Render
-		(
-			nullptr,
-			true, true,
-			W * matViewProjection, W,
-			lightDirection, Donya::Vector4{ 0.6f, 1.0f, 0.6f, 0.5f }
-		);
+		Donya::DebugDraw::ReserveAABB( wsBody, Donya::Vector4{ 0.6f, 1.0f, 0.6f, 1.0f } );
+
+		// The path of this frame's movement.
+		Donya::DebugDraw::ReserveLine( wsBody.pos, wsBody.pos + velocity, Donya::Vector4{ 1.0f, 0.8f, 0.2f, 1.0f } );
 	}
 #endif // DEBUG_MODE
 }
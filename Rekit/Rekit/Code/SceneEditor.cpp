@@ -8,6 +8,7 @@
 #include "Donya/Camera.h"
 #include "Donya/CBuffer.h"
 #include "Donya/Constant.h"
+#include "Donya/DebugDraw.h"
 #include "Donya/Donya.h"		// Use GetFPS().
 #include "Donya/GeometricPrimitive.h"
 #include "Donya/Keyboard.h"
@@ -729,6 +730,8 @@ void SceneEditor::Draw(float elapsedTime)
 
 	// Drawing Objects.
 	{
+		// The gimmicks make the WVP by the view-projection of the BeginBatchDraw().
+		GimmickBase::BeginBatchDraw(V * P);
 		for (auto& it : EditParam::Get().Data().editObjects.pEditGimmicks)
 		{
 			if (!it) { continue; }
@@ -736,6 +739,10 @@ void SceneEditor::Draw(float elapsedTime)
 
 			it->Draw(V, P, dirLight.dir);
 		}
+		GimmickBase::EndBatchDraw(dirLight.dir);
+
+		// The collisions of the gimmicks are reserved at the Draw().
+		Donya::DebugDraw::Flush(V * P);
 	}
 
 	if (isPressG)return;
@@ -4,11 +4,13 @@
 
 #include <cereal/types/vector.hpp>
 
+#include "Donya/AllocationTracker.h"
 #include "Donya/Constant.h"
+#include "Donya/DebugDraw.h"
 #include "Donya/Donya.h"		// Use GetFPS().
-#include "Donya/GeometricPrimitive.h"
-#include "Donya/Keyboard.h"
+#include "Donya/Input.h"
 #include "Donya/Mouse.h"
+#include "Donya/RenderCommand.h"
 #include "Donya/Sound.h"
 #include "Donya/Sprite.h"
 #include "Donya/Useful.h"
@@ -206,13 +208,14 @@ namespace GameStorage
 SceneGame::SceneGame() :
 	stageCount( -1 ), currentStageNo( 0 ),
 	iCamera(),
-	controller( Donya::Gamepad::PAD_1 ),
 	roomOriginPos(),
 	idMission( NULL ), idComplete( NULL ),
 	idTitleText( NULL ), idTitleGear( NULL ), idTutorial( NULL ),
 	idTeachInset( NULL ), idTeachBomb( NULL ),
 	bg(), player(), alert(), pHook( nullptr ),
 	terrains(), gimmicks(),
+	terrainsForHook(), forGimmickCollisions(),
+	renderBackend(),
 	tutorialState( scast<TutorialState>( 0 ) ),
 	nowTutorial( false ),
 	enableAlert( false ),
@@ -303,6 +306,8 @@ void SceneGame::Init()
 		Donya::Sound::Play( Music::BGM_Main );
 	}
 
+	// These are packed into an atlas, so drawing these continuously does not switch the batch.
+	Donya::Sprite::BeginAtlas();
 	idMission	= Donya::Sprite::Load( GetSpritePath( SpriteAttribute::Mission		) );
 	idComplete	= Donya::Sprite::Load( GetSpritePath( SpriteAttribute::Complete		) );
 	idTitleText	= Donya::Sprite::Load( GetSpritePath( SpriteAttribute::TitleText	) );
@@ -310,6 +315,11 @@ void SceneGame::Init()
 	idTutorial	= Donya::Sprite::Load( GetSpritePath( SpriteAttribute::Tutorial		) );
 	idTeachInset= Donya::Sprite::Load( GetSpritePath( SpriteAttribute::TeachInsert	) );
 	idTeachBomb = Donya::Sprite::Load( GetSpritePath( SpriteAttribute::TeachBomb	) );
+	Donya::Sprite::EndAtlas();
+
+	// The first frames of a stage allocate the buffers that are reused after that.
+	constexpr int ALLOCATION_WARM_UP_FRAME = 120;
+	Donya::AllocationTracker::ResetWarmUp( ALLOCATION_WARM_UP_FRAME );
 }
 void SceneGame::Uninit()
 {
@@ -348,6 +358,10 @@ Scene::Result SceneGame::Update( float elapsedTime )
 
 #endif // USE_IMGUI
 
+	// The ImGui above is excluded, it allocates the strings.
+	Donya::AllocationTracker::Zone			allocationZone{ "SceneGame::Update" };
+	Donya::AllocationTracker::ForbidScope	forbidAllocation{};
+
 	auto AppendGimmicksBox	= []( std::vector<BoxEx> *pTerrains, const Gimmick &gimmicks )
 	{
 		const auto boxes = gimmicks.RequireHitBoxes();
@@ -370,8 +384,6 @@ Scene::Result SceneGame::Update( float elapsedTime )
 		return hitBoxes;
 	};
 
-	controller.Update();
-
 	bg.Update( elapsedTime );
 
 	if ( enableAlert )
@@ -400,6 +412,8 @@ Scene::Result SceneGame::Update( float elapsedTime )
 
 	// 2. Update velocity of all objects.
 	{
+		Donya::AllocationTracker::Zone allocationZone{ "Objects::Update" };
+
 		// This flag prevent a double updating a lifts.
 		// const bool alsoUpdateLifts = ( refGimmick.HasLift() ) ? false : true;
 		refGimmick.Update( elapsedTime, /* alsoLifts = */ true, /* useImGui = */ true );
@@ -425,12 +439,14 @@ Scene::Result SceneGame::Update( float elapsedTime )
 	// 3. The hook's PhysicUpdate().
 	if ( pHook )
 	{
+		Donya::AllocationTracker::Zone allocationZone{ "Hook::PhysicUpdate" };
+
 		BoxEx wsScreen{};
 		wsScreen.pos.x =  roomOriginPos.x;
 		wsScreen.pos.y = -roomOriginPos.y; // Convert Y from screen space -> world space.
 		wsScreen.size  = GameParam::Get().Data().roomSize * 0.5f;
 
-		std::vector<BoxEx>   terrainsForHook = refTerrain.Acquire();
+		refTerrain.Acquire( &terrainsForHook );
 		AppendGimmicksBox(  &terrainsForHook,  refGimmick );
 
 		pHook->PhysicUpdate( terrainsForHook,  player.GetPosition(), wsScreen );
@@ -438,9 +454,11 @@ Scene::Result SceneGame::Update( float elapsedTime )
 
 	// 4. The gimmicks PhysicUpdate().
 	{
+		Donya::AllocationTracker::Zone allocationZone{ "Gimmick::PhysicUpdate" };
+
 		const BoxEx wsPlayerBody = player.GetHitBox().Get2D();
 
-		std::vector<BoxEx> forGimmickCollisions = refTerrain.Acquire();
+		refTerrain.Acquire( &forGimmickCollisions );
 		BoxEx accompanyBox{};
 		if ( pHook )
 		{
@@ -463,10 +481,13 @@ Scene::Result SceneGame::Update( float elapsedTime )
 	}
 
 	// 5. Add the gimmicks block.
-	refTerrain.Append( ExtractHitBoxes( refGimmick ) );
-	
 	// 6. The player's PhysicUpdate().
-	PlayerPhysicUpdate( refTerrain.Acquire() );
+	{
+		Donya::AllocationTracker::Zone allocationZone{ "Player::PhysicUpdate" };
+
+		refTerrain.Append( ExtractHitBoxes( refGimmick ) );
+		PlayerPhysicUpdate( refTerrain.Acquire() );
+	}
 
 	CameraUpdate();
 
@@ -487,8 +508,8 @@ Scene::Result SceneGame::Update( float elapsedTime )
 #if DEBUG_MODE
 	// Scene Transition Demo.
 	{
-		bool pressCtrl = Donya::Keyboard::Press( VK_LCONTROL ) || Donya::Keyboard::Press( VK_RCONTROL );
-		bool triggerDebugButton = ( Donya::Keyboard::Trigger( VK_RETURN ) || controller.Trigger( Donya::Gamepad::Button::A ) || controller.Trigger( Donya::Gamepad::Button::START ) );
+		bool pressCtrl = Donya::Input::Press( VK_LCONTROL ) || Donya::Input::Press( VK_RCONTROL );
+		bool triggerDebugButton = ( Donya::Input::Trigger( VK_RETURN ) || Donya::Input::Trigger( Donya::Gamepad::Button::A ) || Donya::Input::Trigger( Donya::Gamepad::Button::START ) );
 		if ( pressCtrl && triggerDebugButton )
 		{
 			if ( !Fader::Get().IsExist() )
@@ -558,6 +579,10 @@ void SceneGame::Draw( float elapsedTime )
 	const Donya::Vector4	lightDir	= GameParam::Get().Data().lightDirection;
 	const Donya::Vector4	lightColor	= GameParam::Get().Data().lightColor;
 
+	// The terrains and the gimmicks are recorded, then these are sorted by the states and drawn at once.
+	// The other draws contain the sprites, that are not all recordable(e.g. the rectangles), so these are drawn immediately after that.
+	Donya::RenderCommand::SetBackend( &renderBackend );
+
 	terrains[currentStageNo].Draw( V * P, lightDir );
 
 	// This flag prevent a double drawing a lifts.
@@ -571,6 +596,9 @@ void SceneGame::Draw( float elapsedTime )
 		gimmicks[i].DrawLifts( V, P, lightDir );
 	}
 
+	Donya::RenderCommand::Submit();
+	Donya::RenderCommand::SetBackend( nullptr );
+
 	player.Draw( V * P, lightDir, lightColor );
 	if ( pHook )
 	{
@@ -582,14 +610,6 @@ void SceneGame::Draw( float elapsedTime )
 #if DEBUG_MODE
 	// Drawing the line that represent the room size.
 	{
-		static Donya::Geometric::Line line{ 32U };
-		static bool initialized = false;
-		if ( !initialized )
-		{
-			line.Init();
-			initialized = true;
-		}
-
 		const auto param = GameParam::Get().Data();
 		const Donya::Vector2 roomHalfSize = param.roomSize * 0.5f;
 		const Donya::Vector3 center{ roomOriginPos.x, -roomOriginPos.y, player.GetPosition().z }; // The Y is should convert to world space from screen space.
@@ -597,37 +617,31 @@ void SceneGame::Draw( float elapsedTime )
 		const Donya::Vector3 vert{ 0.0f, roomHalfSize.y, 0.0f };
 
 		constexpr Donya::Vector4 color{ 1.0f, 0.0f, 0.0f, 1.0f };
-		line.Reserve( center - side, center + side, color );
-		line.Reserve( center - vert, center + vert, color );
-
-		line.Flush( V * P );
+		Donya::DebugDraw::ReserveLine( center - side, center + side, color );
+		Donya::DebugDraw::ReserveLine( center - vert, center + vert, color );
 	}
 
 	if ( Common::IsShowCollision() )
 	{
-		static auto cube = Donya::Geometric::CreateCube();
-
 		// Drawing area of clear-trigger.
 		if ( 0 )
 		{
-			constexpr Donya::Vector4 cubeColor{ 1.0f, 1.0f, 1.0f, 1.0f };
+			constexpr Donya::Vector4 boxColor{ 1.0f, 1.0f, 1.0f, 1.0f };
 			const auto box = GameParam::Get().Data().debugClearTrigger;
-			Donya::Vector4x4 cubeT = Donya::Vector4x4::MakeTranslation( Donya::Vector3{ box.pos, 1.0f } );
-			Donya::Vector4x4 cubeS = Donya::Vector4x4::MakeScaling( Donya::Vector3{ box.size * 2.0f, 1.0f } );
-			Donya::Vector4x4 cubeW = cubeS * cubeT;
+			Donya::DebugDraw::ReserveBox( box, /* wsPlaneZ = */ 1.0f, boxColor );
+		}
 
-			cube.Render
-			(
-				nullptr,
-				/* useDefaultShading	= */ true,
-				/* isEnableFill			= */ true,
-				( cubeW * V * P ), cubeW,
-				lightDir,
-				cubeColor
-			);
+		// Drawing the rope of the hook.
+		if ( pHook )
+		{
+			constexpr Donya::Vector4 ropeColor{ 1.0f, 0.4f, 0.8f, 1.0f };
+			Donya::DebugDraw::ReserveLine( player.GetPosition(), pHook->GetPosition(), ropeColor );
 		}
 	}
 #endif // DEBUG_MODE
+
+	// The collisions and the debug lines that were reserved at above are drawn at once.
+	Donya::DebugDraw::Flush( V * P );
 }
 
 void SceneGame::LoadAllStages()
@@ -804,7 +818,7 @@ void SceneGame::CameraUpdate()
 	input.slerpPercent = GameParam::Get().Data().cameraSlerp;
 
 #if DEBUG_MODE
-	if ( Donya::Keyboard::Press( VK_MENU ) )
+	if ( Donya::Input::Press( VK_MENU ) )
 	{
 		const int wheel = Donya::Mouse::WheelRot();
 		if ( wheel != 0 )
@@ -813,7 +827,7 @@ void SceneGame::CameraUpdate()
 			input.moveVelocity.z = scast<float>( wheel ) * Z_SPEED;
 		}
 
-		if ( Donya::Keyboard::Trigger( 'R' ) )
+		if ( Donya::Input::Trigger( 'R' ) )
 		{
 			iCamera.SetPosition( { 0.0f, 0.0f, -5.0f } );
 		}
@@ -845,26 +859,28 @@ void SceneGame::PlayerUpdate( float elapsedTime )
 	bool moveRight	= false;
 	bool useJump	= false;
 
-	if ( controller.IsConnected() )
+	// Read from the snapshot, so the replay can drive the player.
+	const auto &snapshot = Donya::Input::Current();
+	if ( snapshot.isPadConnected )
 	{
 		using Pad  = Donya::Gamepad;
 
-		bool left  = controller.Press( Pad::LEFT  ) || controller.PressStick( Pad::StickDirection::LEFT,  /* leftStick = */ true );
-		bool right = controller.Press( Pad::RIGHT ) || controller.PressStick( Pad::StickDirection::RIGHT, /* leftStick = */ true );
+		bool left  = snapshot.IsPressed( Pad::LEFT  ) || snapshot.LeftStick().x < 0.0f;
+		bool right = snapshot.IsPressed( Pad::RIGHT ) || 0.0f < snapshot.LeftStick().x;
 
 		if ( left  ) { moveLeft  = true; }
 		if ( right ) { moveRight = true; }
 
-		if ( controller.Trigger( Pad::LT ) ) { useJump = true; }
+		if ( snapshot.IsDown( Pad::LT ) ) { useJump = true; }
 	}
 	else
 	{
-		bool pressLeft  = Donya::Keyboard::Press( 'Z' )/* || Donya::Keyboard::Press( VK_LEFT  )*/;
-		bool pressRight = Donya::Keyboard::Press( 'X' )/* || Donya::Keyboard::Press( VK_RIGHT )*/;
+		bool pressLeft  = snapshot.IsPressed( 'Z' )/* || snapshot.IsPressed( VK_LEFT  )*/;
+		bool pressRight = snapshot.IsPressed( 'X' )/* || snapshot.IsPressed( VK_RIGHT )*/;
 		if ( pressLeft  ) { moveLeft  = true; }
 		if ( pressRight ) { moveRight = true; }
 		
-		bool trgJump = Donya::Keyboard::Trigger( VK_SPACE )/* || Donya::Keyboard::Trigger( VK_LSHIFT )*/;
+		bool trgJump = snapshot.IsDown( VK_SPACE )/* || snapshot.IsDown( VK_LSHIFT )*/;
 		if ( trgJump ) { useJump = true; }
 	}
 
@@ -890,7 +906,7 @@ void SceneGame::PlayerPhysicUpdate( const std::vector<BoxEx> &hitBoxes )
 	// else
 
 #if DEBUG_MODE
-	if ( Donya::Keyboard::Press( VK_MENU ) && Donya::Keyboard::Trigger( 'Q' ) )
+	if ( Donya::Input::Press( VK_MENU ) && Donya::Input::Trigger( 'Q' ) )
 	{
 		if ( !Fader::Get().IsExist() )
 		{
@@ -1018,26 +1034,27 @@ void SceneGame::HookUpdate( float elapsedTime )
 	bool				create		= false;
 	bool				erase		= false; // A User can erase the hook arbitally.
 
-	if ( controller.IsConnected() )
+	const auto &snapshot = Donya::Input::Current();
+	if ( snapshot.isPadConnected )
 	{
 		using Pad = Donya::Gamepad;
 
-		stick = controller.RightStick();
+		stick = snapshot.RightStick();
 
-		if (controller.Trigger ( Pad::RT )) { useAction = true; }
+		if (snapshot.IsDown ( Pad::RT )) { useAction = true; }
 		if (stick.Length () != 0) {
 			create = true;
 			extend = true;
 		}
 		else { shrink = true; }
-		if (controller.Trigger ( Pad::RB )) { erase = true; }
+		if (snapshot.IsDown ( Pad::RB )) { erase = true; }
 	}
 	else
 	{
-		if ( Donya::Keyboard::Press  ( VK_LEFT		) ) { stick.x	-= 1.0f; }
-		if ( Donya::Keyboard::Press  ( VK_RIGHT		) ) { stick.x	+= 1.0f; }
-		if ( Donya::Keyboard::Press  ( VK_UP		) ) { stick.y	+= 1.0f; }
-		if ( Donya::Keyboard::Press  ( VK_DOWN		) ) { stick.y	-= 1.0f; }
+		if ( snapshot.IsPressed( VK_LEFT	) ) { stick.x	-= 1.0f; }
+		if ( snapshot.IsPressed( VK_RIGHT	) ) { stick.x	+= 1.0f; }
+		if ( snapshot.IsPressed( VK_UP		) ) { stick.y	+= 1.0f; }
+		if ( snapshot.IsPressed( VK_DOWN	) ) { stick.y	-= 1.0f; }
 		if ( stick.IsZero() )
 		{
 			shrink = true;
@@ -1048,8 +1065,8 @@ void SceneGame::HookUpdate( float elapsedTime )
 			extend = true;
 		}
 
-		if ( Donya::Keyboard::Trigger( VK_RSHIFT	) ) { useAction	= true; }
-		if ( Donya::Keyboard::Trigger( VK_END		) ) { erase		= true; }
+		if ( snapshot.IsDown( VK_RSHIFT	) ) { useAction	= true; }
+		if ( snapshot.IsDown( VK_END	) ) { erase		= true; }
 	}
 
 	if ( create )
@@ -1125,22 +1142,23 @@ void SceneGame::UpdateOfTutorial()
 	Donya::Vector2 dir{};
 	bool useJump{}, useHook{}, useErase{};
 
-	if ( controller.IsConnected() )
+	const auto &snapshot = Donya::Input::Current();
+	if ( snapshot.isPadConnected )
 	{
-		dir = controller.RightStick();
-		useJump  = controller.Trigger( Donya::Gamepad::LT );
-		useHook  = controller.Trigger( Donya::Gamepad::RT );
-		useErase = controller.Trigger( Donya::Gamepad::RB );
+		dir = snapshot.RightStick();
+		useJump  = snapshot.IsDown( Donya::Gamepad::LT );
+		useHook  = snapshot.IsDown( Donya::Gamepad::RT );
+		useErase = snapshot.IsDown( Donya::Gamepad::RB );
 	}
 	else
 	{
-		dir.x += Donya::Keyboard::Press( VK_RIGHT ) ? +1.0f : 0.0f;
-		dir.x += Donya::Keyboard::Press( VK_LEFT  ) ? -1.0f : 0.0f;
-		dir.y += Donya::Keyboard::Press( VK_UP    ) ? +1.0f : 0.0f;
-		dir.y += Donya::Keyboard::Press( VK_DOWN  ) ? -1.0f : 0.0f;
-		useJump  = Donya::Keyboard::Trigger( VK_SPACE	);
-		useHook  = Donya::Keyboard::Trigger( VK_RSHIFT	);
-		useErase = Donya::Keyboard::Trigger( VK_END		);
+		dir.x += snapshot.IsPressed( VK_RIGHT ) ? +1.0f : 0.0f;
+		dir.x += snapshot.IsPressed( VK_LEFT  ) ? -1.0f : 0.0f;
+		dir.y += snapshot.IsPressed( VK_UP    ) ? +1.0f : 0.0f;
+		dir.y += snapshot.IsPressed( VK_DOWN  ) ? -1.0f : 0.0f;
+		useJump  = snapshot.IsDown( VK_SPACE	);
+		useHook  = snapshot.IsDown( VK_RSHIFT	);
+		useErase = snapshot.IsDown( VK_END		);
 	}
 
 	switch (tutorialState)
@@ -1279,8 +1297,8 @@ Scene::Result SceneGame::ReturnResult()
 {
 #if DEBUG_MODE
 
-		bool pressCtrl =  Donya::Keyboard::Press( VK_LCONTROL ) || Donya::Keyboard::Press( VK_RCONTROL );
-		if ( pressCtrl && Donya::Keyboard::Trigger( VK_RETURN ) && !Fader::Get().IsExist() )
+		bool pressCtrl =  Donya::Input::Press( VK_LCONTROL ) || Donya::Input::Press( VK_RCONTROL );
+		if ( pressCtrl && Donya::Input::Trigger( VK_RETURN ) && !Fader::Get().IsExist() )
 		{
 			Donya::Sound::Play( Music::ItemDecision );
 			Scene::Result change{};
@@ -1290,7 +1308,7 @@ Scene::Result SceneGame::ReturnResult()
 		}
 		else
 		{
-			if ( pressCtrl && Donya::Keyboard::Trigger( 'E' ) && !Fader::Get().IsExist() )
+			if ( pressCtrl && Donya::Input::Trigger( 'E' ) && !Fader::Get().IsExist() )
 			{
 				Scene::Result change{};
 				change.AddRequest( Scene::Request::ADD_SCENE, Scene::Request::REMOVE_ALL );
@@ -1310,7 +1328,7 @@ Scene::Result SceneGame::ReturnResult()
 	}
 	// else
 
-	bool requestPause	= controller.Trigger( Donya::Gamepad::Button::START ) || controller.Trigger( Donya::Gamepad::Button::SELECT ) || Donya::Keyboard::Trigger( 'P' );
+	bool requestPause	= Donya::Input::Trigger( Donya::Gamepad::Button::START ) || Donya::Input::Trigger( Donya::Gamepad::Button::SELECT ) || Donya::Input::Trigger( 'P' );
 	bool allowPause		= !Fader::Get().IsExist();
 	if ( requestPause && allowPause )
 	{
@@ -5,6 +5,7 @@
 
 #include "Donya/Camera.h"
 #include "Donya/GamepadXInput.h"
+#include "Donya/RenderCommand.h"
 #include "Donya/UseImGui.h"
 #include "Donya/Vector.h"
 
@@ -38,7 +39,6 @@ private:
 	int						currentStageNo;	// 0-based.
 
 	Donya::ICamera			iCamera;
-	Donya::XInput			controller;
 	Donya::Vector2			roomOriginPos;	// Center. Screen space.
 	
 	size_t					idMission;		// Sprite.
@@ -59,6 +59,11 @@ private:
 
 	std::vector<int>		liftRoomIndices; // Cache the indices of room that has the elevator.
 
+	std::vector<BoxEx>		terrainsForHook;		// Reuse the buffer between frames.
+	std::vector<BoxEx>		forGimmickCollisions;	// Reuse the buffer between frames.
+
+	Donya::RenderCommand::DeviceBackend renderBackend;	// Draws the recorded world.
+
 	TutorialState			tutorialState;	// This variable controll drawing texts of tutorial.
 	bool					nowTutorial;	// Do you doing tutorial now?
 	bool					enableAlert;	// Will be true when the player ariived at the last room.
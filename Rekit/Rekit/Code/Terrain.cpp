@@ -1,5 +1,6 @@
 #include "Terrain.h"
 
+#include "Donya/FrameArena.h"
 #include "Donya/Loader.h"
 #include "Donya/StaticMesh.h"
 
@@ -62,6 +63,9 @@ void Terrain::Init( const Donya::Vector3 &wsRoomOrigin, const std::vector<BoxEx>
 		it.pos.x += worldOffset.x;
 		it.pos.y += worldOffset.y;
 	}
+
+	BuildGrid( source, &sourceGrid );
+	boxesGridDirty = true;
 }
 void Terrain::Uninit()
 {
@@ -69,37 +73,72 @@ void Terrain::Uninit()
 	source.shrink_to_fit();
 	boxes.clear();
 	boxes.shrink_to_fit();
+
+	sourceGrid.Clear();
+	boxesGrid.Clear();
+	boxesGridDirty = true;
 }
 
 void Terrain::Draw( const Donya::Vector4x4 &matVP, const Donya::Vector4 &lightDir, bool drawEditableBoxes ) const
 {
 	constexpr Donya::Vector4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
 
-	Donya::StaticMesh model = TerrainModel::GetModel();
-	Donya::Vector4x4 S{}, T{}, W{};
+	const Donya::StaticMesh &model = TerrainModel::GetModel();
+	Donya::Vector4x4 S{}, T{};
 
 	const std::vector<BoxEx> &refBoxes = ( drawEditableBoxes ) ? boxes : source;
-	for ( const auto &it : refBoxes )
+
+	if ( drawEditableBoxes && boxesGridDirty )
+	{
+		BuildGrid( boxes, &boxesGrid );
+		boxesGridDirty = false;
+	}
+	const ViewCulling::Grid &grid = ( drawEditableBoxes ) ? boxesGrid : sourceGrid;
+
+	// The model is scaled by 1.0f in Z, so the boxes are in [-1.0f ~ +1.0f] of Z.
+	const Donya::Box viewRect = ViewCulling::CalcVisibleRect( matVP, -1.0f, 1.0f );
+
+	// Draw all visible boxes by one instanced draw.
+	Donya::FrameVector<Donya::StaticMesh::InstanceData> instances{};
+	instances.reserve( refBoxes.size() );
+	auto AppendIfVisible = [&]( const BoxEx &box )
+	{
+		if ( !ViewCulling::IsVisible( viewRect, box ) ) { return; }
+		// else
+
+		S = Donya::Vector4x4::MakeScaling( Donya::Vector3{ box.size, 1.0f } );
+		T = Donya::Vector4x4::MakeTranslation( Donya::Vector3{ box.pos, 0.0f } );
+
+		instances.emplace_back( Donya::StaticMesh::InstanceData{ S * T, color } );
+	};
+
+	if ( ViewCulling::IsEnabled() && !grid.IsEmpty() )
+	{
+		Donya::FrameVector<size_t> candidates{};
+		grid.Query( viewRect, &candidates );
+		ViewCulling::CountQuery();
+		for ( const size_t index : candidates )
+		{
+			AppendIfVisible( refBoxes[index] );
+		}
+	}
+	else
 	{
-		S = Donya::Vector4x4::MakeScaling( Donya::Vector3{ it.size, 1.0f } );
-		T = Donya::Vector4x4::MakeTranslation( Donya::Vector3{ it.pos, 0.0f } );
-		W = S * T;
-
-		model.Render
-		(
-			nullptr,
-			/* useDefaultShading	= */ true,
-			/* isEnableFill			= */ true,
-			( W * matVP ), W,
-			lightDir,
-			color
-		);
+		for ( const auto &it : refBoxes )
+		{
+			AppendIfVisible( it );
+		}
 	}
+
+	ViewCulling::CountResult( refBoxes.size(), refBoxes.size() - instances.size() );
+
+	model.RenderInstanced( instances.data(), instances.size(), matVP, lightDir );
 }
 
 void Terrain::Reset()
 {
 	boxes = source;
+	boxesGridDirty = true;
 }
 
 std::vector<BoxEx> Terrain::Acquire() const
@@ -113,7 +152,30 @@ std::vector<BoxEx> Terrain::Acquire() const
 	return wsHitBoxes;
 }
 
+void Terrain::Acquire( std::vector<BoxEx> *pOutput ) const
+{
+	if ( !pOutput ) { return; }
+	// else
+
+	pOutput->assign( boxes.begin(), boxes.end() );
+}
+
 void Terrain::Append( const std::vector<BoxEx> &terrain )
 {
 	boxes.insert( boxes.end(), terrain.begin(), terrain.end() );
+	boxesGridDirty = true;
+}
+
+void Terrain::BuildGrid( const std::vector<BoxEx> &boxes, ViewCulling::Grid *pGrid )
+{
+	if ( boxes.size() <= GRID_THRESHOLD )
+	{
+		pGrid->Clear();
+		return;
+	}
+	// else
+
+	// The BoxEx is passed as the Donya::Box, so copy to the array of Donya::Box.
+	std::vector<Donya::Box> base( boxes.begin(), boxes.end() );
+	pGrid->Build( base.data(), base.size() );
 }
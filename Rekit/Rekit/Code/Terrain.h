@@ -5,6 +5,7 @@
 #include "Donya/Vector.h"
 
 #include "DerivedCollision.h"
+#include "ViewCulling.h"
 
 /// <summary>
 /// This class have simple terrains(represent by hit-box).
@@ -13,10 +14,18 @@ class Terrain
 {
 public:
 	static bool LoadModel();
+	/// <summary>
+	/// The terrain that has boxes more than this uses the grid for the culling.
+	/// </summary>
+	static constexpr size_t GRID_THRESHOLD = 64U;
 private:
 	Donya::Vector3		worldOffset{};
 	std::vector<BoxEx>	source{};		// Constant.
 	std::vector<BoxEx>	boxes{};		// Editable.
+
+	ViewCulling::Grid			sourceGrid{};
+	mutable ViewCulling::Grid	boxesGrid{};			// Re-built at the drawing, when the "boxes" was changed.
+	mutable bool				boxesGridDirty{ true };
 public:
 	void Init( const Donya::Vector3 &wsRoomOriginPos, const std::vector<BoxEx> &sourceTerrain );
 	void Uninit();
@@ -32,9 +41,18 @@ public:
 	/// Returns current edited hit-boxes.
 	/// </summary>
 	std::vector<BoxEx> Acquire() const;
+	/// <summary>
+	/// Overwrite the "pOutput" by current edited hit-boxes. This reuses the capacity of "pOutput".
+	/// </summary>
+	void Acquire( std::vector<BoxEx> *pOutput ) const;
 
 	/// <summary>
 	/// Append the terrain to current editable hit-boxes.
 	/// </summary>
 	void Append( const std::vector<BoxEx> &terrain );
+private:
+	/// <summary>
+	/// The grid is empty if the count of boxes is not more than GRID_THRESHOLD.
+	/// </summary>
+	static void BuildGrid( const std::vector<BoxEx> &boxes, ViewCulling::Grid *pGrid );
 };
@@ -0,0 +1,249 @@
+#include "ViewCulling.h"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+#include "Donya/Constant.h"	// Use scast macro.
+
+#undef max
+#undef min
+
+namespace ViewCulling
+{
+	namespace
+	{
+		bool	enabled = true;
+		Stats	currentStats{};
+		Stats	lastStats{};
+	}
+
+	Donya::Box CalcVisibleRect( const Donya::Vector4x4 &VP, float wsMinZ, float wsMaxZ )
+	{
+		Donya::Box infinite{};
+		infinite.size = Donya::Vector2{ FLT_MAX, FLT_MAX };
+
+		const Donya::Vector4x4 invVP = VP.Inverse();
+		auto Unproject = [&invVP]( float ndcX, float ndcY, float ndcZ )
+		{
+			const Donya::Vector4 ws = Donya::Vector4{ ndcX, ndcY, ndcZ, 1.0f } * invVP;
+			return Donya::Vector3{ ws.x / ws.w, ws.y / ws.w, ws.z / ws.w };
+		};
+
+		const std::array<Donya::Vector2, 4> CORNERS
+		{
+			Donya::Vector2{ -1.0f, -1.0f },
+			Donya::Vector2{ -1.0f, +1.0f },
+			Donya::Vector2{ +1.0f, -1.0f },
+			Donya::Vector2{ +1.0f, +1.0f },
+		};
+
+		Donya::Vector2 min{ +FLT_MAX, +FLT_MAX };
+		Donya::Vector2 max{ -FLT_MAX, -FLT_MAX };
+		for ( const auto &corner : CORNERS )
+		{
+			// The edge of view-volume, from the near plane to the far plane.
+			const Donya::Vector3 nearPoint	= Unproject( corner.x, corner.y, 0.0f );
+			const Donya::Vector3 farPoint	= Unproject( corner.x, corner.y, 1.0f );
+			const float distZ = farPoint.z - nearPoint.z;
+			if ( fabsf( distZ ) < FLT_EPSILON ) { return infinite; }
+			// else
+
+			for ( const float planeZ : { wsMinZ, wsMaxZ } )
+			{
+				// The plane out of the view-volume is clamped to the near or far plane.
+				const float t = std::max( 0.0f, std::min( 1.0f, ( planeZ - nearPoint.z ) / distZ ) );
+				const float x = nearPoint.x + ( farPoint.x - nearPoint.x ) * t;
+				const float y = nearPoint.y + ( farPoint.y - nearPoint.y ) * t;
+				min.x = std::min( min.x, x );
+				min.y = std::min( min.y, y );
+				max.x = std::max( max.x, x );
+				max.y = std::max( max.y, y );
+			}
+		}
+
+		Donya::Box rect{};
+		rect.pos	= ( min + max ) * 0.5f;
+		rect.size	= ( max - min ) * 0.5f;
+		return rect;
+	}
+
+	bool IsVisible( const Donya::Box &rect, const Donya::Box &box, float margin )
+	{
+		if ( !enabled ) { return true; }
+		// else
+
+		if ( rect.pos.x + rect.size.x < box.pos.x - box.size.x - margin ) { return false; }
+		if ( box.pos.x + box.size.x + margin < rect.pos.x - rect.size.x ) { return false; }
+		if ( rect.pos.y + rect.size.y < box.pos.y - box.size.y - margin ) { return false; }
+		if ( box.pos.y + box.size.y + margin < rect.pos.y - rect.size.y ) { return false; }
+		// else
+		return true;
+	}
+	bool IsVisible( const Donya::Box &rect, const Donya::AABB &box, float margin )
+	{
+		Donya::Box xy{};
+		xy.pos.x	= box.pos.x;
+		xy.pos.y	= box.pos.y;
+		xy.size.x	= box.size.x;
+		xy.size.y	= box.size.y;
+		return IsVisible( rect, xy, margin );
+	}
+
+	void SetEnable( bool enable )
+	{
+		enabled = enable;
+	}
+	bool IsEnabled()
+	{
+		return enabled;
+	}
+
+	void CountResult( size_t totalCount, size_t culledCount )
+	{
+		currentStats.totalCount  += totalCount;
+		currentStats.culledCount += culledCount;
+	}
+	void CountQuery( size_t queryCount )
+	{
+		currentStats.queryCount  += queryCount;
+	}
+	Stats GetLastStats()
+	{
+		return lastStats;
+	}
+	void FlushStats()
+	{
+		lastStats		= currentStats;
+		currentStats	= Stats{};
+	}
+
+	Grid::Grid() :
+		origin(), cellSize( 1.0f ),
+		columnCount( 0 ), rowCount( 0 ),
+		cellStarts(), indices(),
+		stamps(), currentStamp( 0 )
+	{}
+
+	void Grid::Build( const Donya::Box *pBoxes, size_t boxCount )
+	{
+		Clear();
+		if ( !pBoxes || !boxCount ) { return; }
+		// else
+
+		Donya::Vector2 min{ +FLT_MAX, +FLT_MAX };
+		Donya::Vector2 max{ -FLT_MAX, -FLT_MAX };
+		for ( size_t i = 0; i < boxCount; ++i )
+		{
+			const auto &box = pBoxes[i];
+			min.x = std::min( min.x, box.pos.x - box.size.x );
+			min.y = std::min( min.y, box.pos.y - box.size.y );
+			max.x = std::max( max.x, box.pos.x + box.size.x );
+			max.y = std::max( max.y, box.pos.y + box.size.y );
+		}
+
+		// Decide the cell size that makes about one box per cell.
+		const float area	= std::max( FLT_EPSILON, ( max.x - min.x ) * ( max.y - min.y ) );
+		cellSize			= std::max( FLT_EPSILON, sqrtf( area / scast<float>( boxCount ) ) );
+		cellSize			= std::max( cellSize, std::max( max.x - min.x, max.y - min.y ) / scast<float>( MAX_CELL_COUNT_PER_AXIS ) );
+		origin				= min;
+		const int maxCellCount	= MAX_CELL_COUNT_PER_AXIS;
+		columnCount			= std::min( maxCellCount, scast<int>( ( max.x - min.x ) / cellSize ) + 1 );
+		rowCount			= std::min( maxCellCount, scast<int>( ( max.y - min.y ) / cellSize ) + 1 );
+
+		// Count per cell, then fill by the prefix-sum.
+
+		const size_t cellCount = scast<size_t>( columnCount * rowCount );
+		cellStarts.assign( cellCount + 1, 0 );
+		auto ForEachCell = [&]( const Donya::Box &box, auto func )
+		{
+			const int left		= ToColumn( box.pos.x - box.size.x );
+			const int right		= ToColumn( box.pos.x + box.size.x );
+			const int bottom	= ToRow( box.pos.y - box.size.y );
+			const int top		= ToRow( box.pos.y + box.size.y );
+			for ( int row = bottom; row <= top; ++row )
+			{
+				for ( int column = left; column <= right; ++column )
+				{
+					func( scast<size_t>( row * columnCount + column ) );
+				}
+			}
+		};
+		for ( size_t i = 0; i < boxCount; ++i )
+		{
+			ForEachCell( pBoxes[i], [&]( size_t cell ) { cellStarts[cell + 1]++; } );
+		}
+		for ( size_t i = 0; i < cellCount; ++i )
+		{
+			cellStarts[i + 1] += cellStarts[i];
+		}
+
+		indices.resize( cellStarts.back() );
+		Donya::FrameVector<size_t> writePos( cellStarts.begin(), cellStarts.end() - 1 );
+		for ( size_t i = 0; i < boxCount; ++i )
+		{
+			ForEachCell( pBoxes[i], [&]( size_t cell ) { indices[writePos[cell]++] = i; } );
+		}
+
+		stamps.assign( boxCount, 0 );
+		currentStamp = 0;
+	}
+	void Grid::Clear()
+	{
+		origin		= Donya::Vector2{};
+		cellSize	= 1.0f;
+		columnCount	= 0;
+		rowCount	= 0;
+		cellStarts.clear();
+		indices.clear();
+		stamps.clear();
+		currentStamp = 0;
+	}
+
+	void Grid::Query( const Donya::Box &rect, Donya::FrameVector<size_t> *pOutput ) const
+	{
+		if ( !pOutput || IsEmpty() ) { return; }
+		// else
+
+		// Reset the stamps at the wrap-around.
+		if ( ++currentStamp == 0 )
+		{
+			std::fill( stamps.begin(), stamps.end(), 0 );
+			currentStamp = 1;
+		}
+
+		const int left		= ToColumn( rect.pos.x - rect.size.x );
+		const int right		= ToColumn( rect.pos.x + rect.size.x );
+		const int bottom	= ToRow( rect.pos.y - rect.size.y );
+		const int top		= ToRow( rect.pos.y + rect.size.y );
+		for ( int row = bottom; row <= top; ++row )
+		{
+			for ( int column = left; column <= right; ++column )
+			{
+				const size_t cell = scast<size_t>( row * columnCount + column );
+				for ( size_t i = cellStarts[cell]; i < cellStarts[cell + 1]; ++i )
+				{
+					const size_t index = indices[i];
+					if ( stamps[index] == currentStamp ) { continue; }
+					// else
+
+					stamps[index] = currentStamp;
+					pOutput->emplace_back( index );
+				}
+			}
+		}
+	}
+
+	int Grid::ToColumn( float x ) const
+	{
+		// The division is done by float, because the infinite rectangle can not be cast to int.
+		const float column = std::floor( ( x - origin.x ) / cellSize );
+		return scast<int>( std::max( 0.0f, std::min( scast<float>( columnCount - 1 ), column ) ) );
+	}
+	int Grid::ToRow( float y ) const
+	{
+		const float row = std::floor( ( y - origin.y ) / cellSize );
+		return scast<int>( std::max( 0.0f, std::min( scast<float>( rowCount - 1 ), row ) ) );
+	}
+}
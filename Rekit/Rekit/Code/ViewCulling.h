@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+
+#include "Donya/Collision.h"
+#include "Donya/FrameArena.h"
+#include "Donya/Vector.h"
+
+/// <summary>
+/// Skip the drawing of the objects that are out of the camera's view, before building the draw commands.<para></para>
+/// The view is regarded as a rectangle on the XY plane, because the stage is placed on the XY plane.
+/// </summary>
+namespace ViewCulling
+{
+	/// <summary>
+	/// Calculate the rectangle on the XY plane that contains the visible area of the "matViewProjection", in the range of [wsMinZ ~ wsMaxZ] of world space.<para></para>
+	/// If the camera does not look toward the Z axis, returns the infinite rectangle(culls nothing).
+	/// </summary>
+	Donya::Box CalcVisibleRect( const Donya::Vector4x4 &matViewProjection, float wsMinZ, float wsMaxZ );
+
+	/// <summary>
+	/// Returns true if the "box" overlaps the "visibleRect" on the XY plane. The "box" is regarded as extended by the "margin".<para></para>
+	/// The exist flag is ignored. If the culling is disabled, always returns true.
+	/// </summary>
+	bool IsVisible( const Donya::Box &visibleRect, const Donya::Box  &box, float margin = 0.0f );
+	/// <summary>
+	/// Returns true if the "box" overlaps the "visibleRect" on the XY plane. The "box" is regarded as extended by the "margin".<para></para>
+	/// The exist flag is ignored. If the culling is disabled, always returns true.
+	/// </summary>
+	bool IsVisible( const Donya::Box &visibleRect, const Donya::AABB &box, float margin = 0.0f );
+
+	/// <summary>
+	/// Default is true. Use for comparing the result.
+	/// </summary>
+	void SetEnable( bool enable );
+	bool IsEnabled();
+
+	struct Stats
+	{
+		size_t totalCount{};	// The count of objects that were tested.
+		size_t culledCount{};	// The count of objects that were not drawn.
+		size_t queryCount{};	// The count of queries to the Grid.
+	};
+	/// <summary>
+	/// Add the result of a culling to the current frame's stats.
+	/// </summary>
+	void CountResult( size_t totalCount, size_t culledCount );
+	/// <summary>
+	/// Add the count of the queries to a Grid for the culling, to the current frame's stats.
+	/// </summary>
+	void CountQuery( size_t queryCount = 1U );
+	/// <summary>
+	/// Returns the stats of last frame.
+	/// </summary>
+	Stats GetLastStats();
+	/// <summary>
+	/// The stats of current frame will become the last frame's. Please call once per frame.
+	/// </summary>
+	void FlushStats();
+
+	/// <summary>
+	/// The uniform grid of the boxes on the XY plane. Use for the many static boxes, the query is faster than testing all boxes.<para></para>
+	/// The boxes are not stored, so please re-build when the boxes are changed.<para></para>
+	/// The Query() rewrites the internal stamps, so please do not query the same grid from some threads at the same time.
+	/// </summary>
+	class Grid
+	{
+	public:
+		static constexpr int MAX_CELL_COUNT_PER_AXIS = 256;
+	private:
+		Donya::Vector2				origin;			// Left-bottom of the grid.
+		float						cellSize;
+		int							columnCount;
+		int							rowCount;
+		std::vector<size_t>			cellStarts;		// The range of cell "i" in "indices" is [cellStarts[i] ~ cellStarts[i + 1]).
+		std::vector<size_t>			indices;		// The indices of boxes. A box is registered to all cells that overlap it.
+		mutable std::vector<unsigned int>	stamps;	// Per box. Prevent to return the same box twice.
+		mutable unsigned int		currentStamp;
+	public:
+		Grid();
+	public:
+		/// <summary>
+		/// Build the grid. The cell size is decided to be that a cell contains about one box.
+		/// </summary>
+		void Build( const Donya::Box *pBoxes, size_t boxCount );
+		void Clear();
+
+		bool IsEmpty() const { return indices.empty(); }
+		/// <summary>
+		/// Append the indices of the boxes that may overlap the "rect" to "pOutput". Each index is appended once.<para></para>
+		/// The returned boxes are candidates, so please test these precisely if necessary.
+		/// </summary>
+		void Query( const Donya::Box &rect, Donya::FrameVector<size_t> *pOutput ) const;
+	private:
+		int ToColumn( float x ) const;
+		int ToRow( float y ) const;
+	};
+}
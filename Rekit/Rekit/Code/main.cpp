@@ -3,13 +3,66 @@
 #include <time.h>
 #include <windows.h>
 
+#include "Donya/Benchmark.h"
+#include "Donya/AssetPipeline.h"
 #include "Donya/Constant.h"	// Use DEBUG_MODE, scast macros.
 #include "Donya/Donya.h"
+#include "Donya/Resource.h"	// Use GetShaderCacheStats().
 
 #include "Common.h"
 #include "Framework.h"
 #include "Icon.h"
 
+/// <summary>
+/// Output the time of the initialization to the debug output. Use for measuring the saving by the shader cache.
+/// </summary>
+void ReportStartupTiming( double engineInitSeconds, double gameInitSeconds )
+{
+	const auto shaderStats = Donya::Resource::GetShaderCacheStats();
+	const auto assetStats  = Donya::AssetPipeline::GetCacheStats();
+
+	char report[512]{};
+	sprintf_s
+	(
+		report,
+		"[Startup] Total : %.2f ms (Engine : %.2f ms, Game : %.2f ms)\n"
+		"[Startup] Shader : Compiled[%u] in %.2f ms, CacheHit[%u], CacheFileRead : %.2f ms\n"
+		"[Startup] Model : CachedBinaryHit[%u], Miss[%u]\n",
+		( engineInitSeconds + gameInitSeconds ) * 1000.0, engineInitSeconds * 1000.0, gameInitSeconds * 1000.0,
+		shaderStats.compiledCount, shaderStats.compileSeconds * 1000.0,
+		shaderStats.cacheHitCount, shaderStats.fileReadSeconds * 1000.0,
+		assetStats.hitCount, assetStats.missCount
+	);
+	OutputDebugStringA( report );
+}
+
+/// <summary>
+/// Convert the changed models in "./Data/Models" to the binary of Loader, and output the result to the debug output.<para></para>
+/// Returns the exit code, it is not zero if some model failed.
+/// </summary>
+INT ConvertChangedAssets()
+{
+	const auto sources = Donya::AssetPipeline::EnumerateSourceAssets( "./Data/Models" );
+	const auto result  = Donya::AssetPipeline::ConvertChangedAssets( sources );
+
+	char report[256]{};
+	sprintf_s
+	(
+		report,
+		"[AssetPipeline] Converted[%zu], UpToDate[%zu], Failed[%zu], Hash : %.2f ms, Convert : %.2f ms\n",
+		result.convertedCount, result.upToDateCount, result.failedCount,
+		result.hashSeconds * 1000.0, result.convertSeconds * 1000.0
+	);
+	OutputDebugStringA( report );
+
+	for ( const auto &error : result.errors )
+	{
+		OutputDebugStringA( ( "[AssetPipeline] " + error + "\n" ).c_str() );
+	}
+
+	return ( result.failedCount ) ? 1 : 0;
+}
+
 INT WINAPI wWinMain( _In_ HINSTANCE instance, _In_opt_ HINSTANCE prevInstance, _In_ LPWSTR cmdLine, _In_ INT cmdShow )
 {
 #if DEBUG_MODE
@@ -29,6 +82,12 @@ INT WINAPI wWinMain( _In_ HINSTANCE instance, _In_opt_ HINSTANCE prevInstance, _
 
 	srand( scast<unsigned int>( time( NULL ) ) );
 
+	// The tool mode, it does not create the window.
+	if ( cmdLine && wcsstr( cmdLine, L"-convert-assets" ) )
+	{
+		return ConvertChangedAssets();
+	}
+
 #if DEBUG_MODE
 	constexpr bool fullScreenMode = false;
 #else
@@ -37,13 +96,25 @@ INT WINAPI wWinMain( _In_ HINSTANCE instance, _In_opt_ HINSTANCE prevInstance, _
 #endif // DEBUG_MODE
 
 	std::string title{ "tbNg[" };
-	Donya::Init( cmdShow, Common::ScreenWidth(), Common::ScreenHeight(), title.c_str(), fullScreenMode );
+	Benchmark startupTimer{};
+	startupTimer.Begin();
+
+	// For the machine that has no audio device. The sounds are mixed by the software, and discarded.
+	const bool isNullAudio = ( cmdLine && wcsstr( cmdLine, L"-null-audio" ) );
+
+	Donya::Init( cmdShow, Common::ScreenWidth(), Common::ScreenHeight(), title.c_str(), fullScreenMode, /* isAppendFPS = */ true, /* isEnableMultiThreaded = */ true, isNullAudio );
+
+	const double engineInitSeconds = startupTimer.End();
 
 	Donya::SetWindowIcon( instance, IDI_ICON );
 
+	startupTimer.Begin();
+
 	Framework framework{};
 	framework.Init();
 
+	ReportStartupTiming( engineInitSeconds, startupTimer.End() );
+
 	while ( Donya::MessageLoop() )
 	{
 		Donya::ClearViews();